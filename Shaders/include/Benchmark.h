@@ -0,0 +1,153 @@
+/**
+@file Benchmark.h
+@brief Benchmarks of the engine's systems on the CPU, of shader costs on the GPU, and of whole generated scenes.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "FramePacket.h"
+
+class Mesh;
+class EntityManager;
+class JobSystem;
+
+/**
+	* The options for the scene benchmark, which renders a generated scene headless and writes the results as JSON.
+*/
+struct SceneBenchmarkSettings {
+	unsigned int m_InstanceCount = 1000;	//!< Stores the number of objects placed in the scene.
+	unsigned int m_LightCount = 8;	//!< Stores the number of lights.
+	float m_LightRadius = 12.0f;	//!< Stores how far each light reaches.
+	unsigned int m_MaterialCount = 16;	//!< Stores the number of generated materials, each on its own sphere.
+	std::vector<std::string> m_ModelNames = { "nanosuit" };	//!< Stores the loaded models placed alongside the spheres.
+	unsigned int m_FrameCount = 600;	//!< Stores the number of frames measured.
+	unsigned int m_WarmUpFrameCount = 60;	//!< Stores the number of frames rendered before measuring.
+	int m_Width = 1280;	//!< Stores the width rendered at.
+	int m_Height = 720;	//!< Stores the height rendered at.
+	bool m_UseSoftwareRenderer = false;	//!< Stores whether to skip the GPU, and use llvmpipe.
+	bool m_IsRenderThreaded = true;	//!< Stores whether to draw on the render thread.
+	bool m_UseDeferredShading = false;	//!< Stores whether to light the scene from a G-buffer.
+	bool m_UseClusteredShading = false;	//!< Stores whether to light the scene with clustered forward shading.
+	bool m_UseShadows = true;	//!< Stores whether the sun, and the scene's light, cast shadows.
+	AntiAliasingMode m_AntiAliasing = AntiAliasingMode::NONE;	//!< Stores how the scene's edges are anti-aliased.
+	bool m_UseHDREffects = false;	//!< Stores whether to add bloom and auto exposure, the tonemap always runs.
+	float m_FrameBudgetMilliseconds = 0.0f;	//!< Stores the GPU time the render scale is adjusted to fit, or 0 to always render at full scale.
+	unsigned int m_Seed = 1234;	//!< Stores the seed the scene is generated from.
+	std::string m_OutputPath = "benchmark.json";	//!< Stores where the results are written.
+	std::string m_Label;	//!< Stores a label to tell runs apart, such as a commit hash.
+};
+
+/*! \class Benchmark
+	\brief Benchmarks of the engine's systems on the CPU, of shader costs on the GPU, and of whole generated scenes.
+
+	The CPU benchmarks don't need a window. The vertex shader and scene benchmarks create an OpenGL context, headless
+	when asked, and render into it.
+*/
+class Benchmark {
+private:
+	Benchmark() = default;
+	~Benchmark() = default;
+
+	/*!
+		\brief Creates entities scattered through a cube, each with a transform, renderable, colour and bounds.
+	*/
+	static void CreateEntities(EntityManager &p_Entities, unsigned int p_EntityCount);
+	/*!
+		\brief Rotates a fraction of the entities, marking their transforms dirty.
+	*/
+	static void MoveEntities(JobSystem &p_JobSystem, EntityManager &p_Entities, float p_MovingFraction, float p_Angle);
+	/*!
+		\brief Reads the scene benchmark's options, e.g: --instances 5000 --lights 16 --materials 32 --models nanosuit --frames 1000 --output results.json
+		\return Returns false if an option wasn't recognised, or its value couldn't be read.
+	*/
+	static bool ParseSceneSettings(const std::vector<std::string> &p_Arguments, SceneBenchmarkSettings &p_Settings);
+	/*!
+		\brief Reads an option's value as a whole number, reporting it if it isn't one.
+		\param p_Option the option, for the report.
+		\param p_Value the value.
+		\param p_Result set to the number, if the value is one.
+		\return Returns whether the value was a whole number.
+	*/
+	static bool ParseUnsigned(const std::string &p_Option, const std::string &p_Value, unsigned int &p_Result);
+	/*!
+		\brief Reads an option's value as a number, reporting it if it isn't one.
+		\param p_Option the option, for the report.
+		\param p_Value the value.
+		\param p_Result set to the number, if the value is one.
+		\return Returns whether the value was a finite number.
+	*/
+	static bool ParseFloat(const std::string &p_Option, const std::string &p_Value, float &p_Result);
+	/*!
+		\brief Creates a small texture of a single colour, for the generated materials.
+		\param p_Colour the colour, each component from zero to one.
+		\return Returns the texture ID.
+	*/
+	static unsigned int CreateSolidTexture(const glm::vec4 &p_Colour);
+	/*!
+		\brief The camera path the scene benchmark flies: once around the scene, swooping down to skim the objects halfway.
+		\param p_Progress how far along the path, from zero to one.
+		\param p_Radius the radius of the scene.
+		\param p_Position receives the camera's position.
+		\param p_Target receives the point the camera looks at.
+	*/
+	static void GetScriptedCameraPose(float p_Progress, float p_Radius, glm::vec3 &p_Position, glm::vec3 &p_Target);
+
+public:
+	/*!
+		\brief Runs a benchmark by name.
+		\param p_Name the name of the benchmark, such as "transforms".
+		\param p_Arguments the benchmark's options, only the scene benchmark takes any.
+		\return Returns true if the benchmark exists, false otherwise.
+	*/
+	static bool Run(const std::string &p_Name, const std::vector<std::string> &p_Arguments = std::vector<std::string>());
+	/*!
+		\brief Builds a UV sphere, with normals, tangents and texture coordinates.
+		\param p_Segments the number of segments around, and rings down, the sphere.
+		\return Returns the sphere's mesh.
+	*/
+	static Mesh CreateSphere(unsigned int p_Segments);
+
+	/*!
+		\brief Compares recalculating every node of a transform hierarchy, against only recalculating the nodes that changed.
+		\param p_NodeCount the number of nodes in the hierarchy.
+		\param p_ChangingFraction the fraction of nodes that move each frame.
+		\param p_FrameCount the number of frames to average over.
+	*/
+	static void TransformHierarchyUpdate(unsigned int p_NodeCount = 100000, float p_ChangingFraction = 0.01f, unsigned int p_FrameCount = 200);
+	/*!
+		\brief Measures the GPU time blinnPhong.vert takes on a high polygon sphere, with its object space and normal matrix paths.
+		\param p_SphereSegments the number of segments around, and rings down, the sphere.
+		\param p_FrameCount the number of frames to average over.
+	*/
+	static void VertexShaderCost(unsigned int p_SphereSegments = 1024, unsigned int p_FrameCount = 200);
+	/*!
+		\brief Measures the entity systems, updating, culling and emitting draw packets for a large number of entities, against a frame budget.
+		\param p_EntityCount the number of entities.
+		\param p_MovingFraction the fraction of entities that move each frame.
+		\param p_FrameCount the number of frames to average over.
+		\param p_BudgetMilliseconds the time the systems should fit in, each frame.
+	*/
+	static void EntitySystems(unsigned int p_EntityCount = 1000000, float p_MovingFraction = 1.0f, unsigned int p_FrameCount = 100, double p_BudgetMilliseconds = 4.0);
+	/*!
+		\brief Measures how the frame graph speeds up, running the job system with one thread up to one per hardware thread.
+		\param p_EntityCount the number of entities.
+		\param p_MovingFraction the fraction of entities that move each frame.
+		\param p_FrameCount the number of frames to average over, for each thread count.
+	*/
+	static void JobSystemScaling(unsigned int p_EntityCount = 1000000, float p_MovingFraction = 0.1f, unsigned int p_FrameCount = 50);
+	/*!
+		\brief Renders a generated scene headless along a scripted camera path, and writes the CPU and GPU frame times,
+		draw calls, triangles and state changes as JSON, so runs can be compared across commits.
+		\param p_Settings the scene and run options.
+		\return Returns true if the scene was rendered, and the results written.
+	*/
+	static bool RenderScene(const SceneBenchmarkSettings &p_Settings);
+
+	// Delete the copy and assignment operators.
+	Benchmark(Benchmark const&) = delete; //!< Copy operator, deleted.
+	Benchmark& operator=(Benchmark const&) = delete; //!< Assignment operator, deleted.
+};
\ No newline at end of file
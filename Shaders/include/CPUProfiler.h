@@ -0,0 +1,153 @@
+/**
+@file CPUProfiler.h
+@brief Scoped CPU timings, written into a ring buffer per thread, and exported as a Chrome trace.
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// The macros compile to nothing unless ENABLE_CPU_PROFILER is defined, the Debug configurations define it.
+#define CPU_PROFILE_CONCATENATE_INNER(p_A, p_B) p_A##p_B
+#define CPU_PROFILE_CONCATENATE(p_A, p_B) CPU_PROFILE_CONCATENATE_INNER(p_A, p_B)
+#ifdef ENABLE_CPU_PROFILER
+// Times the rest of the enclosing scope, the name must outlive the profiler, so use a string literal or an interned name.
+#define CPU_PROFILE_SCOPE(p_Name) CPUProfileScope CPU_PROFILE_CONCATENATE(cpuProfileScope, __LINE__)(p_Name)
+#define CPU_PROFILE_FUNCTION() CPU_PROFILE_SCOPE(__FUNCTION__)
+// Names the calling thread in the trace.
+#define CPU_PROFILE_THREAD_NAME(p_Name) CPUProfiler::SetThreadName(p_Name)
+#else
+#define CPU_PROFILE_SCOPE(p_Name) ((void)0)
+#define CPU_PROFILE_FUNCTION() ((void)0)
+#define CPU_PROFILE_THREAD_NAME(p_Name) ((void)0)
+#endif
+
+/**
+	* A scope that was timed, as it's stored in a thread's ring.
+*/
+struct CPUProfileEvent {
+	const char *m_Name;	//!< Stores the name of the scope, which must outlive the profiler.
+	long long m_StartNanoseconds;	//!< Stores when the scope started, relative to the profiler's epoch.
+	long long m_DurationNanoseconds;	//!< Stores how long the scope took.
+};
+
+/*! \class CPUProfiler
+	\brief Collects scoped CPU timings from every thread, and exports them in the Chrome Trace Event format.
+
+	Each thread gets its own fixed size ring of events the first time it records one, so recording never allocates,
+	locks or shares a cache line with another thread. When a ring is full the oldest events are overwritten. A scope
+	is stored once it ends, as a single complete event, so an overwritten event can't leave a begin without an end.
+	The trace can be opened in chrome://tracing, or ui.perfetto.dev.
+*/
+class CPUProfiler {
+private:
+	static const size_t s_m_EventRingSize = 1 << 15;	//!< The number of events each thread keeps.
+
+	/**
+		* One thread's ring of events.
+	*/
+	struct ThreadBuffer {
+		std::array<CPUProfileEvent, s_m_EventRingSize> m_Events;	//!< Stores the ring of events.
+		std::atomic<unsigned long long> m_WriteCount{ 0 };	//!< Stores the number of events ever written, only the owning thread writes it.
+		std::string m_ThreadName;	//!< Stores the thread's name, for the trace.
+		unsigned int m_ThreadID = 0;	//!< Stores the ID the thread is given in the trace.
+	};
+
+	static std::mutex s_m_BuffersMutex;	//!< Guards the list of buffers, which only changes when a thread records its first event.
+	static std::vector<std::unique_ptr<ThreadBuffer>> s_m_Buffers;	//!< Stores every thread's buffer, kept after the thread exits so its events can be exported.
+	static thread_local ThreadBuffer *t_m_Buffer;	//!< Stores the calling thread's buffer.
+	static const std::chrono::steady_clock::time_point s_m_Epoch;	//!< Stores the time the events are relative to.
+	static std::mutex s_m_NamesMutex;	//!< Guards the interned names.
+	static std::unordered_set<std::string> s_m_Names;	//!< Stores the interned names, a set's elements never move, so their pointers stay valid.
+
+	CPUProfiler() = default;
+	~CPUProfiler() = default;
+
+	/*!
+		\brief Gets the calling thread's buffer, creating it the first time.
+		\return Returns the buffer.
+	*/
+	static ThreadBuffer &GetThreadBuffer();
+
+public:
+	/*!
+		\brief Gets the time since the profiler's epoch.
+		\return Returns the time, in nanoseconds.
+	*/
+	static long long Now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_m_Epoch).count();
+	}
+
+	/*!
+		\brief Records a scope that has ended, into the calling thread's ring.
+		\param p_Name the name of the scope.
+		\param p_StartNanoseconds when the scope started.
+		\param p_EndNanoseconds when the scope ended.
+	*/
+	static void RecordEvent(const char *p_Name, long long p_StartNanoseconds, long long p_EndNanoseconds) {
+		ThreadBuffer &buffer = t_m_Buffer ? *t_m_Buffer : GetThreadBuffer();
+		unsigned long long writeCount = buffer.m_WriteCount.load(std::memory_order_relaxed);
+		CPUProfileEvent &profileEvent = buffer.m_Events[writeCount % s_m_EventRingSize];
+		profileEvent.m_Name = p_Name;
+		profileEvent.m_StartNanoseconds = p_StartNanoseconds;
+		profileEvent.m_DurationNanoseconds = p_EndNanoseconds - p_StartNanoseconds;
+		// Publishes the event, to a thread exporting the trace.
+		buffer.m_WriteCount.store(writeCount + 1, std::memory_order_release);
+	}
+
+	/*!
+		\brief Names the calling thread in the trace.
+		\param p_Name the name.
+	*/
+	static void SetThreadName(const std::string &p_Name);
+	/*!
+		\brief Keeps a copy of a name for as long as the profiler, for scopes whose names are only known at run time.
+		\param p_Name the name.
+		\return Returns the copy, the same pointer every time for the same name.
+	*/
+	static const char *InternName(const std::string &p_Name);
+
+	/*!
+		\brief Writes every thread's events to a Chrome Trace Event file.
+		\param p_FilePath the path of the file.
+		\return Returns true if the file was written, false otherwise.
+	*/
+	static bool WriteChromeTrace(const std::string &p_FilePath);
+
+	static bool IsEnabled() {
+#ifdef ENABLE_CPU_PROFILER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Delete the copy and assignment operators.
+	CPUProfiler(CPUProfiler const&) = delete; //!< Copy operator, deleted.
+	CPUProfiler& operator=(CPUProfiler const&) = delete; //!< Assignment operator, deleted.
+};
+
+/*! \class CPUProfileScope
+	\brief Times a scope, from construction to destruction, use the CPU_PROFILE_SCOPE macro rather than this directly.
+*/
+class CPUProfileScope {
+private:
+	const char *m_Name;	//!< Stores the name of the scope.
+	long long m_StartNanoseconds;	//!< Stores when the scope started.
+
+public:
+	explicit CPUProfileScope(const char *p_Name) : m_Name(p_Name), m_StartNanoseconds(CPUProfiler::Now()) {}
+	~CPUProfileScope() {
+		CPUProfiler::RecordEvent(m_Name, m_StartNanoseconds, CPUProfiler::Now());
+	}
+
+	// Delete the copy and assignment operators.
+	CPUProfileScope(CPUProfileScope const&) = delete; //!< Copy operator, deleted.
+	CPUProfileScope& operator=(CPUProfileScope const&) = delete; //!< Assignment operator, deleted.
+};
@@ -54,4 +54,6 @@ public:
 	glm::mat4 GetViewMatrix();
 	void ProcessKeyboard(const CameraMovement &p_Direction, const float &p_DeltaTime);
 	void ProcessMouseMovement(float p_XOffset, float p_YOffset, bool p_ContrainPitch = true);
+	// Moves the camera, and turns it to face the target.
+	void LookAt(const glm::vec3 &p_Position, const glm::vec3 &p_Target);
 };
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+@file CommandBuffer.h
+@brief An API-agnostic list of draw commands, recorded on any thread and replayed in order on the one with the graphics context.
+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Mesh;
+
+/**
+	* The kinds of command a command buffer can hold.
+*/
+enum class CommandType : unsigned char {
+	BIND_PROGRAM = 0,
+	BIND_MATERIAL,
+	BIND_OBJECT_DATA,
+	DRAW_INDEXED,
+	COUNT
+};
+
+/**
+	* Makes a shader program current.
+*/
+struct BindProgramCommand {
+	unsigned int m_Program;	//!< Stores the ID of the program.
+};
+
+/**
+	* Binds a mesh's textures, to the samplers of the current program.
+*/
+struct BindMaterialCommand {
+	const Mesh *m_Material;	//!< Stores the mesh whose textures are bound.
+	unsigned int m_Program;	//!< Stores the program the samplers belong to, it must be the current one.
+};
+
+/**
+	* Binds a range of a buffer to the per-object uniform block, the per-draw offset.
+*/
+struct BindObjectDataCommand {
+	unsigned int m_Buffer;	//!< Stores the ID of the buffer object.
+	std::ptrdiff_t m_Offset;	//!< Stores the offset of the range.
+	std::ptrdiff_t m_Size;	//!< Stores the size of the range.
+};
+
+/**
+	* Draws indexed triangles.
+*/
+struct DrawIndexedCommand {
+	unsigned int m_VertexArray;	//!< Stores the ID of the vertex array object.
+	unsigned int m_IndexCount;	//!< Stores the number of indices to draw.
+	unsigned int m_FirstIndex;	//!< Stores the first index to draw.
+};
+
+/**
+	* A single command, and the arguments for its type.
+*/
+struct Command {
+	CommandType m_Type;	//!< Stores the kind of command.
+	union {
+		BindProgramCommand m_BindProgram;
+		BindMaterialCommand m_BindMaterial;
+		BindObjectDataCommand m_BindObjectData;
+		DrawIndexedCommand m_DrawIndexed;
+	};
+};
+
+/*! \class CommandBuffer
+	\brief A list of commands, that only records what to do, so it can be filled without a graphics context.
+
+	Each worker records its own slice of the render queue into its own buffer, and a single thread replays the
+	buffers in order. A buffer never relies on state left behind by another: the first command of each kind is
+	always recorded, and after that commands that wouldn't change anything are dropped.
+*/
+class CommandBuffer {
+private:
+	std::vector<Command> m_Commands;	//!< Stores the commands, in the order they're replayed.
+
+	unsigned int m_CurrentProgram = 0;	//!< Stores the last program recorded.
+	const Mesh *m_CurrentMaterial = nullptr;	//!< Stores the last material recorded.
+	unsigned int m_CurrentMaterialProgram = 0;	//!< Stores the program the last material was bound to.
+	BindObjectDataCommand m_CurrentObjectData = { 0, 0, 0 };	//!< Stores the last object data range recorded.
+
+	std::array<unsigned int, static_cast<size_t>(CommandType::COUNT)> m_CommandCounts = {};	//!< Stores the number of commands of each type.
+	unsigned int m_IndexCount = 0;	//!< Stores the number of indices drawn.
+	unsigned int m_DroppedCommandCount = 0;	//!< Stores the number of commands dropped, because they wouldn't change anything.
+
+	void Add(const Command &p_Command) {
+		m_Commands.push_back(p_Command);
+		m_CommandCounts[static_cast<size_t>(p_Command.m_Type)]++;
+	}
+
+public:
+	CommandBuffer() = default;
+	~CommandBuffer() = default;
+
+	/*!
+		\brief Empties the buffer, keeping its memory for the next frame.
+	*/
+	void Reset();
+
+	/*!
+		\brief Records a program change.
+		\param p_Program the ID of the program.
+	*/
+	void BindProgram(unsigned int p_Program);
+	/*!
+		\brief Records binding a material's textures, to the current program's samplers.
+		\param p_Material the mesh whose textures are bound.
+	*/
+	void BindMaterial(const Mesh *p_Material);
+	/*!
+		\brief Records binding the per-object data, used by the following draws.
+		\param p_Buffer the ID of the buffer object.
+		\param p_Offset the offset of the object's data, inside the buffer.
+		\param p_Size the size of the object's data.
+	*/
+	void BindObjectData(unsigned int p_Buffer, std::ptrdiff_t p_Offset, std::ptrdiff_t p_Size);
+	/*!
+		\brief Records an indexed draw.
+		\param p_VertexArray the ID of the vertex array object.
+		\param p_IndexCount the number of indices.
+		\param p_FirstIndex the first index.
+	*/
+	void DrawIndexed(unsigned int p_VertexArray, unsigned int p_IndexCount, unsigned int p_FirstIndex = 0);
+
+	/*!
+		\brief Checks the recorded commands could be replayed by themselves, without the graphics API.
+		\param p_ObjectDataAlignment the alignment object data offsets need, for binding.
+		\param p_Error receives a description of the first problem found.
+		\return Returns true if the commands are valid.
+	*/
+	bool Validate(std::ptrdiff_t p_ObjectDataAlignment, std::string &p_Error) const;
+
+	const std::vector<Command> &GetCommands() const {
+		return m_Commands;
+	}
+	unsigned int GetCommandCount(CommandType p_Type) const {
+		return m_CommandCounts[static_cast<size_t>(p_Type)];
+	}
+	unsigned int GetDrawCount() const {
+		return GetCommandCount(CommandType::DRAW_INDEXED);
+	}
+	unsigned int GetIndexCount() const {
+		return m_IndexCount;
+	}
+	unsigned int GetDroppedCommandCount() const {
+		return m_DroppedCommandCount;
+	}
+};
@@ -0,0 +1,34 @@
+/**
+@file CommandReplayer.h
+@brief Replays recorded command buffers with OpenGL.
+*/
+#pragma once
+
+#include <vector>
+
+#include "CommandBuffer.h"
+
+/*! \class CommandReplayer
+	\brief Replays recorded command buffers with OpenGL, it must be used on the thread that owns the context.
+*/
+class CommandReplayer {
+private:
+	CommandReplayer() = default;
+	~CommandReplayer() = default;
+
+public:
+	/*!
+		\brief Replays a command buffer.
+		\param p_CommandBuffer the command buffer.
+	*/
+	static void Replay(const CommandBuffer &p_CommandBuffer);
+	/*!
+		\brief Replays command buffers, in order.
+		\param p_CommandBuffers the command buffers.
+	*/
+	static void Replay(const std::vector<CommandBuffer> &p_CommandBuffers);
+
+	// Delete the copy and assignment operators.
+	CommandReplayer(CommandReplayer const&) = delete; //!< Copy operator, deleted.
+	CommandReplayer& operator=(CommandReplayer const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,132 @@
+/**
+@file Components.h
+@brief The components an entity can be made of.
+*/
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class Model;
+class Shader;
+
+/**
+	* Identifies each type of component, and the bit it uses in an archetype's mask.
+*/
+enum class ComponentType : unsigned int {
+	TRANSFORM = 0,
+	RENDERABLE,
+	COLOUR,
+	BOUNDS,
+	LIGHT,
+	SHADOW_CASTER,
+
+	COUNT
+};
+
+/**
+	* A handle to an entity. The generation stops a handle to a destroyed entity referring to a new one, that reused its index.
+*/
+struct Entity {
+	unsigned int m_Index = ~0u;	//!< Stores the index of the entity's record.
+	unsigned int m_Generation = 0;	//!< Stores the generation of the record, when the entity was created.
+
+	bool operator==(const Entity &p_Other) const {
+		return m_Index == p_Other.m_Index && m_Generation == p_Other.m_Generation;
+	}
+	bool operator!=(const Entity &p_Other) const {
+		return !(*this == p_Other);
+	}
+};
+
+/**
+	* A position, rotation and scale, and the matrices calculated from them.
+*/
+struct TransformComponent {
+	static const ComponentType s_Type = ComponentType::TRANSFORM;
+
+	glm::vec3 m_Position = glm::vec3(0.0f);	//!< Stores the position.
+	glm::quat m_Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);	//!< Stores the rotation.
+	glm::vec3 m_Scale = glm::vec3(1.0f);	//!< Stores the scale.
+	Entity m_Parent;	//!< Stores the entity the position, rotation and scale are relative to, or an invalid entity for the world.
+	bool m_Dirty = true;	//!< Stores whether the matrices need recalculating.
+
+	glm::mat4 m_WorldMatrix = glm::mat4(1.0f);	//!< Stores the world matrix, calculated by the transform system.
+	glm::mat3 m_NormalMatrix = glm::mat3(1.0f);	//!< Stores the normal matrix, calculated by the transform system.
+};
+
+/**
+	* What to draw an entity with. The model and shader are owned by the resource manager.
+*/
+struct RenderableComponent {
+	static const ComponentType s_Type = ComponentType::RENDERABLE;
+
+	Model *m_Model = nullptr;	//!< Stores the model to draw.
+	Shader *m_Shader = nullptr;	//!< Stores the shader to draw the model with.
+};
+
+/**
+	* A surface colour.
+*/
+struct ColourComponent {
+	static const ComponentType s_Type = ComponentType::COLOUR;
+
+	glm::vec3 m_Colour = glm::vec3(1.0f);	//!< Stores the colour.
+};
+
+/**
+	* A bounding sphere, used for culling.
+*/
+struct BoundsComponent {
+	static const ComponentType s_Type = ComponentType::BOUNDS;
+
+	glm::vec3 m_LocalCentre = glm::vec3(0.0f);	//!< Stores the centre, in object space.
+	float m_LocalRadius = 1.0f;	//!< Stores the radius, in object space.
+	glm::vec3 m_WorldCentre = glm::vec3(0.0f);	//!< Stores the centre, in world space, calculated by the transform system.
+	float m_WorldRadius = 1.0f;	//!< Stores the radius, in world space, calculated by the transform system.
+	bool m_IsVisible = true;	//!< Stores whether the sphere was inside the view frustum, set by the culling system.
+};
+
+/**
+	* A point light, positioned by the entity's transform.
+*/
+struct LightComponent {
+	static const ComponentType s_Type = ComponentType::LIGHT;
+
+	glm::vec3 m_Colour = glm::vec3(1.0f);	//!< Stores the light's colour.
+	glm::vec3 m_Attenuation = glm::vec3(1.0f, 0.022f, 0.0019f);	//!< Stores the constant, linear and quadratic attenuation.
+};
+
+/**
+	* Marks an entity as casting shadows. Static casters are drawn once into the shadow caches, and only redrawn when one of them moves.
+*/
+struct ShadowCasterComponent {
+	static const ComponentType s_Type = ComponentType::SHADOW_CASTER;
+
+	bool m_IsStatic = true;	//!< Stores whether the caster is expected to stay still, so it can be cached.
+	bool m_HasMoved = true;	//!< Stores whether the transform has changed since the shadows last saw it, set by the transform system.
+	glm::vec4 m_CachedBounds = glm::vec4(0.0f);	//!< Stores the world bounding sphere the shadow caches last drew the caster with, zero when it isn't cached.
+};
+
+// Components are moved around inside chunks with memcpy.
+static_assert(std::is_trivially_copyable<TransformComponent>::value, "Components must be trivially copyable.");
+static_assert(std::is_trivially_copyable<RenderableComponent>::value, "Components must be trivially copyable.");
+static_assert(std::is_trivially_copyable<ColourComponent>::value, "Components must be trivially copyable.");
+static_assert(std::is_trivially_copyable<BoundsComponent>::value, "Components must be trivially copyable.");
+static_assert(std::is_trivially_copyable<LightComponent>::value, "Components must be trivially copyable.");
+static_assert(std::is_trivially_copyable<ShadowCasterComponent>::value, "Components must be trivially copyable.");
+
+/**
+	* The size of each type of component, indexed by ComponentType.
+*/
+static const std::array<size_t, static_cast<size_t>(ComponentType::COUNT)> s_ComponentSizes = { {
+	sizeof(TransformComponent),
+	sizeof(RenderableComponent),
+	sizeof(ColourComponent),
+	sizeof(BoundsComponent),
+	sizeof(LightComponent),
+	sizeof(ShadowCasterComponent)
+} };
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+@file DeferredRenderer.h
+@brief A G-buffer, and the light volumes that light it, so the cost of many lights follows the pixels they cover.
+*/
+#pragma once
+
+#include <memory>
+
+class Shader;
+
+/*! \class DeferredRenderer
+	\brief Shades the lit objects once per light per covered pixel, rather than once per light per object.
+
+	The geometry pass writes each pixel's albedo, specular intensity, normal and depth into a compact G-buffer: an
+	RGBA8 target, an RG16 target holding the normal folded onto an octahedron, and the depth buffer, which is read
+	back to rebuild positions. The lighting pass then draws one sphere per light, instanced, scaled to the light's
+	radius. Only the back faces are drawn, and only where they're behind the scene's depth, so each light shades the
+	pixels inside its volume and nothing else. The lights are read from the light buffer, bound by the caller. The
+	sun reaches everywhere, so it's one full screen triangle instead.
+*/
+class DeferredRenderer {
+private:
+	static const unsigned int s_m_VolumeSegments = 16;	//!< The number of segments around each light volume.
+
+	int m_Width = 0;	//!< Stores the width of the G-buffer.
+	int m_Height = 0;	//!< Stores the height of the G-buffer.
+
+	unsigned int m_FrameBufferObject = 0;	//!< Stores the ID of the G-buffer's framebuffer.
+	unsigned int m_AlbedoSpecularTexture = 0;	//!< Stores the ID of the albedo and specular intensity texture.
+	unsigned int m_NormalTexture = 0;	//!< Stores the ID of the octahedral normal texture.
+	unsigned int m_DepthTexture = 0;	//!< Stores the ID of the depth and stencil texture.
+
+	unsigned int m_VolumeVertexArrayObject = 0;	//!< Stores the ID of the light volume's vertex array.
+	unsigned int m_VolumeVertexBufferObject = 0;	//!< Stores the ID of the light volume's vertex buffer.
+	unsigned int m_VolumeIndexBufferObject = 0;	//!< Stores the ID of the light volume's index buffer.
+	unsigned int m_VolumeIndexCount = 0;	//!< Stores the number of indices in the light volume.
+	unsigned int m_EmptyVertexArrayObject = 0;	//!< Stores an empty vertex array, for the full screen triangle that builds itself.
+
+	std::shared_ptr<Shader> m_LightingShader;	//!< Stores the shader that lights the G-buffer.
+	std::shared_ptr<Shader> m_SunShader;	//!< Stores the shader that lights the G-buffer with the sun.
+
+	void CreateTargets();
+	void DeleteTargets();
+	void CreateLightVolume();
+	void BindTargets();
+	void UnbindTargets();
+
+public:
+	/*!
+		\brief Constructor.
+		\param p_Width the width of the G-buffer.
+		\param p_Height the height of the G-buffer.
+	*/
+	DeferredRenderer(int p_Width, int p_Height);
+	~DeferredRenderer();
+
+	/*!
+		\brief Recreates the G-buffer's targets, if the size has changed.
+		\param p_Width the new width.
+		\param p_Height the new height.
+	*/
+	void Resize(int p_Width, int p_Height);
+
+	/*!
+		\brief Binds and clears the G-buffer, ready for the geometry pass.
+	*/
+	void BeginGeometryPass();
+	/*!
+		\brief Copies the G-buffer's depth into the target, binds it, and clears its colour, ready for the lights to be added.
+		\param p_FrameBufferObject the framebuffer the lighting is accumulated in, with a depth and stencil buffer the same size.
+	*/
+	void EndGeometryPass(unsigned int p_FrameBufferObject);
+	/*!
+		\brief Adds each light's contribution, from the lights bound at ShaderStorageBinding::LIGHTS.
+		\param p_LightCount the number of lights in the buffer.
+	*/
+	void RenderLights(unsigned int p_LightCount);
+	/*!
+		\brief Adds the sun's contribution, with the frame data's sun and the shadow maps bound by the caller.
+	*/
+	void RenderSun();
+
+	int GetWidth() const {
+		return m_Width;
+	}
+	int GetHeight() const {
+		return m_Height;
+	}
+
+	// Delete the copy and assignment operators.
+	DeferredRenderer(DeferredRenderer const&) = delete; //!< Copy operator, deleted.
+	DeferredRenderer& operator=(DeferredRenderer const&) = delete; //!< Assignment operator, deleted.
+};
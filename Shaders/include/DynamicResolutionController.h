@@ -0,0 +1,68 @@
+/**
+@file DynamicResolutionController.h
+@brief Picks the scale the scene is rendered at, from the measured GPU frame time, to keep it within a budget.
+*/
+#pragma once
+
+/*! \class DynamicResolutionController
+	\brief Lowers the render scale when the GPU frame time goes over budget, and raises it again when there's room.
+
+	The frame's cost is taken to grow with the number of pixels, the square of the scale, so the scale that fits the
+	budget is found from the square root of the ratio of the two. The scale only moves in fixed steps, so small
+	changes in the frame time don't reallocate the targets, and only rises one step at a time, so it doesn't
+	overshoot and fall straight back. After every change the results are ignored until the GPU profiler's latency has
+	passed, as they still measure the old scale.
+*/
+class DynamicResolutionController {
+private:
+	static const float s_m_MinScale;	//!< The smallest scale, half the output's width and height.
+	static const float s_m_MaxScale;	//!< The largest scale, the output's size.
+	static const float s_m_ScaleStep;	//!< The size of the steps the scale moves in.
+	static const float s_m_TargetUsage;	//!< The fraction of the budget a change aims for, leaving headroom for spikes.
+	static const float s_m_LowerUsage;	//!< The fraction of the budget below which the scale rises.
+	static const float s_m_UpperUsage;	//!< The fraction of the budget above which the scale falls.
+	static const float s_m_SmoothingWeight;	//!< How much a new frame time contributes to the smoothed frame time.
+	static const unsigned int s_m_LatencyFrameCount = 4;	//!< The number of frames after a change whose results still measure the old scale.
+	static const unsigned int s_m_SampleFrameCount = 4;	//!< The number of frames measured before deciding on a change.
+
+	float m_BudgetMilliseconds;	//!< Stores the GPU time a frame should take.
+	float m_Scale = 1.0f;	//!< Stores the current scale.
+	float m_SmoothedMilliseconds = 0.0f;	//!< Stores the smoothed frame time, measured since the results caught up with the last change.
+	unsigned int m_FramesSinceChange = 0;	//!< Stores the number of frames since the scale last changed.
+	unsigned int m_ChangeCount = 0;	//!< Stores the number of times the scale has changed.
+
+public:
+	/*!
+		\brief Creates the controller, starting at full scale.
+		\param p_BudgetMilliseconds the GPU time a frame should take.
+	*/
+	DynamicResolutionController(float p_BudgetMilliseconds = 16.6f);
+
+	/*!
+		\brief Measures a frame, and changes the scale if it's been over, or well under, the budget.
+		\param p_GPUMilliseconds the frame's GPU time, or 0 if there's no result this frame.
+		\return Returns the scale to render the next frame at.
+	*/
+	float Update(float p_GPUMilliseconds);
+	/*!
+		\brief Goes back to full scale, and forgets the frame times measured so far.
+	*/
+	void Reset();
+
+	void SetBudget(float p_BudgetMilliseconds) {
+		m_BudgetMilliseconds = p_BudgetMilliseconds;
+	}
+	float GetBudget() const {
+		return m_BudgetMilliseconds;
+	}
+	float GetScale() const {
+		return m_Scale;
+	}
+	unsigned int GetChangeCount() const {
+		return m_ChangeCount;
+	}
+
+	// Delete the copy and assignment operators.
+	DynamicResolutionController(DynamicResolutionController const&) = delete; //!< Copy operator, deleted.
+	DynamicResolutionController& operator=(DynamicResolutionController const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,208 @@
+/**
+@file EntityManager.h
+@brief Stores entities' components in chunks, grouped by the set of components each entity has (its archetype).
+*/
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Components.h"
+
+using ComponentMask = std::bitset<static_cast<size_t>(ComponentType::COUNT)>;
+
+/*! \class EntityChunk
+	\brief A fixed size block of memory, holding an array of each of its archetype's components, for up to a set number of entities.
+*/
+
+class EntityChunk {
+private:
+	friend class EntityManager;
+
+	ComponentMask m_Mask;	//!< Stores which components the chunk has.
+	std::unique_ptr<unsigned char[]> m_Data;	//!< Stores the component arrays, one after another.
+	const size_t *m_ColumnOffsets;	//!< Stores where each component's array starts in the data, owned by the archetype.
+	std::unique_ptr<Entity[]> m_Entities;	//!< Stores the entity in each row.
+	unsigned int m_Count = 0;	//!< Stores the number of rows in use.
+
+	void *GetComponentData(size_t p_Type, unsigned int p_Row) {
+		return m_Data.get() + m_ColumnOffsets[p_Type] + s_ComponentSizes[p_Type] * p_Row;
+	}
+
+public:
+	/*!
+		\brief Gets the chunk's array of a component, the archetype must have the component.
+		\return Returns the first element of the array, the array's length is GetCount().
+	*/
+	template<typename Component>
+	Component *Get() {
+		return reinterpret_cast<Component*>(m_Data.get() + m_ColumnOffsets[static_cast<size_t>(Component::s_Type)]);
+	}
+	template<typename Component>
+	const Component *Get() const {
+		return reinterpret_cast<const Component*>(m_Data.get() + m_ColumnOffsets[static_cast<size_t>(Component::s_Type)]);
+	}
+
+	template<typename Component>
+	bool Has() const {
+		return m_Mask.test(static_cast<size_t>(Component::s_Type));
+	}
+	const Entity *GetEntities() const {
+		return m_Entities.get();
+	}
+	unsigned int GetCount() const {
+		return m_Count;
+	}
+};
+
+/*! \class EntityManager
+	\brief Creates and destroys entities, and finds the chunks holding a set of components, for systems to iterate over.
+*/
+
+class EntityManager {
+private:
+	/**
+		* Every entity with the same set of components. Each chunk is full, except the last.
+	*/
+	struct Archetype {
+		ComponentMask m_Mask;	//!< Stores which components the archetype has.
+		std::array<size_t, static_cast<size_t>(ComponentType::COUNT)> m_ColumnOffsets;	//!< Stores where each component's array starts in a chunk.
+		size_t m_ChunkDataSize = 0;	//!< Stores the size of a chunk's data.
+		unsigned int m_ChunkCapacity = 0;	//!< Stores the number of entities a chunk holds.
+		std::vector<std::unique_ptr<EntityChunk>> m_Chunks;	//!< Stores the archetype's chunks.
+	};
+
+	/**
+		* Where an entity's components are stored.
+	*/
+	struct EntityRecord {
+		Archetype *m_Archetype = nullptr;	//!< Stores the entity's archetype, null if the record is free.
+		unsigned int m_Chunk = 0;	//!< Stores the index of the chunk, in the archetype.
+		unsigned int m_Row = 0;	//!< Stores the row, in the chunk.
+		unsigned int m_Generation = 0;	//!< Stores the generation, incremented when the entity is destroyed.
+	};
+
+	static const size_t s_m_ChunkSize = 64 * 1024;	//!< The target size of a chunk, in bytes.
+	static const size_t s_m_ColumnAlignment = 16;	//!< The alignment of each component array.
+
+	std::vector<std::unique_ptr<Archetype>> m_Archetypes;	//!< Stores every archetype.
+	std::vector<EntityRecord> m_Records;	//!< Stores every entity's record.
+	std::vector<unsigned int> m_FreeRecords;	//!< Stores the indices of records that can be reused.
+	size_t m_EntityCount = 0;	//!< Stores the number of entities alive.
+
+	/*!
+		\brief Finds the archetype with a set of components, creating it if there isn't one.
+		\param p_Mask the set of components.
+		\return Returns the archetype.
+	*/
+	Archetype *GetArchetype(const ComponentMask &p_Mask);
+	/*!
+		\brief Gets a row for a new entity, at the end of an archetype's last chunk, adding a chunk if it's full.
+		\param p_Archetype the archetype.
+		\param p_Entity the entity to store in the row.
+		\return Returns the entity's record.
+	*/
+	EntityRecord &AllocateRow(Archetype &p_Archetype, Entity p_Entity);
+
+	template<typename Component>
+	void WriteComponent(EntityChunk &p_Chunk, unsigned int p_Row, const Component &p_Component) {
+		std::memcpy(p_Chunk.GetComponentData(static_cast<size_t>(Component::s_Type), p_Row), &p_Component, sizeof(Component));
+	}
+
+public:
+	EntityManager() = default;
+	EntityManager(const EntityManager&) = delete;
+	EntityManager &operator=(const EntityManager&) = delete;
+
+	/*!
+		\brief Gets the mask of a set of components.
+	*/
+	template<typename... Components>
+	static ComponentMask MakeMask() {
+		ComponentMask mask;
+		int expand[] = { 0, (mask.set(static_cast<size_t>(Components::s_Type)), 0)... };
+		(void)expand;
+		return mask;
+	}
+
+	/*!
+		\brief Creates an entity, with a copy of each of the components given.
+		\param p_Components the entity's components, one of each type at most.
+		\return Returns the entity's handle.
+	*/
+	template<typename... Components>
+	Entity CreateEntity(const Components &... p_Components) {
+		ComponentMask mask = MakeMask<Components...>();
+		assert(mask.count() == sizeof...(Components) && "An entity can only have one of each component.");
+
+		Entity entity;
+		if (m_FreeRecords.empty()) {
+			entity.m_Index = static_cast<unsigned int>(m_Records.size());
+			m_Records.emplace_back();
+		}
+		else {
+			entity.m_Index = m_FreeRecords.back();
+			m_FreeRecords.pop_back();
+		}
+		entity.m_Generation = m_Records[entity.m_Index].m_Generation;
+
+		EntityRecord &record = AllocateRow(*GetArchetype(mask), entity);
+		EntityChunk &chunk = *record.m_Archetype->m_Chunks[record.m_Chunk];
+		int expand[] = { 0, (WriteComponent(chunk, record.m_Row, p_Components), 0)... };
+		(void)expand;
+
+		return entity;
+	}
+	/*!
+		\brief Destroys an entity. The last entity of its archetype is moved into the hole, to keep the chunks packed.
+		\param p_Entity the entity.
+	*/
+	void DestroyEntity(Entity p_Entity);
+	/*!
+		\brief Reserves space for a number of entities with a set of components, so creating them doesn't have to allocate chunks.
+		\param p_Count the number of entities.
+	*/
+	template<typename... Components>
+	void Reserve(size_t p_Count) {
+		Archetype *archetype = GetArchetype(MakeMask<Components...>());
+		archetype->m_Chunks.reserve((p_Count + archetype->m_ChunkCapacity - 1) / archetype->m_ChunkCapacity);
+		m_Records.reserve(m_Records.size() + p_Count);
+	}
+
+	bool IsAlive(Entity p_Entity) const {
+		return p_Entity.m_Index < m_Records.size() && m_Records[p_Entity.m_Index].m_Archetype && m_Records[p_Entity.m_Index].m_Generation == p_Entity.m_Generation;
+	}
+	/*!
+		\brief Gets one of an entity's components.
+		\return Returns the component, or null if the entity is dead or doesn't have the component.
+	*/
+	template<typename Component>
+	Component *GetComponent(Entity p_Entity) {
+		if (!IsAlive(p_Entity))
+			return nullptr;
+
+		const EntityRecord &record = m_Records[p_Entity.m_Index];
+		if (!record.m_Archetype->m_Mask.test(static_cast<size_t>(Component::s_Type)))
+			return nullptr;
+
+		return record.m_Archetype->m_Chunks[record.m_Chunk]->Get<Component>() + record.m_Row;
+	}
+
+	/*!
+		\brief Gets every chunk, of every archetype, that has at least a set of components.
+		\param p_Mask the set of components.
+		\param p_Chunks receives the chunks, it's cleared first.
+	*/
+	void GetChunks(const ComponentMask &p_Mask, std::vector<EntityChunk*> &p_Chunks) const;
+
+	size_t GetEntityCount() const {
+		return m_EntityCount;
+	}
+	size_t GetArchetypeCount() const {
+		return m_Archetypes.size();
+	}
+};
@@ -0,0 +1,202 @@
+/**
+@file EntitySystems.h
+@brief The systems that update, cull and draw entities, each a linear pass over the chunks with the components it needs, split across the job system.
+*/
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "EntityManager.h"
+
+struct Frustum;
+struct FrameLight;
+class JobSystem;
+class Model;
+class Shader;
+
+/**
+	* Everything needed to draw one visible entity, copied out of its components.
+*/
+struct DrawPacket {
+	Model *m_Model;	//!< Stores the model to draw.
+	Shader *m_Shader;	//!< Stores the shader to draw the model with.
+	glm::mat4 m_WorldMatrix;	//!< Stores the entity's world matrix.
+	glm::mat3 m_NormalMatrix;	//!< Stores the entity's normal matrix.
+	glm::vec3 m_Colour;	//!< Stores the entity's colour.
+	Entity m_Entity;	//!< Stores the entity drawn.
+	unsigned long long m_SortKey;	//!< Stores the key the draw list is sorted by: shader, then model, then distance front to back.
+};
+
+/**
+	* Everything needed to draw one entity into the shadow maps, copied out of its components.
+*/
+struct ShadowCaster {
+	Model *m_Model;	//!< Stores the model to draw.
+	glm::mat4 m_WorldMatrix;	//!< Stores the entity's world matrix.
+	glm::vec4 m_Bounds;	//!< Stores the entity's world bounding sphere, the centre then the radius.
+	bool m_IsStatic;	//!< Stores whether the caster can be drawn into the shadow caches.
+};
+
+/*! \class TransformSystem
+	\brief Recalculates the world and normal matrices, and world bounds, of entities whose transform has changed.
+
+	Transforms without a parent are updated in parallel over the chunks. A parent can be in any chunk, so those with
+	one are gathered as they're found, and updated afterwards on the calling thread, parents before children. A
+	child is recalculated every update, as its parent can move without the child's own transform changing.
+*/
+class TransformSystem {
+private:
+	/**
+		* Where a transform with a parent is, and how many parents are above it.
+	*/
+	struct ChildTransform {
+		EntityChunk *m_Chunk;	//!< Stores the chunk the transform is in.
+		unsigned int m_Row;	//!< Stores the transform's row in the chunk.
+		unsigned int m_Depth;	//!< Stores the number of parents above the transform.
+	};
+
+	std::vector<EntityChunk*> m_Chunks;	//!< Stores the chunks being updated, kept to avoid allocating every frame.
+	std::vector<ChildTransform> m_Children;	//!< Stores the transforms with a parent, kept to avoid allocating every frame.
+	std::mutex m_ChildrenMutex;	//!< Stores the mutex the jobs take to add the children they find.
+
+	/*!
+		\brief Calculates a transform's matrices, relative to its parent.
+		\param p_Transform the transform.
+		\param p_NormalMatrix set to the normal matrix.
+		\return Returns the matrix.
+	*/
+	static glm::mat4 CalculateLocalMatrix(const TransformComponent &p_Transform, glm::mat3 &p_NormalMatrix);
+	/*!
+		\brief Updates the transforms with a parent, from their parents' world matrices.
+		\param p_Entities the entities.
+		\return Returns the number of world matrices that changed.
+	*/
+	size_t UpdateChildren(EntityManager &p_Entities);
+
+public:
+	/*!
+		\brief Updates every dirty transform, in parallel over the chunks, and every transform with a parent.
+		\param p_JobSystem the job system to split the chunks across.
+		\param p_Entities the entities.
+		\return Returns the number of transforms recalculated.
+	*/
+	size_t Update(JobSystem &p_JobSystem, EntityManager &p_Entities);
+};
+
+/*! \class CullingSystem
+	\brief Marks whether each entity's bounding sphere is inside the view frustum.
+*/
+class CullingSystem {
+private:
+	std::vector<EntityChunk*> m_Chunks;	//!< Stores the chunks being culled, kept to avoid allocating every frame.
+
+public:
+	/*!
+		\brief Tests every entity's bounds against the frustum, in parallel over the chunks.
+		\param p_JobSystem the job system to split the chunks across.
+		\param p_Entities the entities.
+		\param p_Frustum the view frustum.
+		\return Returns the number of visible entities.
+	*/
+	size_t Update(JobSystem &p_JobSystem, EntityManager &p_Entities, const Frustum &p_Frustum);
+};
+
+/*! \class DrawPacketSystem
+	\brief Emits a draw packet for each visible renderable entity, and sorts them into the order they should be drawn.
+*/
+class DrawPacketSystem {
+private:
+	/**
+		* A packet's sort key, and where the packet is, so sorting doesn't move the packets themselves.
+	*/
+	struct DrawKey {
+		unsigned long long m_SortKey;	//!< Stores the packet's sort key.
+		unsigned int m_Index;	//!< Stores the packet's index.
+	};
+
+	std::vector<EntityChunk*> m_Chunks;	//!< Stores the chunks being drawn, kept to avoid allocating every frame.
+	std::vector<size_t> m_ChunkOffsets;	//!< Stores where each chunk's packets start, in the draw list.
+	std::vector<DrawKey> m_DrawKeys;	//!< Stores the keys being sorted, kept to avoid allocating every frame.
+
+	static unsigned long long MakeSortKey(const DrawPacket &p_DrawPacket, float p_Distance);
+
+public:
+	/*!
+		\brief Fills the draw list, in parallel over the chunks. Entities without bounds are always visible, and without a colour are white.
+		\param p_JobSystem the job system to split the chunks across.
+		\param p_Entities the entities.
+		\param p_ViewPosition the camera's position, used to sort the packets front to back.
+		\param p_DrawPackets receives the draw list, it's resized to fit.
+	*/
+	void Update(JobSystem &p_JobSystem, EntityManager &p_Entities, const glm::vec3 &p_ViewPosition, std::vector<DrawPacket> &p_DrawPackets);
+	/*!
+		\brief Sorts the draw list by key, to group packets sharing a shader and model, then front to back within each group.
+		\param p_DrawPackets the draw list.
+		\param p_DrawOrder receives the indices of the packets, in the order they should be drawn.
+	*/
+	void Sort(const std::vector<DrawPacket> &p_DrawPackets, std::vector<unsigned int> &p_DrawOrder);
+};
+
+/*! \class ShadowCasterSystem
+	\brief Gathers every shadow caster, whether or not it's visible, and finds how deep the visible receivers go.
+*/
+class ShadowCasterSystem {
+private:
+	std::vector<EntityChunk*> m_Chunks;	//!< Stores the chunks being gathered, kept to avoid allocating every frame.
+
+public:
+	/*!
+		\brief Fills the caster list, and lists where each static caster that moved was, and now is, so the caches it touched can be redrawn.
+		\param p_Entities the entities.
+		\param p_Casters receives the shadow casters.
+		\param p_MovedStaticBounds receives the old and new world bounding spheres of the static casters that moved.
+		\return Returns the number of casters.
+	*/
+	size_t Update(EntityManager &p_Entities, std::vector<ShadowCaster> &p_Casters, std::vector<glm::vec4> &p_MovedStaticBounds);
+
+	/*!
+		\brief Finds the furthest any visible object reaches from the camera, which is as far as the shadows need to go.
+		\param p_Entities the entities, already culled.
+		\param p_ViewMatrix the camera's view matrix.
+		\return Returns the view depth.
+	*/
+	float CalculateReceiverDepth(EntityManager &p_Entities, const glm::mat4 &p_ViewMatrix);
+};
+
+/*! \class LightSystem
+	\brief Gathers the point lights whose range is inside the view frustum.
+*/
+class LightSystem {
+public:
+	static const float s_m_MaxRadius;	//!< The furthest any light reaches, well past the far clipping plane, so a light that never fades still has a finite volume.
+
+private:
+	std::vector<EntityChunk*> m_Chunks;	//!< Stores the chunks being gathered, kept to avoid allocating every frame.
+
+public:
+	/*!
+		\brief Fills the light list, with each light's range worked out from its colour and attenuation.
+		\param p_Entities the entities.
+		\param p_Frustum the view frustum.
+		\param p_Lights receives the visible lights.
+		\return Returns the number of visible lights.
+	*/
+	size_t Update(EntityManager &p_Entities, const Frustum &p_Frustum, std::vector<FrameLight> &p_Lights);
+
+	/*!
+		\brief Works out how far a light reaches, before its brightest channel falls below 1/256.
+		\param p_Colour the light's colour.
+		\param p_Attenuation the constant, linear and quadratic attenuation.
+		\return Returns the distance, beyond which the light can be ignored, capped at s_m_MaxRadius.
+	*/
+	static float CalculateRadius(const glm::vec3 &p_Colour, const glm::vec3 &p_Attenuation);
+	/*!
+		\brief Works out an attenuation that fades a white light out at a given distance.
+		\param p_Radius the distance the light should reach.
+		\return Returns the constant, linear and quadratic attenuation.
+	*/
+	static glm::vec3 CalculateAttenuation(float p_Radius);
+};
@@ -0,0 +1,149 @@
+/**
+@file EnvironmentBaker.h
+@brief Bakes the sky into the maps the image based ambient lighting reads, on the CPU, and caches them on disk.
+*/
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class JobSystem;
+
+/**
+	* A cube map's texels on the CPU, the faces in the GL's order, each a row at a time.
+*/
+struct CubeMapImage {
+	int m_Size = 0;	//!< Stores each face's width and height.
+	std::vector<glm::vec3> m_Texels;	//!< Stores the texels, six faces of size by size.
+
+	glm::vec3 &At(int p_Face, int p_X, int p_Y) {
+		return m_Texels[(static_cast<size_t>(p_Face) * m_Size + p_Y) * m_Size + p_X];
+	}
+	const glm::vec3 &At(int p_Face, int p_X, int p_Y) const {
+		return m_Texels[(static_cast<size_t>(p_Face) * m_Size + p_Y) * m_Size + p_X];
+	}
+};
+
+/*! \class EnvironmentBaker
+	\brief Works out the sky's diffuse irradiance, as spherical harmonics, and its reflections prefiltered for each shininess.
+
+	The sky is box filtered down to a small source first, whose texels each stand for the solid angle they cover. The
+	irradiance is the source projected onto the first nine spherical harmonics, convolved with the cosine lobe. Each
+	of the prefiltered map's levels below the first is the source convolved with a Phong lobe, the exponent quartering
+	with each level, so the level a surface reads follows from its specular exponent. The exponents being powers of four
+	lets each texel's weight be found by squaring its cosine, four source texels at a time with SSE, and the output
+	texels are split across the job system's threads. The first level is the sky itself, for mirror-like surfaces.
+
+	A bake is slow enough to notice at start up, so it's written to a cache on disk, keyed by the sky's files,
+	and only redone when they change.
+*/
+class EnvironmentBaker {
+public:
+	static const int s_m_PrefilteredSize = 128;	//!< The width and height of the prefiltered map's first level.
+	static const int s_m_PrefilteredLevelCount = 6;	//!< The number of levels in the prefiltered map, down to 4x4.
+	static const int s_m_IrradianceSize = 16;	//!< The width and height of the irradiance map, which is very smooth.
+
+private:
+	static const int s_m_SourceSize = 32;	//!< The width and height the sky is filtered down to, before it's convolved.
+	static const unsigned int s_m_CacheMagic = 0x314C4249;	//!< The cache's first four bytes, "IBL1".
+	static const unsigned int s_m_CacheVersion = 1;	//!< Changed whenever the bake's results would change, so old caches are ignored.
+
+	std::array<glm::vec3, 9> m_IrradianceCoefficients;	//!< Stores the irradiance's spherical harmonic coefficients, over pi.
+	std::vector<CubeMapImage> m_PrefilteredLevels;	//!< Stores the prefiltered map's levels, from the largest.
+	bool m_WasCached = false;	//!< Stores whether the last bake was read from the cache.
+	float m_BakeMilliseconds = 0.0f;	//!< Stores how long the last bake, or cache read, took.
+
+	/*!
+		\brief Projects the source onto the spherical harmonics, and convolves it into irradiance.
+		\param p_Source the filtered down sky.
+	*/
+	void ProjectIrradiance(const CubeMapImage &p_Source);
+	/*!
+		\brief Convolves the source with each level's Phong lobe.
+		\param p_JobSystem the job system the texels are split across.
+		\param p_Source the filtered down sky.
+	*/
+	void Prefilter(JobSystem &p_JobSystem, const CubeMapImage &p_Source);
+	/*!
+		\brief Reads a bake from the cache, if it was made from the same files by the same version.
+		\param p_CachePath the cache's path.
+		\param p_Key the key of the sky's files.
+		\return Returns whether the cache was read.
+	*/
+	bool ReadCache(const std::string &p_CachePath, unsigned long long p_Key);
+	/*!
+		\brief Writes the bake to the cache.
+		\param p_CachePath the cache's path.
+		\param p_Key the key of the sky's files.
+	*/
+	void WriteCache(const std::string &p_CachePath, unsigned long long p_Key) const;
+
+public:
+	EnvironmentBaker() = default;
+
+	/*!
+		\brief Works out the key a sky's files are cached by, from their paths, sizes and modification times.
+		\param p_FacePaths the paths of the six faces.
+		\return Returns the key.
+	*/
+	static unsigned long long GetCacheKey(const std::vector<std::string> &p_FacePaths);
+	/*!
+		\brief Reads the bake from the cache, without loading the sky.
+		\param p_CachePath the cache's path.
+		\param p_Key the key of the sky's files.
+		\return Returns whether the cache matched, and was read.
+	*/
+	bool Load(const std::string &p_CachePath, unsigned long long p_Key);
+	/*!
+		\brief Bakes the sky, and writes the cache.
+		\param p_JobSystem the job system the convolution is split across.
+		\param p_Sky the sky, each face at least the prefiltered map's size.
+		\param p_CachePath the cache's path, or empty to not write one.
+		\param p_Key the key of the sky's files.
+	*/
+	void Bake(JobSystem &p_JobSystem, const CubeMapImage &p_Sky, const std::string &p_CachePath, unsigned long long p_Key);
+
+	/*!
+		\brief Evaluates the irradiance in every direction of a cube map, for the shaders to look up.
+		\param p_Size the width and height of each face.
+		\return Returns the cube map, the irradiance over pi, the light a white diffuse surface reflects.
+	*/
+	CubeMapImage EvaluateIrradiance(int p_Size) const;
+
+	/*!
+		\brief Box filters a cube map down, or point samples it up.
+		\param p_Image the cube map.
+		\param p_Size the new width and height of each face.
+		\return Returns the resized cube map.
+	*/
+	static CubeMapImage Resize(const CubeMapImage &p_Image, int p_Size);
+	/*!
+		\brief Works out the direction through a texel's centre, the way the GL samples cube maps.
+		\param p_Face the face, in the GL's order.
+		\param p_X the texel's column.
+		\param p_Y the texel's row.
+		\param p_Size the width and height of each face.
+		\return Returns the unit direction.
+	*/
+	static glm::vec3 GetTexelDirection(int p_Face, int p_X, int p_Y, int p_Size);
+
+	const std::array<glm::vec3, 9> &GetIrradianceCoefficients() const {
+		return m_IrradianceCoefficients;
+	}
+	const std::vector<CubeMapImage> &GetPrefilteredLevels() const {
+		return m_PrefilteredLevels;
+	}
+	bool WasCached() const {
+		return m_WasCached;
+	}
+	float GetBakeMilliseconds() const {
+		return m_BakeMilliseconds;
+	}
+
+	// Delete the copy and assignment operators.
+	EnvironmentBaker(EnvironmentBaker const&) = delete; //!< Copy operator, deleted.
+	EnvironmentBaker& operator=(EnvironmentBaker const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,131 @@
+/**
+@file FrameCapture.h
+@brief Reads finished frames back through a ring of pixel buffer objects, and writes them to disk on a background thread.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+	* How captured frames are written.
+*/
+enum class CaptureFormat {
+	PNG_SEQUENCE = 0,	//!< One PNG file per frame, in a folder.
+	RAW_VIDEO	//!< Every frame appended to one file of raw RGB24, top row first, for ffmpeg to encode.
+};
+
+/*! \class FrameCapture
+	\brief Captures every frame without stalling the pipeline on glReadPixels.
+
+	Each frame is read into the next pixel buffer object of a ring, and fenced. The copy into client memory happens
+	when the ring comes back round to that buffer, by which time the GPU has almost always finished with it, so
+	mapping it doesn't wait. Encoding and writing happen on a background thread. If the writer falls too far behind,
+	the render thread waits for it rather than dropping frames, as every frame of an offline render matters.
+*/
+class FrameCapture {
+private:
+	/**
+		* A frame read back into client memory, waiting to be written.
+	*/
+	struct CapturedFrame {
+		unsigned long long m_FrameIndex = 0;	//!< Stores the number of the frame.
+		std::vector<unsigned char> m_Pixels;	//!< Stores the RGBA pixels, bottom row first as OpenGL reads them.
+	};
+
+	/**
+		* A pixel buffer object in the ring, and the frame it holds.
+	*/
+	struct ReadbackSlot {
+		unsigned int m_PixelBufferObject = 0;	//!< Stores the ID of the pixel buffer object.
+		GLsync m_Fence = nullptr;	//!< Stores the fence signalled when the read has finished, or nullptr when the slot is free.
+		unsigned long long m_FrameIndex = 0;	//!< Stores the number of the frame the slot holds.
+	};
+
+	static const size_t s_m_MaxQueuedFrames = 8;	//!< The number of frames that can wait for the writer, before the render thread has to.
+
+	int m_Width;	//!< Stores the width of the captured frames.
+	int m_Height;	//!< Stores the height of the captured frames.
+	CaptureFormat m_Format;	//!< Stores how the frames are written.
+	std::string m_OutputPath;	//!< Stores the folder of a PNG sequence, or the file of a raw video.
+
+	std::vector<ReadbackSlot> m_Slots;	//!< Stores the ring of pixel buffer objects.
+	size_t m_CurrentSlot = 0;	//!< Stores the slot the next frame is read into.
+
+	std::thread m_WriterThread;	//!< Stores the thread that encodes and writes the frames.
+	std::mutex m_QueueMutex;	//!< Guards the queues, and the writer's state.
+	std::condition_variable m_QueueCondition;	//!< Wakes the writer when a frame is queued, and the render thread when one is written.
+	std::deque<CapturedFrame> m_QueuedFrames;	//!< Stores the frames waiting to be written.
+	std::vector<std::vector<unsigned char>> m_FreePixelBuffers;	//!< Stores written frames' memory, for reuse.
+	bool m_IsWriterRunning = true;	//!< Stores whether the writer should keep waiting for frames.
+	bool m_HasWriteFailed = false;	//!< Stores whether a frame couldn't be written.
+
+	unsigned int m_CapturedFrameCount = 0;	//!< Stores the number of frames read back.
+	unsigned int m_WrittenFrameCount = 0;	//!< Stores the number of frames written.
+	unsigned int m_SkippedFrameCount = 0;	//!< Stores the number of frames that didn't match the capture's size.
+	unsigned int m_ReadbackStallCount = 0;	//!< Stores how often mapping a buffer had to wait for the GPU.
+	double m_WriterWaitMilliseconds = 0.0;	//!< Stores how long the render thread has waited for the writer.
+
+	/*!
+		\brief Copies a slot's frame into client memory, and hands it to the writer.
+		\param p_Slot the slot, which must hold a frame.
+	*/
+	void ResolveSlot(ReadbackSlot &p_Slot);
+	void WriterLoop();
+	/*!
+		\brief Encodes and writes a frame, on the writer thread.
+		\param p_Frame the frame.
+		\param p_RawVideoFile the raw video file, which is only open when writing one.
+		\return Returns true if successful, false otherwise.
+	*/
+	bool WriteFrame(const CapturedFrame &p_Frame, std::ofstream &p_RawVideoFile) const;
+
+public:
+	/*!
+		\brief Constructor, must be called on the thread that owns the OpenGL context.
+		\param p_Width the width of the frames.
+		\param p_Height the height of the frames.
+		\param p_Format how the frames are written.
+		\param p_OutputPath the folder of a PNG sequence, which is created if needed, or the file of a raw video.
+		\param p_RingSize the number of frames read back before the oldest is mapped.
+	*/
+	FrameCapture(int p_Width, int p_Height, CaptureFormat p_Format, const std::string &p_OutputPath, unsigned int p_RingSize = 3);
+	/*!
+		\brief Destructor, finishes writing every frame read back, must be called on the thread that owns the OpenGL context.
+	*/
+	~FrameCapture();
+
+	/*!
+		\brief Reads the frame from a framebuffer, and writes out whichever frame last used the slot.
+		\param p_FrameBufferObject the framebuffer the finished frame is in, zero for the window's.
+		\param p_Width the width of the frame.
+		\param p_Height the height of the frame.
+		\param p_FrameIndex the number of the frame, used to name the files.
+	*/
+	void Capture(unsigned int p_FrameBufferObject, int p_Width, int p_Height, unsigned long long p_FrameIndex);
+	/*!
+		\brief Reads back every frame still in the ring, waiting for the GPU if need be.
+	*/
+	void Flush();
+
+	unsigned int GetCapturedFrameCount() const {
+		return m_CapturedFrameCount;
+	}
+	unsigned int GetReadbackStallCount() const {
+		return m_ReadbackStallCount;
+	}
+	double GetWriterWaitMilliseconds() const {
+		return m_WriterWaitMilliseconds;
+	}
+
+	// Delete the copy and assignment operators.
+	FrameCapture(FrameCapture const&) = delete; //!< Copy operator, deleted.
+	FrameCapture& operator=(FrameCapture const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,174 @@
+/**
+@file FramePacket.h
+@brief Everything the render thread needs to draw a frame, and the double buffer the simulation hands it over with.
+*/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "EntitySystems.h"
+
+/**
+	* How the scene's edges are anti-aliased.
+*/
+enum class AntiAliasingMode {
+	NONE = 0,	//!< Not anti-aliased.
+	MSAA,	//!< Rendered with several samples per pixel, and resolved before the post-processing.
+	FXAA,	//!< Smoothed in one post-processing pass, from the luma.
+	SMAA,	//!< Smoothed in three post-processing passes, from the lines the edges came from.
+	COUNT	//!< The number of modes.
+};
+
+/*!
+	\brief Names an anti-aliasing mode, for the reports.
+	\param p_Mode the mode.
+	\return Returns the name.
+*/
+inline const char *GetAntiAliasingModeName(AntiAliasingMode p_Mode) {
+	static const char *s_Names[] = { "None", "MSAA", "FXAA", "SMAA" };
+	return p_Mode < AntiAliasingMode::COUNT ? s_Names[static_cast<int>(p_Mode)] : "Unknown";
+}
+
+/**
+	* The rendering options the user can toggle.
+*/
+struct RenderSettings {
+	bool m_UseBlinnPhong = true;	//!< Stores whether to use Blinn-Phong, rather than Phong, specular highlights.
+	bool m_UseNormalMap = true;	//!< Stores whether to use normal maps.
+	bool m_UseToonShading = true;	//!< Stores whether to use toon shading.
+	bool m_ShowNormalMap = false;	//!< Stores whether to show the normal map, instead of the lighting.
+	bool m_UseDepthPrePass = false;	//!< Stores whether to lay down depth before the colour pass.
+	bool m_UseDeferredShading = false;	//!< Stores whether to light the lit objects from a G-buffer, rather than in the colour pass.
+	bool m_UseClusteredShading = false;	//!< Stores whether the colour pass lights each pixel with every light binned into its cluster, rather than the scene's one light.
+	bool m_UseShadows = true;	//!< Stores whether the sun, and the scene's light, cast shadows.
+	bool m_UseDynamicResolution = false;	//!< Stores whether the scene's render scale follows the GPU frame time.
+	float m_FrameBudgetMilliseconds = 16.6f;	//!< Stores the GPU time a frame should take, when the render scale follows it.
+	AntiAliasingMode m_AntiAliasing = AntiAliasingMode::NONE;	//!< Stores how the scene's edges are anti-aliased.
+	bool m_ShowGPUProfiler = false;	//!< Stores whether to draw the GPU pass timings over the frame.
+	bool m_UseDistanceFieldText = false;	//!< Stores whether text is drawn from distance fields, rather than bitmaps rasterised at each size.
+	bool m_Shake = false;	//!< Stores whether the post-processing shake effect is on.
+	bool m_InvertColours = false;	//!< Stores whether the post-processing inverted colour effect is on.
+	bool m_Chaos = false;	//!< Stores whether the post-processing edge kernel effect is on.
+	bool m_UseBlur = false;	//!< Stores whether the post-processing blur effect is on.
+	bool m_UseBloom = false;	//!< Stores whether the post-processing bloom effect is on.
+	bool m_UseAutoExposure = false;	//!< Stores whether the exposure of the tonemap, which always ends the HDR chain, follows the image's luminance, rather than staying at one.
+	bool m_UseColourGrading = false;	//!< Stores whether the post-processing colour grading effect is on.
+	bool m_UseVignette = false;	//!< Stores whether the post-processing vignette effect is on.
+};
+
+/**
+	* A point light, as the render thread sees it.
+*/
+struct FrameLight {
+	glm::vec3 m_Position;	//!< Stores the light's position.
+	glm::vec3 m_Colour;	//!< Stores the light's colour.
+	glm::vec3 m_Attenuation;	//!< Stores the constant, linear and quadratic attenuation.
+	float m_Radius = 0.0f;	//!< Stores the distance beyond which the light adds nothing.
+};
+
+/**
+	* A directional light, infinitely far away.
+*/
+struct FrameDirectionalLight {
+	glm::vec3 m_Direction = glm::vec3(0.0f, -1.0f, 0.0f);	//!< Stores the direction the light shines in.
+	glm::vec3 m_Colour = glm::vec3(0.0f);	//!< Stores the light's colour.
+};
+
+/**
+	* A snapshot of one simulated frame. Once published, the render thread only reads it.
+*/
+struct FramePacket {
+	unsigned long long m_FrameIndex = 0;	//!< Stores the number of the frame.
+	float m_DeltaTime = 0.0f;	//!< Stores the time the frame simulated.
+	int m_Width = 0;	//!< Stores the window's width.
+	int m_Height = 0;	//!< Stores the window's height.
+
+	glm::mat4 m_ProjectionMatrix;	//!< Stores the camera's projection matrix.
+	glm::mat4 m_ViewMatrix;	//!< Stores the camera's view matrix.
+	glm::vec3 m_ViewPosition;	//!< Stores the camera's position.
+	FrameLight m_Light;	//!< Stores the scene's light, the one forward shading uses.
+	std::vector<FrameLight> m_Lights;	//!< Stores every light that reaches into the view frustum, for deferred and clustered shading.
+	std::vector<glm::uvec2> m_ClusterLightRanges;	//!< Stores the offset and count of each light cluster's lights, in the list of indices.
+	std::vector<unsigned int> m_ClusterLightIndices;	//!< Stores every light cluster's light indices, one cluster after another.
+	FrameDirectionalLight m_Sun;	//!< Stores the sun.
+	std::vector<ShadowCaster> m_ShadowCasters;	//!< Stores every shadow caster, visible or not.
+	std::vector<glm::vec4> m_MovedStaticCasterBounds;	//!< Stores the old and new bounds of the static casters that moved, since the last frame.
+	float m_ShadowReceiverDepth = 0.0f;	//!< Stores how far from the camera the visible objects reach.
+	RenderSettings m_Settings;	//!< Stores the rendering options.
+	std::string m_StatusMessage;	//!< Stores the message shown over the frame, or empty for none.
+	float m_StatusMessageOpacity = 0.0f;	//!< Stores how opaque the message is, as it fades out.
+
+	std::vector<DrawPacket> m_DrawPackets;	//!< Stores a packet for each visible entity.
+	std::vector<unsigned int> m_DrawOrder;	//!< Stores the indices of the draw packets, in the order they should be drawn.
+
+	std::chrono::steady_clock::time_point m_InputTime;	//!< Stores when the input this frame reacts to was read, to measure latency.
+	float m_SimulationMilliseconds = 0.0f;	//!< Stores how long the simulation took to build the packet.
+};
+
+/*! \class FramePacketBuffer
+	\brief Two frame packets: the simulation fills one while the render thread draws the other.
+
+	The simulation can run at most one frame ahead, so the frame time is the slower of the two threads, rather than their sum.
+*/
+class FramePacketBuffer {
+private:
+	static const int s_m_NoPacket = -1;
+
+	std::array<FramePacket, 2> m_Packets;	//!< Stores the two packets.
+	int m_WriteIndex = 0;	//!< Stores the packet the simulation fills next.
+	int m_ReadyIndex = s_m_NoPacket;	//!< Stores the packet published, but not yet taken by the render thread.
+	int m_ReadingIndex = s_m_NoPacket;	//!< Stores the packet the render thread is drawing.
+	bool m_IsClosed = false;	//!< Stores whether the simulation has stopped publishing.
+
+	float m_ProducerWaitMilliseconds = 0.0f;	//!< Stores how long the simulation has waited on the render thread.
+	float m_ConsumerWaitMilliseconds = 0.0f;	//!< Stores how long the render thread has waited on the simulation.
+
+	std::mutex m_Mutex;	//!< Guards the indices.
+	std::condition_variable m_Condition;	//!< Signalled whenever a packet is published, taken or released.
+
+	static float MillisecondsSince(std::chrono::steady_clock::time_point p_Start);
+
+public:
+	FramePacketBuffer() = default;
+
+	/*!
+		\brief Gets the packet to fill, waiting until the render thread has finished drawing it.
+		\return Returns the packet.
+	*/
+	FramePacket &BeginWrite();
+	/*!
+		\brief Publishes the filled packet, waiting until the render thread has taken the previous one.
+	*/
+	void Publish();
+	/*!
+		\brief Takes the most recently published packet, waiting for one if needed.
+		\return Returns the packet, or null once the buffer is closed and there's nothing left to draw.
+	*/
+	const FramePacket *Acquire();
+	/*!
+		\brief Hands the packet taken by Acquire back, to be filled again.
+	*/
+	void Release();
+	/*!
+		\brief Stops the buffer, waking the render thread so it can exit.
+	*/
+	void Close();
+
+	/*!
+		\brief Gets, and resets, how long each side has waited for the other.
+		\param p_ProducerWaitMilliseconds receives the simulation's waiting time.
+		\param p_ConsumerWaitMilliseconds receives the render thread's waiting time.
+	*/
+	void TakeWaitTimes(float &p_ProducerWaitMilliseconds, float &p_ConsumerWaitMilliseconds);
+
+	// Delete the copy and assignment operators.
+	FramePacketBuffer(FramePacketBuffer const&) = delete; //!< Copy operator, deleted.
+	FramePacketBuffer& operator=(FramePacketBuffer const&) = delete; //!< Assignment operator, deleted.
+};
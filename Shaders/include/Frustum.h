@@ -0,0 +1,39 @@
+/**
+@file Frustum.h
+@brief A view frustum, used to cull objects that can't be seen.
+*/
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+/**
+	* A view frustum, made of six planes facing inwards, extracted from a view projection matrix.
+*/
+struct Frustum {
+	std::array<glm::vec4, 6> m_Planes;	//!< Stores the left, right, bottom, top, near and far planes (normal, distance).
+
+	Frustum() = default;
+	Frustum(const glm::mat4 &p_ViewProjection) {
+		// Gribb and Hartmann: each plane is the fourth row of the matrix, plus or minus one of the others.
+		glm::mat4 matrix = glm::transpose(p_ViewProjection);
+		m_Planes[0] = matrix[3] + matrix[0];
+		m_Planes[1] = matrix[3] - matrix[0];
+		m_Planes[2] = matrix[3] + matrix[1];
+		m_Planes[3] = matrix[3] - matrix[1];
+		m_Planes[4] = matrix[3] + matrix[2];
+		m_Planes[5] = matrix[3] - matrix[2];
+
+		for (auto &plane : m_Planes)
+			plane /= glm::length(glm::vec3(plane));
+	}
+
+	bool IntersectsSphere(const glm::vec3 &p_Centre, float p_Radius) const {
+		for (const auto &plane : m_Planes) {
+			if (glm::dot(glm::vec3(plane), p_Centre) + plane.w < -p_Radius)
+				return false;
+		}
+		return true;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+@file GPUProfiler.h
+@brief Times named, nested render passes on the GPU, with timestamp queries that are read back a few frames later.
+*/
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TextRenderer;
+
+/**
+	* The timings of one named pass.
+*/
+struct GPUPassTiming {
+	std::string m_Name;	//!< Stores the name of the pass.
+	unsigned int m_Depth = 0;	//!< Stores how many passes it was nested inside, when it was first seen.
+	float m_ElapsedMilliseconds = 0.0f;	//!< Stores the most recent result.
+	float m_AverageMilliseconds = 0.0f;	//!< Stores a rolling average of the results.
+	bool m_WasRecorded = false;	//!< Stores whether the pass ran in the most recent frame read back.
+};
+
+/*! \class GPUProfiler
+	\brief Times named render passes with pairs of GL_TIMESTAMP queries, which, unlike GL_TIME_ELAPSED, can nest.
+
+	Each frame's queries are kept in one slot of a ring, and read back when the slot comes round again, so the results
+	are always a few frames old but reading them never waits on the GPU. Every pass is also pushed as a KHR_debug group,
+	so it shows up by name in external tools such as RenderDoc and Nsight.
+*/
+class GPUProfiler {
+private:
+	static const unsigned int s_m_FrameRingSize = 3;	//!< Results are read back this many frames after they're issued.
+	static const float s_m_AverageWeight;	//!< How much a new sample contributes to the rolling average.
+
+	/**
+		* A pass issued in a frame, and the queries that bracket it.
+	*/
+	struct PassRecord {
+		size_t m_Pass;	//!< Stores the index of the pass's timings.
+		unsigned int m_BeginQuery;	//!< Stores the index of the query issued at the start of the pass.
+		unsigned int m_EndQuery;	//!< Stores the index of the query issued at the end of the pass.
+	};
+
+	/**
+		* The queries, and passes, of one frame in the ring.
+	*/
+	struct Frame {
+		std::vector<unsigned int> m_Queries;	//!< Stores the query object IDs, grown when a frame needs more.
+		unsigned int m_UsedQueryCount = 0;	//!< Stores the number of queries issued this frame.
+		std::vector<PassRecord> m_Passes;	//!< Stores the passes issued this frame, in the order they began.
+	};
+
+	std::array<Frame, s_m_FrameRingSize> m_Frames;	//!< Stores the ring of frames.
+	unsigned int m_CurrentFrame = 0;	//!< Stores the index of the frame being recorded.
+	std::vector<size_t> m_OpenPasses;	//!< Stores the records of the passes begun, but not yet ended.
+	bool m_IsRecording = false;	//!< Stores whether a frame has been begun, and not yet ended.
+	bool m_HasDebugGroups = false;	//!< Stores whether KHR_debug groups are available.
+	unsigned int m_DroppedFrameCount = 0;	//!< Stores the number of frames whose results weren't ready in time.
+
+	std::vector<GPUPassTiming> m_Timings;	//!< Stores the timings of every pass seen, in the order they were first seen.
+	std::unordered_map<std::string, size_t> m_TimingIndices;	//!< Stores the index of each pass's timings, by name.
+
+	/*!
+		\brief Issues a timestamp query into the current frame.
+		\return Returns the index of the query, in the current frame.
+	*/
+	unsigned int IssueTimestamp();
+	/*!
+		\brief Reads back the results of the current frame slot, if it holds a frame and its results are ready.
+	*/
+	void ReadResults();
+
+public:
+	GPUProfiler();
+	~GPUProfiler();
+
+	/*!
+		\brief Starts recording a frame, reading back the results of the frame that last used the slot.
+	*/
+	void BeginFrame();
+	/*!
+		\brief Stops recording the frame, closing any passes left open.
+	*/
+	void EndFrame();
+
+	/*!
+		\brief Starts timing a pass, nested inside any pass that's already open.
+		\param p_Name the name of the pass, passes with the same name share their timings.
+	*/
+	void BeginPass(const char *p_Name);
+	/*!
+		\brief Stops timing the most recently begun pass.
+	*/
+	void EndPass();
+
+	/*!
+		\brief Gets the timings of a pass.
+		\param p_Name the name of the pass.
+		\return Returns the timings, or nullptr if the pass hasn't been seen.
+	*/
+	const GPUPassTiming *GetPassTiming(const std::string &p_Name) const;
+	const std::vector<GPUPassTiming> &GetPassTimings() const {
+		return m_Timings;
+	}
+	unsigned int GetDroppedFrameCount() const {
+		return m_DroppedFrameCount;
+	}
+
+	/*!
+		\brief Draws the average time of each outermost pass, and the passes directly inside them, as bars over the current framebuffer.
+		\param p_Width the width of the framebuffer.
+		\param p_Height the height of the framebuffer.
+		\param p_BudgetMilliseconds the frame time the full width of the bars stands for.
+		\param p_TextRenderer the text renderer to label the bars with, under them, or null for no labels.
+	*/
+	void RenderOverlay(int p_Width, int p_Height, float p_BudgetMilliseconds = 16.6f, TextRenderer *p_TextRenderer = nullptr) const;
+
+	// Delete the copy and assignment operators.
+	GPUProfiler(GPUProfiler const&) = delete; //!< Copy operator, deleted.
+	GPUProfiler& operator=(GPUProfiler const&) = delete; //!< Assignment operator, deleted.
+};
+
+/*! \class GPUProfileScope
+	\brief Times a pass for as long as it's in scope.
+*/
+class GPUProfileScope {
+private:
+	GPUProfiler &m_Profiler;	//!< Stores the profiler the pass is timed by.
+
+public:
+	GPUProfileScope(GPUProfiler &p_Profiler, const char *p_Name) : m_Profiler(p_Profiler) {
+		m_Profiler.BeginPass(p_Name);
+	}
+	~GPUProfileScope() {
+		m_Profiler.EndPass();
+	}
+
+	// Delete the copy and assignment operators.
+	GPUProfileScope(GPUProfileScope const&) = delete; //!< Copy operator, deleted.
+	GPUProfileScope& operator=(GPUProfileScope const&) = delete; //!< Assignment operator, deleted.
+};
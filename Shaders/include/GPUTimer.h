@@ -0,0 +1,52 @@
+/**
+@file GPUTimer.h
+@brief Measures how long the GPU spends on a block of commands, using timer queries.
+*/
+#pragma once
+
+#include <array>
+
+/*! \class GPUTimer
+	\brief Measures GPU time with a ring of GL_TIME_ELAPSED queries, so reading a result never waits on the GPU.
+*/
+class GPUTimer {
+private:
+	static const unsigned int s_m_QueryRingSize = 3;	//!< Results are read back this many frames after they're issued.
+	static const float s_m_AverageWeight;	//!< How much a new sample contributes to the rolling average.
+
+	std::array<unsigned int, s_m_QueryRingSize> m_Queries;	//!< Stores the query object IDs.
+	std::array<bool, s_m_QueryRingSize> m_QueryIssued;	//!< Stores whether a query in the ring holds a pending result.
+	unsigned int m_CurrentQuery = 0;	//!< Stores the index of the query used by the next Begin/End pair.
+
+	float m_ElapsedMilliseconds = 0.0f;	//!< Stores the most recent result.
+	float m_AverageMilliseconds = 0.0f;	//!< Stores a rolling average of the results.
+
+	/*!
+		\brief Reads the result of the current query, if it has one available.
+	*/
+	void ReadResult();
+
+public:
+	GPUTimer();
+	~GPUTimer();
+
+	/*!
+		\brief Starts timing the commands that follow.
+	*/
+	void Begin();
+	/*!
+		\brief Stops timing, the result becomes available a few frames later.
+	*/
+	void End();
+
+	float GetElapsedMilliseconds() const {
+		return m_ElapsedMilliseconds;
+	}
+	float GetAverageMilliseconds() const {
+		return m_AverageMilliseconds;
+	}
+
+	// Delete the copy and assignment operators.
+	GPUTimer(GPUTimer const&) = delete; //!< Copy operator, deleted.
+	GPUTimer& operator=(GPUTimer const&) = delete; //!< Assignment operator, deleted.
+};
\ No newline at end of file
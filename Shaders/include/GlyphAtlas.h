@@ -0,0 +1,154 @@
+/**
+@file GlyphAtlas.h
+@brief Rasterises a font's glyphs once each, with FreeType, and packs them into one texture.
+*/
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <glm/glm.hpp>
+
+/**
+	* Where a glyph is in the atlas, and how it's placed along a line, in the atlas's pixels.
+*/
+struct Glyph {
+	glm::vec2 m_Offset = glm::vec2(0.0f);	//!< Stores the offset from the pen, on the baseline, to the quad's top left corner, down being positive.
+	glm::vec2 m_Size = glm::vec2(0.0f);	//!< Stores the quad's size, which is zero for glyphs with nothing to draw.
+	glm::vec2 m_TextureMin = glm::vec2(0.0f);	//!< Stores the quad's top left texture coordinates.
+	glm::vec2 m_TextureMax = glm::vec2(0.0f);	//!< Stores the quad's bottom right texture coordinates.
+	float m_Advance = 0.0f;	//!< Stores how far the pen moves along the line, after the glyph.
+};
+
+/*! \class GlyphAtlas
+	\brief One texture holding every glyph drawn so far, each rasterised the first time it's asked for.
+
+	The glyphs are packed into shelves, rows as tall as the first glyph placed in them. Each glyph goes on the
+	shelf it wastes the least height on, with room left for it, or a new shelf if none has. Text is mostly glyphs
+	of a few similar heights, so the shelves fill up with little wasted space, and packing a glyph never moves any
+	that are already there.
+
+	A bitmap atlas rasterises each glyph at every size it's drawn at, so it's sharp, but each size needs its own
+	copies. A distance field atlas rasterises each glyph once, at a fixed size, storing each texel's distance to
+	the outline, which the shader thresholds at whatever size it's drawn. FreeType only rasterises coverage, so the
+	outline is rasterised at several times the size, its exact distance transform taken, and that box filtered down.
+*/
+class GlyphAtlas {
+public:
+	static const int s_m_Size = 1024;	//!< The width and height of the atlas's texture.
+	static const int s_m_DistanceFieldPixelHeight = 48;	//!< The size the distance field glyphs are rasterised at.
+	static const int s_m_DistanceFieldSpread = 6;	//!< How far, in the distance field's pixels, the distance reaches either side of the outline.
+
+private:
+	static const int s_m_DistanceFieldOversampling = 4;	//!< How many times larger the outline is rasterised, before it's filtered down.
+	static const int s_m_Padding = 1;	//!< The empty texels kept between glyphs, so filtering doesn't bleed across them.
+	static const int s_m_ShelfRounding = 4;	//!< The height new shelves are rounded up to a multiple of, so slightly taller glyphs can share them.
+
+	/**
+		* A row of the atlas, filled from the left.
+	*/
+	struct Shelf {
+		int m_Y = 0;	//!< Stores the shelf's top.
+		int m_Height = 0;	//!< Stores the shelf's height.
+		int m_UsedWidth = 0;	//!< Stores how much of the shelf's width is taken.
+	};
+
+	FT_Face m_Face;	//!< Stores the font the glyphs come from, which belongs to the caller.
+	bool m_IsDistanceField;	//!< Stores whether the atlas holds distance fields, rather than coverage.
+	unsigned int m_TextureID = 0;	//!< Stores the ID of the atlas's texture.
+	std::vector<Shelf> m_Shelves;	//!< Stores the shelves, from the top.
+	int m_NextShelfY = 0;	//!< Stores the top of the next shelf to be opened.
+	int m_UsedArea = 0;	//!< Stores the texels taken by glyphs, padding included.
+	bool m_IsFull = false;	//!< Stores whether a glyph hasn't fit, so it's only reported once.
+	std::unordered_map<unsigned long long, Glyph> m_Glyphs;	//!< Stores the glyphs rasterised so far, by size and character.
+
+	/*!
+		\brief Finds room for a glyph on a shelf, opening a new one if it has to.
+		\param p_Width the glyph's width, padding included.
+		\param p_Height the glyph's height, padding included.
+		\param p_Position set to the top left corner of the room found.
+		\return Returns whether there was room.
+	*/
+	bool Pack(int p_Width, int p_Height, glm::ivec2 &p_Position);
+	/*!
+		\brief Rasterises a glyph, packs it, and uploads it.
+		\param p_Character the character.
+		\param p_PixelHeight the size to rasterise it at.
+		\return Returns the glyph, with no quad if it didn't fit or failed to load.
+	*/
+	Glyph Rasterise(unsigned int p_Character, unsigned int p_PixelHeight);
+	/*!
+		\brief Turns an oversampled coverage bitmap into a distance field, at the atlas's size.
+		\param p_Bitmap the coverage, one byte a texel.
+		\param p_Width the bitmap's width.
+		\param p_Height the bitmap's height.
+		\param p_Pitch the bytes between the bitmap's rows.
+		\param p_FieldWidth set to the distance field's width.
+		\param p_FieldHeight set to the distance field's height.
+		\return Returns the distance field, one byte a texel, with the outline at half way.
+	*/
+	static std::vector<unsigned char> CreateDistanceField(const unsigned char *p_Bitmap, int p_Width, int p_Height, int p_Pitch, int &p_FieldWidth, int &p_FieldHeight);
+	/*!
+		\brief Finds each texel's squared distance to the nearest texel that's in the set, exactly, in linear time.
+		\param p_Distances the set's texels at zero and the rest at a large value, replaced by the squared distances.
+		\param p_Width the grid's width.
+		\param p_Height the grid's height.
+	*/
+	static void DistanceTransform(std::vector<float> &p_Distances, int p_Width, int p_Height);
+	/*!
+		\brief The one dimensional transform the two dimensional one is made of, the lower envelope of parabolas.
+		\param p_Input the squared distances along the line, so far.
+		\param p_Output set to the squared distances along the line.
+		\param p_Count the number of texels along the line.
+		\param p_Vertices scratch space for the parabolas' vertices, of the count.
+		\param p_Boundaries scratch space for the boundaries between the parabolas, of the count plus one.
+	*/
+	static void DistanceTransform(const float *p_Input, float *p_Output, int p_Count, int *p_Vertices, float *p_Boundaries);
+
+public:
+	/*!
+		\brief Creates the atlas's texture, empty.
+		\param p_Face the font, which must outlive the atlas.
+		\param p_IsDistanceField whether to store distance fields, rather than coverage.
+	*/
+	GlyphAtlas(FT_Face p_Face, bool p_IsDistanceField);
+	~GlyphAtlas();
+
+	/*!
+		\brief Gets a glyph, rasterising it the first time it's asked for.
+		\param p_Character the character.
+		\param p_PixelHeight the size it's drawn at, which the distance field ignores.
+		\return Returns the glyph, in the atlas's pixels, which GetScale turns into the size it's drawn at.
+	*/
+	const Glyph &GetGlyph(unsigned int p_Character, unsigned int p_PixelHeight);
+	/*!
+		\brief Works out how much the glyphs are scaled by, to be drawn at a size.
+		\param p_PixelHeight the size they're drawn at.
+		\return Returns the scale.
+	*/
+	float GetScale(unsigned int p_PixelHeight) const;
+
+	unsigned int GetTextureID() const {
+		return m_TextureID;
+	}
+	bool IsDistanceField() const {
+		return m_IsDistanceField;
+	}
+	size_t GetGlyphCount() const {
+		return m_Glyphs.size();
+	}
+	// The fraction of the atlas the glyphs take up, which is less than the shelves do.
+	float GetOccupancy() const {
+		return static_cast<float>(m_UsedArea) / static_cast<float>(s_m_Size * s_m_Size);
+	}
+	size_t GetShelfCount() const {
+		return m_Shelves.size();
+	}
+
+	// Delete the copy and assignment operators.
+	GlyphAtlas(GlyphAtlas const&) = delete; //!< Copy operator, deleted.
+	GlyphAtlas& operator=(GlyphAtlas const&) = delete; //!< Assignment operator, deleted.
+};
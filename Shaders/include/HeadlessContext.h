@@ -0,0 +1,130 @@
+/**
+@file HeadlessContext.h
+@brief An OpenGL 4.3 core context without a window, created through EGL, so the renderer can run without a display.
+*/
+#pragma once
+
+#include <glad/glad.h>
+
+/*! \class HeadlessContext
+	\brief An OpenGL 4.3 core context without a window, created through EGL.
+
+	EGL is loaded at runtime, so the renderer doesn't need it to start with a window. A pbuffer surface is used
+	when the driver offers one, otherwise the context is made current without a surface and renders into a
+	framebuffer object of its own. If the hardware driver can't create a context, Mesa's llvmpipe software
+	rasteriser is tried instead.
+*/
+class HeadlessContext {
+private:
+	// The few EGL types and functions used, declared here so EGL's headers aren't needed to build.
+	typedef void *EGLDisplay;
+	typedef void *EGLConfig;
+	typedef void *EGLSurface;
+	typedef void *EGLContext;
+	typedef int EGLint;
+	typedef unsigned int EGLBoolean;
+	typedef unsigned int EGLenum;
+
+	typedef EGLDisplay (APIENTRYP GetDisplayFunction)(void *p_NativeDisplay);
+	typedef EGLDisplay (APIENTRYP GetPlatformDisplayFunction)(EGLenum p_Platform, void *p_NativeDisplay, const EGLint *p_Attributes);
+	typedef EGLBoolean (APIENTRYP InitializeFunction)(EGLDisplay p_Display, EGLint *p_Major, EGLint *p_Minor);
+	typedef EGLBoolean (APIENTRYP TerminateFunction)(EGLDisplay p_Display);
+	typedef const char *(APIENTRYP QueryStringFunction)(EGLDisplay p_Display, EGLint p_Name);
+	typedef EGLBoolean (APIENTRYP BindAPIFunction)(EGLenum p_API);
+	typedef EGLBoolean (APIENTRYP ChooseConfigFunction)(EGLDisplay p_Display, const EGLint *p_Attributes, EGLConfig *p_Configs, EGLint p_ConfigSize, EGLint *p_ConfigCount);
+	typedef EGLSurface (APIENTRYP CreatePbufferSurfaceFunction)(EGLDisplay p_Display, EGLConfig p_Config, const EGLint *p_Attributes);
+	typedef EGLBoolean (APIENTRYP DestroySurfaceFunction)(EGLDisplay p_Display, EGLSurface p_Surface);
+	typedef EGLContext (APIENTRYP CreateContextFunction)(EGLDisplay p_Display, EGLConfig p_Config, EGLContext p_ShareContext, const EGLint *p_Attributes);
+	typedef EGLBoolean (APIENTRYP DestroyContextFunction)(EGLDisplay p_Display, EGLContext p_Context);
+	typedef EGLBoolean (APIENTRYP MakeCurrentFunction)(EGLDisplay p_Display, EGLSurface p_Draw, EGLSurface p_Read, EGLContext p_Context);
+	typedef EGLint (APIENTRYP GetErrorFunction)();
+	typedef void *(APIENTRYP GetProcAddressFunction)(const char *p_Name);
+
+	void *m_Library = nullptr;	//!< Stores the handle of the loaded EGL library.
+	GetDisplayFunction m_GetDisplay = nullptr;	//!< eglGetDisplay.
+	GetPlatformDisplayFunction m_GetPlatformDisplay = nullptr;	//!< eglGetPlatformDisplayEXT, or nullptr when it isn't supported.
+	InitializeFunction m_Initialize = nullptr;	//!< eglInitialize.
+	TerminateFunction m_Terminate = nullptr;	//!< eglTerminate.
+	QueryStringFunction m_QueryString = nullptr;	//!< eglQueryString.
+	BindAPIFunction m_BindAPI = nullptr;	//!< eglBindAPI.
+	ChooseConfigFunction m_ChooseConfig = nullptr;	//!< eglChooseConfig.
+	CreatePbufferSurfaceFunction m_CreatePbufferSurface = nullptr;	//!< eglCreatePbufferSurface.
+	DestroySurfaceFunction m_DestroySurface = nullptr;	//!< eglDestroySurface.
+	CreateContextFunction m_CreateContext = nullptr;	//!< eglCreateContext.
+	DestroyContextFunction m_DestroyContext = nullptr;	//!< eglDestroyContext.
+	MakeCurrentFunction m_MakeCurrent = nullptr;	//!< eglMakeCurrent.
+	GetErrorFunction m_GetError = nullptr;	//!< eglGetError.
+	static GetProcAddressFunction s_m_GetProcAddress;	//!< eglGetProcAddress, shared with GLAD's loader.
+
+	EGLDisplay m_Display = nullptr;	//!< Stores the EGL display.
+	EGLSurface m_Surface = nullptr;	//!< Stores the pbuffer surface, or nullptr when rendering without one.
+	EGLContext m_Context = nullptr;	//!< Stores the OpenGL context.
+	int m_Width = 0;	//!< Stores the width of the surface.
+	int m_Height = 0;	//!< Stores the height of the surface.
+	bool m_IsSoftwareRenderer = false;	//!< Stores whether the software rasteriser was requested.
+
+	unsigned int m_FrameBufferObject = 0;	//!< Stores the framebuffer rendered into, when there isn't a surface.
+	unsigned int m_ColourRenderBufferObject = 0;	//!< Stores the framebuffer's colour attachment.
+
+	bool LoadEGL();
+	/*!
+		\brief Gets a display, initialises it and creates a context, with a pbuffer surface if possible.
+		\param p_UseSoftwareRenderer whether to ask Mesa for its software rasteriser.
+		\return Returns true if a context was created, false otherwise.
+	*/
+	bool CreateContext(bool p_UseSoftwareRenderer);
+	void DestroyContext();
+	static void *LoadFunction(const char *p_Name);
+
+public:
+	HeadlessContext() = default;
+	~HeadlessContext();
+
+	/*!
+		\brief Creates the context, and makes it current on the calling thread.
+		\param p_Width the width of the surface.
+		\param p_Height the height of the surface.
+		\param p_UseSoftwareRenderer whether to skip the hardware driver, and go straight to llvmpipe.
+		\return Returns true if the context was created, false otherwise.
+	*/
+	bool Initialize(int p_Width, int p_Height, bool p_UseSoftwareRenderer = false);
+	/*!
+		\brief Creates the framebuffer rendered into when there isn't a surface, must be called once GLAD has been loaded.
+	*/
+	void CreateFrameBuffer();
+
+	/*!
+		\brief Makes the context current on the calling thread.
+		\return Returns true if successful, false otherwise.
+	*/
+	bool MakeCurrent();
+	/*!
+		\brief Releases the context from the calling thread, so another can make it current.
+	*/
+	void ReleaseCurrent();
+
+	/*!
+		\brief Gets the function GLAD should load the OpenGL functions with.
+		\return Returns the loader.
+	*/
+	static GLADloadproc GetLoader() {
+		return LoadFunction;
+	}
+	bool HasSurface() const {
+		return m_Surface != nullptr;
+	}
+	bool IsSoftwareRenderer() const {
+		return m_IsSoftwareRenderer;
+	}
+	/*!
+		\brief Gets the framebuffer that stands in for the window's.
+		\return Returns the framebuffer object, which is zero when rendering into the pbuffer surface.
+	*/
+	unsigned int GetFrameBufferObject() const {
+		return m_FrameBufferObject;
+	}
+
+	// Delete the copy and assignment operators.
+	HeadlessContext(HeadlessContext const&) = delete; //!< Copy operator, deleted.
+	HeadlessContext& operator=(HeadlessContext const&) = delete; //!< Assignment operator, deleted.
+};
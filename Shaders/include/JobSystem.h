@@ -0,0 +1,139 @@
+/**
+@file JobSystem.h
+@brief A fixed pool of worker threads, that share jobs through work-stealing deques.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "WorkStealingQueue.h"
+
+/**
+	* Counts the unfinished jobs started with it, wait on it to know when they're all done.
+*/
+using JobCounter = std::atomic<unsigned int>;
+
+/*! \class JobSystem
+	\brief A fixed pool of worker threads, each with a deque of jobs. Idle threads steal from the others.
+
+	The thread that creates the job system is worker zero. The other workers never push jobs onto its deque, but
+	while it waits it runs any job it can find, including ones stolen from other workers. The OpenGL context is
+	only safe because jobs never make GL calls: GL work stays on the owning thread, outside of jobs.
+*/
+class JobSystem {
+private:
+	/**
+		* A function to run, and the counter to decrement once it has.
+	*/
+	struct Job {
+		std::function<void()> m_Function;	//!< Stores the function.
+		JobCounter *m_Counter = nullptr;	//!< Stores the counter.
+		std::atomic<bool> m_IsFree{ true };	//!< Stores whether the job has run, so its slot can be reused. Only the owning worker claims it, whoever runs it frees it.
+	};
+
+	/**
+		* A worker's deque, and the pool its jobs are allocated from.
+	*/
+	struct Worker {
+		std::unique_ptr<WorkStealingQueue<Job>> m_Queue;	//!< Stores the jobs waiting to run.
+		std::unique_ptr<Job[]> m_Jobs;	//!< Stores a ring of jobs, each reused once it's free.
+		unsigned int m_NextJob = 0;	//!< Stores the index to start looking for a free job from.
+		unsigned int m_RandomState = 0;	//!< Stores the state used to pick which worker to steal from.
+	};
+
+	static const unsigned int s_m_MaxJobsPerWorker = 4096;	//!< The most jobs a worker can have in flight.
+	static const unsigned int s_m_IdleSpinCount = 64;	//!< The number of times an idle worker looks for a job, before sleeping.
+
+	static thread_local JobSystem *t_m_JobSystem;	//!< Stores the job system the calling thread is a worker of.
+	static thread_local unsigned int t_m_WorkerIndex;	//!< Stores the calling thread's worker index.
+
+	std::vector<Worker> m_Workers;	//!< Stores every worker, including the creating thread at index zero.
+	std::vector<std::thread> m_Threads;	//!< Stores the worker threads.
+	std::atomic<bool> m_IsRunning{ true };	//!< Stores whether the workers should keep running.
+	std::atomic<int> m_QueuedJobs{ 0 };	//!< Stores the number of jobs pushed, but not yet taken.
+	std::atomic<int> m_SleepingWorkers{ 0 };	//!< Stores the number of workers waiting to be woken.
+	std::mutex m_WakeMutex;	//!< Guards the wake condition.
+	std::condition_variable m_WakeCondition;	//!< Wakes sleeping workers when jobs are pushed.
+	JobSystem *m_PreviousJobSystem;	//!< Stores the job system the creating thread belonged to, restored on destruction.
+	unsigned int m_PreviousWorkerIndex;	//!< Stores the creating thread's previous worker index.
+
+	void WorkerLoop(unsigned int p_WorkerIndex);
+	/*!
+		\brief Takes a job from the worker's own deque, or steals one from another worker's.
+		\return Returns the job, or null if there weren't any.
+	*/
+	Job *FindJob(unsigned int p_WorkerIndex);
+	/*!
+		\brief Finds a free job in the worker's ring, starting after the last one allocated.
+		\return Returns the job, or null if every job in the ring is still waiting or running.
+	*/
+	Job *AllocateJob(Worker &p_Worker);
+	void Execute(Job *p_Job);
+
+public:
+	/*!
+		\brief Constructor, starts the worker threads.
+		\param p_ThreadCount the number of threads, including the calling thread. Zero uses one per hardware thread.
+	*/
+	JobSystem(unsigned int p_ThreadCount = 0);
+	~JobSystem();
+
+	/*!
+		\brief Queues a job. If the calling thread isn't a worker, or has too many jobs in flight, the job runs immediately instead.
+		\param p_Function the function to run.
+		\param p_Counter the counter, incremented now, and decremented once the job has run.
+	*/
+	void Run(std::function<void()> p_Function, JobCounter &p_Counter);
+	/*!
+		\brief Runs jobs until every job started with the counter has finished.
+
+		The jobs it runs aren't limited to the counter's, so a job that touches state owned by the caller isn't safe.
+		\param p_Counter the counter.
+	*/
+	void Wait(const JobCounter &p_Counter);
+
+	/*!
+		\brief Splits a range into jobs, and waits for them to finish.
+		\param p_Count the size of the range.
+		\param p_GrainSize the size of each job's part of the range.
+		\param p_Function the function to call with each part's begin and end.
+	*/
+	template<typename Function>
+	void ParallelFor(size_t p_Count, size_t p_GrainSize, const Function &p_Function) {
+		if (p_Count == 0)
+			return;
+		if (p_Count <= p_GrainSize || m_Workers.size() == 1) {
+			p_Function(size_t(0), p_Count);
+			return;
+		}
+
+		JobCounter counter{ 0 };
+		for (size_t begin = 0; begin < p_Count; begin += p_GrainSize) {
+			size_t end = std::min(begin + p_GrainSize, p_Count);
+			Run([&p_Function, begin, end]() { p_Function(begin, end); }, counter);
+		}
+		Wait(counter);
+	}
+	/*!
+		\brief Splits a range into a few jobs per thread, and waits for them to finish.
+	*/
+	template<typename Function>
+	void ParallelFor(size_t p_Count, const Function &p_Function) {
+		ParallelFor(p_Count, std::max<size_t>(1, p_Count / (m_Workers.size() * 4)), p_Function);
+	}
+
+	unsigned int GetThreadCount() const {
+		return static_cast<unsigned int>(m_Workers.size());
+	}
+
+	// Delete the copy and assignment operators.
+	JobSystem(JobSystem const&) = delete; //!< Copy operator, deleted.
+	JobSystem& operator=(JobSystem const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,95 @@
+/**
+@file LightClusters.h
+@brief Bins the point lights into a grid of clusters over the view frustum, for clustered forward shading.
+*/
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+struct FrameLight;
+class JobSystem;
+
+/*! \class LightClusterBinner
+	\brief Splits the view frustum into screen tiles, and exponentially spaced depth slices, and lists the lights that reach into each cluster.
+
+	Each light's view space bounding box is projected to find the tiles, and its depth range to find the slices, it
+	could touch. Only those clusters are tested against the light's sphere. The slices are binned in parallel, each
+	into its own list, which are joined once every slice is done. The shaders find their cluster from the pixel's
+	position and view depth, and only loop over the lights listed there.
+*/
+class LightClusterBinner {
+public:
+	static const unsigned int s_m_TileCountX = 16;	//!< The number of clusters across the screen.
+	static const unsigned int s_m_TileCountY = 9;	//!< The number of clusters down the screen.
+	static const unsigned int s_m_SliceCount = 24;	//!< The number of clusters into the screen.
+	static const unsigned int s_m_ClusterCount = s_m_TileCountX * s_m_TileCountY * s_m_SliceCount;	//!< The number of clusters.
+
+private:
+	static const unsigned int s_m_TileCount = s_m_TileCountX * s_m_TileCountY;	//!< The number of clusters in each slice.
+
+	/**
+		* A light moved into view space, and the range of clusters its bounds cover.
+	*/
+	struct BinnedLight {
+		glm::vec3 m_ViewPosition;	//!< Stores the light's position in view space.
+		float m_Radius;	//!< Stores the light's radius.
+		glm::uvec2 m_TileMinimum;	//!< Stores the first tile the light could touch.
+		glm::uvec2 m_TileMaximum;	//!< Stores the last tile the light could touch.
+		unsigned int m_FirstSlice;	//!< Stores the first slice the light could touch.
+		unsigned int m_LastSlice;	//!< Stores the last slice the light could touch.
+		unsigned int m_Index;	//!< Stores the light's index, in the frame's list of lights.
+	};
+
+	/**
+		* One depth slice's lists, built by whichever worker bins the slice.
+	*/
+	struct SliceBin {
+		std::vector<glm::uvec2> m_Hits;	//!< Stores each light found in a tile, as the tile then the light.
+		std::array<unsigned int, s_m_TileCount + 1> m_TileOffsets;	//!< Stores where each tile's lights start, once sorted.
+		std::vector<unsigned int> m_Indices;	//!< Stores the slice's light indices, sorted by tile.
+	};
+
+	std::vector<BinnedLight> m_Lights;	//!< Stores the lights being binned, kept to avoid allocating every frame.
+	std::array<SliceBin, s_m_SliceCount> m_Slices;	//!< Stores each slice's lists.
+	std::array<float, s_m_SliceCount + 1> m_SliceDepths;	//!< Stores the view depth each slice starts at, and where the last one ends.
+	unsigned int m_DroppedIndexCount = 0;	//!< Stores the number of light indices that didn't fit, in the last frame binned.
+
+	void BinSlice(unsigned int p_Slice, const glm::mat4 &p_Projection);
+
+public:
+	LightClusterBinner() = default;
+
+	/*!
+		\brief Lists the lights reaching into each cluster.
+		\param p_JobSystem the job system to split the slices across.
+		\param p_Lights the lights, in world space, with their radii.
+		\param p_View the camera's view matrix.
+		\param p_Projection the camera's perspective projection matrix.
+		\param p_NearPlane the distance to the near clipping plane.
+		\param p_FarPlane the distance to the far clipping plane.
+		\param p_MaxIndexCount the most light indices the shaders can be given, any more are dropped.
+		\param p_ClusterLightRanges receives the offset and count of each cluster's lights, in the list of indices.
+		\param p_ClusterLightIndices receives every cluster's light indices, one cluster after another.
+	*/
+	void Bin(JobSystem &p_JobSystem, const std::vector<FrameLight> &p_Lights, const glm::mat4 &p_View, const glm::mat4 &p_Projection, float p_NearPlane, float p_FarPlane,
+		size_t p_MaxIndexCount, std::vector<glm::uvec2> &p_ClusterLightRanges, std::vector<unsigned int> &p_ClusterLightIndices);
+
+	/*!
+		\brief Works out the constants the shaders turn a view depth into a slice with, floor(log(depth) * scale - bias).
+		\param p_NearPlane the distance to the near clipping plane.
+		\param p_FarPlane the distance to the far clipping plane.
+		\return Returns the scale, and the bias.
+	*/
+	static glm::vec2 GetSliceScaleAndBias(float p_NearPlane, float p_FarPlane);
+
+	unsigned int GetDroppedIndexCount() const {
+		return m_DroppedIndexCount;
+	}
+
+	// Delete the copy and assignment operators.
+	LightClusterBinner(LightClusterBinner const&) = delete; //!< Copy operator, deleted.
+	LightClusterBinner& operator=(LightClusterBinner const&) = delete; //!< Assignment operator, deleted.
+};
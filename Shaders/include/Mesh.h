@@ -25,6 +25,15 @@ struct Vertex {
 	glm::vec3 m_Bitangent;	//!< Stores the bitangent.
 };
 
+/**
+	* A structure to represent the per-vertex surface attributes, uploaded in their own stream, apart from the positions.
+*/
+struct VertexSurface {
+	glm::vec3 m_Normal;	//!< Stores the normal.
+	glm::vec2 m_TextureCoordinates;	//!< Stores the texture coordinates.
+	glm::vec3 m_Tangent;	//!< Stores the tangent.
+};
+
 /**
 	* A structure to represent Texture information.
 */
@@ -39,9 +48,14 @@ struct Texture {
 */
 class Mesh {
 private:
+	static const unsigned int s_m_PositionStreamBinding = 0;	//!< The vertex buffer binding point, of the position stream.
+	static const unsigned int s_m_SurfaceStreamBinding = 1;	//!< The vertex buffer binding point, of the surface attribute stream.
+
 	// Buffer objects.
-	unsigned int m_VertexBufferObject;	//!< Stores an ID to the vertex buffer object.
+	unsigned int m_PositionBufferObject;	//!< Stores an ID to the tightly packed vertex position buffer object.
+	unsigned int m_SurfaceBufferObject;	//!< Stores an ID to the interleaved normal, texture coordinate and tangent buffer object.
 	unsigned int m_ElementBufferObject;	//!< Stores an ID to the element buffer object.
+	unsigned int m_PositionOnlyVertexArrayObject;	//!< Stores the vertex array object, that only fetches positions.
 
 	/*!
 		\brief Initialises all the buffer arrays.
@@ -52,7 +66,7 @@ public:
 	std::vector<Vertex> m_Vertices;		//!< Stores the vertices.
 	std::vector<unsigned int> m_Indices;	//!< Stores the indices.
 	std::vector<Texture> m_Textures;	//!< Stores the textures.
-	unsigned int m_VertexArrayObject;	//!< Stores the vertex array objects.
+	unsigned int m_VertexArrayObject;	//!< Stores the vertex array object, that fetches every attribute.
 
 	/*!
 		\brief Constructor.
@@ -67,4 +81,23 @@ public:
 		\param p_ShaderProgram the shader program, used to render the mesh.
 	*/
 	void Render(const unsigned int p_ShaderProgram);
+	/*!
+		\brief Render only the mesh's positions, without binding any textures, for depth-only passes.
+	*/
+	void RenderDepthOnly();
+	/*!
+		\brief Binds the mesh's textures, and points the shader program's samplers at them.
+		\param p_ShaderProgram the shader program, it must be the one in use.
+	*/
+	void BindTextures(const unsigned int p_ShaderProgram) const;
+
+	unsigned int GetVertexArray() const {
+		return m_VertexArrayObject;
+	}
+	unsigned int GetPositionOnlyVertexArray() const {
+		return m_PositionOnlyVertexArrayObject;
+	}
+	unsigned int GetIndexCount() const {
+		return static_cast<unsigned int>(m_Indices.size());
+	}
 };
\ No newline at end of file
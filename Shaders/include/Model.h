@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "Mesh.h"
+#include "TransformHierarchy.h"
 
 /*! \class Model
 	\brief A class that stores the properties necessary to create a model.
@@ -21,6 +22,11 @@ private:
 	std::vector<Mesh> m_Meshes;	//!< Stores the model's meshes.
 	std::string m_Directory;	//!< Stores the directory.
 	std::vector<Texture> m_Textures;	//!< Stores the model's textures.
+	TransformHierarchy m_NodeHierarchy;	//!< Stores the transforms of the model's nodes.
+	std::vector<TransformHandle> m_MeshNodes;	//!< Stores the node each mesh belongs to.
+	bool m_HasNodeTransforms = false;	//!< Stores whether any mesh is transformed by its node.
+	glm::vec3 m_BoundingSphereCentre = glm::vec3(0.0f);	//!< Stores the centre of a sphere enclosing every mesh.
+	float m_BoundingSphereRadius = 0.0f;	//!< Stores the radius of a sphere enclosing every mesh.
 
 	/*!
 		\brief Loads the model data.
@@ -31,8 +37,13 @@ private:
 		\brief Processes the model node.
 		\param p_Node the ai node.
 		\param p_Scene the ai scene.
+		\param p_ParentNode the node's parent, in the node hierarchy.
 	*/
-	void ProcessNode(aiNode *p_Node, const aiScene *p_Scene);
+	void ProcessNode(aiNode *p_Node, const aiScene *p_Scene, TransformHandle p_ParentNode);
+	/*!
+		\brief Calculates a sphere enclosing every mesh, around the centre of their bounding box.
+	*/
+	void CalculateBoundingSphere();
 	/*!
 		\brief Processes the model mesh.
 		\param p_Path the ai mesh.
@@ -59,12 +70,60 @@ public:
 		\param p_ModelLoaded sets this to true if the model loaded successfully, false otherwise.
 	*/
 	Model(const std::string &p_FilePath, bool &p_ModelLoaded);
+	/*!
+		\brief Constructor, for models generated in code.
+		\param p_Meshes the model's meshes.
+	*/
+	Model(std::vector<Mesh> p_Meshes);
 
 	/*!
 		\brief Renders the model.
 		\param p_ShaderProgram the shader program ID, being used, to render the model.
 	*/
 	void Render(const unsigned int p_ShaderProgram);
+	/*!
+		\brief Renders the model's geometry only, for depth-only passes.
+	*/
+	void RenderDepthOnly();
+	/*!
+		\brief Renders one of the model's meshes.
+		\param p_MeshIndex the index of the mesh.
+		\param p_ShaderProgram the shader program ID, being used, to render the mesh.
+	*/
+	void RenderMesh(size_t p_MeshIndex, const unsigned int p_ShaderProgram);
+	/*!
+		\brief Renders the geometry of one of the model's meshes only, for depth-only passes.
+		\param p_MeshIndex the index of the mesh.
+	*/
+	void RenderMeshDepthOnly(size_t p_MeshIndex);
+
+	size_t GetMeshCount() const {
+		return m_Meshes.size();
+	}
+	const Mesh &GetMesh(size_t p_MeshIndex) const {
+		return m_Meshes[p_MeshIndex];
+	}
+	/*!
+		\brief Gets the transform of a mesh's node, relative to the model.
+		\param p_MeshIndex the index of the mesh.
+		\return Returns the node's world matrix.
+	*/
+	const glm::mat4 &GetMeshTransform(size_t p_MeshIndex) const {
+		return m_NodeHierarchy.GetWorldMatrix(m_MeshNodes[p_MeshIndex]);
+	}
+	/*!
+		\brief Checks whether any mesh is transformed by its node, if not the meshes can share the model's transform.
+		\return Returns true if any mesh's node transform isn't the identity.
+	*/
+	bool HasNodeTransforms() const {
+		return m_HasNodeTransforms;
+	}
+	const glm::vec3 &GetBoundingSphereCentre() const {
+		return m_BoundingSphereCentre;
+	}
+	float GetBoundingSphereRadius() const {
+		return m_BoundingSphereRadius;
+	}
 
 	/*!
 		\brief Loads textures from a file/folder.
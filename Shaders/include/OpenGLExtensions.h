@@ -0,0 +1,56 @@
+/**
+@file OpenGLExtensions.h
+@brief Loads the few functions, newer than the OpenGL 4.3 core profile GLAD provides, that the renderer can take advantage of.
+*/
+#pragma once
+
+#include <glad/glad.h>
+
+// ARB_buffer_storage (core in OpenGL 4.4).
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_CLIENT_STORAGE_BIT
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum p_Target, GLsizeiptr p_Size, const void *p_Data, GLbitfield p_Flags);
+
+/*! \class OpenGLExtensions
+	\brief Loads the few functions, newer than the OpenGL 4.3 core profile GLAD provides, that the renderer can take advantage of.
+*/
+class OpenGLExtensions {
+private:
+	OpenGLExtensions() = default;
+	~OpenGLExtensions() = default;
+
+	/*!
+		\brief Checks whether the current context advertises an extension.
+		\param p_Name the name of the extension.
+		\return Returns true if the extension is supported, false otherwise.
+	*/
+	static bool IsExtensionSupported(const char *p_Name);
+
+public:
+	static PFNGLBUFFERSTORAGEPROC s_m_BufferStorage;	//!< glBufferStorage, or nullptr when it isn't supported.
+
+	/*!
+		\brief Loads the functions, must be called after GLAD has been initialised, with the same loader.
+		\param p_Loader the function used to look up OpenGL function addresses.
+	*/
+	static void Load(GLADloadproc p_Loader);
+
+	static bool HasBufferStorage() {
+		return s_m_BufferStorage != nullptr;
+	}
+
+	// Delete the copy and assignment operators.
+	OpenGLExtensions(OpenGLExtensions const&) = delete; //!< Copy operator, deleted.
+	OpenGLExtensions& operator=(OpenGLExtensions const&) = delete; //!< Assignment operator, deleted.
+};
\ No newline at end of file
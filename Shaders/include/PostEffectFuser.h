@@ -0,0 +1,58 @@
+/**
+@file PostEffectFuser.h
+@brief Generates, and caches, one fragment shader for each chain of per-pixel effects that runs together.
+*/
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PixelEffect;
+class Shader;
+
+/*! \class PostEffectFuser
+	\brief Joins chains of per-pixel effects into one shader, so the chain reads and writes the image once rather than once per effect.
+
+	Each effect is a GLSL function in its own snippet, taking the colour and returning it changed. The generated
+	shader includes every snippet in the chain, samples the image once, and calls the functions in the chain's
+	order. Programs are cached by the chain's functions, so each combination is only compiled the first time it's used.
+*/
+class PostEffectFuser {
+private:
+	std::map<std::string, std::shared_ptr<Shader>> m_Programs;	//!< Stores the programs compiled so far, by the chain's functions.
+	unsigned int m_FailedCompileCount = 0;	//!< Stores the number of chains that didn't compile.
+
+	/*!
+		\brief Writes the fragment shader for a chain.
+		\param p_Effects the chain, in the order its functions run.
+		\return Returns the source, with the snippets still to be included.
+	*/
+	static std::string GenerateFragmentShader(const std::vector<const PixelEffect*> &p_Effects);
+
+public:
+	PostEffectFuser() = default;
+
+	/*!
+		\brief Finds the program for a chain, compiling it if it's the first time the chain's been used.
+		\param p_Effects the chain, in the order its functions run.
+		\return Returns the program, or null if it didn't compile.
+	*/
+	std::shared_ptr<Shader> GetProgram(const std::vector<const PixelEffect*> &p_Effects);
+
+	// Only the chains that compiled, the ones that failed are cached as null.
+	size_t GetProgramCount() const {
+		return static_cast<size_t>(std::count_if(m_Programs.begin(), m_Programs.end(), [](const std::pair<const std::string, std::shared_ptr<Shader>> &p_Program) {
+			return p_Program.second != nullptr;
+		}));
+	}
+	unsigned int GetFailedCompileCount() const {
+		return m_FailedCompileCount;
+	}
+
+	// Delete the copy and assignment operators.
+	PostEffectFuser(PostEffectFuser const&) = delete; //!< Copy operator, deleted.
+	PostEffectFuser& operator=(PostEffectFuser const&) = delete; //!< Assignment operator, deleted.
+};
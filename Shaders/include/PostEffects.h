@@ -0,0 +1,420 @@
+/**
+@file PostEffects.h
+@brief The full-screen effects applied after the scene is drawn, each adding its own passes to the post-processing graph.
+*/
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+class PostProcessGraph;
+class Shader;
+
+typedef unsigned int PostResource;
+
+/*! \class PostEffect
+	\brief An effect in the post-processing chain. New effects derive from this, and are added to the post-processor.
+*/
+class PostEffect {
+private:
+	std::string m_Name;	//!< Stores the effect's name.
+	bool m_IsEnabled = false;	//!< Stores whether the effect adds its passes.
+
+public:
+	/*!
+		\brief Creates the effect, disabled.
+		\param p_Name the effect's name.
+	*/
+	PostEffect(const std::string &p_Name) : m_Name(p_Name) { }
+	virtual ~PostEffect() = default;
+
+	/*!
+		\brief Moves any animation on.
+		\param p_DeltaTime the time since the last frame.
+	*/
+	virtual void Update(float /*p_DeltaTime*/) { }
+	/*!
+		\brief Adds the effect's passes, reading the graph's colour, and sets the colour to what the effect produced.
+		\param p_Graph the graph.
+	*/
+	virtual void Setup(PostProcessGraph &p_Graph) = 0;
+
+	const std::string &GetName() const {
+		return m_Name;
+	}
+	bool IsEnabled() const {
+		return m_IsEnabled;
+	}
+	void SetEnabled(bool p_IsEnabled) {
+		m_IsEnabled = p_IsEnabled;
+	}
+
+	// Delete the copy and assignment operators.
+	PostEffect(PostEffect const&) = delete; //!< Copy operator, deleted.
+	PostEffect& operator=(PostEffect const&) = delete; //!< Assignment operator, deleted.
+};
+
+/*! \class ShakeEffect
+	\brief Blurs the image with a 3x3 kernel, and shakes it around the screen.
+*/
+class ShakeEffect : public PostEffect {
+private:
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the shader.
+	float m_AccumulatedTime = 0.0f;	//!< Stores the time the shake has run for.
+
+public:
+	ShakeEffect();
+
+	void Update(float p_DeltaTime) override;
+	void Setup(PostProcessGraph &p_Graph) override;
+};
+
+/*! \class BlurEffect
+	\brief Blurs the image with a wide Gaussian, at a reduced resolution, in two compute passes.
+
+	The first pass box filters the image down while blurring its rows, the second blurs the columns. Each work group
+	loads its run of pixels into shared memory once, so the cost grows with the radius in reduced pixels, not full
+	ones. The blurred image is left at the reduced resolution, and is upsampled bilinearly by whatever samples it next.
+*/
+class BlurEffect : public PostEffect {
+private:
+	static const int s_m_MaxRadius = 32;	//!< The largest radius, in reduced pixels, the shader's tile has room for.
+	static const int s_m_TileSize = 128;	//!< The number of pixels each work group blurs, the shader's work group size.
+
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the compute shader.
+	float m_Radius = 32.0f;	//!< Stores the blur's radius, in full resolution pixels.
+	int m_Downsample = 4;	//!< Stores how many times smaller the blur's resolution is, 2 or 4.
+	std::vector<float> m_Weights;	//!< Stores this frame's weights, from the centre out.
+
+	/*!
+		\brief Blurs one direction, from the input into the output.
+		\param p_Graph the graph, inside the pass.
+		\param p_Input the texture to blur, which is box filtered down when it's larger than the output.
+		\param p_Output the image to write.
+		\param p_Direction (1, 0) to blur the rows, (0, 1) the columns.
+	*/
+	void Dispatch(PostProcessGraph &p_Graph, unsigned int p_Input, unsigned int p_Output, const glm::ivec2 &p_Direction) const;
+
+public:
+	BlurEffect();
+
+	void Setup(PostProcessGraph &p_Graph) override;
+
+	void SetRadius(float p_Radius) {
+		m_Radius = p_Radius;
+	}
+	// Halving the resolution again quarters the pixels blurred, and halves the taps for the same radius.
+	void SetDownsample(int p_Downsample) {
+		m_Downsample = p_Downsample >= 4 ? 4 : 2;
+	}
+};
+
+/**
+	* A texture from earlier in the graph that a pixel effect samples, at the pixel's own texture coordinates.
+*/
+struct PixelEffectTexture {
+	std::string m_Uniform;	//!< Stores the name of the snippet's sampler.
+	PostResource m_Resource;	//!< Stores the texture.
+};
+
+/*! \class PixelEffect
+	\brief An effect that only changes each pixel's colour, from that pixel alone, so it can be fused with its neighbours in the chain.
+
+	The effect is a GLSL function in a snippet, taking the colour and texture coordinates and returning the new colour.
+	Consecutive pixel effects are fused into one pass, drawn by a shader generated for that chain, so the image is read
+	and written once for the whole chain. Every snippet in a chain is included into the same shader, so their uniforms
+	must have names unique to the effect. An effect can also sample textures other passes wrote, at the same pixel.
+*/
+class PixelEffect : public PostEffect {
+private:
+	std::string m_SnippetPath;	//!< Stores the snippet's path, relative to the shader folder.
+	std::string m_FunctionName;	//!< Stores the name of the function the snippet defines.
+	std::vector<PixelEffectTexture> m_Textures;	//!< Stores this frame's textures the snippet samples.
+
+protected:
+	/*!
+		\brief Sets the texture one of the snippet's samplers reads this frame, before the effect is added to the graph.
+		\param p_Uniform the sampler's name.
+		\param p_Resource the texture.
+	*/
+	void SetTexture(const std::string &p_Uniform, PostResource p_Resource);
+
+public:
+	/*!
+		\brief Creates the effect, disabled.
+		\param p_Name the effect's name.
+		\param p_SnippetPath the snippet's path, relative to the shader folder.
+		\param p_FunctionName the name of the function the snippet defines.
+	*/
+	PixelEffect(const std::string &p_Name, const std::string &p_SnippetPath, const std::string &p_FunctionName)
+		: PostEffect(p_Name), m_SnippetPath(p_SnippetPath), m_FunctionName(p_FunctionName) { }
+
+	void Setup(PostProcessGraph &p_Graph) override;
+	/*!
+		\brief Sets the snippet's uniforms, on the fused shader it was included into.
+		\param p_Shader the fused shader, already in use.
+	*/
+	virtual void SetUniforms(const Shader & /*p_Shader*/) const { }
+	/*!
+		\brief Whether the effect maps the colour into the displayable range, so the colour after it no longer needs a floating point target.
+		\return Returns true if it does.
+	*/
+	virtual bool MapsToDisplay() const {
+		return false;
+	}
+
+	const std::vector<PixelEffectTexture> &GetTextures() const {
+		return m_Textures;
+	}
+	const std::string &GetSnippetPath() const {
+		return m_SnippetPath;
+	}
+	const std::string &GetFunctionName() const {
+		return m_FunctionName;
+	}
+};
+
+/*! \class InvertColoursEffect
+	\brief Inverts the image's colours.
+*/
+class InvertColoursEffect : public PixelEffect {
+public:
+	InvertColoursEffect();
+};
+
+/*! \class TonemapEffect
+	\brief Scales the image by an exposure, and maps it into the displayable range with a filmic curve.
+*/
+class TonemapEffect : public PixelEffect {
+private:
+	float m_Exposure = 1.0f;	//!< Stores the scale applied before the curve.
+
+public:
+	TonemapEffect();
+
+	void SetUniforms(const Shader &p_Shader) const override;
+	bool MapsToDisplay() const override {
+		return true;
+	}
+
+	void SetExposure(float p_Exposure) {
+		m_Exposure = p_Exposure;
+	}
+};
+
+/*! \class BloomEffect
+	\brief Adds a wide glow around the image's brightest parts, from a chain of progressively smaller copies of it.
+
+	The image is filtered down through a chain of halved targets, the first keeping only what's brighter than the
+	threshold, then filtered back up, each level adding its tent filtered upsample to the level above. Each level only
+	blurs a few of its own pixels, so the glow spreads to a sixteenth of the screen for little more than the cost of the
+	first level. The result is added to the image in the fused pass, before the image is tonemapped.
+*/
+class BloomEffect : public PixelEffect {
+private:
+	static const int s_m_MaxLevelCount = 6;	//!< The most halved levels in the chain.
+	static const int s_m_MinLevelSize = 8;	//!< The smallest a level's width or height gets, before the chain stops.
+
+	std::shared_ptr<Shader> m_DownsampleShader;	//!< Stores the shader that filters each level down.
+	std::shared_ptr<Shader> m_UpsampleShader;	//!< Stores the shader that filters each level back up.
+	float m_Threshold = 1.0f;	//!< Stores the brightness the glow starts from.
+	float m_Knee = 0.5f;	//!< Stores how far below the threshold the glow fades in.
+	float m_Intensity = 0.05f;	//!< Stores how much of the glow is added to the image.
+	float m_Radius = 1.0f;	//!< Stores the size of the upsample's tent, in each level's pixels.
+	int m_LevelCount = 1;	//!< Stores the number of levels in this frame's chain.
+
+public:
+	BloomEffect();
+
+	void Setup(PostProcessGraph &p_Graph) override;
+	void SetUniforms(const Shader &p_Shader) const override;
+
+	void SetThreshold(float p_Threshold) {
+		m_Threshold = p_Threshold;
+	}
+	void SetKnee(float p_Knee) {
+		m_Knee = p_Knee;
+	}
+	void SetIntensity(float p_Intensity) {
+		m_Intensity = p_Intensity;
+	}
+};
+
+/*! \class AutoExposureEffect
+	\brief Works out the exposure the tonemap should use, from a histogram of the image's luminance.
+
+	A compute pass bins each pixel's log luminance, with each work group counting into shared memory and adding its
+	counts to the frame's buffer once. The buffer is only read back once the GPU has finished it, a frame or more later,
+	through a ring of buffers each with a fence, so the CPU never waits on the GPU. The average luminance ignores the
+	darkest and brightest few percent, and the exposure adapts towards it over time, like an eye.
+*/
+class AutoExposureEffect : public PostEffect {
+private:
+	static const int s_m_BinCount = 256;	//!< The number of bins, the shader's too.
+	static const int s_m_GroupSize = 16;	//!< The width and height of the shader's work group.
+	static const int s_m_RingSize = 3;	//!< The number of frames the histograms can be in flight for.
+	static const float s_m_MinLogLuminance;	//!< The log2 luminance of the darkest bin, past the black one.
+	static const float s_m_LogLuminanceRange;	//!< The log2 luminance range the bins cover.
+	static const float s_m_LowPercentile;	//!< The fraction of the darkest pixels the average ignores.
+	static const float s_m_HighPercentile;	//!< The fraction of the pixels, from the darkest, the average stops at.
+	static const float s_m_KeyValue;	//!< The luminance the average is exposed to, mid grey.
+
+	/**
+		* A histogram buffer, and the fence that's signalled once the GPU has finished filling it.
+	*/
+	struct Histogram {
+		unsigned int m_Buffer = 0;	//!< Stores the ID of the buffer.
+		GLsync m_Fence = nullptr;	//!< Stores the fence signalled when the GPU has filled it, or nullptr when it's free.
+	};
+
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the compute shader.
+	Histogram m_Histograms[s_m_RingSize];	//!< Stores the ring of histograms.
+	unsigned int m_NextHistogram = 0;	//!< Stores the histogram the next frame fills.
+	float m_TargetExposure = 1.0f;	//!< Stores the exposure from the last histogram read back.
+	float m_Exposure = 1.0f;	//!< Stores the exposure adapted towards the target.
+	float m_AdaptationSpeed = 1.5f;	//!< Stores how quickly the exposure adapts, the inverse of its time constant in seconds.
+	float m_MinExposure = 0.1f;	//!< Stores the lowest exposure.
+	float m_MaxExposure = 10.0f;	//!< Stores the highest exposure.
+	unsigned int m_SkippedFrameCount = 0;	//!< Stores the number of frames skipped because the next histogram was still in flight.
+
+	/*!
+		\brief Reads back every histogram the GPU has finished, and works out the target exposure from the newest.
+	*/
+	void ReadBackHistograms();
+
+public:
+	AutoExposureEffect();
+	~AutoExposureEffect();
+
+	void Update(float p_DeltaTime) override;
+	void Setup(PostProcessGraph &p_Graph) override;
+
+	float GetExposure() const {
+		return m_Exposure;
+	}
+	float GetTargetExposure() const {
+		return m_TargetExposure;
+	}
+	unsigned int GetSkippedFrameCount() const {
+		return m_SkippedFrameCount;
+	}
+	void SetAdaptationSpeed(float p_AdaptationSpeed) {
+		m_AdaptationSpeed = p_AdaptationSpeed;
+	}
+};
+
+/*! \class ColourGradingEffect
+	\brief Adjusts the image's contrast and saturation, and tints it.
+*/
+class ColourGradingEffect : public PixelEffect {
+private:
+	float m_Contrast = 1.1f;	//!< Stores the contrast, about mid grey.
+	float m_Saturation = 1.2f;	//!< Stores the saturation, 0 being greyscale.
+	glm::vec3 m_ColourFilter = glm::vec3(1.0f, 0.97f, 0.92f);	//!< Stores the tint the colour is multiplied by.
+
+public:
+	ColourGradingEffect();
+
+	void SetUniforms(const Shader &p_Shader) const override;
+
+	void SetContrast(float p_Contrast) {
+		m_Contrast = p_Contrast;
+	}
+	void SetSaturation(float p_Saturation) {
+		m_Saturation = p_Saturation;
+	}
+	void SetColourFilter(const glm::vec3 &p_ColourFilter) {
+		m_ColourFilter = p_ColourFilter;
+	}
+};
+
+/*! \class VignetteEffect
+	\brief Darkens the image towards its corners.
+*/
+class VignetteEffect : public PixelEffect {
+private:
+	float m_Strength = 0.6f;	//!< Stores how dark the corners get, 0 being no darkening.
+	float m_Radius = 0.5f;	//!< Stores the distance from the centre the darkening starts at, 1 being the corners.
+
+public:
+	VignetteEffect();
+
+	void SetUniforms(const Shader &p_Shader) const override;
+
+	void SetStrength(float p_Strength) {
+		m_Strength = p_Strength;
+	}
+	void SetRadius(float p_Radius) {
+		m_Radius = p_Radius;
+	}
+};
+
+/*! \class EdgeKernelEffect
+	\brief Finds the image's edges with a 3x3 Laplacian kernel.
+*/
+class EdgeKernelEffect : public PostEffect {
+private:
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the shader.
+
+public:
+	EdgeKernelEffect();
+
+	void Setup(PostProcessGraph &p_Graph) override;
+};
+
+/*! \class FXAAEffect
+	\brief Smooths the image's aliased edges in one pass, from its luma alone.
+*/
+class FXAAEffect : public PostEffect {
+private:
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the shader.
+
+public:
+	FXAAEffect();
+
+	void Setup(PostProcessGraph &p_Graph) override;
+};
+
+/*! \class SMAAEffect
+	\brief Smooths the image's aliased edges by finding the lines they came from, in three passes.
+
+	The first pass finds the edges, the second searches along each one for its ends and the edges crossing it there,
+	and looks up how much of each pixel the line that pattern stands for covers, the third blends each pixel with its
+	neighbour by that much. The lookups are the reference's area and search textures, which are generated when the
+	effect is created rather than loaded. Only the orthogonal patterns are handled, like the reference's medium preset.
+*/
+class SMAAEffect : public PostEffect {
+private:
+	static const int s_m_AreaTileSize = 16;	//!< The width and height of each crossing edge pattern's tile in the area texture.
+	static const int s_m_AreaTileCount = 5;	//!< The number of tiles along each side, one per crossing edge value.
+	static const int s_m_SearchHalfWidth = 33;	//!< The width of each search direction's half of the search texture.
+	static const int s_m_SearchHeight = 33;	//!< The height of the search texture.
+	static const float s_m_SmoothMaxDistance;	//!< The line length by which the rounding of short U shapes has faded out.
+
+	std::shared_ptr<Shader> m_EdgesShader;	//!< Stores the shader that finds the edges.
+	std::shared_ptr<Shader> m_WeightsShader;	//!< Stores the shader that works out the blending weights.
+	std::shared_ptr<Shader> m_BlendingShader;	//!< Stores the shader that blends with the neighbours.
+	unsigned int m_AreaTexture = 0;	//!< Stores the ID of the area texture.
+	unsigned int m_SearchTexture = 0;	//!< Stores the ID of the search texture.
+
+	/*!
+		\brief Works out the area texture, the coverage of a pixel by the line an edge pattern stands for.
+		\return Returns the texels, two bytes each, a row at a time.
+	*/
+	static std::vector<unsigned char> GenerateAreaTexture();
+	/*!
+		\brief Works out the search texture, how far past the last fetch a search's line goes on.
+		\return Returns the texels, a byte each, a row at a time.
+	*/
+	static std::vector<unsigned char> GenerateSearchTexture();
+
+public:
+	SMAAEffect();
+	~SMAAEffect();
+
+	void Setup(PostProcessGraph &p_Graph) override;
+};
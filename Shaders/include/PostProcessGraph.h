@@ -0,0 +1,201 @@
+/**
+@file PostProcessGraph.h
+@brief A graph of full-screen passes, rebuilt every frame, that culls what isn't needed and shares targets between passes.
+*/
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "RenderTargetPool.h"
+
+class GPUProfiler;
+class PixelEffect;
+class PostEffectFuser;
+class Shader;
+
+typedef unsigned int PostResource;	//!< The index of a texture in the graph.
+
+/**
+	* What a pass needs a new texture to be.
+*/
+struct PostTargetDescription {
+	float m_Scale = 1.0f;	//!< Stores the texture's size, as a fraction of the graph's.
+	GLenum m_Format = GL_RGBA8;	//!< Stores the texture's internal format.
+	bool m_IsImage = false;	//!< Stores whether a compute shader writes the texture as an image, so it always needs a texture of its own.
+};
+
+/*! \class PostProcessGraph
+	\brief The passes after the scene is drawn, each declaring the textures it reads and writes.
+
+	The effects add their passes every frame, passing the chain's colour along from one to the next. Executing the
+	graph walks back from the final colour, culling any pass whose textures nothing reads. The textures are only
+	acquired from the pool just before the pass that writes them, and released after the last pass that reads them,
+	so textures whose lifetimes don't overlap share the same memory. The last pass draws straight into the output
+	framebuffer, when nothing else reads what it writes and it's the output's size. Otherwise the final colour is
+	blitted across, or upscaled and sharpened when the scene was rendered smaller than the output.
+*/
+class PostProcessGraph {
+public:
+	typedef std::function<void(PostProcessGraph&)> PassFunction;	//!< Draws a pass, using the graph to find its textures.
+	static const PostResource s_m_InvalidResource = ~0u;	//!< The resource that stands for no texture.
+
+private:
+	static const unsigned int s_m_NoPass = ~0u;	//!< The pass index that stands for no pass.
+
+	/**
+		* A texture the passes read or write, either created by the graph or imported into it.
+	*/
+	struct Resource {
+		std::string m_Name;	//!< Stores the name, for debugging.
+		PostTargetDescription m_Description;	//!< Stores the size and format, for textures the graph creates.
+		int m_Width = 0;	//!< Stores the width.
+		int m_Height = 0;	//!< Stores the height.
+		const RenderTarget *m_Target = nullptr;	//!< Stores the target, while it's acquired, or always if it's imported.
+		bool m_IsImported = false;	//!< Stores whether the texture belongs to someone else, so it's never pooled.
+		bool m_IsOutput = false;	//!< Stores whether the pass writing the texture draws into the output framebuffer instead.
+		bool m_IsNeeded = false;	//!< Stores whether a pass that isn't culled reads the texture.
+		unsigned int m_LastUse = s_m_NoPass;	//!< Stores the last pass that uses the texture, after which it's released.
+	};
+
+	/**
+		* A full-screen pass.
+	*/
+	struct Pass {
+		std::string m_Name;	//!< Stores the name, which the profiler times it under.
+		std::vector<PostResource> m_Reads;	//!< Stores the textures the pass samples.
+		std::vector<PostResource> m_Writes;	//!< Stores the textures the pass draws into.
+		PassFunction m_Function;	//!< Stores the function that draws the pass.
+		bool m_HasSideEffects = false;	//!< Stores whether the pass does something besides writing its textures, so it's never culled.
+		bool m_IsCulled = false;	//!< Stores whether the pass was culled.
+		std::vector<const PixelEffect*> m_PixelEffects;	//!< Stores the pixel effects fused into the pass, in the order they run, if it's a fused pass.
+	};
+
+	RenderTargetPool &m_Pool;	//!< Stores the pool the textures come from.
+	PostEffectFuser &m_Fuser;	//!< Stores the fuser that makes the fused passes' shaders.
+	std::vector<Resource> m_Resources;	//!< Stores this frame's textures.
+	std::vector<Pass> m_Passes;	//!< Stores this frame's passes, in the order they're added.
+	PostResource m_Colour = s_m_InvalidResource;	//!< Stores the chain's colour, the texture the next effect reads.
+	RenderTarget m_OutputTarget;	//!< Stores the output framebuffer, which has no texture, and its size.
+	int m_Width = 0;	//!< Stores the size the textures are scaled from.
+	int m_Height = 0;	//!< Stores the size the textures are scaled from.
+	std::shared_ptr<Shader> m_UpscaleShader;	//!< Stores the shader that upscales the final colour into the output.
+	float m_UpscaleSharpness = 0.0f;	//!< Stores how much the upscale sharpens.
+	unsigned int m_EmptyVertexArrayObject = 0;	//!< Stores a vertex array with no attributes, for the full-screen triangle.
+	unsigned int m_CulledPassCount = 0;	//!< Stores the number of passes culled, in the last frame executed.
+
+	void Cull();
+	void Present(GPUProfiler *p_Profiler);
+	void DrawPixelEffects(unsigned int p_PassIndex, PostResource p_Input, PostResource p_Output) const;
+
+public:
+	/*!
+		\brief Creates the graph.
+		\param p_Pool the pool the textures come from, which must outlive the graph.
+		\param p_Fuser the fuser that makes the fused passes' shaders, which must outlive the graph.
+	*/
+	PostProcessGraph(RenderTargetPool &p_Pool, PostEffectFuser &p_Fuser);
+	~PostProcessGraph();
+
+	/*!
+		\brief Clears the last frame's passes, and starts a chain from the scene's colour.
+		\param p_Width the width the textures are scaled from, the size the scene was rendered at.
+		\param p_Height the height the textures are scaled from, the size the scene was rendered at.
+		\param p_SceneColour the target the scene was drawn into, which becomes the chain's first colour.
+		\param p_OutputFrameBufferObject the framebuffer the final colour ends up in.
+		\param p_OutputWidth the output's width.
+		\param p_OutputHeight the output's height.
+	*/
+	void Reset(int p_Width, int p_Height, const RenderTarget &p_SceneColour, unsigned int p_OutputFrameBufferObject, int p_OutputWidth, int p_OutputHeight);
+
+	/*!
+		\brief Declares a texture for a pass to write, only acquired if the pass isn't culled.
+		\param p_Name the name, for debugging.
+		\param p_Description the size and format.
+		\return Returns the texture.
+	*/
+	PostResource CreateTarget(const std::string &p_Name, const PostTargetDescription &p_Description);
+	/*!
+		\brief Adds a pass, which runs in the order it was added.
+		\param p_Name the name, which the profiler times it under.
+		\param p_Reads the textures the pass samples.
+		\param p_Writes the textures the pass draws into, which must be created for this pass.
+		\param p_Function the function that draws the pass.
+		\param p_HasSideEffects whether the pass does something besides writing its textures, so must never be culled.
+	*/
+	void AddPass(const std::string &p_Name, const std::vector<PostResource> &p_Reads, const std::vector<PostResource> &p_Writes, PassFunction p_Function, bool p_HasSideEffects = false);
+	/*!
+		\brief Adds a pixel effect, fused into the last pass if that's a fused pass writing the chain's colour, otherwise into a new one.
+		The pass's target keeps the colour's format, until an effect maps the colour into the displayable range.
+		\param p_Effect the effect, which must outlive the frame, with this frame's textures already set.
+	*/
+	void AddPixelEffect(const PixelEffect &p_Effect);
+
+	// How much the final colour is sharpened, when it's smaller than the output and has to be upscaled.
+	void SetUpscaleSharpness(float p_Sharpness) {
+		m_UpscaleSharpness = p_Sharpness;
+	}
+
+	PostResource GetColour() const {
+		return m_Colour;
+	}
+	// The texture the next effect reads, and what ends up in the output if it's the last.
+	void SetColour(PostResource p_Colour) {
+		m_Colour = p_Colour;
+	}
+
+	/*!
+		\brief Culls the passes nothing needs, then runs the rest, acquiring and releasing their textures around them.
+		\param p_Profiler the profiler to time each pass with, or null.
+	*/
+	void Execute(GPUProfiler *p_Profiler);
+
+	/*!
+		\brief Binds a texture's framebuffer, and sets the viewport to its size. Only valid inside a pass that writes it.
+		\param p_Resource the texture.
+	*/
+	void BindTarget(PostResource p_Resource) const;
+	/*!
+		\brief Binds a texture to a texture unit. Only valid inside a pass that reads it.
+		\param p_Unit the texture unit.
+		\param p_Resource the texture.
+	*/
+	void BindTexture(unsigned int p_Unit, PostResource p_Resource) const;
+	/*!
+		\brief Binds a texture to an image unit, for a compute shader to write. Only valid inside a pass that writes it.
+		\param p_Unit the image unit.
+		\param p_Resource the texture, which must have been created as an image.
+	*/
+	void BindImage(unsigned int p_Unit, PostResource p_Resource) const;
+	/*!
+		\brief Draws one triangle over the whole target, the vertex shader builds it from the vertex index.
+	*/
+	void DrawFullScreenTriangle() const;
+
+	glm::ivec2 GetSize(PostResource p_Resource) const {
+		return glm::ivec2(m_Resources[p_Resource].m_Width, m_Resources[p_Resource].m_Height);
+	}
+	// The fraction of the graph's size the texture is, so an effect can size its targets from what it reads.
+	float GetScale(PostResource p_Resource) const {
+		return m_Resources[p_Resource].m_Description.m_Scale;
+	}
+	// Effects that keep the colour's range write targets in the format they read, so HDR colour stays HDR until it's tonemapped.
+	GLenum GetFormat(PostResource p_Resource) const {
+		return m_Resources[p_Resource].m_Description.m_Format;
+	}
+	size_t GetPassCount() const {
+		return m_Passes.size();
+	}
+	unsigned int GetCulledPassCount() const {
+		return m_CulledPassCount;
+	}
+
+	// Delete the copy and assignment operators.
+	PostProcessGraph(PostProcessGraph const&) = delete; //!< Copy operator, deleted.
+	PostProcessGraph& operator=(PostProcessGraph const&) = delete; //!< Assignment operator, deleted.
+};
@@ -1,67 +1,99 @@
 #pragma once
 
 #include <memory>
-#include <array>
+#include <vector>
 
-class Shader;
+#include "RenderTargetPool.h"
 
+class GPUProfiler;
+class PostEffect;
+class PostEffectFuser;
+class PostProcessGraph;
+
+// Renders the scene into a pooled, high dynamic range target at a fraction of the output's size, and runs the chain of effects from it into the output.
 class PostProcessor {
 private:
-	float m_QuadWidth;
-	float m_QuadHeight;
-	float m_AccumulatedTime = 0;
-	
-	unsigned int m_FrameBufferObject;
-	unsigned int m_TextureID;
-	unsigned int m_RenderBufferObject;	
-	unsigned int m_VAO;
-	unsigned int m_VBO;
+	static const float s_m_MinRenderScale;
+	static const float s_m_DefaultSharpness;
+
+	int m_OutputWidth;
+	int m_OutputHeight;
+	float m_RenderScale = 1.0f;
+	int m_RenderWidth;
+	int m_RenderHeight;
+	float m_Sharpness = s_m_DefaultSharpness;
+	int m_SampleCount = 0;
+	int m_MaxSampleCount = 0;
+
+	// Acquired from the pool at the render size when the scene starts, and released once the effects have run.
+	const RenderTarget *m_SceneTarget = nullptr;
+	// Where a multisampled scene is resolved to, before the effects run.
+	const RenderTarget *m_ResolveTarget = nullptr;
+	unsigned int m_OutputFrameBufferObject = 0;
 
-	std::shared_ptr<Shader> m_Shader;
-	bool m_Shake = false;
-	bool m_InvertColours = false;
-	bool m_Chaos = false;
+	std::shared_ptr<RenderTargetPool> m_TargetPool;
+	std::shared_ptr<PostEffectFuser> m_Fuser;
+	std::shared_ptr<PostProcessGraph> m_Graph;
+	// Applied in the order they were added, only the enabled ones add passes.
+	std::vector<std::shared_ptr<PostEffect>> m_Effects;
 
-	void InitializeRenderData();
+	void UpdateRenderSize();
 
 public:
-	PostProcessor(float p_QuadWidth, float p_QuadHeight);
+	PostProcessor(int p_OutputWidth, int p_OutputHeight);
 	~PostProcessor();
 
-	void Update(float p_DeltaTime);	
+	void AddEffect(std::shared_ptr<PostEffect> p_Effect);
+	void Update(float p_DeltaTime);
 
+	// Binds the scene's target, at the render size, with the viewport set to match.
 	void BeginRender();
-	void Render();
+	// Each pass is timed by the profiler, when one is given.
+	void Render(GPUProfiler *p_Profiler = nullptr);
 
-	bool GetShakeState() const {
-		return m_Shake;
-	}
-	void SetShakeState(bool p_ShakeState) {
-		m_Shake = p_ShakeState;
+	// The framebuffer the scene is drawn into, before the effects are applied. Only valid between BeginRender and Render.
+	unsigned int GetSceneFrameBuffer() const {
+		return m_SceneTarget ? m_SceneTarget->m_FrameBufferObject : 0;
 	}
 
-	bool GetInvertColoursState() const {
-		return m_InvertColours;
+	// The framebuffer the final image is drawn into, the window's by default.
+	void SetOutputFrameBuffer(unsigned int p_FrameBufferObject) {
+		m_OutputFrameBufferObject = p_FrameBufferObject;
 	}
-	void SetInvertColoursState(bool p_InvertColoursState) {
-		m_InvertColours = p_InvertColoursState;
-		if (m_InvertColours) {
-			m_Chaos = false;
-		}
+	unsigned int GetOutputFrameBuffer() const {
+		return m_OutputFrameBufferObject;
 	}
 
-	bool GetChaosState() const {
-		return m_Chaos;
+	// The targets are only reallocated, from the pool, the next time the scene is rendered.
+	void SetOutputSize(int p_OutputWidth, int p_OutputHeight);
+	// The fraction of the output's width and height the scene is rendered at, clamped between a half and one.
+	void SetRenderScale(float p_RenderScale);
+	float GetRenderScale() const {
+		return m_RenderScale;
+	}
+	int GetRenderWidth() const {
+		return m_RenderWidth;
 	}
-	void SetChaosState(bool p_ChaosState) {
-		m_Chaos = p_ChaosState;
-		if (m_Chaos) {
-			m_InvertColours = false;
-		}
+	int GetRenderHeight() const {
+		return m_RenderHeight;
+	}
+	// The number of samples per pixel the scene is rendered with, 0 or 1 to not multisample, clamped to what the GL supports.
+	void SetSampleCount(int p_SampleCount);
+	int GetSampleCount() const {
+		return m_SampleCount;
+	}
+	// How much the upscale sharpens, when the scene is rendered smaller than the output.
+	void SetSharpness(float p_Sharpness) {
+		m_Sharpness = p_Sharpness;
 	}
 
-	void SetTextureSize(float p_QuadWidth, float p_QuadHeight) {
-		m_QuadWidth = p_QuadWidth;
-		m_QuadHeight = p_QuadHeight;
+	const RenderTargetPool &GetTargetPool() const {
+		return *m_TargetPool;
+	}
+	const PostProcessGraph &GetGraph() const {
+		return *m_Graph;
+	}
+	const PostEffectFuser &GetFuser() const {
+		return *m_Fuser;
 	}
-};
\ No newline at end of file
+};
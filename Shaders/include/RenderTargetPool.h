@@ -0,0 +1,94 @@
+/**
+@file RenderTargetPool.h
+@brief A pool of colour render targets, shared out by size and format, and freed once they've gone unused for a few frames.
+*/
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+	* A texture, and a framebuffer with it as the only colour attachment, and optionally a depth and stencil buffer.
+	* A multisampled target's texture can't be sampled, only resolved into another target.
+*/
+struct RenderTarget {
+	unsigned int m_TextureID = 0;	//!< Stores the ID of the texture.
+	unsigned int m_FrameBufferObject = 0;	//!< Stores the ID of the framebuffer that draws into the texture.
+	int m_Width = 0;	//!< Stores the width.
+	int m_Height = 0;	//!< Stores the height.
+	GLenum m_Format = GL_RGBA8;	//!< Stores the texture's internal format.
+	unsigned int m_DepthRenderBuffer = 0;	//!< Stores the ID of the depth and stencil renderbuffer, if the target has one.
+	int m_SampleCount = 0;	//!< Stores the number of samples per pixel, or 0 if the target isn't multisampled.
+};
+
+/*! \class RenderTargetPool
+	\brief Hands out render targets by size and format, reusing any that were released, and frees the ones nothing has wanted for a while.
+
+	A target released during a frame can be acquired again in the same frame, so two passes whose targets are never
+	needed at the same time share one texture. Only the targets the current chain of passes needs stay allocated.
+*/
+class RenderTargetPool {
+private:
+	static const unsigned int s_m_MaxIdleFrames = 8;	//!< The number of frames a target can go unused before it's freed.
+
+	/**
+		* A target, and whether it's been handed out.
+	*/
+	struct PooledTarget {
+		RenderTarget m_Target;	//!< Stores the target.
+		bool m_IsAcquired = false;	//!< Stores whether the target is being used.
+		unsigned long long m_LastUsedFrame = 0;	//!< Stores the last frame the target was acquired in.
+	};
+
+	std::vector<std::unique_ptr<PooledTarget>> m_Targets;	//!< Stores the targets, which stay where they are so pointers to them stay valid.
+	unsigned long long m_FrameIndex = 0;	//!< Stores the number of frames the pool has seen.
+	unsigned int m_CreatedTargetCount = 0;	//!< Stores the number of targets ever created.
+
+	static void CreateTarget(RenderTarget &p_Target, bool p_HasDepth);
+	static void DeleteTarget(RenderTarget &p_Target);
+
+public:
+	RenderTargetPool() = default;
+	~RenderTargetPool();
+
+	/*!
+		\brief Finds a free target of the size and format, or creates one.
+		\param p_Width the width.
+		\param p_Height the height.
+		\param p_Format the texture's internal format.
+		\param p_HasDepth whether the target needs a depth and stencil buffer, for drawing geometry into.
+		\param p_SampleCount the number of samples per pixel, or 0 for a target that isn't multisampled.
+		\return Returns the target, which stays the caller's until it's released.
+	*/
+	const RenderTarget *Acquire(int p_Width, int p_Height, GLenum p_Format, bool p_HasDepth = false, int p_SampleCount = 0);
+	/*!
+		\brief Hands a target back, so anything acquired after can use it.
+		\param p_Target the target.
+	*/
+	void Release(const RenderTarget *p_Target);
+	/*!
+		\brief Frees the targets nothing has acquired for a while, must be called once a frame with every target released.
+	*/
+	void EndFrame();
+
+	/*!
+		\brief Works out how many bytes a texel takes up in a format.
+		\param p_Format the texture's internal format.
+		\return Returns the size, in bytes.
+	*/
+	static unsigned int GetBytesPerTexel(GLenum p_Format);
+
+	size_t GetTargetCount() const {
+		return m_Targets.size();
+	}
+	size_t GetAllocatedBytes() const;
+	unsigned int GetCreatedTargetCount() const {
+		return m_CreatedTargetCount;
+	}
+
+	// Delete the copy and assignment operators.
+	RenderTargetPool(RenderTargetPool const&) = delete; //!< Copy operator, deleted.
+	RenderTargetPool& operator=(RenderTargetPool const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,79 @@
+/**
+@file RenderThread.h
+@brief Draws the frame packets the simulation publishes, on a thread that owns the OpenGL context.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "FramePacket.h"
+
+class Window;
+class Scene;
+class JobSystem;
+
+/*! \class RenderThread
+	\brief Owns the OpenGL context, and draws each frame packet while the simulation builds the next one.
+
+	When it isn't threaded, each packet is drawn as soon as it's published instead, for comparison.
+*/
+class RenderThread {
+private:
+	std::shared_ptr<Window> m_Window;	//!< Stores the window, whose context the thread makes current.
+	std::shared_ptr<Scene> m_Scene;	//!< Stores the scene that draws the packets.
+	FramePacketBuffer m_Packets;	//!< Stores the double buffered packets.
+	FramePacket m_UnthreadedPacket;	//!< Stores the only packet, when not threaded.
+	std::thread m_Thread;	//!< Stores the render thread.
+	bool m_IsThreaded;	//!< Stores whether the packets are drawn on their own thread.
+	bool m_IsStopped = false;	//!< Stores whether the thread has been stopped.
+	unsigned long long m_FrameIndex = 0;	//!< Stores the number of packets built.
+	FramePacket *m_CurrentPacket = nullptr;	//!< Stores the packet being built.
+
+	static const float s_m_ReportInterval;	//!< How often, in seconds, the timings are written out.
+	std::chrono::steady_clock::time_point m_ReportStart;	//!< Stores when the timings were last reset.
+	unsigned int m_FramesRendered = 0;	//!< Stores the number of frames drawn, since the last report.
+	float m_SimulationMilliseconds = 0.0f;	//!< Stores the simulation's total time, since the last report.
+	float m_RenderMilliseconds = 0.0f;	//!< Stores the render thread's total time drawing, since the last report.
+	float m_LatencyMilliseconds = 0.0f;	//!< Stores the total time from input to the buffers being swapped, since the last report.
+	float m_WorstLatencyMilliseconds = 0.0f;	//!< Stores the longest time from input to the buffers being swapped, since the last report.
+
+	void ThreadLoop();
+	/*!
+		\brief Draws a packet, swaps the buffers and records how long it took.
+		\param p_Packet the packet.
+		\param p_JobSystem the job system, the calling thread must be one of its workers.
+	*/
+	void RenderPacket(const FramePacket &p_Packet, JobSystem &p_JobSystem);
+	void ReportTimings();
+
+public:
+	/*!
+		\brief Constructor. If threaded, the calling thread gives up the OpenGL context to the render thread.
+		\param p_Window the window, its context must be current on the calling thread.
+		\param p_Scene the scene.
+		\param p_IsThreaded whether to draw on a separate thread.
+	*/
+	RenderThread(std::shared_ptr<Window> p_Window, std::shared_ptr<Scene> p_Scene, bool p_IsThreaded = true);
+	~RenderThread();
+
+	/*!
+		\brief Starts a simulation frame, call this before reading the input.
+		\return Returns the packet for the simulation to fill.
+	*/
+	FramePacket &BeginFrame();
+	/*!
+		\brief Publishes the packet for drawing, or draws it straight away when not threaded.
+	*/
+	void EndFrame();
+	/*!
+		\brief Stops the render thread, and hands the OpenGL context back to the calling thread.
+	*/
+	void Stop();
+
+	// Delete the copy and assignment operators.
+	RenderThread(RenderThread const&) = delete; //!< Copy operator, deleted.
+	RenderThread& operator=(RenderThread const&) = delete; //!< Assignment operator, deleted.
+};
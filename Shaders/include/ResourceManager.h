@@ -20,11 +20,16 @@ private:
 	std::map<std::string, std::shared_ptr<Shader>> m_Shaders;
 
 	std::vector<std::string> m_UnsuccessfullyLoadedModels;
+	std::string m_ShaderFolder;
+
+	static const unsigned int s_m_MaxShaderIncludeDepth = 8;
 
 	ResourceManager();
 	~ResourceManager();
 
 	bool LoadShaderFromFile(const std::string &p_VertexShaderFile, const std::string &p_FragmentShaderFile, const std::string &p_GeometryShaderFile = " ");
+	bool LoadComputeShaderFromFile(const std::string &p_ComputeShaderFile);
+	static std::string ResolveShaderIncludes(const std::string &p_ShaderCode, const std::string &p_Directory, unsigned int p_Depth = 0);
 
 public:
 	static ResourceManager &Instance();
@@ -32,6 +37,8 @@ public:
 	bool LoadShadersFromFolder(const std::string &p_FolderPath);
 	std::shared_ptr<Shader> LoadShader(const std::string &p_VertexShaderFile, const std::string &p_FragmentShaderFile, const std::string &p_GeometryShaderFile = " ");
 	std::shared_ptr<Shader> GetShader(const std::string &p_Name);
+	// Compiles shader source generated in code, its includes are found relative to the shader folder. Returns null if it doesn't compile.
+	std::shared_ptr<Shader> CompileShader(const std::string &p_Name, const std::string &p_VertexCode, const std::string &p_FragmentCode);
 
 	static unsigned int LoadOpenGLTexture(const std::string &p_FilePath);
 	static unsigned int LoadOpenGLCubemapTexture(const std::vector<std::string> &p_CubemapFaces);
@@ -40,4 +47,6 @@ public:
 	bool LoadModelFromFile(const FileInformation &p_FileLocation);
 	bool LoadModelFromFile(std::string p_FileLocation);
 	std::shared_ptr<Model> GetModel(const std::string &p_ModelName);
+	// Adds a model that was generated in code, rather than loaded from a file.
+	bool AddModel(const std::string &p_ModelName, std::shared_ptr<Model> p_Model);
 };
\ No newline at end of file
@@ -1,43 +1,179 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <string>
 
+#include <glm/mat4x4.hpp>
+
+#include "CommandBuffer.h"
+#include "EntitySystems.h"
+#include "FramePacket.h"
+#include "StreamingBuffer.h"
+#include "FrameCapture.h"
+#include "LightClusters.h"
+
 class Window;
 class Camera;
 class PostProcessor;
+class PostEffect;
+class TonemapEffect;
+class AutoExposureEffect;
 class Skybox;
-class GameObject;
+class TextRenderer;
+class Shader;
+class GPUProfiler;
+class DeferredRenderer;
+class JobSystem;
+class TaskGraph;
+class ShadowRenderer;
+class DynamicResolutionController;
+
+// What the render thread did for one frame, recorded for the benchmarks.
+struct FrameStatistics {
+	unsigned long long m_FrameIndex = 0;
+	float m_RenderMilliseconds = 0.0f;	// CPU time spent in Render, not counting the swap.
+	float m_GPUMilliseconds = 0.0f;	// The most recent whole frame GPU time, which lags a few frames behind.
+	float m_RenderScale = 1.0f;	// The fraction of the output's width and height the scene was rendered at.
+	unsigned int m_VisibleObjectCount = 0;
+	unsigned int m_DrawCount = 0;
+	unsigned int m_TriangleCount = 0;
+	unsigned int m_ProgramChangeCount = 0;
+	unsigned int m_MaterialChangeCount = 0;
+	unsigned int m_ObjectDataChangeCount = 0;
+};
 
 class Scene {
 private:
 	std::shared_ptr<Window> m_Window;
 	std::shared_ptr<Camera> m_Camera;
 	std::shared_ptr<PostProcessor> m_PostProcessor;
+	std::shared_ptr<PostEffect> m_ShakeEffect;
+	std::shared_ptr<PostEffect> m_InvertColoursEffect;
+	std::shared_ptr<PostEffect> m_EdgeKernelEffect;
+	std::shared_ptr<PostEffect> m_BlurEffect;
+	std::shared_ptr<TonemapEffect> m_TonemapEffect;
+	std::shared_ptr<PostEffect> m_BloomEffect;
+	std::shared_ptr<AutoExposureEffect> m_AutoExposureEffect;
+	std::shared_ptr<PostEffect> m_ColourGradingEffect;
+	std::shared_ptr<PostEffect> m_VignetteEffect;
+	std::shared_ptr<PostEffect> m_FXAAEffect;
+	std::shared_ptr<PostEffect> m_SMAAEffect;
 	std::shared_ptr<Skybox> m_Skybox;
 
-	std::shared_ptr<GameObject> m_SceneObject;
-	std::shared_ptr<GameObject> m_LightObject;
+	std::shared_ptr<JobSystem> m_JobSystem;
+	std::shared_ptr<TaskGraph> m_FrameGraph;
+	std::shared_ptr<EntityManager> m_Entities;
+	std::shared_ptr<TransformSystem> m_TransformSystem;
+	std::shared_ptr<CullingSystem> m_CullingSystem;
+	std::shared_ptr<DrawPacketSystem> m_DrawPacketSystem;
+	std::shared_ptr<LightSystem> m_LightSystem;
+	std::shared_ptr<LightClusterBinner> m_LightClusterBinner;
+	std::shared_ptr<ShadowCasterSystem> m_ShadowCasterSystem;
+	Entity m_SceneEntity;
+	Entity m_LightEntity;
+	FramePacket *m_SimulationPacket = nullptr;
+	RenderSettings m_Settings;
+	FrameDirectionalLight m_Sun;
+	std::string m_StatusMessage;	// The last toggle's message, shown on screen until its time runs out.
+	float m_StatusMessageTime = 0.0f;
+	float m_StatusMessageDuration = 2.0f;
+	float m_StatusMessageFadeTime = 0.5f;
+
+	// Everything below is only touched by the render thread, which owns the GL context, and the workers it records commands on.
+	std::vector<CommandBuffer> m_DepthCommandBuffers;
+	std::vector<CommandBuffer> m_ColourCommandBuffers;
+	std::vector<CommandBuffer> m_GeometryCommandBuffers;	// The lit objects, drawn into the G-buffer when deferred shading is on.
+	bool m_ValidateCommandBuffers = false;
+	bool m_RecordFrameStatistics = false;
+	std::vector<FrameStatistics> m_FrameStatistics;
+
+	std::shared_ptr<Shader> m_DepthShader;
+	std::shared_ptr<Shader> m_LitShader;	// Objects drawn with this shader are the ones deferred shading takes over.
+	std::shared_ptr<Shader> m_GeometryShader;
+	std::shared_ptr<DeferredRenderer> m_DeferredRenderer;
+	std::shared_ptr<ShadowRenderer> m_ShadowRenderer;
+	std::shared_ptr<TextRenderer> m_TextRenderer;
+	std::shared_ptr<GPUProfiler> m_GPUProfiler;
+	std::shared_ptr<DynamicResolutionController> m_ResolutionController;
+	// The smoothed whole frame GPU time in each anti-aliasing mode, once it's been used, to compare what each costs.
+	std::array<float, static_cast<size_t>(AntiAliasingMode::COUNT)> m_AntiAliasingMilliseconds = {};
+	AntiAliasingMode m_MeasuredAntiAliasing = AntiAliasingMode::NONE;
+	unsigned int m_FramesInAntiAliasingMode = 0;
+	std::shared_ptr<FrameCapture> m_FrameCapture;
+	std::shared_ptr<StreamingBuffer> m_StreamingBuffer;
+	std::shared_ptr<StreamingBuffer> m_LightBuffer;
+	std::shared_ptr<StreamingBuffer> m_ClusterBuffer;
+
+	static const size_t s_m_MinimumDrawsPerSlice = 64;
+	static const size_t s_m_MaxLights = 4096;
+	static const size_t s_m_MaxClusterLightIndices = LightClusterBinner::s_m_ClusterCount * 64;
+	static const int s_m_MSAASampleCount = 4;
+	static const unsigned int s_m_AntiAliasingSettleFrames = 4;	// The GPU profiler's results still measure the old mode for a few frames after a change.
 
 	float m_FarClippingPlane = 100.0f;
 	float m_NearClippingPlane = 0.1f;
 	float m_DeltaTime = 0.0f;
+	float m_TimingReportInterval = 2.0f;
+	float m_TimeSinceSimulationReport = 0.0f;
+	float m_TimeSinceRenderReport = 0.0f;
+	int m_ViewportWidth = 0;
+	int m_ViewportHeight = 0;
 
 	bool m_IsRunning = true;
-	bool m_UseBlinnPhong = true;
-	bool m_UseNormalMap = true;
-	bool m_UseToonShading = true;
-	bool m_ShowNormalMap = false;
+
+	void BuildFrameGraph();
+	// Prints the message, and shows it on screen for a while.
+	void ShowStatus(const std::string &p_Message);
+	glm::mat4 GetProjectionMatrix() const;
+	void UploadFrameData(const FramePacket &p_Packet);
+	unsigned int UploadLights(const FramePacket &p_Packet);
+	void UploadLightClusters(const FramePacket &p_Packet);
+	StreamingBuffer::Allocation UploadObjectData(const FramePacket &p_Packet, const DrawPacket &p_DrawPacket, size_t p_MeshIndex);
+	void RecordCommandBuffers(const FramePacket &p_Packet, JobSystem &p_JobSystem);
+	void RecordDrawPacket(const FramePacket &p_Packet, const DrawPacket &p_DrawPacket, CommandBuffer *p_DepthCommands, CommandBuffer &p_ColourCommands, CommandBuffer *p_GeometryCommands);
+	void ValidateCommandBuffers() const;
+	void ReportSimulationTimings();
+	void UpdateAntiAliasing(const RenderSettings &p_Settings);
+	void ReportRenderTimings(const FramePacket &p_Packet);
+	void RecordFrameStatistics(const FramePacket &p_Packet, float p_RenderMilliseconds);
 
 public:
-	Scene(std::shared_ptr<Window> p_Window);
+	static const unsigned int s_m_DefaultStreamingBufferRegionSize = 64 * 1024;
+
+	// Without the default entities the scene starts empty, for the benchmarks to fill. The streaming buffer region must hold a frame's object data.
+	Scene(std::shared_ptr<Window> p_Window, bool p_CreateDefaultEntities = true, unsigned int p_StreamingBufferRegionSize = s_m_DefaultStreamingBufferRegionSize);
 	~Scene() = default;
 
+	// The first light created lights the scene. With a parent, the position and scale are relative to the parent's.
+	Entity CreateRenderableEntity(const glm::vec3 &p_Position, const glm::vec3 &p_Scale, const std::string &p_ModelName, const std::string &p_ShaderName, const glm::vec3 &p_Colour,
+		bool p_IsLight = false, Entity p_Parent = Entity());
+
 	void HandleMouseInput(float p_XPosition, float p_YPosition);
 	void HandleKeyboardInput(std::vector<bool> &p_KeyPressBuffer, std::vector<bool> &p_KeyReleaseBuffer);
-	void Update(float p_DeltaTime);
-	void Render();
+	void Update(float p_DeltaTime, FramePacket &p_Packet);
+	void Render(const FramePacket &p_Packet, JobSystem &p_JobSystem);
+
+	JobSystem &GetJobSystem();
+	void SetCommandBufferValidation(bool p_IsEnabled);
+	std::shared_ptr<Camera> GetCamera();
+	// The settings handed to the render thread with each frame, only change them from the simulation thread.
+	RenderSettings &GetRenderSettings();
+	// Changes a light's attenuation, which also changes how far deferred shading lets it reach.
+	void SetLightAttenuation(Entity p_LightEntity, const glm::vec3 &p_Attenuation);
+	// The direction is the way the sunlight travels.
+	void SetSun(const glm::vec3 &p_Direction, const glm::vec3 &p_Colour);
+	// Static casters are cached in the shadow maps, so only mark objects static if they rarely move.
+	void SetShadowCasterStatic(Entity p_Entity, bool p_IsStatic);
+
+	// Must be set before the render thread starts, and the statistics read once it has stopped.
+	void SetFrameStatisticsRecording(bool p_IsEnabled);
+	const std::vector<FrameStatistics> &GetFrameStatistics() const;
+	// Only the render thread may read the timings while it's running.
+	const GPUProfiler &GetGPUProfiler() const;
+	// Captures every frame from then on, it must be started before the render thread, on the thread that owns the GL context.
+	void StartFrameCapture(CaptureFormat p_Format, const std::string &p_OutputPath);
 
 	bool IsRunning() const;
 };
\ No newline at end of file
@@ -16,6 +16,7 @@ public:
 	Shader();
 
 	bool Compile(const GLchar *p_VertexPath, const GLchar *p_FragmentPath, const GLchar *p_GeometryPath = nullptr);
+	bool CompileCompute(const GLchar *p_ComputePath);
 
 	Shader &Use();
 
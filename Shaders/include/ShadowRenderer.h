@@ -0,0 +1,194 @@
+/**
+@file ShadowRenderer.h
+@brief Cascaded shadow maps for the sun, and a cube map for the scene's light, with the static casters cached between frames.
+*/
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <glm/glm.hpp>
+
+#include "CommandBuffer.h"
+#include "StreamingBuffer.h"
+
+struct FramePacket;
+struct ShadowCaster;
+class JobSystem;
+class Shader;
+
+/*! \class ShadowRenderer
+	\brief Draws the shadow casters into the sun's cascades, and the scene light's cube map, redrawing as little as it can.
+
+	Each map has a cache holding only the static casters. It's only redrawn when the light changes, the map has to
+	move, or a static caster inside it moves. Otherwise the cache is copied into the map, and only the moving
+	casters are drawn over it. When nothing moves, even the copy is skipped.
+
+	Each cascade bounds its slice of the view frustum with a sphere, which doesn't change size as the camera turns.
+	The map covers a window a little larger than the sphere, snapped to whole texels, and only moves once the sphere
+	leaves it, so panning the camera doesn't redraw anything. The slices only reach as far as the furthest visible
+	receiver. Casters between the sun and the window are flattened onto its near plane by depth clamping, so the
+	window's depth only has to cover the receivers. Each map only draws the casters that overlap it.
+
+	The cube map is drawn in one pass, with a geometry shader sending each triangle to the faces it lands on.
+*/
+class ShadowRenderer {
+public:
+	static const unsigned int s_m_CascadeCount = 4;	//!< The number of cascades, which must match shadows.glsl.
+	static const int s_m_CascadeTextureUnit = 8;	//!< The texture unit the cascades are bound to, clear of the materials'.
+	static const int s_m_PointTextureUnit = 9;	//!< The texture unit the cube map is bound to.
+
+private:
+	static const int s_m_CascadeResolution = 2048;	//!< The width and height of each cascade.
+	static const int s_m_PointResolution = 1024;	//!< The width and height of each cube map face.
+	static const unsigned int s_m_ViewCount = s_m_CascadeCount + 1;	//!< The number of maps: the cascades, then the cube map.
+	static const unsigned int s_m_PointView = s_m_CascadeCount;	//!< The index of the cube map, among the maps.
+	static const size_t s_m_MaxDrawsPerFrame = 16384;	//!< The number of casters' object data that fit in a frame.
+	static const float s_m_MinShadowDistance;	//!< The least distance the cascades cover, however close the receivers are.
+	static const float s_m_MaxShadowDistance;	//!< The furthest distance the cascades cover.
+	static const float s_m_SplitBlend;	//!< How far the splits lean from evenly spaced towards logarithmic.
+	static const float s_m_CacheMargin;	//!< How much larger than its sphere a cascade's window is, as a fraction of the radius.
+	static const float s_m_SlopeBias;	//!< The polygon offset factor the cascades are drawn with.
+	static const float s_m_ConstantBias;	//!< The polygon offset units the cascades are drawn with.
+	static const float s_m_PointNearPlane;	//!< The cube map's near plane.
+	static const float s_m_MaxPointShadowDistance;	//!< The furthest the cube map reaches, however far the light does.
+
+	/**
+		* One map the casters are drawn into, a cascade or the cube map, and its cache.
+	*/
+	struct ShadowView {
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);	//!< Stores the matrix from world space into a cascade, unused by the cube map.
+		bool m_IsActive = false;	//!< Stores whether the map is drawn and read this frame.
+		bool m_IsCacheValid = false;	//!< Stores whether the cache holds the static casters, as they are this frame.
+		bool m_IsCacheComplete = true;	//!< Stores whether every static caster recorded this frame fit in the object buffer.
+		bool m_HasMovingCasters = false;	//!< Stores whether the map holds moving casters, so differs from the cache.
+		CommandBuffer m_StaticCommands;	//!< Stores the static casters, recorded only when the cache is redrawn.
+		CommandBuffer m_MovingCommands;	//!< Stores the moving casters, recorded every frame.
+	};
+
+	/**
+		* The region a cascade's map covers, in the light's space. It's larger than the cascade needs, so the camera can move a little before it has to be redrawn.
+	*/
+	struct CascadeWindow {
+		glm::vec2 m_Centre = glm::vec2(0.0f);	//!< Stores the centre, across the light.
+		float m_HalfSize = 0.0f;	//!< Stores half the width.
+		float m_Bottom = 0.0f;	//!< Stores the depth furthest from the sun.
+		float m_Top = 0.0f;	//!< Stores the depth nearest the sun.
+	};
+
+	unsigned int m_FrameBufferObject = 0;	//!< Stores the ID of the depth only framebuffer, each map is attached as it's drawn.
+	unsigned int m_CascadeTexture = 0;	//!< Stores the ID of the cascades' array texture, the one the shaders read.
+	unsigned int m_CascadeCacheTexture = 0;	//!< Stores the ID of the cascades' static caster caches.
+	unsigned int m_PointTexture = 0;	//!< Stores the ID of the cube map the shaders read.
+	unsigned int m_PointCacheTexture = 0;	//!< Stores the ID of the cube map's static caster cache.
+
+	std::shared_ptr<Shader> m_CascadeShader;	//!< Stores the shader that draws depth into a cascade.
+	std::shared_ptr<Shader> m_PointShader;	//!< Stores the shader that draws distance into every face of the cube map.
+	std::shared_ptr<StreamingBuffer> m_ObjectBuffer;	//!< Stores the casters' object data, and the shadow data.
+
+	std::array<ShadowView, s_m_ViewCount> m_Views;	//!< Stores the maps.
+	std::array<CascadeWindow, s_m_CascadeCount> m_CascadeWindows;	//!< Stores the region each cascade covers.
+	std::array<float, s_m_CascadeCount> m_CascadeSplits;	//!< Stores the view depth each cascade reaches to.
+	glm::mat4 m_LightRotation = glm::mat4(1.0f);	//!< Stores the rotation into the sun's space.
+	glm::vec3 m_SunDirection = glm::vec3(0.0f);	//!< Stores the direction the caches were drawn with.
+	glm::vec4 m_PointPositionFar = glm::vec4(0.0f);	//!< Stores the position and far plane the cube map's cache was drawn with.
+	std::array<glm::mat4, 6> m_FaceViewProjections;	//!< Stores the matrix into each face of the cube map.
+
+	unsigned int m_CacheRedrawCount = 0;	//!< Stores the number of times any cache has been redrawn.
+	unsigned int m_StaticDrawCount = 0;	//!< Stores the number of static caster draws, in the last frame.
+	unsigned int m_MovingDrawCount = 0;	//!< Stores the number of moving caster draws, in the last frame.
+
+	void CreateTextures();
+	/*!
+		\brief Works out each cascade's depth range and window, and which caches the camera or the sun have invalidated.
+		\param p_Packet the frame.
+		\param p_NearPlane the camera's near plane.
+	*/
+	void FitCascades(const FramePacket &p_Packet, float p_NearPlane);
+	/*!
+		\brief Moves the cube map to the scene's light, invalidating its cache if the light has moved.
+		\param p_Packet the frame.
+	*/
+	void FitPointLight(const FramePacket &p_Packet);
+	/*!
+		\brief Tests whether a sphere overlaps a map, a cascade's window or the cube map's range.
+		\param p_View the index of the map.
+		\param p_Bounds the sphere, the centre then the radius.
+		\return Returns true if it overlaps.
+	*/
+	bool Overlaps(unsigned int p_View, const glm::vec4 &p_Bounds) const;
+	/*!
+		\brief Culls the casters against a map, and records the ones it needs this frame.
+		\param p_View the index of the map.
+		\param p_Packet the frame.
+	*/
+	void RecordView(unsigned int p_View, const FramePacket &p_Packet);
+	/*!
+		\brief Records drawing a caster's meshes, with their object data written into this frame's region.
+		\param p_Commands the commands to record into.
+		\param p_Caster the caster.
+		\param p_Program the program to draw with.
+		\return Returns false if the object data didn't fit.
+	*/
+	bool RecordCaster(CommandBuffer &p_Commands, const ShadowCaster &p_Caster, unsigned int p_Program);
+	/*!
+		\brief Draws a map's cache if needed, copies it into the map, then draws the moving casters.
+		\param p_View the map.
+		\param p_Target the texture target of both textures.
+		\param p_CacheTexture the cache.
+		\param p_Texture the map.
+		\param p_Layer the layer of a cascade, or zero for the cube map.
+		\param p_LayerCount the number of layers drawn.
+		\param p_Resolution the width and height of a layer.
+	*/
+	void RenderView(ShadowView &p_View, unsigned int p_Target, unsigned int p_CacheTexture, unsigned int p_Texture, int p_Layer, int p_LayerCount, int p_Resolution);
+
+public:
+	ShadowRenderer();
+	~ShadowRenderer();
+
+	/*!
+		\brief Moves the object buffer on to the next frame's region.
+	*/
+	void BeginFrame();
+	/*!
+		\brief Fits the maps, culls and records the casters across the job system, and binds the shadow data for the shaders.
+		\param p_Packet the frame, whose settings say whether there are shadows at all.
+		\param p_NearPlane the camera's near plane.
+		\param p_JobSystem the job system to spread the maps across.
+	*/
+	void Prepare(const FramePacket &p_Packet, float p_NearPlane, JobSystem &p_JobSystem);
+	/*!
+		\brief Draws the sun's cascades, leaving the viewport for the caller to restore.
+	*/
+	void RenderCascades();
+	/*!
+		\brief Draws the scene light's cube map, leaving the viewport for the caller to restore.
+	*/
+	void RenderPointLight();
+	/*!
+		\brief Binds the maps to their texture units, for the lighting passes.
+	*/
+	void BindTextures() const;
+	/*!
+		\brief Fences the object buffer, must be called after the last command that reads this frame's data.
+	*/
+	void EndFrame();
+
+	unsigned int GetCacheRedrawCount() const {
+		return m_CacheRedrawCount;
+	}
+	unsigned int GetStaticDrawCount() const {
+		return m_StaticDrawCount;
+	}
+	unsigned int GetMovingDrawCount() const {
+		return m_MovingDrawCount;
+	}
+	unsigned int GetFailedAllocationCount() const {
+		return m_ObjectBuffer->GetFailedAllocationCount();
+	}
+
+	// Delete the copy and assignment operators.
+	ShadowRenderer(ShadowRenderer const&) = delete; //!< Copy operator, deleted.
+	ShadowRenderer& operator=(ShadowRenderer const&) = delete; //!< Assignment operator, deleted.
+};
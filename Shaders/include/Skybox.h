@@ -1,24 +1,69 @@
+/**
+@file Skybox.h
+@brief The sky drawn behind the scene, and the image based ambient lighting baked from it.
+*/
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "EnvironmentBaker.h"
+
+class JobSystem;
 class Shader;
 
+/*! \class Skybox
+	\brief Draws the sky as one triangle over the screen at the far plane, and owns the lighting maps baked from it.
+
+	The sky's direction at each pixel is rebuilt from the inverse view projection, so no cube is drawn and the sky
+	never has a size the camera could reach. The irradiance and prefiltered maps are read from the bake's cache when
+	the sky's files haven't changed, and baked on the CPU when they have.
+*/
 class Skybox {
+public:
+	static const int s_m_IrradianceTextureUnit = 10;	//!< The texture unit the irradiance map is bound to, clear of the shadow maps'.
+	static const int s_m_PrefilteredTextureUnit = 11;	//!< The texture unit the prefiltered map is bound to.
+
 private:
-	static const float m_SkyboxSize;
-	static const unsigned int m_SkyboxNumberOfVertices = 108;
-	float m_SkyboxVertices[m_SkyboxNumberOfVertices];
+	static const std::string s_m_CachePath;	//!< The path the bake is cached at, in a folder of generated files kept out of the resources.
 
-	std::shared_ptr<Shader> m_Shader;
-	unsigned int m_CubeMapTextureID;
-	unsigned int m_SkyBoxVBO;
-	unsigned int m_SkyBoxVAO;
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the sky's shader.
+	EnvironmentBaker m_Baker;	//!< Stores the baker, and what it baked.
+	unsigned int m_CubeMapTextureID = 0;	//!< Stores the ID of the sky's cube map.
+	unsigned int m_IrradianceTextureID = 0;	//!< Stores the ID of the irradiance map.
+	unsigned int m_PrefilteredTextureID = 0;	//!< Stores the ID of the prefiltered map.
+	unsigned int m_EmptyVertexArrayObject = 0;	//!< Stores a vertex array with no attributes, for the full-screen triangle.
 
-	void Prepare();
+	/*!
+		\brief Reads the sky's faces back from its cube map, for the baker.
+		\return Returns the sky, or a grey one the size of a texel if the faces couldn't be loaded.
+	*/
+	CubeMapImage ReadBackSky() const;
+	/*!
+		\brief Uploads the baked maps into their cube maps.
+	*/
+	void CreateEnvironmentTextures();
 
 public:
-	Skybox();
+	/*!
+		\brief Loads the sky, and reads its lighting maps from the cache, or bakes them.
+		\param p_JobSystem the job system the bake is split across.
+	*/
+	Skybox(JobSystem &p_JobSystem);
+	~Skybox();
 
 	void Render();
-};
\ No newline at end of file
+	/*!
+		\brief Binds the irradiance and prefiltered maps, to their texture units, for the lit shaders.
+	*/
+	void BindTextures() const;
+
+	const EnvironmentBaker &GetBaker() const {
+		return m_Baker;
+	}
+
+	// Delete the copy and assignment operators.
+	Skybox(Skybox const&) = delete; //!< Copy operator, deleted.
+	Skybox& operator=(Skybox const&) = delete; //!< Assignment operator, deleted.
+};
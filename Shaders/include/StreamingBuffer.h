@@ -0,0 +1,126 @@
+/**
+@file StreamingBuffer.h
+@brief A ring buffer, for data that's written by the CPU every frame and read by the GPU.
+*/
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <glad/glad.h>
+
+/*! \class StreamingBuffer
+	\brief A ring buffer, for data that's written by the CPU every frame and read by the GPU.
+
+	The buffer is split into one region per frame in flight. Each region is guarded by a fence, so the CPU only
+	writes into a region once the GPU has finished reading from it. When glBufferStorage is available the
+	buffer is persistently and coherently mapped, otherwise the writes are staged and uploaded by Flush().
+
+	Allocate may be called from any thread, so workers can write their own data while recording commands.
+	Everything else, including Flush, must be called from the thread that owns the OpenGL context.
+*/
+class StreamingBuffer {
+public:
+	/**
+		* A sub-allocation handed out for the current frame.
+	*/
+	struct Allocation {
+		void *m_Data = nullptr;	//!< Stores where the CPU should write the data.
+		unsigned int m_Buffer = 0;	//!< Stores the ID of the buffer object the allocation lives in.
+		GLintptr m_Offset = 0;	//!< Stores the offset into the buffer object, for binding.
+		GLsizeiptr m_Size = 0;	//!< Stores the size of the allocation.
+
+		bool IsValid() const {
+			return m_Data != nullptr;
+		}
+	};
+
+private:
+	unsigned int m_BufferObject;	//!< Stores the ID of the buffer object.
+	GLenum m_Target;	//!< Stores the target the buffer is bound to, when it's written.
+	GLsizeiptr m_RegionSize;	//!< Stores the size of each frame's region.
+	unsigned int m_RegionCount;	//!< Stores the number of regions (frames in flight).
+	unsigned int m_CurrentRegion = 0;	//!< Stores the region written to this frame.
+	std::atomic<GLsizeiptr> m_RegionOffset{ 0 };	//!< Stores the offset of the next allocation, inside the current region.
+	GLsizeiptr m_FlushedOffset = 0;	//!< Stores how much of the current region has been uploaded, when staging.
+
+	bool m_IsPersistentlyMapped;	//!< Stores whether the buffer is persistently mapped.
+	unsigned char *m_MappedData = nullptr;	//!< Stores the CPU address of the buffer, or of the staging copy.
+	std::vector<unsigned char> m_StagingData;	//!< Stores the writes, when the buffer can't be persistently mapped.
+	std::vector<GLsync> m_RegionFences;	//!< Stores a fence for each region, signalled when the GPU is done with it.
+
+	unsigned int m_StallCount = 0;	//!< Stores how many times the CPU had to wait for the GPU.
+	double m_StallMilliseconds = 0.0;	//!< Stores the total time spent waiting for the GPU.
+	std::atomic<unsigned int> m_FailedAllocationCount{ 0 };	//!< Stores how many allocations didn't fit inside their region.
+	GLint m_BindingAlignment;	//!< Stores the alignment glBindBufferRange needs on the buffer's target, queried once so workers don't need the context.
+
+	/*!
+		\brief Waits until the GPU has finished reading from a region.
+		\param p_Region the region to wait for.
+	*/
+	void WaitForRegion(unsigned int p_Region);
+
+public:
+	/*!
+		\brief Queries the alignment glBindBufferRange needs, for a buffer target.
+		\param p_Target the buffer target.
+		\return Returns the alignment, which is one for targets that aren't bound by range.
+	*/
+	static GLint QueryBindingAlignment(GLenum p_Target);
+
+	/*!
+		\brief Constructor.
+		\param p_Target the buffer target, such as GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+		\param p_RegionSize the number of bytes available to each frame.
+		\param p_RegionCount the number of frames that can be in flight.
+	*/
+	StreamingBuffer(GLenum p_Target, GLsizeiptr p_RegionSize, unsigned int p_RegionCount = 3);
+	~StreamingBuffer();
+
+	/*!
+		\brief Moves on to the next region, waiting for the GPU if it's still reading from it.
+	*/
+	void BeginFrame();
+	/*!
+		\brief Fences the current region, must be called after the last command that reads this frame's data.
+	*/
+	void EndFrame();
+
+	/*!
+		\brief Hands out space in the current region, safe to call from any thread.
+		\param p_Size the number of bytes needed.
+		\param p_Alignment the alignment the offset must have, for binding.
+		\return Returns the allocation, which is invalid if the region is full.
+	*/
+	Allocation Allocate(GLsizeiptr p_Size, GLsizeiptr p_Alignment);
+	/*!
+		\brief Hands out space in the current region, aligned for glBindBufferRange on the buffer's target.
+		\param p_Size the number of bytes needed.
+		\return Returns the allocation, which is invalid if the region is full.
+	*/
+	Allocation AllocateForBinding(GLsizeiptr p_Size);
+	/*!
+		\brief Makes the data written so far visible to the GPU, must be called before it's read.
+	*/
+	void Flush();
+
+	unsigned int GetStallCount() const {
+		return m_StallCount;
+	}
+	double GetStallMilliseconds() const {
+		return m_StallMilliseconds;
+	}
+	unsigned int GetFailedAllocationCount() const {
+		return m_FailedAllocationCount.load();
+	}
+	GLint GetBindingAlignment() const {
+		return m_BindingAlignment;
+	}
+	bool IsPersistentlyMapped() const {
+		return m_IsPersistentlyMapped;
+	}
+
+	// Delete the copy and assignment operators.
+	StreamingBuffer(StreamingBuffer const&) = delete; //!< Copy operator, deleted.
+	StreamingBuffer& operator=(StreamingBuffer const&) = delete; //!< Assignment operator, deleted.
+};
\ No newline at end of file
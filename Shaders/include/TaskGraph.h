@@ -0,0 +1,74 @@
+/**
+@file TaskGraph.h
+@brief A graph of tasks and the dependencies between them, built once and run on the job system every frame.
+*/
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+using TaskHandle = unsigned int;
+
+/*! \class TaskGraph
+	\brief A graph of tasks, each task is queued as a job as soon as every task it depends on has finished.
+*/
+class TaskGraph {
+private:
+	/**
+		* A task, the tasks that wait on it, and how long it last took.
+	*/
+	struct Task {
+		std::string m_Name;	//!< Stores the task's name, for reporting.
+		const char *m_ProfileName = nullptr;	//!< Stores the task's name, interned so the CPU profiler's events can keep it.
+		std::function<void()> m_Function;	//!< Stores the task's work.
+		std::vector<TaskHandle> m_Successors;	//!< Stores the tasks that depend on this one.
+		unsigned int m_DependencyCount = 0;	//!< Stores the number of tasks this one depends on.
+		std::atomic<unsigned int> m_RemainingDependencies{ 0 };	//!< Stores the number of dependencies yet to finish, this run.
+		float m_Milliseconds = 0.0f;	//!< Stores how long the task took, last run.
+	};
+
+	std::vector<std::unique_ptr<Task>> m_Tasks;	//!< Stores every task.
+
+	void RunTask(JobSystem &p_JobSystem, TaskHandle p_Task, JobCounter &p_Counter);
+
+public:
+	TaskGraph() = default;
+
+	/*!
+		\brief Adds a task to the graph.
+		\param p_Name the task's name.
+		\param p_Function the task's work, it can use the job system itself to go wider.
+		\return Returns the task's handle.
+	*/
+	TaskHandle AddTask(const std::string &p_Name, std::function<void()> p_Function);
+	/*!
+		\brief Makes one task wait for another to finish.
+		\param p_Before the task that runs first.
+		\param p_After the task that waits.
+	*/
+	void AddDependency(TaskHandle p_Before, TaskHandle p_After);
+	/*!
+		\brief Runs every task, in dependency order, and waits for them all to finish.
+		\param p_JobSystem the job system to run the tasks on.
+	*/
+	void Execute(JobSystem &p_JobSystem);
+
+	size_t GetTaskCount() const {
+		return m_Tasks.size();
+	}
+	const std::string &GetTaskName(TaskHandle p_Task) const {
+		return m_Tasks[p_Task]->m_Name;
+	}
+	float GetTaskMilliseconds(TaskHandle p_Task) const {
+		return m_Tasks[p_Task]->m_Milliseconds;
+	}
+
+	// Delete the copy and assignment operators.
+	TaskGraph(TaskGraph const&) = delete; //!< Copy operator, deleted.
+	TaskGraph& operator=(TaskGraph const&) = delete; //!< Assignment operator, deleted.
+};
@@ -0,0 +1,113 @@
+/**
+@file TextRenderer.h
+@brief Draws every string queued during a frame, in one draw, from a glyph atlas.
+*/
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <glm/glm.hpp>
+
+#include "GlyphAtlas.h"
+#include "StreamingBuffer.h"
+
+class Shader;
+
+/*! \class TextRenderer
+	\brief Lays strings out into quads as they're added, then draws them all at once over the frame.
+
+	Each string's quads go into one list on the CPU, coloured per vertex, so strings in different colours and sizes
+	still batch together. Rendering copies the list into a streaming vertex buffer, and draws every quad with one
+	draw call, from whichever atlas is in use. The bitmap atlas is sharpest at small sizes, the distance field atlas
+	serves every size from one set of glyphs, and stays smooth when scaled up.
+
+	The strings' bytes are taken as characters, which covers ASCII and Latin-1.
+*/
+class TextRenderer {
+public:
+	static const unsigned int s_m_MaxCharactersPerFrame = 8192;	//!< The characters the vertex buffer has room for each frame.
+
+private:
+	/**
+		* A corner of a glyph's quad, laid out as font.vert reads it.
+	*/
+	struct TextVertex {
+		glm::vec2 m_Position;	//!< Stores the position, in pixels from the top left of the screen.
+		glm::vec2 m_TextureCoords;	//!< Stores the position in the atlas.
+		unsigned int m_Colour;	//!< Stores the colour, packed into four bytes.
+	};
+
+	FT_Library m_Library = nullptr;	//!< Stores the FreeType library.
+	FT_Face m_Face = nullptr;	//!< Stores the font.
+	std::unique_ptr<GlyphAtlas> m_BitmapAtlas;	//!< Stores the glyphs rasterised at each size drawn.
+	std::unique_ptr<GlyphAtlas> m_DistanceFieldAtlas;	//!< Stores the glyphs as distance fields, for every size.
+	bool m_UseDistanceField = false;	//!< Stores whether text is laid out and drawn from the distance field atlas.
+
+	std::shared_ptr<Shader> m_Shader;	//!< Stores the text's shader.
+	std::unique_ptr<StreamingBuffer> m_VertexBuffer;	//!< Stores each frame's vertices.
+	unsigned int m_VertexArrayObject = 0;	//!< Stores the vertex layout.
+	std::vector<TextVertex> m_Vertices;	//!< Stores the quads added since the last render.
+	unsigned int m_DroppedCharacterCount = 0;	//!< Stores the characters that didn't fit in the vertex buffer.
+	unsigned int m_LastDrawCharacterCount = 0;	//!< Stores the characters drawn by the last render.
+
+	GlyphAtlas &GetAtlas() const {
+		return m_UseDistanceField ? *m_DistanceFieldAtlas : *m_BitmapAtlas;
+	}
+
+public:
+	/*!
+		\brief Loads the font, and creates both atlases, empty.
+		\param p_FontPath the font file's path.
+	*/
+	TextRenderer(const std::string &p_FontPath);
+	~TextRenderer();
+
+	/*!
+		\brief Lays a string out, adding its quads to this frame's.
+		\param p_Text the string, which starts a new line at each line break.
+		\param p_Position the top left of the first line, in pixels from the top left of the screen.
+		\param p_PixelHeight the font's size, in pixels.
+		\param p_Colour the colour, and opacity.
+	*/
+	void AddText(const std::string &p_Text, const glm::vec2 &p_Position, unsigned int p_PixelHeight, const glm::vec4 &p_Colour);
+	/*!
+		\brief Works out how far apart lines of text are.
+		\param p_PixelHeight the font's size, in pixels.
+		\return Returns the distance between one baseline and the next, in pixels.
+	*/
+	float GetLineHeight(unsigned int p_PixelHeight) const;
+	/*!
+		\brief Draws every string added since the last render, into the bound framebuffer, then clears them.
+		\param p_Width the framebuffer's width.
+		\param p_Height the framebuffer's height.
+	*/
+	void Render(int p_Width, int p_Height);
+
+	// Text added after a change is laid out from the other atlas, so change it before adding any for the frame.
+	void SetUseDistanceField(bool p_UseDistanceField) {
+		m_UseDistanceField = p_UseDistanceField;
+	}
+	bool IsUsingDistanceField() const {
+		return m_UseDistanceField;
+	}
+	const GlyphAtlas &GetBitmapAtlas() const {
+		return *m_BitmapAtlas;
+	}
+	const GlyphAtlas &GetDistanceFieldAtlas() const {
+		return *m_DistanceFieldAtlas;
+	}
+	unsigned int GetDroppedCharacterCount() const {
+		return m_DroppedCharacterCount;
+	}
+	unsigned int GetLastDrawCharacterCount() const {
+		return m_LastDrawCharacterCount;
+	}
+
+	// Delete the copy and assignment operators.
+	TextRenderer(TextRenderer const&) = delete; //!< Copy operator, deleted.
+	TextRenderer& operator=(TextRenderer const&) = delete; //!< Assignment operator, deleted.
+};
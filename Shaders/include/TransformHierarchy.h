@@ -0,0 +1,113 @@
+/**
+@file TransformHierarchy.h
+@brief Stores a hierarchy of transforms, and keeps their world matrices up to date.
+*/
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+using TransformHandle = unsigned int;
+static const TransformHandle s_InvalidTransform = static_cast<TransformHandle>(~0u);
+
+/*! \class TransformHierarchy
+	\brief Stores a hierarchy of transforms, and keeps their world matrices up to date.
+
+	The local position, rotation and scale of each node are stored in separate arrays. A parent is always added
+	before its children, so the nodes are kept in topological order and the world matrices are updated in a
+	single pass. Only nodes whose local transform changed, and their descendants, are recalculated.
+*/
+class TransformHierarchy {
+private:
+	// Local transforms.
+	std::vector<glm::vec3> m_LocalPositions;	//!< Stores each node's position, relative to its parent.
+	std::vector<glm::quat> m_LocalRotations;	//!< Stores each node's rotation, relative to its parent.
+	std::vector<glm::vec3> m_LocalScales;	//!< Stores each node's scale, relative to its parent.
+	std::vector<TransformHandle> m_Parents;	//!< Stores each node's parent, which always has a lower index.
+
+	// Cached results.
+	std::vector<glm::mat4> m_WorldMatrices;	//!< Stores each node's world matrix.
+	std::vector<glm::mat3> m_NormalMatrices;	//!< Stores each node's normal matrix (inverse transpose of the world matrix).
+
+	std::vector<unsigned char> m_Dirty;	//!< Stores whether a node's local transform changed, since the last update.
+	std::vector<unsigned char> m_WorldChanged;	//!< Stores whether a node's world matrix changed, in the last update.
+
+public:
+	TransformHierarchy() = default;
+	~TransformHierarchy() = default;
+
+	/*!
+		\brief Reserves space for a number of nodes.
+		\param p_NodeCount the number of nodes.
+	*/
+	void Reserve(size_t p_NodeCount);
+
+	/*!
+		\brief Adds a node to the hierarchy.
+		\param p_Parent the parent node, or s_InvalidTransform for a root node.
+		\param p_Position the position, relative to the parent.
+		\param p_Rotation the rotation, relative to the parent.
+		\param p_Scale the scale, relative to the parent.
+		\return Returns a handle to the node.
+	*/
+	TransformHandle AddNode(TransformHandle p_Parent = s_InvalidTransform, const glm::vec3 &p_Position = glm::vec3(0.0f),
+		const glm::quat &p_Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3 &p_Scale = glm::vec3(1.0f));
+
+	/*!
+		\brief Recalculates the world and normal matrices, of the nodes that changed and their descendants.
+		\return Returns the number of nodes that were recalculated.
+	*/
+	unsigned int Update();
+	/*!
+		\brief Marks every node as changed, so the next update recalculates the whole hierarchy.
+	*/
+	void MarkAllDirty();
+	/*!
+		\brief Checks whether a matrix scales equally along each axis, so it can transform normals without the normal matrix.
+		\param p_Matrix the matrix.
+		\return Returns whether the scale is uniform, to within a small tolerance.
+	*/
+	static bool HasUniformScale(const glm::mat4 &p_Matrix);
+
+	void SetLocalPosition(TransformHandle p_Node, const glm::vec3 &p_Position) {
+		m_LocalPositions[p_Node] = p_Position;
+		m_Dirty[p_Node] = true;
+	}
+	const glm::vec3 &GetLocalPosition(TransformHandle p_Node) const {
+		return m_LocalPositions[p_Node];
+	}
+
+	void SetLocalRotation(TransformHandle p_Node, const glm::quat &p_Rotation) {
+		m_LocalRotations[p_Node] = p_Rotation;
+		m_Dirty[p_Node] = true;
+	}
+	const glm::quat &GetLocalRotation(TransformHandle p_Node) const {
+		return m_LocalRotations[p_Node];
+	}
+
+	void SetLocalScale(TransformHandle p_Node, const glm::vec3 &p_Scale) {
+		m_LocalScales[p_Node] = p_Scale;
+		m_Dirty[p_Node] = true;
+	}
+	const glm::vec3 &GetLocalScale(TransformHandle p_Node) const {
+		return m_LocalScales[p_Node];
+	}
+
+	TransformHandle GetParent(TransformHandle p_Node) const {
+		return m_Parents[p_Node];
+	}
+	const glm::mat4 &GetWorldMatrix(TransformHandle p_Node) const {
+		return m_WorldMatrices[p_Node];
+	}
+	const glm::mat3 &GetNormalMatrix(TransformHandle p_Node) const {
+		return m_NormalMatrices[p_Node];
+	}
+	bool HasWorldChanged(TransformHandle p_Node) const {
+		return m_WorldChanged[p_Node] != 0;
+	}
+	size_t GetNodeCount() const {
+		return m_Parents.size();
+	}
+};
\ No newline at end of file
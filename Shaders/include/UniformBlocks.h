@@ -0,0 +1,71 @@
+/**
+@file UniformBlocks.h
+@brief The CPU side layout of the uniform blocks, declared in resources/shaders/include/uniformBlocks.glsl.
+*/
+#pragma once
+
+#include <glm/glm.hpp>
+
+/**
+	* The binding points, of the uniform blocks shared by the shaders.
+*/
+enum class UniformBlockBinding : unsigned int {
+	FRAME_DATA = 0,
+	OBJECT_DATA,
+	SHADOW_DATA
+};
+
+/**
+	* The binding points, of the shader storage blocks shared by the shaders.
+*/
+enum class ShaderStorageBinding : unsigned int {
+	LIGHTS = 0,
+	CLUSTER_LIGHT_RANGES,
+	CLUSTER_LIGHT_INDICES,
+	LUMINANCE_HISTOGRAM
+};
+
+/**
+	* Data that's the same for every object drawn during a frame (std140 layout).
+*/
+struct FrameUniformData {
+	glm::mat4 m_Projection;	//!< Stores the projection matrix.
+	glm::mat4 m_View;	//!< Stores the view matrix.
+	glm::vec4 m_ViewPosition;	//!< Stores the camera's world position.
+	glm::mat4 m_InverseViewProjection;	//!< Stores the inverse of the projection and view matrices, to rebuild positions from depth.
+	glm::uvec4 m_ClusterGridSize;	//!< Stores the number of light clusters across, down and into the screen.
+	glm::vec4 m_ClusterParameters;	//!< Stores the depth slice scale and bias, then the clusters per pixel across and down.
+	glm::vec4 m_SunDirection;	//!< Stores the direction towards the sun.
+	glm::vec4 m_SunColour;	//!< Stores the sun's colour.
+};
+
+/**
+	* Data that's unique to each object drawn (std140 layout).
+*/
+struct ObjectUniformData {
+	glm::mat4 m_Model;	//!< Stores the model matrix.
+	glm::mat3x4 m_NormalMatrix;	//!< Stores the normal matrix, padded to match std140's mat3 layout.
+	glm::vec4 m_SurfaceColour;	//!< Stores the surface colour, used by the flat shader.
+	glm::vec4 m_ObjectLightPosition;	//!< Stores the light's position in object space, w is 1 when lighting can be done in object space.
+	glm::vec4 m_ObjectViewPosition;	//!< Stores the camera's position in object space.
+};
+
+/**
+	* Where the shadow maps are, and how to read them (std140 layout).
+*/
+struct ShadowUniformData {
+	glm::mat4 m_CascadeViewProjections[4];	//!< Stores the matrix from world space into each cascade.
+	glm::vec4 m_CascadeSplits;	//!< Stores the view depth each cascade reaches to.
+	glm::vec4 m_CascadeTexelSizes;	//!< Stores the world size of a texel, in each cascade.
+	glm::vec4 m_PointShadowPositionFar;	//!< Stores the position of the light the cube map was drawn from, and its far plane.
+	glm::uvec4 m_ShadowFlags;	//!< Stores whether the cascades, then the cube map, can be read.
+};
+
+/**
+	* A point light, as the lighting passes read it from the light buffer (std430 layout).
+*/
+struct PointLightData {
+	glm::vec4 m_PositionRadius;	//!< Stores the light's position, and its radius in w.
+	glm::vec4 m_Colour;	//!< Stores the light's colour.
+	glm::vec4 m_Attenuation;	//!< Stores the constant, linear and quadratic attenuation.
+};
\ No newline at end of file
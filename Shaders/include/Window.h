@@ -5,6 +5,7 @@
 #include <string>
 
 struct GLFWwindow;
+class HeadlessContext;
 
 class Window {
 private:
@@ -12,7 +13,8 @@ private:
 	static std::vector<bool> s_m_KeyReleaseBuffer;
 	static const int s_m_KeyBufferSize = 400;
 
-	GLFWwindow *m_Window;
+	GLFWwindow *m_Window = nullptr;
+	std::unique_ptr<HeadlessContext> m_HeadlessContext;
 	static double s_m_MouseXPosition;
 	static double s_m_MouseYPosition;
 	static int s_m_ScreenWidth;
@@ -24,11 +26,25 @@ private:
 	static void KeyCallbackEvent(GLFWwindow *p_Window, int p_Key, int p_ScanCode, int p_Action, int p_Mods);
 	static void WindowResizeCallbackEvent(GLFWwindow *p_Window, int p_Width, int p_Height);
 
+	// Loads the OpenGL functions, with GLAD, and sets up the state shared by every context.
+	bool InitializeOpenGL(void *(*p_Loader)(const char *p_Name));
+
 public:
-	Window() = default;
+	Window();
 	~Window();
 
 	bool InitializeWindow(int p_Width, int p_Height, const std::string &p_WindowName);
+	// Creates an OpenGL context without a window, for running on machines without a display or GPU.
+	bool InitializeHeadless(int p_Width, int p_Height, bool p_UseSoftwareRenderer = false);
+
+	// Only one thread can have the context current at a time.
+	bool MakeContextCurrent();
+	void ReleaseContext();
+	void SwapBuffers();
+
+	bool IsHeadless() const;
+	// The framebuffer the final image goes to, zero unless headless without a surface.
+	unsigned int GetFrameBufferObject() const;
 
 	GLFWwindow *GetWindow() const;
 
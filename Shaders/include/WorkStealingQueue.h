@@ -0,0 +1,97 @@
+/**
+@file WorkStealingQueue.h
+@brief A lock-free, fixed capacity, Chase-Lev work-stealing deque.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/*! \class WorkStealingQueue
+	\brief A Chase-Lev deque: the owning thread pushes and pops at the bottom, any other thread steals from the top.
+*/
+template<typename T>
+class WorkStealingQueue {
+private:
+	std::unique_ptr<std::atomic<T*>[]> m_Items;	//!< Stores the ring of items.
+	std::int64_t m_Mask;	//!< Stores the capacity minus one, the capacity is a power of two.
+	alignas(64) std::atomic<std::int64_t> m_Top{ 0 };	//!< Stores the index thieves steal from.
+	alignas(64) std::atomic<std::int64_t> m_Bottom{ 0 };	//!< Stores the index the owner pushes to.
+
+public:
+	/*!
+		\brief Constructor.
+		\param p_Capacity the maximum number of items, rounded up to a power of two.
+	*/
+	WorkStealingQueue(std::int64_t p_Capacity) {
+		std::int64_t capacity = 1;
+		while (capacity < p_Capacity)
+			capacity <<= 1;
+
+		m_Items.reset(new std::atomic<T*>[static_cast<size_t>(capacity)]);
+		m_Mask = capacity - 1;
+	}
+
+	/*!
+		\brief Adds an item to the bottom, only the owning thread may call this.
+		\return Returns false if the queue is full.
+	*/
+	bool Push(T *p_Item) {
+		std::int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		std::int64_t top = m_Top.load(std::memory_order_acquire);
+		if (bottom - top > m_Mask)
+			return false;
+
+		m_Items[bottom & m_Mask].store(p_Item, std::memory_order_relaxed);
+		m_Bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+		\brief Takes the most recently pushed item, only the owning thread may call this.
+		\return Returns the item, or null if the queue is empty.
+	*/
+	T *Pop() {
+		std::int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+		m_Bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t top = m_Top.load(std::memory_order_relaxed);
+
+		if (top > bottom) {
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T *item = m_Items[bottom & m_Mask].load(std::memory_order_relaxed);
+		if (top == bottom) {
+			// The last item: race any thieves for it.
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				item = nullptr;
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	/*!
+		\brief Takes the oldest item, any thread may call this.
+		\return Returns the item, or null if the queue is empty or another thread took it first.
+	*/
+	T *Steal() {
+		std::int64_t top = m_Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return nullptr;
+
+		T *item = m_Items[top & m_Mask].load(std::memory_order_relaxed);
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+
+		return item;
+	}
+
+	// Delete the copy and assignment operators.
+	WorkStealingQueue(WorkStealingQueue const&) = delete; //!< Copy operator, deleted.
+	WorkStealingQueue& operator=(WorkStealingQueue const&) = delete; //!< Assignment operator, deleted.
+};
@@ -10,47 +10,77 @@ in VS_OUT {
 	vec3 TangentLightPos;
 	vec3 TangentViewPos;
 	vec3 TangentFragPos;
+
+	mat3 WorldTBN;
 } fs_in;
 
-uniform sampler2D textureDiffuse0;
+// Named the way Mesh::BindTextures numbers them, from one for each type.
+uniform sampler2D textureDiffuse1;
 uniform sampler2D textureNormal1;
-uniform sampler2D textureSpecular2;
+uniform sampler2D textureSpecular1;
 
 uniform vec3 lightPosition;
 uniform vec3 lightAttenuation;
-uniform vec3 viewPosition;
+uniform vec3 lightColour;
 
-uniform bool blinn;
 uniform bool useNormalMap;
-uniform bool toonShading;
 uniform bool showNormalMap;
-
-uniform vec3 lightColour;
-uniform float ambientStrength;
-uniform float specularExponent;
-uniform float surfaceSpecularBrightness;
-
-// Toon shading.
-const float levels = 4.0f;
+uniform bool clusteredLighting;
+
+#include "include/uniformBlocks.glsl"
+#include "include/lights.glsl"
+#include "include/clusters.glsl"
+#include "include/lighting.glsl"
+#include "include/environment.glsl"
+#include "include/shadows.glsl"
+
+// Adds up the lights binned into this pixel's cluster, in world space.
+vec3 CalculateClusteredLights(vec3 surfaceColour, float specularIntensity, vec3 normal, vec3 viewDir, float viewDepth) {
+	uvec2 lightRange = clusterLightRanges[GetClusterIndex(gl_FragCoord.xy, viewDepth)];
+	vec3 colour = vec3(0.0f);
+	for (uint i = 0u; i < lightRange.y; i++) {
+		PointLight light = lights[clusterLightIndices[lightRange.x + i]];
+		vec3 toLight = light.positionRadius.xyz - fs_in.FragPos;
+		float distance = length(toLight);
+		// The cluster is only a bound, so some of its pixels are still out of the light's reach.
+		if (distance > light.positionRadius.w)
+			continue;
+
+		float attenuationFactor = CalculateAttenuation(light.attenuation.xyz, distance);
+		colour += CalculatePointLight(surfaceColour, specularIntensity, normal, toLight / distance, viewDir, light.colour.rgb, attenuationFactor, 1.0f);
+	}
+	return colour;
+}
 
 void main() {
-    vec3 surfaceColour = texture(textureDiffuse0, fs_in.TexCoords).rgb;
+    vec3 surfaceColour = texture(textureDiffuse1, fs_in.TexCoords).rgb;
+	float specularIntensity = texture(textureSpecular1, fs_in.TexCoords).r;
+
+	// The sun, and the shadows, are in world space whichever way the point lights are done.
+	vec3 worldNormal = fs_in.WorldTBN[2];
+	if (useNormalMap)
+		worldNormal = fs_in.WorldTBN * (texture(textureNormal1, fs_in.TexCoords).rgb * 2.0f - 1.0f);
+	worldNormal = normalize(worldNormal);
+	vec3 geometryNormal = normalize(fs_in.WorldTBN[2]);
+	vec3 worldViewDir = normalize(viewPosition.xyz - fs_in.FragPos);
+	float viewDepth = -(view * vec4(fs_in.FragPos, 1.0f)).z;
+
+	float sunShadow = CalculateSunShadow(fs_in.FragPos, geometryNormal, viewDepth);
+	vec3 sun = CalculatePointLight(surfaceColour, specularIntensity, worldNormal, sunDirection.xyz, worldViewDir, sunColour.rgb, 1.0f, sunShadow);
+	// Once for the pixel, not for each light, since it's the sky's light.
+	vec3 ambient = CalculateAmbient(surfaceColour, specularIntensity, worldNormal, worldViewDir);
+
+	if (clusteredLighting) {
+		FragSurfaceColour = vec4(ambient + sun + CalculateClusteredLights(surfaceColour, specularIntensity, worldNormal, worldViewDir, viewDepth), 1.0f);
+		if (showNormalMap)
+			FragSurfaceColour = vec4(vec3(texture(textureNormal1, fs_in.TexCoords).rgb), 1.0f);
+		return;
+	}
 
 	// Light attenuation.
 	float distance = length(lightPosition - fs_in.FragPos);
-	float attenuationFactor = lightAttenuation.x / (lightAttenuation.x + lightAttenuation.y * distance + lightAttenuation.z * (distance * distance));
-
-    // Ambient.
-    vec3 ambient = lightColour * surfaceColour * ambientStrength;
-
-	// Calculate ambient toon shading level.
-	float ambientEffect = length(ambient);
-	float level = floor(ambientEffect * levels);
-	ambientEffect = level / levels;
-
-	if (toonShading)
-		ambient = ambient * ambientEffect;
-	ambient *= attenuationFactor;
+	float attenuationFactor = CalculateAttenuation(lightAttenuation, distance);
+	float lightShadow = CalculatePointShadow(fs_in.FragPos, geometryNormal);
 
 	// Normal mapping.
 	vec3 normal = vec3(0.0f, 0.0f, 0.0f);
@@ -63,34 +93,9 @@ void main() {
 		normal = normalize(fs_in.Normal);
 	}
 
-    // Diffuse.
     vec3 lightDir = normalize(fs_in.TangentLightPos - fs_in.TangentFragPos);
-    float diff = max(dot(lightDir, normal), 0.0f);	// Brightness.
-	if (toonShading) {
-		level = floor(diff * levels);
-		diff = level / levels;
-	}
-    vec3 diffuse = (lightColour * diff * surfaceColour) * attenuationFactor;
-
-    // Specular.
     vec3 viewDir = normalize(fs_in.TangentViewPos - fs_in.TangentFragPos);
-    float spec = 0.0;
-    if (blinn) {
-        vec3 halfwayDir = normalize(lightDir + viewDir);  
-        spec = pow(max(dot(normal, halfwayDir), 0.0f), specularExponent);
-    }
-    else {
-        vec3 reflectDir = reflect(-lightDir, normal);
-        spec = pow(max(dot(viewDir, reflectDir), 0.0f), specularExponent);
-    }
-
-	if(toonShading) {
-		level = floor(spec * levels);
-		spec = level / levels;
-	}
-    vec3 specular = (lightColour * surfaceSpecularBrightness * spec) * attenuationFactor;
-	
-    FragSurfaceColour = vec4(ambient + diffuse + specular, 1.0f);
+    FragSurfaceColour = vec4(ambient + sun + CalculatePointLight(surfaceColour, specularIntensity, normal, lightDir, viewDir, lightColour, attenuationFactor, lightShadow), 1.0f);
 	if(showNormalMap)
 		FragSurfaceColour = vec4(vec3(texture(textureNormal1, fs_in.TexCoords).rgb), 1.0f);
-}
\ No newline at end of file
+}
@@ -4,7 +4,6 @@ layout (location = 0) in vec3 aPosition;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 layout (location = 3) in vec3 aTangent;
-layout (location = 4) in vec3 aBitangent;
 
 out VS_OUT {
     vec3 FragPos;
@@ -14,30 +13,55 @@ out VS_OUT {
 	vec3 TangentLightPos;
 	vec3 TangentViewPos;
 	vec3 TangentFragPos;
+
+	mat3 WorldTBN;
 } vs_out;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+#include "include/uniformBlocks.glsl"
 
 uniform vec3 lightPosition;
-uniform vec3 viewPosition;
+uniform bool clusteredLighting;
+
+invariant gl_Position;
 
 void main() {
 	vs_out.FragPos = vec3(model * vec4(aPosition, 1.0f));
 	vs_out.Normal = aNormal;
 	vs_out.TexCoords = aTexCoords;
 
-	mat3 normalMatrix = transpose(inverse(mat3(model)));
-	vec3 tangent = normalize(normalMatrix * aTangent);
-	vec3 normal = normalize(normalMatrix * aNormal);
+	vec3 tangent = normalize(aTangent);
+	vec3 normal = normalize(aNormal);
 	tangent = normalize(tangent - dot(tangent, normal) * normal);
 	vec3 bitangent = cross(normal, tangent);
+	// The sun, shadows and sky light in world space whichever way the point lights are done. The normal matrix, calculated once
+	// per object on the CPU, carries the frame there, the fragment shader normalises whatever it transforms with it.
+	vs_out.WorldTBN = normalMatrix * mat3(tangent, bitangent, normal);
+
+	if (clusteredLighting) {
+		// Clustered lighting loops over many lights, so it lights in world space rather than moving every light into tangent space.
+		vs_out.TangentLightPos = vec3(0.0f);
+		vs_out.TangentViewPos = vec3(0.0f);
+		vs_out.TangentFragPos = vec3(0.0f);
+	}
+	else if (objectLightPosition.w > 0.0f) {
+		// A rigid model matrix, with a uniform scale, doesn't change the angles between the tangent frame and the light.
+		// So the tangent frame can stay in object space, as the light and view positions were moved into object space once, on the CPU.
+		mat3 TBN = transpose(mat3(tangent, bitangent, normal));
+		vs_out.TangentLightPos = TBN * objectLightPosition.xyz;
+		vs_out.TangentViewPos = TBN * objectViewPosition.xyz;
+		vs_out.TangentFragPos = TBN * aPosition;
+	}
+	else {
+		// A non-uniform scale skews the frame, so it's made orthonormal again in world space, before positions are moved into it.
+		vec3 worldTangent = normalize(vs_out.WorldTBN[0]);
+		vec3 worldNormal = normalize(vs_out.WorldTBN[2]);
+		worldTangent = normalize(worldTangent - dot(worldTangent, worldNormal) * worldNormal);
 
-	mat3 TBN = transpose(mat3(tangent, bitangent, normal));
-	vs_out.TangentLightPos = TBN * lightPosition;
-	vs_out.TangentViewPos = TBN * viewPosition;
-	vs_out.TangentFragPos = TBN * vs_out.FragPos;
+		mat3 TBN = transpose(mat3(worldTangent, cross(worldNormal, worldTangent), worldNormal));
+		vs_out.TangentLightPos = TBN * lightPosition;
+		vs_out.TangentViewPos = TBN * viewPosition.xyz;
+		vs_out.TangentFragPos = TBN * vs_out.FragPos;
+	}
 	
 	gl_Position = projection * view * model * vec4(aPosition, 1.0);
 }
\ No newline at end of file
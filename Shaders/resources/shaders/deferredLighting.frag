@@ -0,0 +1,40 @@
+#version 430 core
+
+out vec4 FragColour;
+
+flat in int LightIndex;
+
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+#include "include/uniformBlocks.glsl"
+#include "include/lights.glsl"
+#include "include/lighting.glsl"
+#include "include/gBuffer.glsl"
+
+void main() {
+	// The light volume only picks the pixels, the surface comes from the G-buffer.
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+	if (depth >= 1.0f)
+		discard;
+
+	vec2 screenPosition = gl_FragCoord.xy / vec2(textureSize(gDepth, 0));
+	vec4 worldPosition = inverseViewProjection * vec4(vec3(screenPosition, depth) * 2.0f - 1.0f, 1.0f);
+	vec3 fragPosition = worldPosition.xyz / worldPosition.w;
+
+	PointLight light = lights[LightIndex];
+	vec3 toLight = light.positionRadius.xyz - fragPosition;
+	float distance = length(toLight);
+	if (distance > light.positionRadius.w)
+		discard;
+
+	vec4 albedoSpecular = texelFetch(gAlbedoSpecular, pixel, 0);
+	vec3 normal = DecodeNormal(texelFetch(gNormal, pixel, 0).rg);
+	vec3 lightDir = toLight / distance;
+	vec3 viewDir = normalize(viewPosition.xyz - fragPosition);
+	float attenuationFactor = CalculateAttenuation(light.attenuation.xyz, distance);
+
+	FragColour = vec4(CalculatePointLight(albedoSpecular.rgb, albedoSpecular.a, normal, lightDir, viewDir, light.colour.rgb, attenuationFactor, 1.0f), 1.0f);
+}
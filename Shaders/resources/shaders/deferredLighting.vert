@@ -0,0 +1,15 @@
+#version 430 core
+
+// A unit sphere, drawn once per light, scaled to the light's radius.
+layout (location = 0) in vec3 aPosition;
+
+flat out int LightIndex;
+
+#include "include/uniformBlocks.glsl"
+#include "include/lights.glsl"
+
+void main() {
+	vec4 positionRadius = lights[gl_InstanceID].positionRadius;
+	LightIndex = gl_InstanceID;
+	gl_Position = projection * view * vec4(positionRadius.xyz + aPosition * positionRadius.w, 1.0f);
+}
@@ -0,0 +1,35 @@
+#version 430 core
+
+out vec4 FragColour;
+
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+#include "include/uniformBlocks.glsl"
+#include "include/lighting.glsl"
+#include "include/environment.glsl"
+#include "include/gBuffer.glsl"
+#include "include/shadows.glsl"
+
+void main() {
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+	if (depth >= 1.0f)
+		discard;
+
+	vec2 screenPosition = gl_FragCoord.xy / vec2(textureSize(gDepth, 0));
+	vec4 worldPosition = inverseViewProjection * vec4(vec3(screenPosition, depth) * 2.0f - 1.0f, 1.0f);
+	vec3 fragPosition = worldPosition.xyz / worldPosition.w;
+
+	vec4 albedoSpecular = texelFetch(gAlbedoSpecular, pixel, 0);
+	vec3 normal = DecodeNormal(texelFetch(gNormal, pixel, 0).rg);
+	vec3 viewDir = normalize(viewPosition.xyz - fragPosition);
+	float viewDepth = -(view * vec4(fragPosition, 1.0f)).z;
+	// The G-buffer only keeps the mapped normal, which offsets the shadow lookup a little less evenly.
+	float shadow = CalculateSunShadow(fragPosition, normal, viewDepth);
+
+	// The sun's pass covers every pixel once, so the sky's ambient light is added here rather than by each light's volume.
+	vec3 ambient = CalculateAmbient(albedoSpecular.rgb, albedoSpecular.a, normal, viewDir);
+	FragColour = vec4(ambient + CalculatePointLight(albedoSpecular.rgb, albedoSpecular.a, normal, sunDirection.xyz, viewDir, sunColour.rgb, 1.0f, shadow), 1.0f);
+}
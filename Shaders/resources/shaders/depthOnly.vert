@@ -0,0 +1,12 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPosition;
+
+#include "include/uniformBlocks.glsl"
+
+// Must match the colour pass exactly, so the depth test can use GL_EQUAL.
+invariant gl_Position;
+
+void main() {
+	gl_Position = projection * view * model * vec4(aPosition, 1.0);
+}
\ No newline at end of file
@@ -1,9 +1,9 @@
 #version 430 core
 
-uniform vec3 surfaceColour;
+#include "include/uniformBlocks.glsl"
 
 out vec4 FragColour;
 
 void main() {
-	FragColour = vec4 (surfaceColour, 1.0f);
+	FragColour = vec4 (surfaceColour.rgb, 1.0f);
 }
\ No newline at end of file
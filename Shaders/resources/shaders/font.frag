@@ -1,13 +1,19 @@
 #version 430 core
 
 in vec2 TexCoords;
+in vec4 TextColour;
 
 out vec4 FragColour;
 
 uniform sampler2D text;
-uniform vec3 textColour;
+uniform bool distanceField;
 
 void main() {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    FragColour = vec4(textColour, 1.0) * sampled;
-}  
\ No newline at end of file
+	float coverage = texture(text, TexCoords).r;
+	if (distanceField) {
+		// The outline is at half way, smoothed over about a pixel at whatever size it's drawn.
+		float width = fwidth(coverage) * 0.5f;
+		coverage = smoothstep(0.5f - width, 0.5f + width, coverage);
+	}
+	FragColour = vec4(TextColour.rgb, TextColour.a * coverage);
+}
@@ -1,12 +1,15 @@
 #version 430 core
 
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec4 colour;
 
 out vec2 TexCoords;
+out vec4 TextColour;
 
 uniform mat4 projection;
 
 void main() {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
-} 
\ No newline at end of file
+	TextColour = colour;
+}
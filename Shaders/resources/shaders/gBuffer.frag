@@ -0,0 +1,27 @@
+#version 430 core
+
+// Albedo in rgb and the specular intensity in a, then the world space normal, folded into two channels.
+layout (location = 0) out vec4 GAlbedoSpecular;
+layout (location = 1) out vec2 GNormal;
+
+in VS_OUT {
+    vec2 TexCoords;
+	mat3 TBN;
+} fs_in;
+
+uniform sampler2D textureDiffuse1;
+uniform sampler2D textureNormal1;
+uniform sampler2D textureSpecular1;
+
+uniform bool useNormalMap;
+
+#include "include/gBuffer.glsl"
+
+void main() {
+	vec3 normal = fs_in.TBN[2];
+	if (useNormalMap)
+		normal = fs_in.TBN * (texture(textureNormal1, fs_in.TexCoords).rgb * 2.0f - 1.0f);
+
+	GAlbedoSpecular = vec4(texture(textureDiffuse1, fs_in.TexCoords).rgb, texture(textureSpecular1, fs_in.TexCoords).r);
+	GNormal = EncodeNormal(normalize(normal));
+}
@@ -0,0 +1,28 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in vec3 aTangent;
+
+out VS_OUT {
+    vec2 TexCoords;
+	mat3 TBN;
+} vs_out;
+
+#include "include/uniformBlocks.glsl"
+
+invariant gl_Position;
+
+void main() {
+	vs_out.TexCoords = aTexCoords;
+
+	// The lights are in world space, so unlike the forward shader the tangent frame has to be too.
+	vec3 tangent = normalize(normalMatrix * aTangent);
+	vec3 normal = normalize(normalMatrix * aNormal);
+	tangent = normalize(tangent - dot(tangent, normal) * normal);
+	vec3 bitangent = cross(normal, tangent);
+	vs_out.TBN = mat3(tangent, bitangent, normal);
+
+	gl_Position = projection * view * model * vec4(aPosition, 1.0);
+}
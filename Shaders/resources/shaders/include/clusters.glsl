@@ -0,0 +1,17 @@
+// Must match ShaderStorageBinding in UniformBlocks.h, and be included after uniformBlocks.glsl.
+
+// The offset and count of each cluster's lights, in the list of indices.
+layout (std430, binding = 1) readonly buffer ClusterLightRanges {
+	uvec2 clusterLightRanges[];
+};
+
+layout (std430, binding = 2) readonly buffer ClusterLightIndices {
+	uint clusterLightIndices[];
+};
+
+// The clusters are spaced evenly across the screen, and exponentially into it, as LightClusterBinner bins them.
+uint GetClusterIndex(vec2 fragCoord, float viewDepth) {
+	uint slice = uint(clamp(log(viewDepth) * clusterParameters.x - clusterParameters.y, 0.0f, float(clusterGridSize.z - 1u)));
+	uvec2 tile = min(uvec2(fragCoord * clusterParameters.zw), clusterGridSize.xy - 1u);
+	return tile.x + clusterGridSize.x * (tile.y + clusterGridSize.y * slice);
+}
@@ -0,0 +1,23 @@
+// Image based ambient lighting, from the maps baked from the sky by EnvironmentBaker, in world space.
+// Included after lighting.glsl, whose shininess it matches.
+
+uniform samplerCube irradianceMap;
+uniform samplerCube prefilteredMap;
+uniform float environmentIntensity;
+
+vec3 CalculateAmbient(vec3 surfaceColour, float specularIntensity, vec3 normal, vec3 viewDir) {
+	vec3 diffuse = surfaceColour * texture(irradianceMap, normal).rgb;
+
+	// The prefiltered map's levels are Phong lobes, the exponent quartering with each level down from 4^(levels - 1).
+	// A Blinn-Phong highlight is about as wide as a Phong one with a quarter of the exponent.
+	float phongExponent = blinn ? specularExponent * 0.25f : specularExponent;
+	float lastLevel = float(textureQueryLevels(prefilteredMap) - 1);
+	float level = clamp(lastLevel - 0.5f * log2(max(phongExponent, 1.0f)), 0.0f, lastLevel);
+	vec3 reflection = textureLod(prefilteredMap, reflect(-viewDir, normal), level).rgb;
+	vec3 specular = reflection * surfaceSpecularBrightness * specularIntensity;
+
+	vec3 ambient = (diffuse + specular) * environmentIntensity;
+	if (toonShading)
+		ambient = ambient * (floor(length(ambient) * toonLevels) / toonLevels);
+	return ambient;
+}
@@ -0,0 +1,5 @@
+// One triangle that covers the screen, made from the vertex index, so no vertex buffer is needed.
+// Returns the texture coordinates, which run from 0 to 1 across the screen, and 2 at the triangle's far corners.
+vec2 FullScreenTexCoords() {
+	return vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+}
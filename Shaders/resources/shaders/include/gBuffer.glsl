@@ -0,0 +1,17 @@
+// Normals are stored in two channels, by folding the unit sphere onto an octahedron and unfolding that into a square.
+
+vec2 OctahedronWrap(vec2 v) {
+	return (1.0f - abs(v.yx)) * vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+vec2 EncodeNormal(vec3 normal) {
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+	return normal.z >= 0.0f ? normal.xy : OctahedronWrap(normal.xy);
+}
+
+vec3 DecodeNormal(vec2 encoded) {
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-normal.z, 0.0f, 1.0f);
+	normal.xy += vec2(normal.x >= 0.0f ? -fold : fold, normal.y >= 0.0f ? -fold : fold);
+	return normalize(normal);
+}
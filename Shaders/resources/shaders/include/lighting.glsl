@@ -0,0 +1,41 @@
+// The Blinn-Phong, or Phong, lighting model, with optional toon shading, shared by the forward and deferred paths.
+// The ambient light comes from the sky instead, in environment.glsl.
+
+uniform bool blinn;
+uniform bool toonShading;
+
+uniform float specularExponent;
+uniform float surfaceSpecularBrightness;
+
+// Toon shading.
+const float toonLevels = 4.0f;
+
+float ToonStep(float value) {
+	return toonShading ? floor(value * toonLevels) / toonLevels : value;
+}
+
+float CalculateAttenuation(vec3 attenuation, float distance) {
+	return attenuation.x / (attenuation.x + attenuation.y * distance + attenuation.z * (distance * distance));
+}
+
+// The directions are unit length, and in whichever space the normal is in. Shadow is the fraction of the light that reaches the surface.
+vec3 CalculatePointLight(vec3 surfaceColour, float specularIntensity, vec3 normal, vec3 lightDir, vec3 viewDir, vec3 lightColour, float attenuationFactor, float shadow) {
+	// Diffuse.
+	float diff = ToonStep(max(dot(lightDir, normal), 0.0f));	// Brightness.
+	vec3 diffuse = (lightColour * diff * surfaceColour) * attenuationFactor;
+
+	// Specular.
+	float spec = 0.0f;
+	if (blinn) {
+		vec3 halfwayDir = normalize(lightDir + viewDir);
+		spec = pow(max(dot(normal, halfwayDir), 0.0f), specularExponent);
+	}
+	else {
+		vec3 reflectDir = reflect(-lightDir, normal);
+		spec = pow(max(dot(viewDir, reflectDir), 0.0f), specularExponent);
+	}
+	spec = ToonStep(spec);
+	vec3 specular = (lightColour * surfaceSpecularBrightness * specularIntensity * spec) * attenuationFactor;
+
+	return (diffuse + specular) * shadow;
+}
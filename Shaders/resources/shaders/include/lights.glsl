@@ -0,0 +1,11 @@
+// Must match PointLightData in UniformBlocks.h.
+
+struct PointLight {
+	vec4 positionRadius;	// The radius is in w.
+	vec4 colour;
+	vec4 attenuation;
+};
+
+layout (std430, binding = 0) readonly buffer LightData {
+	PointLight lights[];
+};
@@ -0,0 +1,7 @@
+uniform sampler2D bloomTexture;
+uniform float bloomIntensity;
+
+vec3 Bloom(vec3 colour, vec2 texCoords) {
+	// The chain's top level, upsampled bilinearly, added before the colour is tonemapped.
+	return colour + texture(bloomTexture, texCoords).rgb * bloomIntensity;
+}
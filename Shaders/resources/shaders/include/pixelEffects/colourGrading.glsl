@@ -0,0 +1,10 @@
+uniform float gradingContrast;
+uniform float gradingSaturation;
+uniform vec3 gradingColourFilter;
+
+vec3 ColourGrading(vec3 colour, vec2 texCoords) {
+	colour = (colour - 0.5f) * gradingContrast + 0.5f;
+	float luminance = dot(colour, vec3(0.2126f, 0.7152f, 0.0722f));
+	colour = mix(vec3(luminance), colour, gradingSaturation);
+	return max(colour * gradingColourFilter, vec3(0.0f));
+}
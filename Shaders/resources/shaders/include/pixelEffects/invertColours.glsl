@@ -0,0 +1,3 @@
+vec3 InvertColours(vec3 colour, vec2 texCoords) {
+	return 1.0f - colour;
+}
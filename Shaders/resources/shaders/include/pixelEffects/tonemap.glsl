@@ -0,0 +1,7 @@
+uniform float tonemapExposure;
+
+vec3 Tonemap(vec3 colour, vec2 texCoords) {
+	// Narkowicz's fit of the ACES filmic curve.
+	colour *= tonemapExposure;
+	return clamp((colour * (2.51f * colour + 0.03f)) / (colour * (2.43f * colour + 0.59f) + 0.14f), 0.0f, 1.0f);
+}
@@ -0,0 +1,9 @@
+uniform float vignetteStrength;
+uniform float vignetteRadius;
+
+vec3 Vignette(vec3 colour, vec2 texCoords) {
+	// Darkens towards the corners, starting at the radius from the centre.
+	float distanceFromCentre = length(texCoords - 0.5f) * 1.41421356f;
+	float darkening = smoothstep(vignetteRadius, 1.0f, distanceFromCentre) * vignetteStrength;
+	return colour * (1.0f - darkening);
+}
@@ -0,0 +1,53 @@
+// Must match ShadowUniformData in UniformBlocks.h, and the texture units the shadow renderer binds its maps to.
+
+#define CASCADE_COUNT 4
+
+layout (std140, binding = 2) uniform ShadowData {
+	mat4 cascadeViewProjections[CASCADE_COUNT];
+	vec4 cascadeSplits;	// The view depth each cascade reaches to.
+	vec4 cascadeTexelSizes;	// The world size of a texel, in each cascade.
+	vec4 pointShadowPositionFar;	// The light the cube map was drawn from, and its far plane.
+	uvec4 shadowFlags;	// Whether the cascades, then the cube map, can be read.
+};
+
+uniform sampler2DArrayShadow cascadeShadowMap;
+uniform samplerCubeShadow pointShadowMap;
+
+// The fraction of the sun that reaches a surface, the normal pushes the lookup off the surface by about a texel, to avoid acne.
+float CalculateSunShadow(vec3 worldPosition, vec3 worldNormal, float viewDepth) {
+	if (shadowFlags.x == 0u || viewDepth > cascadeSplits[CASCADE_COUNT - 1])
+		return 1.0f;
+
+	int cascade = 0;
+	while (cascade < CASCADE_COUNT - 1 && viewDepth > cascadeSplits[cascade])
+		cascade++;
+
+	vec3 offsetPosition = worldPosition + worldNormal * (cascadeTexelSizes[cascade] * 1.5f);
+	// The projection is orthographic, so there's no divide.
+	vec3 coordinates = (cascadeViewProjections[cascade] * vec4(offsetPosition, 1.0f)).xyz * 0.5f + 0.5f;
+
+	// Nine bilinear comparisons, a 4x4 texel filter.
+	vec2 texelSize = 1.0f / vec2(textureSize(cascadeShadowMap, 0).xy);
+	float lit = 0.0f;
+	for (int y = -1; y <= 1; y++) {
+		for (int x = -1; x <= 1; x++)
+			lit += texture(cascadeShadowMap, vec4(coordinates.xy + vec2(x, y) * texelSize, float(cascade), coordinates.z));
+	}
+	return lit / 9.0f;
+}
+
+// The fraction of the cube map's light that reaches a surface, the map holds each texel's distance from the light, over the far plane.
+float CalculatePointShadow(vec3 worldPosition, vec3 worldNormal) {
+	if (shadowFlags.y == 0u)
+		return 1.0f;
+
+	vec3 fromLight = worldPosition - pointShadowPositionFar.xyz;
+	float distance = length(fromLight);
+	if (distance >= pointShadowPositionFar.w)
+		return 1.0f;
+
+	// A cube face texel covers about twice the distance over the resolution.
+	float texelSize = 2.0f * distance / float(textureSize(pointShadowMap, 0).x);
+	fromLight += worldNormal * (texelSize * 1.5f);
+	return texture(pointShadowMap, vec4(fromLight, length(fromLight) / pointShadowPositionFar.w - 0.002f));
+}
@@ -0,0 +1,19 @@
+// SMAA 1x, Jimenez et al., at its medium preset, without the diagonal and corner passes.
+// The directions follow the reference, "top" being towards -y, which flips the whole algorithm in the GL's texture
+// space without changing what it finds.
+
+// The smallest luma contrast treated as an edge.
+const float SMAA_THRESHOLD = 0.1f;
+// How much stronger a neighbouring edge must be to hide a weaker one.
+const float SMAA_LOCAL_CONTRAST_ADAPTATION_FACTOR = 2.0f;
+// Each step of the search along an edge covers two pixels.
+const int SMAA_MAX_SEARCH_STEPS = 8;
+
+// The area texture is 5x5 tiles, one per pair of crossing edges, each indexed by the square roots of the distances to the ends.
+const float SMAA_AREATEX_MAX_DISTANCE = 16.0f;
+const float SMAA_AREATEX_SIZE = 80.0f;
+// The search texture has a half for each direction, each indexed by the fetched edges in 32nds.
+const int SMAA_SEARCHTEX_HALF_WIDTH = 33;
+
+// One over the width and height, and the width and height, of the targets the passes draw into.
+uniform vec4 smaaMetrics;
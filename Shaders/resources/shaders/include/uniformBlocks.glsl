@@ -0,0 +1,22 @@
+// Must match the structures in UniformBlocks.h.
+
+// Data that's the same for every object drawn during a frame.
+layout (std140, binding = 0) uniform FrameData {
+	mat4 projection;
+	mat4 view;
+	vec4 viewPosition;
+	mat4 inverseViewProjection;
+	uvec4 clusterGridSize;
+	vec4 clusterParameters;	// The depth slice scale and bias, then the clusters per pixel across and down.
+	vec4 sunDirection;	// Towards the sun.
+	vec4 sunColour;
+};
+
+// Data that's unique to each object drawn.
+layout (std140, binding = 1) uniform ObjectData {
+	mat4 model;
+	mat3 normalMatrix;
+	vec4 surfaceColour;
+	vec4 objectLightPosition;	// w is 1 when the model matrix is rigid, with a uniform scale.
+	vec4 objectViewPosition;
+};
\ No newline at end of file
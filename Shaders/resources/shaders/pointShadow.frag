@@ -0,0 +1,11 @@
+#version 430 core
+
+in vec3 WorldPosition;
+
+uniform vec3 shadowLightPosition;
+uniform float shadowFarPlane;
+
+// The distance from the light, rather than the projected depth, so every face is compared the same way.
+void main() {
+	gl_FragDepth = length(WorldPosition - shadowLightPosition) / shadowFarPlane;
+}
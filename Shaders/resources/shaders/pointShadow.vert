@@ -0,0 +1,10 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPosition;
+
+#include "include/uniformBlocks.glsl"
+
+// The geometry shader projects onto each face, so only move into world space here.
+void main() {
+	gl_Position = model * vec4(aPosition, 1.0);
+}
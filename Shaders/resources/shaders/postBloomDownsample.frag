@@ -0,0 +1,73 @@
+#version 430 core
+
+// Filters the image down to half its size for the bloom's chain, with the 13 tap filter from Jimenez's Call of Duty
+// talk: five overlapping 2x2 boxes, made of bilinear taps, so the downsample doesn't shimmer as things move.
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D source;
+uniform vec2 sourceTexelSize;
+// The first level also keeps only what's brighter than the threshold, and weights each box down by its brightness,
+// so a single very bright pixel can't flicker across the whole glow.
+uniform bool isFirstLevel;
+// The threshold, the threshold less the knee, twice the knee, and a quarter over the knee.
+uniform vec4 bloomFilter;
+
+float Luma(vec3 colour) {
+	return dot(colour, vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+// Fades the colour in over the knee below the threshold, rather than cutting it off there.
+vec3 Threshold(vec3 colour) {
+	float brightness = max(colour.r, max(colour.g, colour.b));
+	float soft = clamp(brightness - bloomFilter.y, 0.0f, bloomFilter.z);
+	soft = soft * soft * bloomFilter.w;
+	float contribution = max(soft, brightness - bloomFilter.x) / max(brightness, 1e-5f);
+	return colour * contribution;
+}
+
+vec3 Sample(vec2 offset) {
+	return textureLod(source, TexCoords + offset * sourceTexelSize, 0.0f).rgb;
+}
+
+void main() {
+	vec3 a = Sample(vec2(-2.0f, -2.0f));
+	vec3 b = Sample(vec2( 0.0f, -2.0f));
+	vec3 c = Sample(vec2( 2.0f, -2.0f));
+	vec3 d = Sample(vec2(-1.0f, -1.0f));
+	vec3 e = Sample(vec2( 1.0f, -1.0f));
+	vec3 f = Sample(vec2(-2.0f,  0.0f));
+	vec3 g = Sample(vec2( 0.0f,  0.0f));
+	vec3 h = Sample(vec2( 2.0f,  0.0f));
+	vec3 i = Sample(vec2(-1.0f,  1.0f));
+	vec3 j = Sample(vec2( 1.0f,  1.0f));
+	vec3 k = Sample(vec2(-2.0f,  2.0f));
+	vec3 l = Sample(vec2( 0.0f,  2.0f));
+	vec3 m = Sample(vec2( 2.0f,  2.0f));
+
+	// The centre box counts for half, the four corner boxes for an eighth each.
+	vec3 boxes[5] = vec3[](
+		(d + e + i + j) * 0.25f,
+		(a + b + f + g) * 0.25f,
+		(b + c + g + h) * 0.25f,
+		(f + g + k + l) * 0.25f,
+		(g + h + l + m) * 0.25f
+	);
+	float weights[5] = float[](0.5f, 0.125f, 0.125f, 0.125f, 0.125f);
+
+	vec3 colour = vec3(0.0f);
+	float totalWeight = 0.0f;
+	for (int box = 0; box < 5; box++) {
+		// Karis' average, each box weighted by one over its brightness.
+		float weight = isFirstLevel ? weights[box] / (1.0f + Luma(boxes[box])) : weights[box];
+		colour += boxes[box] * weight;
+		totalWeight += weight;
+	}
+	colour /= totalWeight;
+
+	if (isFirstLevel)
+		colour = Threshold(colour);
+	FragColour = vec4(colour, 1.0f);
+}
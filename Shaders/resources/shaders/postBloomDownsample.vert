@@ -0,0 +1,10 @@
+#version 430 core
+
+#include "include/fullScreenTriangle.glsl"
+
+out vec2 TexCoords;
+
+void main() {
+	TexCoords = FullScreenTexCoords();
+	gl_Position = vec4(TexCoords * 2.0f - 1.0f, 0.0f, 1.0f);
+}
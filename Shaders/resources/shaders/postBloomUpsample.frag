@@ -0,0 +1,27 @@
+#version 430 core
+
+// Filters the bloom's smaller level up with a 3x3 tent, and adds the level this size, so each level up the chain
+// carries the glow of every smaller one.
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D source;
+uniform sampler2D current;
+uniform vec2 sourceTexelSize;
+// The tent's size, in the smaller level's pixels.
+uniform float radius;
+
+vec3 Sample(vec2 offset) {
+	return textureLod(source, TexCoords + offset * radius * sourceTexelSize, 0.0f).rgb;
+}
+
+void main() {
+	vec3 colour = Sample(vec2(0.0f, 0.0f)) * 4.0f;
+	colour += (Sample(vec2(0.0f, -1.0f)) + Sample(vec2(-1.0f, 0.0f)) + Sample(vec2(1.0f, 0.0f)) + Sample(vec2(0.0f, 1.0f))) * 2.0f;
+	colour += Sample(vec2(-1.0f, -1.0f)) + Sample(vec2(1.0f, -1.0f)) + Sample(vec2(-1.0f, 1.0f)) + Sample(vec2(1.0f, 1.0f));
+	colour /= 16.0f;
+
+	FragColour = vec4(colour + textureLod(current, TexCoords, 0.0f).rgb, 1.0f);
+}
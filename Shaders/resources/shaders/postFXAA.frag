@@ -0,0 +1,140 @@
+#version 430 core
+
+// FXAA, following the quality version of Lottes' algorithm: finds the edge through each pixel from the luma of its
+// neighbours, walks along it to both ends, and samples across the edge by how far the pixel is from the nearer end.
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D scene;
+
+// The smallest contrast treated as an edge, and the contrast relative to the brightest neighbour.
+const float EDGE_THRESHOLD_MIN = 0.0312f;
+const float EDGE_THRESHOLD_MAX = 0.125f;
+// How much pixels smaller than the edge search, like thin lines and single pixels, are blended.
+const float SUBPIXEL_QUALITY = 0.75f;
+// The steps the search along the edge takes, growing once it's far from the pixel.
+const int SEARCH_STEPS = 12;
+const float SEARCH_STEP_SIZES[SEARCH_STEPS] = float[](1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.5f, 2.0f, 2.0f, 2.0f, 2.0f, 4.0f, 8.0f);
+
+float Luma(vec3 colour) {
+	// In roughly perceptual space, so edges in dark areas aren't missed.
+	return sqrt(dot(colour, vec3(0.299f, 0.587f, 0.114f)));
+}
+
+float LumaAt(vec2 texCoords) {
+	return Luma(textureLod(scene, texCoords, 0.0f).rgb);
+}
+
+void main() {
+	vec2 texelSize = 1.0f / vec2(textureSize(scene, 0));
+	vec3 colourCentre = textureLod(scene, TexCoords, 0.0f).rgb;
+
+	float lumaCentre = Luma(colourCentre);
+	float lumaDown = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(0, -1)).rgb);
+	float lumaUp = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(0, 1)).rgb);
+	float lumaLeft = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(-1, 0)).rgb);
+	float lumaRight = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(1, 0)).rgb);
+
+	// Flat areas are left alone, which is most of the image.
+	float lumaMin = min(lumaCentre, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+	float lumaMax = max(lumaCentre, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+	float lumaRange = lumaMax - lumaMin;
+	if (lumaRange < max(EDGE_THRESHOLD_MIN, lumaMax * EDGE_THRESHOLD_MAX)) {
+		FragColour = vec4(colourCentre, 1.0f);
+		return;
+	}
+
+	float lumaDownLeft = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(-1, -1)).rgb);
+	float lumaUpRight = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(1, 1)).rgb);
+	float lumaUpLeft = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(-1, 1)).rgb);
+	float lumaDownRight = Luma(textureLodOffset(scene, TexCoords, 0.0f, ivec2(1, -1)).rgb);
+
+	float lumaDownUp = lumaDown + lumaUp;
+	float lumaLeftRight = lumaLeft + lumaRight;
+	float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+	float lumaDownCorners = lumaDownLeft + lumaDownRight;
+	float lumaRightCorners = lumaDownRight + lumaUpRight;
+	float lumaUpCorners = lumaUpRight + lumaUpLeft;
+
+	// The edge runs along whichever direction changes least.
+	float edgeHorizontal = abs(-2.0f * lumaLeft + lumaLeftCorners) + abs(-2.0f * lumaCentre + lumaDownUp) * 2.0f + abs(-2.0f * lumaRight + lumaRightCorners);
+	float edgeVertical = abs(-2.0f * lumaUp + lumaUpCorners) + abs(-2.0f * lumaCentre + lumaLeftRight) * 2.0f + abs(-2.0f * lumaDown + lumaDownCorners);
+	bool isHorizontal = edgeHorizontal >= edgeVertical;
+
+	// Which side of the pixel the edge is on.
+	float luma1 = isHorizontal ? lumaDown : lumaLeft;
+	float luma2 = isHorizontal ? lumaUp : lumaRight;
+	float gradient1 = luma1 - lumaCentre;
+	float gradient2 = luma2 - lumaCentre;
+	bool is1Steepest = abs(gradient1) >= abs(gradient2);
+	float gradientScaled = 0.25f * max(abs(gradient1), abs(gradient2));
+
+	float stepLength = isHorizontal ? texelSize.y : texelSize.x;
+	float lumaLocalAverage;
+	if (is1Steepest) {
+		stepLength = -stepLength;
+		lumaLocalAverage = 0.5f * (luma1 + lumaCentre);
+	}
+	else {
+		lumaLocalAverage = 0.5f * (luma2 + lumaCentre);
+	}
+
+	// Searched along the edge itself, half a pixel across, until the luma moves away from the edge's average.
+	vec2 edgeTexCoords = TexCoords;
+	if (isHorizontal)
+		edgeTexCoords.y += stepLength * 0.5f;
+	else
+		edgeTexCoords.x += stepLength * 0.5f;
+	vec2 searchStep = isHorizontal ? vec2(texelSize.x, 0.0f) : vec2(0.0f, texelSize.y);
+
+	vec2 texCoords1 = edgeTexCoords - searchStep;
+	vec2 texCoords2 = edgeTexCoords + searchStep;
+	float lumaEnd1 = LumaAt(texCoords1) - lumaLocalAverage;
+	float lumaEnd2 = LumaAt(texCoords2) - lumaLocalAverage;
+	bool isEnd1 = abs(lumaEnd1) >= gradientScaled;
+	bool isEnd2 = abs(lumaEnd2) >= gradientScaled;
+	if (!isEnd1)
+		texCoords1 -= searchStep;
+	if (!isEnd2)
+		texCoords2 += searchStep;
+
+	for (int i = 2; i < SEARCH_STEPS && !(isEnd1 && isEnd2); i++) {
+		if (!isEnd1)
+			lumaEnd1 = LumaAt(texCoords1) - lumaLocalAverage;
+		if (!isEnd2)
+			lumaEnd2 = LumaAt(texCoords2) - lumaLocalAverage;
+		isEnd1 = abs(lumaEnd1) >= gradientScaled;
+		isEnd2 = abs(lumaEnd2) >= gradientScaled;
+		if (!isEnd1)
+			texCoords1 -= searchStep * SEARCH_STEP_SIZES[i];
+		if (!isEnd2)
+			texCoords2 += searchStep * SEARCH_STEP_SIZES[i];
+	}
+
+	float distance1 = isHorizontal ? TexCoords.x - texCoords1.x : TexCoords.y - texCoords1.y;
+	float distance2 = isHorizontal ? texCoords2.x - TexCoords.x : texCoords2.y - TexCoords.y;
+	bool isDirection1 = distance1 < distance2;
+	float distanceFinal = min(distance1, distance2);
+	float edgeLength = distance1 + distance2;
+
+	// Pixels nearer the end are moved further across the edge, only if the end's luma goes the way the pixel's does.
+	float pixelOffset = 0.5f - distanceFinal / edgeLength;
+	bool isLumaCentreSmaller = lumaCentre < lumaLocalAverage;
+	bool isCorrectVariation = ((isDirection1 ? lumaEnd1 : lumaEnd2) < 0.0f) != isLumaCentreSmaller;
+	float finalOffset = isCorrectVariation ? pixelOffset : 0.0f;
+
+	// Pixels that stand out from all their neighbours are blended by how much, whatever the edge search found.
+	float lumaAverage = (1.0f / 12.0f) * (2.0f * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+	float subPixelOffset = clamp(abs(lumaAverage - lumaCentre) / lumaRange, 0.0f, 1.0f);
+	subPixelOffset = (-2.0f * subPixelOffset + 3.0f) * subPixelOffset * subPixelOffset;
+	finalOffset = max(finalOffset, subPixelOffset * subPixelOffset * SUBPIXEL_QUALITY);
+
+	vec2 finalTexCoords = TexCoords;
+	if (isHorizontal)
+		finalTexCoords.y += finalOffset * stepLength;
+	else
+		finalTexCoords.x += finalOffset * stepLength;
+	FragColour = vec4(textureLod(scene, finalTexCoords, 0.0f).rgb, 1.0f);
+}
@@ -0,0 +1,36 @@
+#version 430 core
+
+// Blends each pixel with the neighbour across its strongest edge, by the weight found for it, in one bilinear fetch.
+
+#include "include/smaa.glsl"
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D scene;
+uniform sampler2D weightsTexture;
+
+void main() {
+	// The weights for the right and bottom edges were written by the neighbours they're the left and top edges of.
+	vec4 a;
+	a.x = textureLod(weightsTexture, TexCoords + vec2(smaaMetrics.x, 0.0f), 0.0f).a;
+	a.y = textureLod(weightsTexture, TexCoords + vec2(0.0f, smaaMetrics.y), 0.0f).g;
+	a.wz = textureLod(weightsTexture, TexCoords, 0.0f).xz;
+
+	if (dot(a, vec4(1.0f)) < 1e-5f) {
+		FragColour = textureLod(scene, TexCoords, 0.0f);
+		return;
+	}
+
+	// Only one direction is blended, whichever has the larger weight.
+	bool isHorizontal = max(a.x, a.z) > max(a.y, a.w);
+	vec4 blendingOffset = isHorizontal ? vec4(a.x, 0.0f, a.z, 0.0f) : vec4(0.0f, a.y, 0.0f, a.w);
+	vec2 blendingWeight = isHorizontal ? a.xz : a.yw;
+	blendingWeight /= dot(blendingWeight, vec2(1.0f));
+
+	vec4 blendingCoords = blendingOffset * vec4(smaaMetrics.xy, -smaaMetrics.xy) + TexCoords.xyxy;
+	vec4 colour = blendingWeight.x * textureLod(scene, blendingCoords.xy, 0.0f);
+	colour += blendingWeight.y * textureLod(scene, blendingCoords.zw, 0.0f);
+	FragColour = colour;
+}
@@ -0,0 +1,44 @@
+#version 430 core
+
+// Finds the edges on each pixel's left and top, from the luma, keeping only the ones that stand out locally.
+
+#include "include/smaa.glsl"
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D scene;
+
+float Luma(vec2 texCoords) {
+	return dot(textureLod(scene, texCoords, 0.0f).rgb, vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+void main() {
+	float luma = Luma(TexCoords);
+	float lumaLeft = Luma(TexCoords + vec2(-smaaMetrics.x, 0.0f));
+	float lumaTop = Luma(TexCoords + vec2(0.0f, -smaaMetrics.y));
+
+	vec4 delta;
+	delta.xy = abs(luma - vec2(lumaLeft, lumaTop));
+	vec2 edges = step(SMAA_THRESHOLD, delta.xy);
+	if (dot(edges, vec2(1.0f)) == 0.0f) {
+		FragColour = vec4(0.0f);
+		return;
+	}
+
+	// The largest contrast around the pixel, and around its left and top neighbours.
+	float lumaRight = Luma(TexCoords + vec2(smaaMetrics.x, 0.0f));
+	float lumaBottom = Luma(TexCoords + vec2(0.0f, smaaMetrics.y));
+	delta.zw = abs(luma - vec2(lumaRight, lumaBottom));
+	vec2 maxDelta = max(delta.xy, delta.zw);
+
+	float lumaLeftLeft = Luma(TexCoords + vec2(-2.0f * smaaMetrics.x, 0.0f));
+	float lumaTopTop = Luma(TexCoords + vec2(0.0f, -2.0f * smaaMetrics.y));
+	delta.zw = abs(vec2(lumaLeft, lumaTop) - vec2(lumaLeftLeft, lumaTopTop));
+	maxDelta = max(maxDelta.xy, delta.zw);
+	float finalDelta = max(maxDelta.x, maxDelta.y);
+
+	edges *= step(finalDelta, SMAA_LOCAL_CONTRAST_ADAPTATION_FACTOR * delta.xy);
+	FragColour = vec4(edges, 0.0f, 0.0f);
+}
@@ -0,0 +1,108 @@
+#version 430 core
+
+// For each edge on the pixel's left or top, searches along it to both ends, reads the edges crossing it there, and
+// looks up how much of the pixel, and of its neighbour across the edge, the line that pattern stands for covers.
+
+#include "include/smaa.glsl"
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D edgesTexture;
+uniform sampler2D areaTexture;
+uniform sampler2D searchTexture;
+
+// How many pixels past the last fetch the line goes on, from the bilinear fetch of two pixels' edges.
+float SearchLength(vec2 e, int side) {
+	// Every value a fetch of binary edges can give lands exactly on a 32nd.
+	ivec2 texel = ivec2(round(e * 32.0f));
+	return texelFetch(searchTexture, ivec2(texel.x + side * SMAA_SEARCHTEX_HALF_WIDTH, texel.y), 0).r;
+}
+
+// The searches fetch between two pixels, and a quarter pixel across, so one fetch reads the edges of both and which they are can be told apart.
+float SearchXLeft(vec2 texCoords, float end) {
+	vec2 e = vec2(0.0f, 1.0f);
+	while (texCoords.x > end && e.g > 0.8281f && e.r == 0.0f) {
+		e = textureLod(edgesTexture, texCoords, 0.0f).rg;
+		texCoords.x -= 2.0f * smaaMetrics.x;
+	}
+	float offset = -(255.0f / 127.0f) * SearchLength(e, 0) + 3.25f;
+	return smaaMetrics.x * offset + texCoords.x;
+}
+
+float SearchXRight(vec2 texCoords, float end) {
+	vec2 e = vec2(0.0f, 1.0f);
+	while (texCoords.x < end && e.g > 0.8281f && e.r == 0.0f) {
+		e = textureLod(edgesTexture, texCoords, 0.0f).rg;
+		texCoords.x += 2.0f * smaaMetrics.x;
+	}
+	float offset = -(255.0f / 127.0f) * SearchLength(e, 1) + 3.25f;
+	return -smaaMetrics.x * offset + texCoords.x;
+}
+
+float SearchYUp(vec2 texCoords, float end) {
+	vec2 e = vec2(1.0f, 0.0f);
+	while (texCoords.y > end && e.r > 0.8281f && e.g == 0.0f) {
+		e = textureLod(edgesTexture, texCoords, 0.0f).rg;
+		texCoords.y -= 2.0f * smaaMetrics.y;
+	}
+	float offset = -(255.0f / 127.0f) * SearchLength(e.gr, 0) + 3.25f;
+	return smaaMetrics.y * offset + texCoords.y;
+}
+
+float SearchYDown(vec2 texCoords, float end) {
+	vec2 e = vec2(1.0f, 0.0f);
+	while (texCoords.y < end && e.r > 0.8281f && e.g == 0.0f) {
+		e = textureLod(edgesTexture, texCoords, 0.0f).rg;
+		texCoords.y += 2.0f * smaaMetrics.y;
+	}
+	float offset = -(255.0f / 127.0f) * SearchLength(e.gr, 1) + 3.25f;
+	return -smaaMetrics.y * offset + texCoords.y;
+}
+
+// The crossing edges were fetched a quarter pixel across, so each end is 0, 0.25, 0.75 or 1, for none, one side, the other or both.
+vec2 Area(vec2 sqrtDistance, float e1, float e2) {
+	vec2 texCoords = SMAA_AREATEX_MAX_DISTANCE * round(4.0f * vec2(e1, e2)) + sqrtDistance;
+	return textureLod(areaTexture, (texCoords + 0.5f) / SMAA_AREATEX_SIZE, 0.0f).rg;
+}
+
+void main() {
+	vec2 pixCoords = TexCoords * smaaMetrics.zw;
+	vec4 offsets[3];
+	offsets[0] = smaaMetrics.xyxy * vec4(-0.25f, -0.125f, 1.25f, -0.125f) + TexCoords.xyxy;
+	offsets[1] = smaaMetrics.xyxy * vec4(-0.125f, -0.25f, -0.125f, 1.25f) + TexCoords.xyxy;
+	// Where the searches stop.
+	offsets[2] = smaaMetrics.xxyy * vec4(-2.0f, 2.0f, -2.0f, 2.0f) * float(SMAA_MAX_SEARCH_STEPS) + vec4(offsets[0].xz, offsets[1].yw);
+
+	vec4 weights = vec4(0.0f);
+	vec2 e = textureLod(edgesTexture, TexCoords, 0.0f).rg;
+
+	// An edge on the top.
+	if (e.g > 0.0f) {
+		vec3 coords;
+		coords.x = SearchXLeft(offsets[0].xy, offsets[2].x);
+		coords.y = offsets[1].y;
+		coords.z = SearchXRight(offsets[0].zw, offsets[2].y);
+		vec2 distance = abs(round(smaaMetrics.zz * coords.xz - pixCoords.xx));
+
+		float e1 = textureLod(edgesTexture, coords.xy, 0.0f).r;
+		float e2 = textureLodOffset(edgesTexture, coords.zy, 0.0f, ivec2(1, 0)).r;
+		weights.rg = Area(sqrt(distance), e1, e2);
+	}
+
+	// An edge on the left.
+	if (e.r > 0.0f) {
+		vec3 coords;
+		coords.y = SearchYUp(offsets[1].xy, offsets[2].z);
+		coords.x = offsets[0].x;
+		coords.z = SearchYDown(offsets[1].zw, offsets[2].w);
+		vec2 distance = abs(round(smaaMetrics.ww * coords.yz - pixCoords.yy));
+
+		float e1 = textureLod(edgesTexture, coords.xy, 0.0f).g;
+		float e2 = textureLodOffset(edgesTexture, coords.xz, 0.0f, ivec2(0, 1)).g;
+		weights.ba = Area(sqrt(distance), e1, e2);
+	}
+
+	FragColour = weights;
+}
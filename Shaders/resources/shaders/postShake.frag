@@ -0,0 +1,16 @@
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D scene;
+uniform vec2 offsets[9];
+uniform float blurKernel[9];
+
+void main() {
+	vec3 colour = vec3(0.0f);
+	for (int i = 0; i < 9; i++)
+		colour += texture(scene, TexCoords + offsets[i]).rgb * blurKernel[i];
+	FragColour = vec4(colour, 1.0f);
+}
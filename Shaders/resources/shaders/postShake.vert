@@ -0,0 +1,17 @@
+#version 430 core
+
+#include "include/fullScreenTriangle.glsl"
+
+out vec2 TexCoords;
+
+uniform float time;
+
+void main() {
+	TexCoords = FullScreenTexCoords();
+	gl_Position = vec4(TexCoords * 2.0f - 1.0f, 0.0f, 1.0f);
+
+	// Shake the screen around.
+	float strength = 0.0125f;
+	gl_Position.x += cos(time * 10.0f) * strength;
+	gl_Position.y += cos(time * 15.0f) * strength;
+}
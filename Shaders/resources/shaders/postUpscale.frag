@@ -0,0 +1,29 @@
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D scene;
+// How much of the detail lost to the bilinear filter is put back, 0 for a plain bilinear upscale.
+uniform float sharpness;
+
+void main() {
+	vec3 centre = texture(scene, TexCoords).rgb;
+	if (sharpness <= 0.0f) {
+		FragColour = vec4(centre, 1.0f);
+		return;
+	}
+
+	// An unsharp mask against the neighbours a texel away, clamped to their range so edges don't ring.
+	vec2 texelSize = 1.0f / vec2(textureSize(scene, 0));
+	vec3 up = texture(scene, TexCoords + vec2(0.0f, texelSize.y)).rgb;
+	vec3 down = texture(scene, TexCoords - vec2(0.0f, texelSize.y)).rgb;
+	vec3 left = texture(scene, TexCoords - vec2(texelSize.x, 0.0f)).rgb;
+	vec3 right = texture(scene, TexCoords + vec2(texelSize.x, 0.0f)).rgb;
+	vec3 minimum = min(centre, min(min(up, down), min(left, right)));
+	vec3 maximum = max(centre, max(max(up, down), max(left, right)));
+
+	vec3 sharpened = centre + (centre - (up + down + left + right) * 0.25f) * sharpness * 2.0f;
+	FragColour = vec4(clamp(sharpened, minimum, maximum), 1.0f);
+}
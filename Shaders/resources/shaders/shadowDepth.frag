@@ -0,0 +1,5 @@
+#version 430 core
+
+// Depth is written by the fixed-function pipeline, there's no colour output.
+void main() {
+}
@@ -0,0 +1,11 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPosition;
+
+#include "include/uniformBlocks.glsl"
+
+uniform mat4 lightViewProjection;
+
+void main() {
+	gl_Position = lightViewProjection * model * vec4(aPosition, 1.0);
+}
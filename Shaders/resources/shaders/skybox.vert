@@ -1,13 +1,16 @@
 #version 430 core
 
-layout (location = 0) in vec3 vertexPosition;
+#include "include/fullScreenTriangle.glsl"
+#include "include/uniformBlocks.glsl"
 
 out vec3 TextureCoords;
 
-uniform mat4 projection;
-uniform mat4 viewWithoutTransform;
-
 void main() {
-	TextureCoords = vertexPosition;
-	gl_Position = projection * viewWithoutTransform * vec4(vertexPosition, 1.0);
-}
\ No newline at end of file
+	// At the far plane, so the sky is only drawn where nothing else has been.
+	vec2 position = FullScreenTexCoords() * 2.0f - 1.0f;
+	gl_Position = vec4(position, 1.0f, 1.0f);
+
+	// The far plane's points all have the same w, so the direction is linear across the screen and can be interpolated.
+	vec4 farPoint = inverseViewProjection * vec4(position, 1.0f, 1.0f);
+	TextureCoords = farPoint.xyz / farPoint.w - viewPosition.xyz;
+}
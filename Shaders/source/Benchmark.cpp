@@ -0,0 +1,793 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <json/json.h>
+
+#include "TransformHierarchy.h"
+#include "Window.h"
+#include "ResourceManager.h"
+#include "Mesh.h"
+#include "Model.h"
+#include "Shader.h"
+#include "StreamingBuffer.h"
+#include "GPUTimer.h"
+#include "GPUProfiler.h"
+#include "UniformBlocks.h"
+#include "EntityManager.h"
+#include "EntitySystems.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "TaskGraph.h"
+#include "Scene.h"
+#include "Camera.h"
+#include "RenderThread.h"
+
+namespace {
+	// Summarises a set of samples, the percentiles show the hitches an average hides.
+	Json::Value Summarise(std::vector<double> p_Samples) {
+		Json::Value summary(Json::objectValue);
+		if (p_Samples.empty())
+			return summary;
+
+		std::sort(p_Samples.begin(), p_Samples.end());
+		auto percentile = [&p_Samples](double p_Percentile) {
+			return p_Samples[std::min(p_Samples.size() - 1, static_cast<size_t>(p_Percentile * (p_Samples.size() - 1) + 0.5))];
+		};
+		summary["mean"] = std::accumulate(p_Samples.begin(), p_Samples.end(), 0.0) / p_Samples.size();
+		summary["median"] = percentile(0.5);
+		summary["p95"] = percentile(0.95);
+		summary["p99"] = percentile(0.99);
+		summary["min"] = p_Samples.front();
+		summary["max"] = p_Samples.back();
+		return summary;
+	}
+}
+
+bool Benchmark::Run(const std::string &p_Name, const std::vector<std::string> &p_Arguments) {
+	if (p_Name == "transforms") {
+		TransformHierarchyUpdate();
+		return true;
+	}
+	if (p_Name == "vertexshader") {
+		VertexShaderCost();
+		return true;
+	}
+	if (p_Name == "ecs") {
+		EntitySystems();
+		return true;
+	}
+	if (p_Name == "jobs") {
+		JobSystemScaling();
+		return true;
+	}
+	if (p_Name == "scene") {
+		SceneBenchmarkSettings settings;
+		return ParseSceneSettings(p_Arguments, settings) && RenderScene(settings);
+	}
+
+	std::cout << "Unknown benchmark: " << p_Name << "\nAvailable benchmarks: transforms, vertexshader, ecs, jobs, scene" << std::endl;
+	return false;
+}
+
+void Benchmark::TransformHierarchyUpdate(unsigned int p_NodeCount, float p_ChangingFraction, unsigned int p_FrameCount) {
+	using Clock = std::chrono::high_resolution_clock;
+	std::mt19937 randomGenerator(1234);
+
+	// Build a forest of small trees: each group of nodes has one root, and the rest form a four-way tree under it.
+	const unsigned int groupSize = 100;
+	TransformHierarchy hierarchy;
+	hierarchy.Reserve(p_NodeCount);
+	std::uniform_real_distribution<float> positionDistribution(-1.0f, 1.0f);
+	for (unsigned int i = 0; i < p_NodeCount; i++) {
+		unsigned int groupStart = i - (i % groupSize);
+		TransformHandle parent = i == groupStart ? s_InvalidTransform : groupStart + (i - groupStart - 1) / 4;
+		glm::vec3 position(positionDistribution(randomGenerator), positionDistribution(randomGenerator), positionDistribution(randomGenerator));
+		hierarchy.AddNode(parent, position);
+	}
+	hierarchy.Update();
+
+	const unsigned int changingNodes = static_cast<unsigned int>(p_NodeCount * p_ChangingFraction);
+	std::uniform_int_distribution<unsigned int> nodeDistribution(0, p_NodeCount - 1);
+	std::uniform_real_distribution<float> angleDistribution(0.0f, glm::two_pi<float>());
+	auto moveRandomNodes = [&]() {
+		for (unsigned int i = 0; i < changingNodes; i++) {
+			TransformHandle node = nodeDistribution(randomGenerator);
+			hierarchy.SetLocalRotation(node, glm::angleAxis(angleDistribution(randomGenerator), glm::vec3(0.0f, 1.0f, 0.0f)));
+		}
+	};
+
+	// Incremental: only the moved nodes, and their descendants, are recalculated.
+	double incrementalMilliseconds = 0.0;
+	unsigned long long incrementalNodes = 0;
+	for (unsigned int frame = 0; frame < p_FrameCount; frame++) {
+		moveRandomNodes();
+		auto start = Clock::now();
+		incrementalNodes += hierarchy.Update();
+		incrementalMilliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Full: every node is recalculated each frame.
+	double fullMilliseconds = 0.0;
+	for (unsigned int frame = 0; frame < p_FrameCount; frame++) {
+		moveRandomNodes();
+		auto start = Clock::now();
+		hierarchy.MarkAllDirty();
+		hierarchy.Update();
+		fullMilliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// Flat Euler rebuild: how GameObject used to build its model matrix every frame, with no hierarchy at all.
+	std::vector<glm::vec3> orientations(p_NodeCount, glm::vec3(15.0f, 30.0f, 45.0f));
+	std::vector<glm::mat4> modelMatrices(p_NodeCount);
+	double eulerMilliseconds = 0.0;
+	for (unsigned int frame = 0; frame < p_FrameCount; frame++) {
+		auto start = Clock::now();
+		for (unsigned int i = 0; i < p_NodeCount; i++) {
+			glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), hierarchy.GetLocalPosition(i));
+			modelMatrix = glm::rotate(modelMatrix, glm::radians(orientations[i].x), glm::vec3(1.0f, 0.0f, 0.0f));
+			modelMatrix = glm::rotate(modelMatrix, glm::radians(orientations[i].y), glm::vec3(0.0f, 1.0f, 0.0f));
+			modelMatrix = glm::rotate(modelMatrix, glm::radians(orientations[i].z), glm::vec3(0.0f, 0.0f, 1.0f));
+			modelMatrices[i] = glm::scale(modelMatrix, hierarchy.GetLocalScale(i));
+		}
+		eulerMilliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	std::cout << "Transform hierarchy: " << p_NodeCount << " nodes, " << changingNodes << " moving per frame, averaged over " << p_FrameCount << " frames."
+		<< "\n\tIncremental update:\t" << incrementalMilliseconds / p_FrameCount << " ms\t(" << incrementalNodes / p_FrameCount << " nodes recalculated)"
+		<< "\n\tFull update:\t\t" << fullMilliseconds / p_FrameCount << " ms\t(" << p_NodeCount << " nodes recalculated)"
+		<< "\n\tFlat Euler rebuild:\t" << eulerMilliseconds / p_FrameCount << " ms" << std::endl;
+}
+
+Mesh Benchmark::CreateSphere(unsigned int p_Segments) {
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	vertices.reserve((p_Segments + 1) * (p_Segments + 1));
+	indices.reserve(p_Segments * p_Segments * 6);
+
+	for (unsigned int ring = 0; ring <= p_Segments; ring++) {
+		float v = static_cast<float>(ring) / p_Segments;
+		float theta = v * glm::pi<float>();
+		for (unsigned int segment = 0; segment <= p_Segments; segment++) {
+			float u = static_cast<float>(segment) / p_Segments;
+			float phi = u * glm::two_pi<float>();
+
+			Vertex vertex;
+			vertex.m_Position = glm::vec3(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi));
+			vertex.m_Normal = vertex.m_Position;
+			vertex.m_TextureCoordinates = glm::vec2(u, v);
+			vertex.m_Tangent = glm::vec3(-glm::sin(phi), 0.0f, glm::cos(phi));
+			vertex.m_Bitangent = glm::cross(vertex.m_Normal, vertex.m_Tangent);
+			vertices.push_back(vertex);
+		}
+	}
+
+	for (unsigned int ring = 0; ring < p_Segments; ring++) {
+		for (unsigned int segment = 0; segment < p_Segments; segment++) {
+			unsigned int first = ring * (p_Segments + 1) + segment;
+			unsigned int second = first + p_Segments + 1;
+			indices.insert(indices.end(), { first, second, first + 1, second, second + 1, first + 1 });
+		}
+	}
+
+	return Mesh(vertices, indices, std::vector<Texture>());
+}
+
+void Benchmark::VertexShaderCost(unsigned int p_SphereSegments, unsigned int p_FrameCount) {
+	std::shared_ptr<Window> window = std::make_shared<Window>();
+	if (!window->InitializeWindow(800, 600, "Vertex shader benchmark"))
+		return;
+
+	std::shared_ptr<Shader> shader = ResourceManagerInstance.GetShader("blinnPhong");
+	Model sphere(std::vector<Mesh>{ CreateSphere(p_SphereSegments) });
+	StreamingBuffer streamingBuffer(GL_UNIFORM_BUFFER, 4096);
+	GPUTimer timer;
+
+	// Only the vertex shader's cost is wanted, so stop the primitives before they're rasterised.
+	glEnable(GL_RASTERIZER_DISCARD);
+	shader->Use();
+	shader->SetVec3("lightPosition", glm::vec3(10.5f, 15.5f, 15.5f));
+
+	auto measure = [&](bool p_UseObjectSpace) {
+		for (unsigned int frame = 0; frame < p_FrameCount; frame++) {
+			streamingBuffer.BeginFrame();
+			StreamingBuffer::Allocation frameAllocation = streamingBuffer.AllocateForBinding(sizeof(FrameUniformData));
+			StreamingBuffer::Allocation objectAllocation = streamingBuffer.AllocateForBinding(sizeof(ObjectUniformData));
+
+			FrameUniformData *frameData = static_cast<FrameUniformData*>(frameAllocation.m_Data);
+			frameData->m_Projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+			frameData->m_View = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			frameData->m_ViewPosition = glm::vec4(0.0f, 0.0f, 3.0f, 1.0f);
+
+			ObjectUniformData *objectData = static_cast<ObjectUniformData*>(objectAllocation.m_Data);
+			objectData->m_Model = glm::rotate(glm::mat4(1.0f), frame * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+			objectData->m_NormalMatrix = glm::mat3x4(glm::transpose(glm::inverse(glm::mat3(objectData->m_Model))));
+			objectData->m_SurfaceColour = glm::vec4(1.0f);
+			glm::mat4 inverseModelMatrix = glm::inverse(objectData->m_Model);
+			objectData->m_ObjectLightPosition = glm::vec4(glm::vec3(inverseModelMatrix * glm::vec4(10.5f, 15.5f, 15.5f, 1.0f)), p_UseObjectSpace ? 1.0f : 0.0f);
+			objectData->m_ObjectViewPosition = inverseModelMatrix * frameData->m_ViewPosition;
+			streamingBuffer.Flush();
+
+			glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBlockBinding::FRAME_DATA), frameAllocation.m_Buffer, frameAllocation.m_Offset, frameAllocation.m_Size);
+			glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBlockBinding::OBJECT_DATA), objectAllocation.m_Buffer, objectAllocation.m_Offset, objectAllocation.m_Size);
+
+			timer.Begin();
+			sphere.Render(shader->GetID());
+			timer.End();
+
+			streamingBuffer.EndFrame();
+			window->SwapBuffers();
+		}
+		return timer.GetAverageMilliseconds();
+	};
+
+	float objectSpaceMilliseconds = measure(true);
+	float normalMatrixMilliseconds = measure(false);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	std::cout << "\nVertex shader cost: " << sphere.GetMeshCount() << " mesh, " << (p_SphereSegments + 1) * (p_SphereSegments + 1) << " vertices, averaged over " << p_FrameCount << " frames."
+		<< "\n\tObject space tangent frame:\t" << objectSpaceMilliseconds << " ms"
+		<< "\n\tCPU normal matrix:\t\t" << normalMatrixMilliseconds << " ms" << std::endl;
+}
+
+void Benchmark::CreateEntities(EntityManager &p_Entities, unsigned int p_EntityCount) {
+	std::mt19937 randomGenerator(1234);
+
+	// Scatter the entities through a cube, around a camera looking down the negative Z-axis, so roughly a twentieth of them are visible.
+	p_Entities.Reserve<TransformComponent, RenderableComponent, ColourComponent, BoundsComponent>(p_EntityCount);
+	std::uniform_real_distribution<float> positionDistribution(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> colourDistribution(0.0f, 1.0f);
+	for (unsigned int i = 0; i < p_EntityCount; i++) {
+		TransformComponent transform;
+		transform.m_Position = glm::vec3(positionDistribution(randomGenerator), positionDistribution(randomGenerator), positionDistribution(randomGenerator));
+		ColourComponent colour;
+		colour.m_Colour = glm::vec3(colourDistribution(randomGenerator), colourDistribution(randomGenerator), colourDistribution(randomGenerator));
+		p_Entities.CreateEntity(transform, RenderableComponent(), colour, BoundsComponent());
+	}
+}
+
+void Benchmark::MoveEntities(JobSystem &p_JobSystem, EntityManager &p_Entities, float p_MovingFraction, float p_Angle) {
+	if (p_MovingFraction <= 0.0f)
+		return;
+
+	// Every nth entity spins, so the moving entities are spread across every chunk.
+	const unsigned int movingStride = std::max(1u, static_cast<unsigned int>(1.0f / p_MovingFraction));
+	glm::quat rotation = glm::angleAxis(p_Angle, glm::vec3(0.0f, 1.0f, 0.0f));
+	std::vector<EntityChunk*> chunks;
+	p_Entities.GetChunks(EntityManager::MakeMask<TransformComponent>(), chunks);
+	p_JobSystem.ParallelFor(chunks.size(), [&](size_t p_Begin, size_t p_End) {
+		for (size_t chunkIndex = p_Begin; chunkIndex < p_End; chunkIndex++) {
+			TransformComponent *transforms = chunks[chunkIndex]->Get<TransformComponent>();
+			const Entity *entities = chunks[chunkIndex]->GetEntities();
+			for (unsigned int i = 0; i < chunks[chunkIndex]->GetCount(); i++) {
+				if (entities[i].m_Index % movingStride != 0)
+					continue;
+
+				transforms[i].m_Rotation = rotation;
+				transforms[i].m_Dirty = true;
+			}
+		}
+	});
+}
+
+void Benchmark::EntitySystems(unsigned int p_EntityCount, float p_MovingFraction, unsigned int p_FrameCount, double p_BudgetMilliseconds) {
+	using Clock = std::chrono::high_resolution_clock;
+
+	JobSystem jobSystem;
+	EntityManager entities;
+	CreateEntities(entities, p_EntityCount);
+
+	TransformSystem transformSystem;
+	CullingSystem cullingSystem;
+	DrawPacketSystem drawPacketSystem;
+	std::vector<DrawPacket> drawPackets;
+	std::vector<unsigned int> drawOrder;
+	transformSystem.Update(jobSystem, entities);
+
+	glm::vec3 viewPosition(0.0f);
+	glm::mat4 projectionMatrix = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	glm::mat4 viewMatrix = glm::lookAt(viewPosition, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	Frustum frustum(projectionMatrix * viewMatrix);
+
+	double moveMilliseconds = 0.0;
+	double transformMilliseconds = 0.0;
+	double cullingMilliseconds = 0.0;
+	double drawPacketMilliseconds = 0.0;
+	double sortMilliseconds = 0.0;
+	double worstFrameMilliseconds = 0.0;
+	size_t transformsUpdated = 0;
+	size_t visibleEntities = 0;
+	for (unsigned int frame = 0; frame < p_FrameCount; frame++) {
+		auto start = Clock::now();
+		MoveEntities(jobSystem, entities, p_MovingFraction, 0.01f * frame);
+		auto moved = Clock::now();
+		transformsUpdated += transformSystem.Update(jobSystem, entities);
+		auto transformed = Clock::now();
+		visibleEntities += cullingSystem.Update(jobSystem, entities, frustum);
+		auto culled = Clock::now();
+		drawPacketSystem.Update(jobSystem, entities, viewPosition, drawPackets);
+		auto emitted = Clock::now();
+		drawPacketSystem.Sort(drawPackets, drawOrder);
+		auto sorted = Clock::now();
+
+		moveMilliseconds += std::chrono::duration<double, std::milli>(moved - start).count();
+		transformMilliseconds += std::chrono::duration<double, std::milli>(transformed - moved).count();
+		cullingMilliseconds += std::chrono::duration<double, std::milli>(culled - transformed).count();
+		drawPacketMilliseconds += std::chrono::duration<double, std::milli>(emitted - culled).count();
+		sortMilliseconds += std::chrono::duration<double, std::milli>(sorted - emitted).count();
+		worstFrameMilliseconds = std::max(worstFrameMilliseconds, std::chrono::duration<double, std::milli>(sorted - moved).count());
+	}
+
+	double frameMilliseconds = (transformMilliseconds + cullingMilliseconds + drawPacketMilliseconds + sortMilliseconds) / p_FrameCount;
+	std::cout << "Entity systems: " << p_EntityCount << " entities in " << entities.GetArchetypeCount() << " archetype(s), " << jobSystem.GetThreadCount()
+		<< " threads, averaged over " << p_FrameCount << " frames."
+		<< "\n\tMoving entities:\t" << moveMilliseconds / p_FrameCount << " ms"
+		<< "\n\tTransform system:\t" << transformMilliseconds / p_FrameCount << " ms\t(" << transformsUpdated / p_FrameCount << " transforms recalculated)"
+		<< "\n\tCulling system:\t\t" << cullingMilliseconds / p_FrameCount << " ms\t(" << visibleEntities / p_FrameCount << " entities visible)"
+		<< "\n\tDraw packet system:\t" << drawPacketMilliseconds / p_FrameCount << " ms\t(" << drawPackets.size() << " packets)"
+		<< "\n\tDraw key sort:\t\t" << sortMilliseconds / p_FrameCount << " ms"
+		<< "\n\tSystems total:\t\t" << frameMilliseconds << " ms average, " << worstFrameMilliseconds << " ms worst"
+		<< "\n\tBudget:\t\t\t" << p_BudgetMilliseconds << " ms, " << (frameMilliseconds <= p_BudgetMilliseconds ? "within budget" : "over budget") << std::endl;
+}
+
+void Benchmark::JobSystemScaling(unsigned int p_EntityCount, float p_MovingFraction, unsigned int p_FrameCount) {
+	using Clock = std::chrono::high_resolution_clock;
+
+	EntityManager entities;
+	CreateEntities(entities, p_EntityCount);
+
+	TransformSystem transformSystem;
+	CullingSystem cullingSystem;
+	DrawPacketSystem drawPacketSystem;
+	std::vector<DrawPacket> drawPackets;
+	std::vector<unsigned int> drawOrder;
+
+	glm::vec3 viewPosition(0.0f);
+	glm::mat4 projectionMatrix = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	Frustum frustum(projectionMatrix * glm::lookAt(viewPosition, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	unsigned int maximumThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << "Job system scaling: the frame graph (transforms, culling, draw packets, draw key sort) on " << p_EntityCount << " entities, "
+		<< p_MovingFraction * 100.0f << "% moving, averaged over " << p_FrameCount << " frames.\n\tThreads\tFrame (ms)\tSpeed-up\tEfficiency" << std::endl;
+
+	double singleThreadMilliseconds = 0.0;
+	for (unsigned int threadCount = 1; threadCount <= maximumThreads; threadCount++) {
+		JobSystem jobSystem(threadCount);
+		TaskGraph frameGraph;
+		TaskHandle transformTask = frameGraph.AddTask("Transforms", [&]() { transformSystem.Update(jobSystem, entities); });
+		TaskHandle cullingTask = frameGraph.AddTask("Culling", [&]() { cullingSystem.Update(jobSystem, entities, frustum); });
+		TaskHandle drawPacketTask = frameGraph.AddTask("Draw packets", [&]() { drawPacketSystem.Update(jobSystem, entities, viewPosition, drawPackets); });
+		TaskHandle sortTask = frameGraph.AddTask("Draw key sort", [&]() { drawPacketSystem.Sort(drawPackets, drawOrder); });
+		frameGraph.AddDependency(transformTask, cullingTask);
+		frameGraph.AddDependency(cullingTask, drawPacketTask);
+		frameGraph.AddDependency(drawPacketTask, sortTask);
+
+		// One frame to warm up the threads and caches.
+		MoveEntities(jobSystem, entities, p_MovingFraction, 0.0f);
+		frameGraph.Execute(jobSystem);
+
+		double milliseconds = 0.0;
+		for (unsigned int frame = 0; frame < p_FrameCount; frame++) {
+			MoveEntities(jobSystem, entities, p_MovingFraction, 0.01f * frame);
+			auto start = Clock::now();
+			frameGraph.Execute(jobSystem);
+			milliseconds += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+		milliseconds /= p_FrameCount;
+		if (threadCount == 1)
+			singleThreadMilliseconds = milliseconds;
+
+		double speedUp = singleThreadMilliseconds / milliseconds;
+		std::cout << "\t" << threadCount << "\t" << milliseconds << "\t\t" << speedUp << "x\t\t" << speedUp / threadCount * 100.0 << "%" << std::endl;
+	}
+}
+
+bool Benchmark::ParseSceneSettings(const std::vector<std::string> &p_Arguments, SceneBenchmarkSettings &p_Settings) {
+	for (size_t i = 0; i < p_Arguments.size(); i++) {
+		const std::string &argument = p_Arguments[i];
+		bool hasValue = i + 1 < p_Arguments.size();
+		if (argument == "--software") {
+			p_Settings.m_UseSoftwareRenderer = true;
+		}
+		else if (argument == "--single-threaded") {
+			p_Settings.m_IsRenderThreaded = false;
+		}
+		else if (argument == "--deferred") {
+			p_Settings.m_UseDeferredShading = true;
+		}
+		else if (argument == "--clustered") {
+			p_Settings.m_UseClusteredShading = true;
+		}
+		else if (argument == "--no-shadows") {
+			p_Settings.m_UseShadows = false;
+		}
+		else if (argument == "--hdr") {
+			p_Settings.m_UseHDREffects = true;
+		}
+		else if (!hasValue) {
+			std::cout << "Unknown, or incomplete, scene benchmark option: " << argument << std::endl;
+			return false;
+		}
+		else if (argument == "--instances") {
+			if (!ParseUnsigned(argument, p_Arguments[++i], p_Settings.m_InstanceCount))
+				return false;
+		}
+		else if (argument == "--lights") {
+			if (!ParseUnsigned(argument, p_Arguments[++i], p_Settings.m_LightCount))
+				return false;
+		}
+		else if (argument == "--light-radius") {
+			if (!ParseFloat(argument, p_Arguments[++i], p_Settings.m_LightRadius))
+				return false;
+		}
+		else if (argument == "--materials") {
+			if (!ParseUnsigned(argument, p_Arguments[++i], p_Settings.m_MaterialCount))
+				return false;
+		}
+		else if (argument == "--models") {
+			// A comma separated list, or "none" for only the spheres.
+			p_Settings.m_ModelNames.clear();
+			std::stringstream modelNames(p_Arguments[++i]);
+			std::string modelName;
+			while (std::getline(modelNames, modelName, ',')) {
+				if (!modelName.empty() && modelName != "none")
+					p_Settings.m_ModelNames.push_back(modelName);
+			}
+		}
+		else if (argument == "--frames") {
+			if (!ParseUnsigned(argument, p_Arguments[++i], p_Settings.m_FrameCount))
+				return false;
+		}
+		else if (argument == "--warm-up") {
+			if (!ParseUnsigned(argument, p_Arguments[++i], p_Settings.m_WarmUpFrameCount))
+				return false;
+		}
+		else if (argument == "--resolution") {
+			// Anything after the height is rejected, as is a size that isn't positive.
+			int width, height;
+			char trailing;
+			if (std::sscanf(p_Arguments[++i].c_str(), "%dx%d%c", &width, &height, &trailing) != 2 || width <= 0 || height <= 0) {
+				std::cout << "The resolution should look like 1920x1080, not: " << p_Arguments[i] << std::endl;
+				return false;
+			}
+			p_Settings.m_Width = width;
+			p_Settings.m_Height = height;
+		}
+		else if (argument == "--aa") {
+			std::string mode = p_Arguments[++i];
+			if (mode == "none")
+				p_Settings.m_AntiAliasing = AntiAliasingMode::NONE;
+			else if (mode == "msaa")
+				p_Settings.m_AntiAliasing = AntiAliasingMode::MSAA;
+			else if (mode == "fxaa")
+				p_Settings.m_AntiAliasing = AntiAliasingMode::FXAA;
+			else if (mode == "smaa")
+				p_Settings.m_AntiAliasing = AntiAliasingMode::SMAA;
+			else {
+				std::cout << "The anti-aliasing should be none, msaa, fxaa or smaa, not: " << mode << std::endl;
+				return false;
+			}
+		}
+		else if (argument == "--frame-budget") {
+			if (!ParseFloat(argument, p_Arguments[++i], p_Settings.m_FrameBudgetMilliseconds))
+				return false;
+		}
+		else if (argument == "--seed") {
+			if (!ParseUnsigned(argument, p_Arguments[++i], p_Settings.m_Seed))
+				return false;
+		}
+		else if (argument == "--output") {
+			p_Settings.m_OutputPath = p_Arguments[++i];
+		}
+		else if (argument == "--label") {
+			p_Settings.m_Label = p_Arguments[++i];
+		}
+		else {
+			std::cout << "Unknown scene benchmark option: " << argument << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Benchmark::ParseUnsigned(const std::string &p_Option, const std::string &p_Value, unsigned int &p_Result) {
+	// strtoul would wrap a negative number round, rather than failing.
+	char *end;
+	unsigned long value = std::strtoul(p_Value.c_str(), &end, 10);
+	if (p_Value.empty() || p_Value.find('-') != std::string::npos || *end != '\0' || value > UINT_MAX) {
+		std::cout << "The value of " << p_Option << " should be a whole number, not: " << p_Value << std::endl;
+		return false;
+	}
+
+	p_Result = static_cast<unsigned int>(value);
+	return true;
+}
+
+bool Benchmark::ParseFloat(const std::string &p_Option, const std::string &p_Value, float &p_Result) {
+	char *end;
+	float value = std::strtof(p_Value.c_str(), &end);
+	if (p_Value.empty() || *end != '\0' || !std::isfinite(value)) {
+		std::cout << "The value of " << p_Option << " should be a number, not: " << p_Value << std::endl;
+		return false;
+	}
+
+	p_Result = value;
+	return true;
+}
+
+unsigned int Benchmark::CreateSolidTexture(const glm::vec4 &p_Colour) {
+	const int size = 4;
+	std::vector<unsigned char> pixels(size * size * 4);
+	for (size_t i = 0; i < pixels.size(); i++)
+		pixels[i] = static_cast<unsigned char>(glm::clamp(p_Colour[i % 4], 0.0f, 1.0f) * 255.0f + 0.5f);
+
+	unsigned int textureID;
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return textureID;
+}
+
+void Benchmark::GetScriptedCameraPose(float p_Progress, float p_Radius, glm::vec3 &p_Position, glm::vec3 &p_Target) {
+	float angle = p_Progress * glm::two_pi<float>();
+	// Far and high at the start and end, close and low halfway round.
+	float swoop = 0.5f - 0.5f * glm::cos(angle);
+	float distance = p_Radius * glm::mix(1.1f, 0.35f, swoop);
+	float height = p_Radius * glm::mix(0.6f, 0.08f, swoop);
+
+	p_Position = glm::vec3(glm::cos(angle) * distance, height, glm::sin(angle) * distance);
+	// Look a little ahead along the path, rather than always at the centre, so the view sweeps across the scene.
+	float aheadAngle = angle + 0.6f;
+	p_Target = glm::vec3(glm::cos(aheadAngle), 0.0f, glm::sin(aheadAngle)) * (p_Radius * 0.3f);
+}
+
+bool Benchmark::RenderScene(const SceneBenchmarkSettings &p_Settings) {
+	using Clock = std::chrono::steady_clock;
+	std::mt19937 randomGenerator(p_Settings.m_Seed);
+
+	std::shared_ptr<Window> window = std::make_shared<Window>();
+	if (!window->InitializeHeadless(p_Settings.m_Width, p_Settings.m_Height, p_Settings.m_UseSoftwareRenderer))
+		return false;
+	std::string renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+	std::string version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+
+	// Each material is its own sphere, with its own textures, so materials cost the same state changes as they would in a real scene.
+	std::vector<std::string> instanceModels;
+	std::uniform_real_distribution<float> unitDistribution(0.0f, 1.0f);
+	for (unsigned int i = 0; i < p_Settings.m_MaterialCount; i++) {
+		Mesh sphere = CreateSphere(32);
+		glm::vec4 diffuse(unitDistribution(randomGenerator), unitDistribution(randomGenerator), unitDistribution(randomGenerator), 1.0f);
+		float specular = unitDistribution(randomGenerator);
+		Texture texture;
+		texture.m_ID = CreateSolidTexture(diffuse);
+		texture.m_Type = "textureDiffuse";
+		sphere.m_Textures.push_back(texture);
+		texture.m_ID = CreateSolidTexture(glm::vec4(specular, specular, specular, 1.0f));
+		texture.m_Type = "textureSpecular";
+		sphere.m_Textures.push_back(texture);
+		texture.m_ID = CreateSolidTexture(glm::vec4(0.5f, 0.5f, 1.0f, 1.0f));
+		texture.m_Type = "textureNormal";
+		sphere.m_Textures.push_back(texture);
+
+		std::string modelName = "benchmarkMaterial" + std::to_string(i);
+		ResourceManagerInstance.AddModel(modelName, std::make_shared<Model>(std::vector<Mesh>{ sphere }));
+		instanceModels.push_back(modelName);
+	}
+	ResourceManagerInstance.AddModel("benchmarkLight", std::make_shared<Model>(std::vector<Mesh>{ CreateSphere(12) }));
+
+	size_t meshesPerInstance = 1;
+	for (const std::string &modelName : p_Settings.m_ModelNames) {
+		std::shared_ptr<Model> model = ResourceManagerInstance.GetModel(modelName);
+		if (!model) {
+			std::cout << "The scene benchmark couldn't find the model: " << modelName << std::endl;
+			return false;
+		}
+		instanceModels.push_back(modelName);
+		meshesPerInstance = std::max(meshesPerInstance, model->HasNodeTransforms() ? model->GetMeshCount() : size_t(1));
+	}
+	if (instanceModels.empty() && p_Settings.m_InstanceCount > 0) {
+		std::cout << "The scene benchmark needs at least one material or model, to place instances of." << std::endl;
+		return false;
+	}
+
+	// Every visible object needs its data streamed each frame, so make sure the worst case fits.
+	const size_t objectDataSize = std::max<size_t>(256, sizeof(ObjectUniformData));
+	size_t regionSize = (p_Settings.m_InstanceCount * meshesPerInstance + p_Settings.m_LightCount + 1) * objectDataSize;
+	regionSize = std::max<size_t>(regionSize, Scene::s_m_DefaultStreamingBufferRegionSize);
+	std::shared_ptr<Scene> scene = std::make_shared<Scene>(window, false, static_cast<unsigned int>(regionSize));
+
+	// Scatter the instances over a disc, spaced so the density stays the same as the count changes.
+	const float spacing = 3.0f;
+	float radius = std::max(10.0f, spacing * glm::sqrt(static_cast<float>(p_Settings.m_InstanceCount)) * 0.5f);
+	std::uniform_int_distribution<size_t> modelDistribution(0, instanceModels.empty() ? 0 : instanceModels.size() - 1);
+	for (unsigned int i = 0; i < p_Settings.m_InstanceCount; i++) {
+		float distance = radius * glm::sqrt(unitDistribution(randomGenerator));
+		float angle = unitDistribution(randomGenerator) * glm::two_pi<float>();
+		glm::vec3 position(glm::cos(angle) * distance, 0.0f, glm::sin(angle) * distance);
+		glm::vec3 colour(unitDistribution(randomGenerator), unitDistribution(randomGenerator), unitDistribution(randomGenerator));
+		scene->CreateRenderableEntity(position, glm::vec3(1.0f), instanceModels[modelDistribution(randomGenerator)], "blinnPhong", colour);
+	}
+	// The lights hover over the same disc, each reaching a fixed distance, so more lights means more overlap rather than brighter lights.
+	glm::vec3 lightAttenuation = LightSystem::CalculateAttenuation(p_Settings.m_LightRadius);
+	for (unsigned int i = 0; i < p_Settings.m_LightCount; i++) {
+		float distance = radius * glm::sqrt(unitDistribution(randomGenerator));
+		float angle = unitDistribution(randomGenerator) * glm::two_pi<float>();
+		glm::vec3 position(glm::cos(angle) * distance, 2.0f + 2.0f * unitDistribution(randomGenerator), glm::sin(angle) * distance);
+		glm::vec3 colour(0.5f + 0.5f * unitDistribution(randomGenerator), 0.5f + 0.5f * unitDistribution(randomGenerator), 0.5f + 0.5f * unitDistribution(randomGenerator));
+		Entity light = scene->CreateRenderableEntity(position, glm::vec3(0.25f), "benchmarkLight", "flat", colour, true);
+		scene->SetLightAttenuation(light, lightAttenuation);
+	}
+	scene->GetRenderSettings().m_UseDeferredShading = p_Settings.m_UseDeferredShading;
+	scene->GetRenderSettings().m_UseClusteredShading = p_Settings.m_UseClusteredShading;
+	scene->GetRenderSettings().m_UseShadows = p_Settings.m_UseShadows;
+	scene->GetRenderSettings().m_AntiAliasing = p_Settings.m_AntiAliasing;
+	scene->GetRenderSettings().m_UseBloom = p_Settings.m_UseHDREffects;
+	scene->GetRenderSettings().m_UseAutoExposure = p_Settings.m_UseHDREffects;
+	scene->GetRenderSettings().m_UseDynamicResolution = p_Settings.m_FrameBudgetMilliseconds > 0.0f;
+	if (p_Settings.m_FrameBudgetMilliseconds > 0.0f)
+		scene->GetRenderSettings().m_FrameBudgetMilliseconds = p_Settings.m_FrameBudgetMilliseconds;
+
+	scene->SetFrameStatisticsRecording(true);
+	std::shared_ptr<RenderThread> renderThread = std::make_shared<RenderThread>(window, scene, p_Settings.m_IsRenderThreaded);
+
+	// A fixed time step, so every run simulates exactly the same frames.
+	const float fixedDeltaTime = 1.0f / 60.0f;
+	unsigned int totalFrameCount = p_Settings.m_WarmUpFrameCount + p_Settings.m_FrameCount;
+	std::vector<double> frameMilliseconds;
+	std::vector<double> simulationMilliseconds;
+	frameMilliseconds.reserve(p_Settings.m_FrameCount);
+	simulationMilliseconds.reserve(p_Settings.m_FrameCount);
+	auto runStart = Clock::now();
+	for (unsigned int frame = 0; frame < totalFrameCount; frame++) {
+		glm::vec3 cameraPosition;
+		glm::vec3 cameraTarget;
+		GetScriptedCameraPose(static_cast<float>(frame) / totalFrameCount, radius, cameraPosition, cameraTarget);
+
+		auto start = Clock::now();
+		FramePacket &packet = renderThread->BeginFrame();
+		scene->GetCamera()->LookAt(cameraPosition, cameraTarget);
+		scene->Update(fixedDeltaTime, packet);
+		auto simulated = Clock::now();
+		renderThread->EndFrame();
+		auto end = Clock::now();
+
+		if (frame >= p_Settings.m_WarmUpFrameCount) {
+			frameMilliseconds.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+			simulationMilliseconds.push_back(std::chrono::duration<double, std::milli>(simulated - start).count());
+		}
+	}
+	renderThread->Stop();
+	double runSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+	// The render thread has stopped, so its statistics can be read.
+	std::vector<double> renderMilliseconds;
+	std::vector<double> gpuMilliseconds;
+	std::vector<double> drawCounts;
+	std::vector<double> triangleCounts;
+	std::vector<double> stateChangeCounts;
+	std::vector<double> renderScales;
+	Json::Value frames(Json::arrayValue);
+	Json::Value stateChanges(Json::objectValue);
+	double programChanges = 0.0;
+	double materialChanges = 0.0;
+	double objectDataChanges = 0.0;
+	double visibleObjects = 0.0;
+	for (const FrameStatistics &statistics : scene->GetFrameStatistics()) {
+		if (statistics.m_FrameIndex < p_Settings.m_WarmUpFrameCount)
+			continue;
+
+		unsigned int stateChangeCount = statistics.m_ProgramChangeCount + statistics.m_MaterialChangeCount + statistics.m_ObjectDataChangeCount;
+		renderMilliseconds.push_back(statistics.m_RenderMilliseconds);
+		gpuMilliseconds.push_back(statistics.m_GPUMilliseconds);
+		drawCounts.push_back(statistics.m_DrawCount);
+		triangleCounts.push_back(statistics.m_TriangleCount);
+		stateChangeCounts.push_back(stateChangeCount);
+		renderScales.push_back(statistics.m_RenderScale);
+		programChanges += statistics.m_ProgramChangeCount;
+		materialChanges += statistics.m_MaterialChangeCount;
+		objectDataChanges += statistics.m_ObjectDataChangeCount;
+		visibleObjects += statistics.m_VisibleObjectCount;
+
+		Json::Value frame(Json::objectValue);
+		frame["frame"] = static_cast<Json::UInt64>(statistics.m_FrameIndex);
+		frame["renderCpuMilliseconds"] = statistics.m_RenderMilliseconds;
+		frame["gpuMilliseconds"] = statistics.m_GPUMilliseconds;
+		frame["renderScale"] = statistics.m_RenderScale;
+		frame["visibleObjects"] = statistics.m_VisibleObjectCount;
+		frame["drawCalls"] = statistics.m_DrawCount;
+		frame["triangles"] = statistics.m_TriangleCount;
+		frame["stateChanges"] = stateChangeCount;
+		frames.append(frame);
+	}
+	double measuredFrames = static_cast<double>(std::max<size_t>(1, drawCounts.size()));
+	stateChanges["programs"] = programChanges / measuredFrames;
+	stateChanges["materials"] = materialChanges / measuredFrames;
+	stateChanges["objectData"] = objectDataChanges / measuredFrames;
+	stateChanges["total"] = Summarise(stateChangeCounts);
+
+	Json::Value root(Json::objectValue);
+	root["benchmark"] = "scene";
+	root["label"] = p_Settings.m_Label;
+	root["renderer"] = renderer;
+	root["version"] = version;
+	root["seconds"] = runSeconds;
+
+	Json::Value settings(Json::objectValue);
+	settings["instances"] = p_Settings.m_InstanceCount;
+	settings["lights"] = p_Settings.m_LightCount;
+	settings["lightRadius"] = p_Settings.m_LightRadius;
+	settings["deferredShading"] = p_Settings.m_UseDeferredShading;
+	settings["clusteredShading"] = p_Settings.m_UseClusteredShading;
+	settings["shadows"] = p_Settings.m_UseShadows;
+	settings["antiAliasing"] = GetAntiAliasingModeName(p_Settings.m_AntiAliasing);
+	settings["hdrEffects"] = p_Settings.m_UseHDREffects;
+	settings["frameBudgetMilliseconds"] = p_Settings.m_FrameBudgetMilliseconds;
+	settings["materials"] = p_Settings.m_MaterialCount;
+	Json::Value modelNames(Json::arrayValue);
+	for (const std::string &modelName : p_Settings.m_ModelNames)
+		modelNames.append(modelName);
+	settings["models"] = modelNames;
+	settings["frames"] = p_Settings.m_FrameCount;
+	settings["warmUpFrames"] = p_Settings.m_WarmUpFrameCount;
+	settings["width"] = p_Settings.m_Width;
+	settings["height"] = p_Settings.m_Height;
+	settings["seed"] = p_Settings.m_Seed;
+	settings["renderThread"] = p_Settings.m_IsRenderThreaded;
+	settings["softwareRenderer"] = p_Settings.m_UseSoftwareRenderer;
+	root["settings"] = settings;
+
+	Json::Value summary(Json::objectValue);
+	summary["cpuFrameMilliseconds"] = Summarise(frameMilliseconds);
+	summary["simulationMilliseconds"] = Summarise(simulationMilliseconds);
+	summary["renderCpuMilliseconds"] = Summarise(renderMilliseconds);
+	summary["gpuMilliseconds"] = Summarise(gpuMilliseconds);
+	summary["renderScale"] = Summarise(renderScales);
+	Json::Value gpuPasses(Json::objectValue);
+	for (const GPUPassTiming &timing : scene->GetGPUProfiler().GetPassTimings())
+		gpuPasses[timing.m_Name] = timing.m_AverageMilliseconds;
+	summary["gpuPassAverageMilliseconds"] = gpuPasses;
+	summary["drawCalls"] = Summarise(drawCounts);
+	summary["triangles"] = Summarise(triangleCounts);
+	summary["stateChanges"] = stateChanges;
+	summary["visibleObjects"] = visibleObjects / measuredFrames;
+	root["summary"] = summary;
+	root["frames"] = frames;
+
+	Json::StyledWriter writer;
+	std::ofstream outputFile(p_Settings.m_OutputPath);
+	if (!outputFile.is_open()) {
+		std::cout << "The scene benchmark couldn't write to: " << p_Settings.m_OutputPath << std::endl;
+		return false;
+	}
+	outputFile << writer.write(root);
+
+	std::cout << "\nScene benchmark: " << p_Settings.m_InstanceCount << " instances, " << p_Settings.m_LightCount << " lights, " << p_Settings.m_MaterialCount
+		<< " materials, " << p_Settings.m_FrameCount << " frames at " << p_Settings.m_Width << "x" << p_Settings.m_Height << " on " << renderer
+		<< "\n\tCPU frame time:\t" << summary["cpuFrameMilliseconds"]["mean"].asDouble() << " ms mean, " << summary["cpuFrameMilliseconds"]["p99"].asDouble() << " ms p99"
+		<< "\n\tGPU time:\t" << summary["gpuMilliseconds"]["mean"].asDouble() << " ms mean"
+		<< "\n\tDraw calls:\t" << summary["drawCalls"]["mean"].asDouble() << "\tTriangles: " << summary["triangles"]["mean"].asDouble()
+		<< "\tState changes: " << stateChanges["total"]["mean"].asDouble()
+		<< "\n\tResults written to " << p_Settings.m_OutputPath << std::endl;
+
+	return true;
+}
@@ -0,0 +1,93 @@
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <json/json.h>
+
+std::mutex CPUProfiler::s_m_BuffersMutex;
+std::vector<std::unique_ptr<CPUProfiler::ThreadBuffer>> CPUProfiler::s_m_Buffers;
+thread_local CPUProfiler::ThreadBuffer *CPUProfiler::t_m_Buffer = nullptr;
+const std::chrono::steady_clock::time_point CPUProfiler::s_m_Epoch = std::chrono::steady_clock::now();
+std::mutex CPUProfiler::s_m_NamesMutex;
+std::unordered_set<std::string> CPUProfiler::s_m_Names;
+
+CPUProfiler::ThreadBuffer &CPUProfiler::GetThreadBuffer() {
+	if (t_m_Buffer == nullptr) {
+		std::lock_guard<std::mutex> lock(s_m_BuffersMutex);
+		s_m_Buffers.push_back(std::make_unique<ThreadBuffer>());
+		t_m_Buffer = s_m_Buffers.back().get();
+		t_m_Buffer->m_ThreadID = static_cast<unsigned int>(s_m_Buffers.size());
+		t_m_Buffer->m_ThreadName = "Thread " + std::to_string(t_m_Buffer->m_ThreadID);
+	}
+
+	return *t_m_Buffer;
+}
+
+void CPUProfiler::SetThreadName(const std::string &p_Name) {
+	ThreadBuffer &buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(s_m_BuffersMutex);
+	buffer.m_ThreadName = p_Name;
+}
+
+const char *CPUProfiler::InternName(const std::string &p_Name) {
+	std::lock_guard<std::mutex> lock(s_m_NamesMutex);
+	return s_m_Names.insert(p_Name).first->c_str();
+}
+
+bool CPUProfiler::WriteChromeTrace(const std::string &p_FilePath) {
+	Json::Value events(Json::arrayValue);
+	{
+		std::lock_guard<std::mutex> lock(s_m_BuffersMutex);
+		for (const auto &buffer : s_m_Buffers) {
+			Json::Value threadName(Json::objectValue);
+			threadName["name"] = "thread_name";
+			threadName["ph"] = "M";
+			threadName["pid"] = 1;
+			threadName["tid"] = buffer->m_ThreadID;
+			threadName["args"]["name"] = buffer->m_ThreadName;
+			events.append(threadName);
+
+			// The owning thread may still be writing, so only keep events it can't have overwritten while they were copied,
+			// counting the one it may be part way through.
+			unsigned long long end = buffer->m_WriteCount.load(std::memory_order_acquire);
+			unsigned long long begin = end > s_m_EventRingSize ? end - s_m_EventRingSize : 0;
+			std::vector<CPUProfileEvent> threadEvents;
+			threadEvents.reserve(static_cast<size_t>(end - begin));
+			for (unsigned long long i = begin; i < end; i++)
+				threadEvents.push_back(buffer->m_Events[i % s_m_EventRingSize]);
+			unsigned long long writtenDuringCopy = buffer->m_WriteCount.load(std::memory_order_acquire) + 1;
+			size_t overwrittenCount = static_cast<size_t>(std::min<unsigned long long>(threadEvents.size(),
+				writtenDuringCopy > s_m_EventRingSize + begin ? writtenDuringCopy - s_m_EventRingSize - begin : 0));
+
+			for (size_t i = overwrittenCount; i < threadEvents.size(); i++) {
+				const CPUProfileEvent &profileEvent = threadEvents[i];
+				Json::Value traceEvent(Json::objectValue);
+				traceEvent["name"] = profileEvent.m_Name;
+				traceEvent["ph"] = "X";
+				traceEvent["pid"] = 1;
+				traceEvent["tid"] = buffer->m_ThreadID;
+				// The trace's times are in microseconds.
+				traceEvent["ts"] = static_cast<double>(profileEvent.m_StartNanoseconds) / 1000.0;
+				traceEvent["dur"] = static_cast<double>(profileEvent.m_DurationNanoseconds) / 1000.0;
+				events.append(traceEvent);
+			}
+		}
+	}
+
+	Json::Value root(Json::objectValue);
+	root["traceEvents"] = events;
+	root["displayTimeUnit"] = "ms";
+
+	std::ofstream traceFile(p_FilePath);
+	if (!traceFile.is_open()) {
+		std::cout << "ERROR::CPU_PROFILER:: Failed to open the trace file: " << p_FilePath << std::endl;
+		return false;
+	}
+	// The trace can hold hundreds of thousands of events, so skip the indentation.
+	Json::FastWriter writer;
+	traceFile << writer.write(root);
+
+	return true;
+}
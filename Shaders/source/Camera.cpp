@@ -55,6 +55,18 @@ void Camera::ProcessMouseMovement(float p_XOffset, float p_YOffset, bool p_Contr
 	UpdateCameraVectors();
 }
 
+void Camera::LookAt(const glm::vec3 &p_Position, const glm::vec3 &p_Target) {
+	m_Position = p_Position;
+
+	// The inverse of UpdateCameraVectors, finding the angles that give this front vector.
+	glm::vec3 front = glm::normalize(p_Target - p_Position);
+	m_Pitch = glm::degrees(asin(front.y));
+	m_Yaw = glm::degrees(atan2(-front.x, -front.z));
+
+	NormalizeAngle();
+	UpdateCameraVectors();
+}
+
 void Camera::NormalizeAngle() {
 	if (this->m_Pitch > s_MaxPitchAngle)
 		this->m_Pitch = s_MaxPitchAngle;
@@ -0,0 +1,128 @@
+#include "CommandBuffer.h"
+
+#include <sstream>
+
+void CommandBuffer::Reset() {
+	m_Commands.clear();
+	m_CurrentProgram = 0;
+	m_CurrentMaterial = nullptr;
+	m_CurrentMaterialProgram = 0;
+	m_CurrentObjectData = { 0, 0, 0 };
+	m_CommandCounts.fill(0);
+	m_IndexCount = 0;
+	m_DroppedCommandCount = 0;
+}
+
+void CommandBuffer::BindProgram(unsigned int p_Program) {
+	if (p_Program == m_CurrentProgram) {
+		m_DroppedCommandCount++;
+		return;
+	}
+	m_CurrentProgram = p_Program;
+
+	Command command;
+	command.m_Type = CommandType::BIND_PROGRAM;
+	command.m_BindProgram.m_Program = p_Program;
+	Add(command);
+}
+
+void CommandBuffer::BindMaterial(const Mesh *p_Material) {
+	// Samplers are set on the program, so a material has to be bound again after the program changes.
+	if (p_Material == m_CurrentMaterial && m_CurrentProgram == m_CurrentMaterialProgram) {
+		m_DroppedCommandCount++;
+		return;
+	}
+	m_CurrentMaterial = p_Material;
+	m_CurrentMaterialProgram = m_CurrentProgram;
+
+	Command command;
+	command.m_Type = CommandType::BIND_MATERIAL;
+	command.m_BindMaterial.m_Material = p_Material;
+	command.m_BindMaterial.m_Program = m_CurrentProgram;
+	Add(command);
+}
+
+void CommandBuffer::BindObjectData(unsigned int p_Buffer, std::ptrdiff_t p_Offset, std::ptrdiff_t p_Size) {
+	if (p_Buffer == m_CurrentObjectData.m_Buffer && p_Offset == m_CurrentObjectData.m_Offset && p_Size == m_CurrentObjectData.m_Size) {
+		m_DroppedCommandCount++;
+		return;
+	}
+	m_CurrentObjectData = { p_Buffer, p_Offset, p_Size };
+
+	Command command;
+	command.m_Type = CommandType::BIND_OBJECT_DATA;
+	command.m_BindObjectData = m_CurrentObjectData;
+	Add(command);
+}
+
+void CommandBuffer::DrawIndexed(unsigned int p_VertexArray, unsigned int p_IndexCount, unsigned int p_FirstIndex) {
+	Command command;
+	command.m_Type = CommandType::DRAW_INDEXED;
+	command.m_DrawIndexed.m_VertexArray = p_VertexArray;
+	command.m_DrawIndexed.m_IndexCount = p_IndexCount;
+	command.m_DrawIndexed.m_FirstIndex = p_FirstIndex;
+	Add(command);
+
+	m_IndexCount += p_IndexCount;
+}
+
+bool CommandBuffer::Validate(std::ptrdiff_t p_ObjectDataAlignment, std::string &p_Error) const {
+	// Replays the state changes, without the graphics API, and checks every draw has what it needs.
+	unsigned int program = 0;
+	const Mesh *material = nullptr;
+	unsigned int materialProgram = 0;
+	bool hasObjectData = false;
+
+	std::ostringstream error;
+	for (size_t i = 0; i < m_Commands.size(); i++) {
+		const Command &command = m_Commands[i];
+		switch (command.m_Type) {
+		case CommandType::BIND_PROGRAM:
+			if (command.m_BindProgram.m_Program == 0)
+				error << "binds program zero";
+			program = command.m_BindProgram.m_Program;
+			break;
+		case CommandType::BIND_MATERIAL:
+			if (command.m_BindMaterial.m_Material == nullptr)
+				error << "binds a null material";
+			else if (program == 0)
+				error << "binds a material before any program";
+			else if (command.m_BindMaterial.m_Program != program)
+				error << "binds a material for program " << command.m_BindMaterial.m_Program << ", but program " << program << " is current";
+			material = command.m_BindMaterial.m_Material;
+			materialProgram = command.m_BindMaterial.m_Program;
+			break;
+		case CommandType::BIND_OBJECT_DATA:
+			if (command.m_BindObjectData.m_Buffer == 0)
+				error << "binds object data from buffer zero";
+			else if (command.m_BindObjectData.m_Offset < 0 || command.m_BindObjectData.m_Size <= 0)
+				error << "binds an empty or negative object data range";
+			else if (p_ObjectDataAlignment > 1 && command.m_BindObjectData.m_Offset % p_ObjectDataAlignment != 0)
+				error << "binds object data at offset " << command.m_BindObjectData.m_Offset << ", which isn't a multiple of " << p_ObjectDataAlignment;
+			hasObjectData = true;
+			break;
+		case CommandType::DRAW_INDEXED:
+			if (program == 0)
+				error << "draws before any program is bound";
+			else if (!hasObjectData)
+				error << "draws before any object data is bound";
+			else if (material != nullptr && materialProgram != program)
+				error << "draws with a material bound to program " << materialProgram << ", after changing to program " << program;
+			else if (command.m_DrawIndexed.m_VertexArray == 0)
+				error << "draws from vertex array zero";
+			else if (command.m_DrawIndexed.m_IndexCount == 0)
+				error << "draws no indices";
+			break;
+		default:
+			error << "has an unknown type, " << static_cast<int>(command.m_Type);
+			break;
+		}
+
+		if (error.tellp() > 0) {
+			p_Error = "Command " + std::to_string(i) + " " + error.str() + ".";
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,39 @@
+#include "CommandReplayer.h"
+
+#include <glad/glad.h>
+
+#include "Mesh.h"
+#include "UniformBlocks.h"
+
+void CommandReplayer::Replay(const CommandBuffer &p_CommandBuffer) {
+	for (const Command &command : p_CommandBuffer.GetCommands()) {
+		switch (command.m_Type) {
+		case CommandType::BIND_PROGRAM:
+			glUseProgram(command.m_BindProgram.m_Program);
+			break;
+		case CommandType::BIND_MATERIAL:
+			command.m_BindMaterial.m_Material->BindTextures(command.m_BindMaterial.m_Program);
+			break;
+		case CommandType::BIND_OBJECT_DATA:
+			glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBlockBinding::OBJECT_DATA), command.m_BindObjectData.m_Buffer,
+				command.m_BindObjectData.m_Offset, command.m_BindObjectData.m_Size);
+			break;
+		case CommandType::DRAW_INDEXED:
+			glBindVertexArray(command.m_DrawIndexed.m_VertexArray);
+			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command.m_DrawIndexed.m_IndexCount), GL_UNSIGNED_INT,
+				reinterpret_cast<const void*>(static_cast<size_t>(command.m_DrawIndexed.m_FirstIndex) * sizeof(unsigned int)));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void CommandReplayer::Replay(const std::vector<CommandBuffer> &p_CommandBuffers) {
+	for (const CommandBuffer &commandBuffer : p_CommandBuffers)
+		Replay(commandBuffer);
+
+	// Leave the same state behind as drawing the meshes directly does.
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE0);
+}
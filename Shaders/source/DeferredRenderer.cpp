@@ -0,0 +1,210 @@
+#include "DeferredRenderer.h"
+
+#include <iostream>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "ResourceManager.h"
+#include "Shader.h"
+
+DeferredRenderer::DeferredRenderer(int p_Width, int p_Height) : m_Width(p_Width), m_Height(p_Height) {
+	m_LightingShader = ResourceManagerInstance.GetShader("deferredLighting");
+	m_LightingShader->Use();
+	m_LightingShader->SetInt("gAlbedoSpecular", 0);
+	m_LightingShader->SetInt("gNormal", 1);
+	m_LightingShader->SetInt("gDepth", 2);
+	m_SunShader = ResourceManagerInstance.GetShader("deferredSun");
+	m_SunShader->Use();
+	m_SunShader->SetInt("gAlbedoSpecular", 0);
+	m_SunShader->SetInt("gNormal", 1);
+	m_SunShader->SetInt("gDepth", 2);
+
+	CreateTargets();
+	CreateLightVolume();
+	glGenVertexArrays(1, &m_EmptyVertexArrayObject);
+}
+
+DeferredRenderer::~DeferredRenderer() {
+	DeleteTargets();
+	glDeleteBuffers(1, &m_VolumeIndexBufferObject);
+	glDeleteBuffers(1, &m_VolumeVertexBufferObject);
+	glDeleteVertexArrays(1, &m_VolumeVertexArrayObject);
+	glDeleteVertexArrays(1, &m_EmptyVertexArrayObject);
+}
+
+void DeferredRenderer::CreateTargets() {
+	auto createTexture = [this](GLenum p_InternalFormat) {
+		unsigned int textureID;
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glTexStorage2D(GL_TEXTURE_2D, 1, p_InternalFormat, m_Width, m_Height);
+		// Every read is a texel fetch at the pixel being lit.
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		return textureID;
+	};
+	m_AlbedoSpecularTexture = createTexture(GL_RGBA8);
+	m_NormalTexture = createTexture(GL_RG16_SNORM);
+	// The same format as the post-processor's depth buffer, so it can be blitted across.
+	m_DepthTexture = createTexture(GL_DEPTH24_STENCIL8);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &m_FrameBufferObject);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_AlbedoSpecularTexture, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_NormalTexture, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthTexture, 0);
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glDrawBuffers(2, drawBuffers);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::DEFERRED_RENDERER:: The G-buffer is not complete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DeferredRenderer::DeleteTargets() {
+	glDeleteFramebuffers(1, &m_FrameBufferObject);
+	const unsigned int textures[] = { m_AlbedoSpecularTexture, m_NormalTexture, m_DepthTexture };
+	glDeleteTextures(3, textures);
+}
+
+void DeferredRenderer::CreateLightVolume() {
+	// A latitude and longitude sphere, pushed out so its flat faces still enclose the unit sphere.
+	const unsigned int segments = s_m_VolumeSegments;
+	const unsigned int rings = s_m_VolumeSegments / 2;
+	float step = glm::pi<float>() / rings;
+	float scale = 1.0f / (glm::cos(step * 0.5f) * glm::cos(step * 0.5f));
+
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
+	for (unsigned int ring = 0; ring <= rings; ring++) {
+		float theta = ring * step;
+		for (unsigned int segment = 0; segment <= segments; segment++) {
+			float phi = segment * step;
+			positions.push_back(glm::vec3(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi)) * scale);
+		}
+	}
+	// Wound anticlockwise seen from outside, so culling the front faces leaves the far side of the volume.
+	for (unsigned int ring = 0; ring < rings; ring++) {
+		for (unsigned int segment = 0; segment < segments; segment++) {
+			unsigned int first = ring * (segments + 1) + segment;
+			unsigned int second = first + segments + 1;
+			indices.insert(indices.end(), { first, first + 1, second, second, first + 1, second + 1 });
+		}
+	}
+	m_VolumeIndexCount = static_cast<unsigned int>(indices.size());
+
+	glGenVertexArrays(1, &m_VolumeVertexArrayObject);
+	glGenBuffers(1, &m_VolumeVertexBufferObject);
+	glGenBuffers(1, &m_VolumeIndexBufferObject);
+	glBindVertexArray(m_VolumeVertexArrayObject);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VolumeVertexBufferObject);
+	glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_VolumeIndexBufferObject);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (GLvoid*)0);
+	glBindVertexArray(0);
+}
+
+void DeferredRenderer::Resize(int p_Width, int p_Height) {
+	if (p_Width == m_Width && p_Height == m_Height)
+		return;
+
+	m_Width = p_Width;
+	m_Height = p_Height;
+	DeleteTargets();
+	CreateTargets();
+}
+
+void DeferredRenderer::BeginGeometryPass() {
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	// The albedo target's alpha holds the specular intensity, so it mustn't be blended.
+	glDisable(GL_BLEND);
+	const float clearColour[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	glClearBufferfv(GL_COLOR, 0, clearColour);
+	glClearBufferfv(GL_COLOR, 1, clearColour);
+	glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+}
+
+void DeferredRenderer::EndGeometryPass(unsigned int p_FrameBufferObject) {
+	glEnable(GL_BLEND);
+
+	// The forward objects and the skybox are drawn afterwards, and have to be hidden by the G-buffer's objects.
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FrameBufferObject);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, p_FrameBufferObject);
+	glBlitFramebuffer(0, 0, m_Width, m_Height, 0, 0, m_Width, m_Height, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, p_FrameBufferObject);
+
+	// The lights are added together, so they have to start from black.
+	const float clearColour[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	glClearBufferfv(GL_COLOR, 0, clearColour);
+}
+
+void DeferredRenderer::BindTargets() {
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, m_AlbedoSpecularTexture);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, m_NormalTexture);
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
+}
+
+void DeferredRenderer::UnbindTargets() {
+	for (int unit = 2; unit >= 0; unit--) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+}
+
+void DeferredRenderer::RenderLights(unsigned int p_LightCount) {
+	if (p_LightCount == 0)
+		return;
+
+	BindTargets();
+
+	// Draw the far side of each volume where it's behind the scene, which works whether or not the camera is inside it.
+	// Depth clamping stops the far side being clipped away, when a volume reaches past the far plane.
+	glBlendFunc(GL_ONE, GL_ONE);
+	glCullFace(GL_FRONT);
+	glDepthFunc(GL_GEQUAL);
+	glDepthMask(GL_FALSE);
+	glEnable(GL_DEPTH_CLAMP);
+
+	m_LightingShader->Use();
+	glBindVertexArray(m_VolumeVertexArrayObject);
+	glDrawElementsInstanced(GL_TRIANGLES, m_VolumeIndexCount, GL_UNSIGNED_INT, 0, p_LightCount);
+	glBindVertexArray(0);
+
+	glDisable(GL_DEPTH_CLAMP);
+	glDepthMask(GL_TRUE);
+	glDepthFunc(GL_LESS);
+	glCullFace(GL_BACK);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	UnbindTargets();
+}
+
+void DeferredRenderer::RenderSun() {
+	BindTargets();
+
+	// Every G-buffer pixel is lit, the shader skips the background by its depth.
+	glBlendFunc(GL_ONE, GL_ONE);
+	glDisable(GL_DEPTH_TEST);
+	glDepthMask(GL_FALSE);
+
+	m_SunShader->Use();
+	glBindVertexArray(m_EmptyVertexArrayObject);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+
+	glDepthMask(GL_TRUE);
+	glEnable(GL_DEPTH_TEST);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	UnbindTargets();
+}
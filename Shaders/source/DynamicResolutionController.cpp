@@ -0,0 +1,57 @@
+#include "DynamicResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float DynamicResolutionController::s_m_MinScale = 0.5f;
+const float DynamicResolutionController::s_m_MaxScale = 1.0f;
+const float DynamicResolutionController::s_m_ScaleStep = 1.0f / 16.0f;
+const float DynamicResolutionController::s_m_TargetUsage = 0.85f;
+const float DynamicResolutionController::s_m_LowerUsage = 0.7f;
+const float DynamicResolutionController::s_m_UpperUsage = 0.95f;
+const float DynamicResolutionController::s_m_SmoothingWeight = 0.25f;
+
+DynamicResolutionController::DynamicResolutionController(float p_BudgetMilliseconds) : m_BudgetMilliseconds(p_BudgetMilliseconds) {
+
+}
+
+float DynamicResolutionController::Update(float p_GPUMilliseconds) {
+	m_FramesSinceChange++;
+	if (p_GPUMilliseconds <= 0.0f || m_FramesSinceChange <= s_m_LatencyFrameCount)
+		return m_Scale;
+
+	if (m_SmoothedMilliseconds == 0.0f)
+		m_SmoothedMilliseconds = p_GPUMilliseconds;
+	else
+		m_SmoothedMilliseconds += (p_GPUMilliseconds - m_SmoothedMilliseconds) * s_m_SmoothingWeight;
+	if (m_FramesSinceChange < s_m_LatencyFrameCount + s_m_SampleFrameCount)
+		return m_Scale;
+
+	float usage = m_SmoothedMilliseconds / m_BudgetMilliseconds;
+	if (usage > s_m_LowerUsage && usage < s_m_UpperUsage)
+		return m_Scale;
+
+	// Snapped to a step, rounding down when falling so one change is enough, and only ever rising one step.
+	float idealScale = m_Scale * std::sqrt(s_m_TargetUsage / usage);
+	float scale;
+	if (idealScale < m_Scale)
+		scale = std::floor(idealScale / s_m_ScaleStep) * s_m_ScaleStep;
+	else
+		scale = std::min(m_Scale + s_m_ScaleStep, std::floor(idealScale / s_m_ScaleStep) * s_m_ScaleStep);
+	scale = std::min(s_m_MaxScale, std::max(s_m_MinScale, scale));
+
+	if (scale != m_Scale) {
+		m_Scale = scale;
+		m_FramesSinceChange = 0;
+		m_SmoothedMilliseconds = 0.0f;
+		m_ChangeCount++;
+	}
+
+	return m_Scale;
+}
+
+void DynamicResolutionController::Reset() {
+	m_Scale = s_m_MaxScale;
+	m_FramesSinceChange = 0;
+	m_SmoothedMilliseconds = 0.0f;
+}
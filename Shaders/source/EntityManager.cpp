@@ -0,0 +1,101 @@
+#include "EntityManager.h"
+
+#include <algorithm>
+
+EntityManager::Archetype *EntityManager::GetArchetype(const ComponentMask &p_Mask) {
+	for (auto &archetype : m_Archetypes) {
+		if (archetype->m_Mask == p_Mask)
+			return archetype.get();
+	}
+
+	auto archetype = std::make_unique<Archetype>();
+	archetype->m_Mask = p_Mask;
+
+	size_t rowSize = 0;
+	for (size_t i = 0; i < s_ComponentSizes.size(); i++) {
+		if (p_Mask.test(i))
+			rowSize += s_ComponentSizes[i];
+	}
+	// Leave room for each array to be padded to the column alignment.
+	size_t padding = s_m_ColumnAlignment * p_Mask.count();
+	archetype->m_ChunkCapacity = static_cast<unsigned int>(std::max<size_t>(1, (s_m_ChunkSize - padding) / std::max<size_t>(1, rowSize)));
+
+	size_t offset = 0;
+	for (size_t i = 0; i < s_ComponentSizes.size(); i++) {
+		archetype->m_ColumnOffsets[i] = offset;
+		if (p_Mask.test(i)) {
+			offset += s_ComponentSizes[i] * archetype->m_ChunkCapacity;
+			offset = (offset + s_m_ColumnAlignment - 1) & ~(s_m_ColumnAlignment - 1);
+		}
+	}
+	archetype->m_ChunkDataSize = std::max<size_t>(offset, 1);
+
+	m_Archetypes.push_back(std::move(archetype));
+	return m_Archetypes.back().get();
+}
+
+EntityManager::EntityRecord &EntityManager::AllocateRow(Archetype &p_Archetype, Entity p_Entity) {
+	if (p_Archetype.m_Chunks.empty() || p_Archetype.m_Chunks.back()->m_Count == p_Archetype.m_ChunkCapacity) {
+		auto chunk = std::make_unique<EntityChunk>();
+		chunk->m_Data.reset(new unsigned char[p_Archetype.m_ChunkDataSize]);
+		chunk->m_Mask = p_Archetype.m_Mask;
+		chunk->m_ColumnOffsets = p_Archetype.m_ColumnOffsets.data();
+		chunk->m_Entities.reset(new Entity[p_Archetype.m_ChunkCapacity]);
+		p_Archetype.m_Chunks.push_back(std::move(chunk));
+	}
+
+	EntityChunk &chunk = *p_Archetype.m_Chunks.back();
+	EntityRecord &record = m_Records[p_Entity.m_Index];
+	record.m_Archetype = &p_Archetype;
+	record.m_Chunk = static_cast<unsigned int>(p_Archetype.m_Chunks.size() - 1);
+	record.m_Row = chunk.m_Count;
+	chunk.m_Entities[chunk.m_Count] = p_Entity;
+	chunk.m_Count++;
+	m_EntityCount++;
+
+	return record;
+}
+
+void EntityManager::DestroyEntity(Entity p_Entity) {
+	if (!IsAlive(p_Entity))
+		return;
+
+	EntityRecord &record = m_Records[p_Entity.m_Index];
+	Archetype &archetype = *record.m_Archetype;
+	EntityChunk &chunk = *archetype.m_Chunks[record.m_Chunk];
+	EntityChunk &lastChunk = *archetype.m_Chunks.back();
+	unsigned int lastRow = lastChunk.m_Count - 1;
+
+	// Fill the hole with the archetype's last entity, so only the last chunk is ever partly full.
+	if (&chunk != &lastChunk || record.m_Row != lastRow) {
+		for (size_t i = 0; i < s_ComponentSizes.size(); i++) {
+			if (archetype.m_Mask.test(i))
+				std::memcpy(chunk.GetComponentData(i, record.m_Row), lastChunk.GetComponentData(i, lastRow), s_ComponentSizes[i]);
+		}
+
+		Entity movedEntity = lastChunk.m_Entities[lastRow];
+		chunk.m_Entities[record.m_Row] = movedEntity;
+		m_Records[movedEntity.m_Index].m_Chunk = record.m_Chunk;
+		m_Records[movedEntity.m_Index].m_Row = record.m_Row;
+	}
+
+	lastChunk.m_Count--;
+	if (lastChunk.m_Count == 0)
+		archetype.m_Chunks.pop_back();
+
+	record.m_Archetype = nullptr;
+	record.m_Generation++;
+	m_FreeRecords.push_back(p_Entity.m_Index);
+	m_EntityCount--;
+}
+
+void EntityManager::GetChunks(const ComponentMask &p_Mask, std::vector<EntityChunk*> &p_Chunks) const {
+	p_Chunks.clear();
+	for (const auto &archetype : m_Archetypes) {
+		if ((archetype->m_Mask & p_Mask) != p_Mask)
+			continue;
+
+		for (const auto &chunk : archetype->m_Chunks)
+			p_Chunks.push_back(chunk.get());
+	}
+}
@@ -0,0 +1,315 @@
+#include "EntitySystems.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "FramePacket.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "Shader.h"
+
+const float LightSystem::s_m_MaxRadius = 1000.0f;
+
+glm::mat4 TransformSystem::CalculateLocalMatrix(const TransformComponent &p_Transform, glm::mat3 &p_NormalMatrix) {
+	// A rotation and scale: the normal matrix, the inverse transpose, is the rotation divided by the scale, no inverse needed.
+	glm::mat3 rotation = glm::mat3_cast(p_Transform.m_Rotation);
+	p_NormalMatrix = glm::mat3(rotation[0] / p_Transform.m_Scale.x, rotation[1] / p_Transform.m_Scale.y, rotation[2] / p_Transform.m_Scale.z);
+	return glm::mat4(glm::vec4(rotation[0] * p_Transform.m_Scale.x, 0.0f), glm::vec4(rotation[1] * p_Transform.m_Scale.y, 0.0f),
+		glm::vec4(rotation[2] * p_Transform.m_Scale.z, 0.0f), glm::vec4(p_Transform.m_Position, 1.0f));
+}
+
+size_t TransformSystem::Update(JobSystem &p_JobSystem, EntityManager &p_Entities) {
+	p_Entities.GetChunks(EntityManager::MakeMask<TransformComponent>(), m_Chunks);
+	m_Children.clear();
+
+	std::atomic<size_t> updated{ 0 };
+	p_JobSystem.ParallelFor(m_Chunks.size(), [this, &updated](size_t p_Begin, size_t p_End) {
+		size_t jobUpdated = 0;
+		std::vector<ChildTransform> jobChildren;
+		for (size_t chunkIndex = p_Begin; chunkIndex < p_End; chunkIndex++) {
+			EntityChunk *chunk = m_Chunks[chunkIndex];
+			TransformComponent *transforms = chunk->Get<TransformComponent>();
+			BoundsComponent *bounds = chunk->Has<BoundsComponent>() ? chunk->Get<BoundsComponent>() : nullptr;
+			ShadowCasterComponent *casters = chunk->Has<ShadowCasterComponent>() ? chunk->Get<ShadowCasterComponent>() : nullptr;
+
+			for (unsigned int i = 0; i < chunk->GetCount(); i++) {
+				TransformComponent &transform = transforms[i];
+				if (transform.m_Parent != Entity()) {
+					jobChildren.push_back({ chunk, i, 0 });
+					continue;
+				}
+				if (!transform.m_Dirty)
+					continue;
+
+				transform.m_WorldMatrix = CalculateLocalMatrix(transform, transform.m_NormalMatrix);
+				transform.m_Dirty = false;
+
+				if (bounds) {
+					glm::vec3 scale = glm::abs(transform.m_Scale);
+					bounds[i].m_WorldCentre = glm::vec3(transform.m_WorldMatrix * glm::vec4(bounds[i].m_LocalCentre, 1.0f));
+					bounds[i].m_WorldRadius = bounds[i].m_LocalRadius * glm::max(scale.x, glm::max(scale.y, scale.z));
+				}
+				if (casters)
+					casters[i].m_HasMoved = true;
+				jobUpdated++;
+			}
+		}
+		updated += jobUpdated;
+
+		if (!jobChildren.empty()) {
+			std::lock_guard<std::mutex> lock(m_ChildrenMutex);
+			m_Children.insert(m_Children.end(), jobChildren.begin(), jobChildren.end());
+		}
+	});
+
+	return updated + UpdateChildren(p_Entities);
+}
+
+size_t TransformSystem::UpdateChildren(EntityManager &p_Entities) {
+	if (m_Children.empty())
+		return 0;
+
+	// Sorting by depth puts every parent before its children. A chain longer than the number of children loops back on itself.
+	const unsigned int maxDepth = static_cast<unsigned int>(m_Children.size());
+	for (ChildTransform &child : m_Children) {
+		const TransformComponent *parent = p_Entities.GetComponent<TransformComponent>(child.m_Chunk->Get<TransformComponent>()[child.m_Row].m_Parent);
+		while (parent && child.m_Depth < maxDepth) {
+			child.m_Depth++;
+			parent = p_Entities.GetComponent<TransformComponent>(parent->m_Parent);
+		}
+	}
+	std::stable_sort(m_Children.begin(), m_Children.end(), [](const ChildTransform &p_First, const ChildTransform &p_Second) {
+		return p_First.m_Depth < p_Second.m_Depth;
+	});
+
+	size_t updated = 0;
+	for (const ChildTransform &child : m_Children) {
+		TransformComponent &transform = child.m_Chunk->Get<TransformComponent>()[child.m_Row];
+		glm::mat3 localNormalMatrix;
+		glm::mat4 worldMatrix = CalculateLocalMatrix(transform, localNormalMatrix);
+		glm::mat3 normalMatrix = localNormalMatrix;
+		// A parent that's been destroyed leaves the child relative to the world.
+		const TransformComponent *parent = p_Entities.GetComponent<TransformComponent>(transform.m_Parent);
+		if (parent) {
+			worldMatrix = parent->m_WorldMatrix * worldMatrix;
+			normalMatrix = parent->m_NormalMatrix * localNormalMatrix;
+		}
+
+		bool hasMoved = transform.m_Dirty || worldMatrix != transform.m_WorldMatrix;
+		transform.m_Dirty = false;
+		if (!hasMoved)
+			continue;
+
+		transform.m_WorldMatrix = worldMatrix;
+		transform.m_NormalMatrix = normalMatrix;
+		if (child.m_Chunk->Has<BoundsComponent>()) {
+			// The parents' scales are in the world matrix, so the radius is scaled by its longest axis.
+			BoundsComponent &bounds = child.m_Chunk->Get<BoundsComponent>()[child.m_Row];
+			float scale = glm::max(glm::length(glm::vec3(worldMatrix[0])), glm::max(glm::length(glm::vec3(worldMatrix[1])), glm::length(glm::vec3(worldMatrix[2]))));
+			bounds.m_WorldCentre = glm::vec3(worldMatrix * glm::vec4(bounds.m_LocalCentre, 1.0f));
+			bounds.m_WorldRadius = bounds.m_LocalRadius * scale;
+		}
+		if (child.m_Chunk->Has<ShadowCasterComponent>())
+			child.m_Chunk->Get<ShadowCasterComponent>()[child.m_Row].m_HasMoved = true;
+		updated++;
+	}
+
+	return updated;
+}
+
+size_t CullingSystem::Update(JobSystem &p_JobSystem, EntityManager &p_Entities, const Frustum &p_Frustum) {
+	p_Entities.GetChunks(EntityManager::MakeMask<BoundsComponent>(), m_Chunks);
+
+	std::atomic<size_t> visible{ 0 };
+	p_JobSystem.ParallelFor(m_Chunks.size(), [this, &p_Frustum, &visible](size_t p_Begin, size_t p_End) {
+		size_t jobVisible = 0;
+		for (size_t chunkIndex = p_Begin; chunkIndex < p_End; chunkIndex++) {
+			EntityChunk *chunk = m_Chunks[chunkIndex];
+			BoundsComponent *bounds = chunk->Get<BoundsComponent>();
+
+			for (unsigned int i = 0; i < chunk->GetCount(); i++) {
+				bounds[i].m_IsVisible = p_Frustum.IntersectsSphere(bounds[i].m_WorldCentre, bounds[i].m_WorldRadius);
+				jobVisible += bounds[i].m_IsVisible ? 1 : 0;
+			}
+		}
+		visible += jobVisible;
+	});
+
+	return visible;
+}
+
+unsigned long long DrawPacketSystem::MakeSortKey(const DrawPacket &p_DrawPacket, float p_Distance) {
+	// The top 16 bits are the shader program, so packets sharing a program are drawn together.
+	unsigned long long shaderBits = static_cast<unsigned long long>(p_DrawPacket.m_Shader ? p_DrawPacket.m_Shader->GetID() & 0xFFFF : 0) << 48;
+
+	// The next 24 bits group packets by model. Two models folding to the same bits only costs some extra state changes.
+	std::uintptr_t modelAddress = reinterpret_cast<std::uintptr_t>(p_DrawPacket.m_Model);
+	unsigned long long modelBits = (static_cast<unsigned long long>(modelAddress ^ (modelAddress >> 24)) >> 4 & 0xFFFFFF) << 24;
+
+	// The bottom 24 bits are the distance. A positive float's bits sort the same way as its value, so no range is needed.
+	std::uint32_t distanceBits;
+	std::memcpy(&distanceBits, &p_Distance, sizeof(distanceBits));
+	unsigned long long depthBits = distanceBits >> 8;
+
+	return shaderBits | modelBits | depthBits;
+}
+
+void DrawPacketSystem::Update(JobSystem &p_JobSystem, EntityManager &p_Entities, const glm::vec3 &p_ViewPosition, std::vector<DrawPacket> &p_DrawPackets) {
+	p_Entities.GetChunks(EntityManager::MakeMask<TransformComponent, RenderableComponent>(), m_Chunks);
+
+	// Count each chunk's visible entities first, so every chunk can write its packets straight into its own part of the list.
+	m_ChunkOffsets.resize(m_Chunks.size() + 1);
+	m_ChunkOffsets[0] = 0;
+	for (size_t i = 0; i < m_Chunks.size(); i++) {
+		const EntityChunk *chunk = m_Chunks[i];
+		size_t visible = chunk->GetCount();
+		if (chunk->Has<BoundsComponent>()) {
+			const BoundsComponent *bounds = chunk->Get<BoundsComponent>();
+			visible = std::count_if(bounds, bounds + chunk->GetCount(), [](const BoundsComponent &p_Bounds) { return p_Bounds.m_IsVisible; });
+		}
+		m_ChunkOffsets[i + 1] = m_ChunkOffsets[i] + visible;
+	}
+	p_DrawPackets.resize(m_ChunkOffsets.back());
+
+	p_JobSystem.ParallelFor(m_Chunks.size(), [this, &p_ViewPosition, &p_DrawPackets](size_t p_Begin, size_t p_End) {
+		for (size_t chunkIndex = p_Begin; chunkIndex < p_End; chunkIndex++) {
+			const EntityChunk *chunk = m_Chunks[chunkIndex];
+			DrawPacket *drawPacket = p_DrawPackets.data() + m_ChunkOffsets[chunkIndex];
+
+			const TransformComponent *transforms = chunk->Get<TransformComponent>();
+			const RenderableComponent *renderables = chunk->Get<RenderableComponent>();
+			const BoundsComponent *bounds = chunk->Has<BoundsComponent>() ? chunk->Get<BoundsComponent>() : nullptr;
+			const ColourComponent *colours = chunk->Has<ColourComponent>() ? chunk->Get<ColourComponent>() : nullptr;
+			const Entity *entities = chunk->GetEntities();
+
+			for (unsigned int i = 0; i < chunk->GetCount(); i++) {
+				if (bounds && !bounds[i].m_IsVisible)
+					continue;
+
+				drawPacket->m_Model = renderables[i].m_Model;
+				drawPacket->m_Shader = renderables[i].m_Shader;
+				drawPacket->m_WorldMatrix = transforms[i].m_WorldMatrix;
+				drawPacket->m_NormalMatrix = transforms[i].m_NormalMatrix;
+				drawPacket->m_Colour = colours ? colours[i].m_Colour : glm::vec3(1.0f);
+				drawPacket->m_Entity = entities[i];
+				drawPacket->m_SortKey = MakeSortKey(*drawPacket, glm::distance(p_ViewPosition, glm::vec3(transforms[i].m_WorldMatrix[3])));
+				drawPacket++;
+			}
+		}
+	});
+}
+
+void DrawPacketSystem::Sort(const std::vector<DrawPacket> &p_DrawPackets, std::vector<unsigned int> &p_DrawOrder) {
+	m_DrawKeys.resize(p_DrawPackets.size());
+	for (size_t i = 0; i < p_DrawPackets.size(); i++)
+		m_DrawKeys[i] = { p_DrawPackets[i].m_SortKey, static_cast<unsigned int>(i) };
+
+	std::sort(m_DrawKeys.begin(), m_DrawKeys.end(), [](const DrawKey &p_First, const DrawKey &p_Second) { return p_First.m_SortKey < p_Second.m_SortKey; });
+
+	p_DrawOrder.resize(m_DrawKeys.size());
+	for (size_t i = 0; i < m_DrawKeys.size(); i++)
+		p_DrawOrder[i] = m_DrawKeys[i].m_Index;
+}
+
+size_t ShadowCasterSystem::Update(EntityManager &p_Entities, std::vector<ShadowCaster> &p_Casters, std::vector<glm::vec4> &p_MovedStaticBounds) {
+	p_Entities.GetChunks(EntityManager::MakeMask<TransformComponent, RenderableComponent, BoundsComponent, ShadowCasterComponent>(), m_Chunks);
+
+	// Only copies, one pass on the calling thread keeps the moved list in a stable order.
+	p_Casters.clear();
+	p_MovedStaticBounds.clear();
+	for (EntityChunk *chunk : m_Chunks) {
+		const TransformComponent *transforms = chunk->Get<TransformComponent>();
+		const RenderableComponent *renderables = chunk->Get<RenderableComponent>();
+		const BoundsComponent *bounds = chunk->Get<BoundsComponent>();
+		ShadowCasterComponent *casters = chunk->Get<ShadowCasterComponent>();
+
+		for (unsigned int i = 0; i < chunk->GetCount(); i++) {
+			ShadowCaster caster;
+			caster.m_Model = renderables[i].m_Model;
+			caster.m_WorldMatrix = transforms[i].m_WorldMatrix;
+			caster.m_Bounds = glm::vec4(bounds[i].m_WorldCentre, bounds[i].m_WorldRadius);
+			caster.m_IsStatic = casters[i].m_IsStatic;
+			p_Casters.push_back(caster);
+
+			if (!casters[i].m_HasMoved)
+				continue;
+			// Both where it was cached and where it is, as either could be in a cache. Moving casters are never cached.
+			if (casters[i].m_CachedBounds.w > 0.0f)
+				p_MovedStaticBounds.push_back(casters[i].m_CachedBounds);
+			if (caster.m_IsStatic)
+				p_MovedStaticBounds.push_back(caster.m_Bounds);
+			casters[i].m_CachedBounds = caster.m_IsStatic ? caster.m_Bounds : glm::vec4(0.0f);
+			casters[i].m_HasMoved = false;
+		}
+	}
+
+	return p_Casters.size();
+}
+
+float ShadowCasterSystem::CalculateReceiverDepth(EntityManager &p_Entities, const glm::mat4 &p_ViewMatrix) {
+	p_Entities.GetChunks(EntityManager::MakeMask<RenderableComponent, BoundsComponent>(), m_Chunks);
+
+	// The view depth is minus the view space z, so only the third row of the view matrix is needed.
+	glm::vec4 depthRow = -glm::vec4(p_ViewMatrix[0][2], p_ViewMatrix[1][2], p_ViewMatrix[2][2], p_ViewMatrix[3][2]);
+	float receiverDepth = 0.0f;
+	for (const EntityChunk *chunk : m_Chunks) {
+		const BoundsComponent *bounds = chunk->Get<BoundsComponent>();
+		for (unsigned int i = 0; i < chunk->GetCount(); i++) {
+			if (bounds[i].m_IsVisible)
+				receiverDepth = glm::max(receiverDepth, glm::dot(depthRow, glm::vec4(bounds[i].m_WorldCentre, 1.0f)) + bounds[i].m_WorldRadius);
+		}
+	}
+
+	return receiverDepth;
+}
+
+size_t LightSystem::Update(EntityManager &p_Entities, const Frustum &p_Frustum, std::vector<FrameLight> &p_Lights) {
+	p_Entities.GetChunks(EntityManager::MakeMask<TransformComponent, LightComponent>(), m_Chunks);
+
+	// There are far fewer lights than objects, so one pass on the calling thread is enough.
+	p_Lights.clear();
+	for (const EntityChunk *chunk : m_Chunks) {
+		const TransformComponent *transforms = chunk->Get<TransformComponent>();
+		const LightComponent *lights = chunk->Get<LightComponent>();
+
+		for (unsigned int i = 0; i < chunk->GetCount(); i++) {
+			FrameLight light;
+			light.m_Position = glm::vec3(transforms[i].m_WorldMatrix[3]);
+			light.m_Colour = lights[i].m_Colour;
+			light.m_Attenuation = lights[i].m_Attenuation;
+			light.m_Radius = CalculateRadius(light.m_Colour, light.m_Attenuation);
+			if (p_Frustum.IntersectsSphere(light.m_Position, light.m_Radius))
+				p_Lights.push_back(light);
+		}
+	}
+
+	return p_Lights.size();
+}
+
+float LightSystem::CalculateRadius(const glm::vec3 &p_Colour, const glm::vec3 &p_Attenuation) {
+	// The shaders scale the light by constant / (constant + linear * d + quadratic * d^2), solve for the distance it drops to 1/256.
+	const float cutOff = 256.0f;
+	float brightness = glm::max(p_Colour.r, glm::max(p_Colour.g, p_Colour.b));
+	float constant = p_Attenuation.x;
+	float linear = p_Attenuation.y;
+	float quadratic = p_Attenuation.z;
+	float target = constant * (cutOff * brightness - 1.0f);
+	if (target <= 0.0f)
+		return 0.0f;
+	// Without any fall-off the light never drops to the cut off, it's capped so its volume and cluster bounds stay finite.
+	if (quadratic <= 0.0f)
+		return linear > 0.0f ? glm::min(target / linear, s_m_MaxRadius) : s_m_MaxRadius;
+
+	return glm::min((-linear + glm::sqrt(linear * linear + 4.0f * quadratic * target)) / (2.0f * quadratic), s_m_MaxRadius);
+}
+
+glm::vec3 LightSystem::CalculateAttenuation(float p_Radius) {
+	// Split the fall-off between the linear and quadratic terms, so the light fades smoothly rather than dropping at the edge.
+	const float cutOff = 256.0f;
+	float radius = glm::max(p_Radius, 0.001f);
+	float linear = (cutOff - 1.0f) * 0.25f / radius;
+	float quadratic = (cutOff - 1.0f) * 0.75f / (radius * radius);
+	return glm::vec3(1.0f, linear, quadratic);
+}
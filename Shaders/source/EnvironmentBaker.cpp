@@ -0,0 +1,306 @@
+#include "EnvironmentBaker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <emmintrin.h>
+
+#include "CPUProfiler.h"
+#include "JobSystem.h"
+
+// The first nine real spherical harmonics, at a unit direction.
+static std::array<float, 9> GetSphericalHarmonicBasis(const glm::vec3 &p_Direction) {
+	const glm::vec3 &d = p_Direction;
+	return { {
+		0.282095f,
+		0.488603f * d.y,
+		0.488603f * d.z,
+		0.488603f * d.x,
+		1.092548f * d.x * d.y,
+		1.092548f * d.y * d.z,
+		0.315392f * (3.0f * d.z * d.z - 1.0f),
+		1.092548f * d.x * d.z,
+		0.546274f * (d.x * d.x - d.y * d.y)
+	} };
+}
+
+// The solid angle from the face's centre out to a point on it, the face running from -1 to 1.
+static float GetAreaElement(float p_X, float p_Y) {
+	return std::atan2(p_X * p_Y, std::sqrt(p_X * p_X + p_Y * p_Y + 1.0f));
+}
+
+// The solid angle a texel covers, which shrinks towards the face's corners.
+static float GetTexelSolidAngle(int p_X, int p_Y, int p_Size) {
+	float x0 = 2.0f * p_X / p_Size - 1.0f;
+	float y0 = 2.0f * p_Y / p_Size - 1.0f;
+	float x1 = 2.0f * (p_X + 1) / p_Size - 1.0f;
+	float y1 = 2.0f * (p_Y + 1) / p_Size - 1.0f;
+	return std::abs(GetAreaElement(x0, y0) - GetAreaElement(x0, y1) - GetAreaElement(x1, y0) + GetAreaElement(x1, y1));
+}
+
+static float SumLanes(__m128 p_Value) {
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, p_Value);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+glm::vec3 EnvironmentBaker::GetTexelDirection(int p_Face, int p_X, int p_Y, int p_Size) {
+	float u = 2.0f * (p_X + 0.5f) / p_Size - 1.0f;
+	float v = 2.0f * (p_Y + 0.5f) / p_Size - 1.0f;
+	// The inverse of the GL's face selection, for +X, -X, +Y, -Y, +Z and -Z.
+	switch (p_Face) {
+	case 0:
+		return glm::normalize(glm::vec3(1.0f, -v, -u));
+	case 1:
+		return glm::normalize(glm::vec3(-1.0f, -v, u));
+	case 2:
+		return glm::normalize(glm::vec3(u, 1.0f, v));
+	case 3:
+		return glm::normalize(glm::vec3(u, -1.0f, -v));
+	case 4:
+		return glm::normalize(glm::vec3(u, -v, 1.0f));
+	default:
+		return glm::normalize(glm::vec3(-u, -v, -1.0f));
+	}
+}
+
+CubeMapImage EnvironmentBaker::Resize(const CubeMapImage &p_Image, int p_Size) {
+	CubeMapImage resized;
+	resized.m_Size = p_Size;
+	resized.m_Texels.resize(static_cast<size_t>(6) * p_Size * p_Size);
+	for (int face = 0; face < 6; face++) {
+		for (int y = 0; y < p_Size; y++) {
+			// The block of texels the new texel covers, at least one when it's being made larger.
+			int y0 = y * p_Image.m_Size / p_Size;
+			int y1 = std::max(y0 + 1, (y + 1) * p_Image.m_Size / p_Size);
+			for (int x = 0; x < p_Size; x++) {
+				int x0 = x * p_Image.m_Size / p_Size;
+				int x1 = std::max(x0 + 1, (x + 1) * p_Image.m_Size / p_Size);
+				glm::vec3 sum(0.0f);
+				for (int sourceY = y0; sourceY < y1; sourceY++) {
+					for (int sourceX = x0; sourceX < x1; sourceX++)
+						sum += p_Image.At(face, sourceX, sourceY);
+				}
+				resized.At(face, x, y) = sum / static_cast<float>((x1 - x0) * (y1 - y0));
+			}
+		}
+	}
+	return resized;
+}
+
+unsigned long long EnvironmentBaker::GetCacheKey(const std::vector<std::string> &p_FacePaths) {
+	// FNV-1a, over each file's path, size and modification time.
+	unsigned long long key = 14695981039346656037ull;
+	auto hash = [&key](const void *p_Data, size_t p_Size) {
+		const unsigned char *bytes = static_cast<const unsigned char*>(p_Data);
+		for (size_t i = 0; i < p_Size; i++) {
+			key ^= bytes[i];
+			key *= 1099511628211ull;
+		}
+	};
+	for (const std::string &path : p_FacePaths) {
+		std::error_code error;
+		unsigned long long size = std::filesystem::file_size(path, error);
+		if (error)
+			size = 0;
+		long long modificationTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		if (error)
+			modificationTime = 0;
+		hash(path.data(), path.size());
+		hash(&size, sizeof(size));
+		hash(&modificationTime, sizeof(modificationTime));
+	}
+	return key;
+}
+
+bool EnvironmentBaker::Load(const std::string &p_CachePath, unsigned long long p_Key) {
+	CPU_PROFILE_FUNCTION();
+	auto start = std::chrono::steady_clock::now();
+	m_WasCached = ReadCache(p_CachePath, p_Key);
+	m_BakeMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return m_WasCached;
+}
+
+void EnvironmentBaker::Bake(JobSystem &p_JobSystem, const CubeMapImage &p_Sky, const std::string &p_CachePath, unsigned long long p_Key) {
+	CPU_PROFILE_FUNCTION();
+	auto start = std::chrono::steady_clock::now();
+	CubeMapImage source = Resize(p_Sky, s_m_SourceSize);
+	ProjectIrradiance(source);
+
+	m_PrefilteredLevels.assign(s_m_PrefilteredLevelCount, CubeMapImage());
+	m_PrefilteredLevels[0] = Resize(p_Sky, s_m_PrefilteredSize);
+	Prefilter(p_JobSystem, source);
+
+	m_WasCached = false;
+	m_BakeMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (!p_CachePath.empty())
+		WriteCache(p_CachePath, p_Key);
+}
+
+void EnvironmentBaker::ProjectIrradiance(const CubeMapImage &p_Source) {
+	m_IrradianceCoefficients.fill(glm::vec3(0.0f));
+	for (int face = 0; face < 6; face++) {
+		for (int y = 0; y < p_Source.m_Size; y++) {
+			for (int x = 0; x < p_Source.m_Size; x++) {
+				glm::vec3 radiance = p_Source.At(face, x, y) * GetTexelSolidAngle(x, y, p_Source.m_Size);
+				std::array<float, 9> basis = GetSphericalHarmonicBasis(GetTexelDirection(face, x, y, p_Source.m_Size));
+				for (int i = 0; i < 9; i++)
+					m_IrradianceCoefficients[i] += radiance * basis[i];
+			}
+		}
+	}
+
+	// Convolving with the cosine lobe scales each band, by pi, two thirds of pi and a quarter of pi (Ramamoorthi and
+	// Hanrahan). It's divided by pi again, so evaluating it gives the light a white diffuse surface reflects.
+	const float bandScales[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+	for (int i = 0; i < 9; i++)
+		m_IrradianceCoefficients[i] *= bandScales[i];
+}
+
+void EnvironmentBaker::Prefilter(JobSystem &p_JobSystem, const CubeMapImage &p_Source) {
+	// The source's directions, solid angles and colours, laid out so four texels load at once. The padding's solid
+	// angle is zero, so it adds nothing.
+	size_t sourceCount = p_Source.m_Texels.size();
+	size_t paddedCount = (sourceCount + 3) & ~static_cast<size_t>(3);
+	std::vector<float> directionX(paddedCount, 0.0f), directionY(paddedCount, 0.0f), directionZ(paddedCount, 0.0f);
+	std::vector<float> solidAngles(paddedCount, 0.0f);
+	std::vector<float> red(paddedCount, 0.0f), green(paddedCount, 0.0f), blue(paddedCount, 0.0f);
+	for (int face = 0, i = 0; face < 6; face++) {
+		for (int y = 0; y < p_Source.m_Size; y++) {
+			for (int x = 0; x < p_Source.m_Size; x++, i++) {
+				glm::vec3 direction = GetTexelDirection(face, x, y, p_Source.m_Size);
+				directionX[i] = direction.x;
+				directionY[i] = direction.y;
+				directionZ[i] = direction.z;
+				solidAngles[i] = GetTexelSolidAngle(x, y, p_Source.m_Size);
+				const glm::vec3 &colour = p_Source.At(face, x, y);
+				red[i] = colour.r;
+				green[i] = colour.g;
+				blue[i] = colour.b;
+			}
+		}
+	}
+
+	for (int level = 1; level < s_m_PrefilteredLevelCount; level++) {
+		CubeMapImage &image = m_PrefilteredLevels[level];
+		image.m_Size = s_m_PrefilteredSize >> level;
+		image.m_Texels.resize(static_cast<size_t>(6) * image.m_Size * image.m_Size);
+		// The exponent is four to the power of the levels left below this one, so the cosine is squared twice per level.
+		int squaringCount = 2 * (s_m_PrefilteredLevelCount - 1 - level);
+
+		p_JobSystem.ParallelFor(image.m_Texels.size(), 16, [&](size_t p_Begin, size_t p_End) {
+			int faceTexelCount = image.m_Size * image.m_Size;
+			for (size_t i = p_Begin; i < p_End; i++) {
+				int face = static_cast<int>(i / faceTexelCount);
+				int texel = static_cast<int>(i % faceTexelCount);
+				glm::vec3 direction = GetTexelDirection(face, texel % image.m_Size, texel / image.m_Size, image.m_Size);
+
+				__m128 reflectionX = _mm_set1_ps(direction.x);
+				__m128 reflectionY = _mm_set1_ps(direction.y);
+				__m128 reflectionZ = _mm_set1_ps(direction.z);
+				__m128 zero = _mm_setzero_ps();
+				__m128 sumRed = zero, sumGreen = zero, sumBlue = zero, sumWeight = zero;
+				for (size_t j = 0; j < paddedCount; j += 4) {
+					__m128 cosine = _mm_mul_ps(reflectionX, _mm_loadu_ps(&directionX[j]));
+					cosine = _mm_add_ps(cosine, _mm_mul_ps(reflectionY, _mm_loadu_ps(&directionY[j])));
+					cosine = _mm_add_ps(cosine, _mm_mul_ps(reflectionZ, _mm_loadu_ps(&directionZ[j])));
+					cosine = _mm_max_ps(cosine, zero);
+					for (int k = 0; k < squaringCount; k++)
+						cosine = _mm_mul_ps(cosine, cosine);
+
+					__m128 weight = _mm_mul_ps(cosine, _mm_loadu_ps(&solidAngles[j]));
+					sumRed = _mm_add_ps(sumRed, _mm_mul_ps(weight, _mm_loadu_ps(&red[j])));
+					sumGreen = _mm_add_ps(sumGreen, _mm_mul_ps(weight, _mm_loadu_ps(&green[j])));
+					sumBlue = _mm_add_ps(sumBlue, _mm_mul_ps(weight, _mm_loadu_ps(&blue[j])));
+					sumWeight = _mm_add_ps(sumWeight, weight);
+				}
+
+				// Normalised by the lobe's total weight, so it's the average the surface reflects, not the sum.
+				float totalWeight = SumLanes(sumWeight);
+				glm::vec3 colour(SumLanes(sumRed), SumLanes(sumGreen), SumLanes(sumBlue));
+				image.m_Texels[i] = totalWeight > 0.0f ? colour / totalWeight : glm::vec3(0.0f);
+			}
+		});
+	}
+}
+
+CubeMapImage EnvironmentBaker::EvaluateIrradiance(int p_Size) const {
+	CubeMapImage image;
+	image.m_Size = p_Size;
+	image.m_Texels.resize(static_cast<size_t>(6) * p_Size * p_Size);
+	for (int face = 0; face < 6; face++) {
+		for (int y = 0; y < p_Size; y++) {
+			for (int x = 0; x < p_Size; x++) {
+				std::array<float, 9> basis = GetSphericalHarmonicBasis(GetTexelDirection(face, x, y, p_Size));
+				glm::vec3 irradiance(0.0f);
+				for (int i = 0; i < 9; i++)
+					irradiance += m_IrradianceCoefficients[i] * basis[i];
+				// Nine coefficients can ring below zero, opposite a very bright part of the sky.
+				image.At(face, x, y) = glm::max(irradiance, glm::vec3(0.0f));
+			}
+		}
+	}
+	return image;
+}
+
+bool EnvironmentBaker::ReadCache(const std::string &p_CachePath, unsigned long long p_Key) {
+	std::ifstream file(p_CachePath, std::ios::binary);
+	if (!file)
+		return false;
+
+	unsigned int magic = 0;
+	unsigned int version = 0;
+	unsigned long long key = 0;
+	int size = 0;
+	int levelCount = 0;
+	file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	file.read(reinterpret_cast<char*>(&key), sizeof(key));
+	file.read(reinterpret_cast<char*>(&size), sizeof(size));
+	file.read(reinterpret_cast<char*>(&levelCount), sizeof(levelCount));
+	if (!file || magic != s_m_CacheMagic || version != s_m_CacheVersion || key != p_Key || size != s_m_PrefilteredSize || levelCount != s_m_PrefilteredLevelCount)
+		return false;
+
+	file.read(reinterpret_cast<char*>(m_IrradianceCoefficients.data()), sizeof(m_IrradianceCoefficients));
+	m_PrefilteredLevels.assign(s_m_PrefilteredLevelCount, CubeMapImage());
+	for (int level = 0; level < s_m_PrefilteredLevelCount; level++) {
+		CubeMapImage &image = m_PrefilteredLevels[level];
+		image.m_Size = s_m_PrefilteredSize >> level;
+		image.m_Texels.resize(static_cast<size_t>(6) * image.m_Size * image.m_Size);
+		file.read(reinterpret_cast<char*>(image.m_Texels.data()), image.m_Texels.size() * sizeof(glm::vec3));
+	}
+	if (!file) {
+		std::cout << "ERROR::ENVIRONMENT_BAKER:: The cache is cut short, so it's baked again: " << p_CachePath << std::endl;
+		m_PrefilteredLevels.clear();
+		return false;
+	}
+	return true;
+}
+
+void EnvironmentBaker::WriteCache(const std::string &p_CachePath, unsigned long long p_Key) const {
+	// The cache's folder is generated too, so it may not exist yet.
+	std::error_code error;
+	std::filesystem::path folder = std::filesystem::path(p_CachePath).parent_path();
+	if (!folder.empty())
+		std::filesystem::create_directories(folder, error);
+
+	std::ofstream file(p_CachePath, std::ios::binary | std::ios::trunc);
+	unsigned int magic = s_m_CacheMagic;
+	unsigned int version = s_m_CacheVersion;
+	int size = s_m_PrefilteredSize;
+	int levelCount = s_m_PrefilteredLevelCount;
+	file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	file.write(reinterpret_cast<const char*>(&p_Key), sizeof(p_Key));
+	file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	file.write(reinterpret_cast<const char*>(&levelCount), sizeof(levelCount));
+	file.write(reinterpret_cast<const char*>(m_IrradianceCoefficients.data()), sizeof(m_IrradianceCoefficients));
+	for (const CubeMapImage &image : m_PrefilteredLevels)
+		file.write(reinterpret_cast<const char*>(image.m_Texels.data()), image.m_Texels.size() * sizeof(glm::vec3));
+	if (!file)
+		std::cout << "ERROR::ENVIRONMENT_BAKER:: Couldn't write the cache to: " << p_CachePath << std::endl;
+}
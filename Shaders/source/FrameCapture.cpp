@@ -0,0 +1,310 @@
+#include "FrameCapture.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "CPUProfiler.h"
+
+namespace {
+	// A minimal PNG writer. The image data is stored in uncompressed deflate blocks, encoding is then little more than
+	// a copy, so the writer keeps up with the renderer, at the cost of larger files.
+	const std::array<unsigned int, 256> &GetCRCTable() {
+		static const std::array<unsigned int, 256> s_Table = []() {
+			std::array<unsigned int, 256> table;
+			for (unsigned int i = 0; i < 256; i++) {
+				unsigned int crc = i;
+				for (int bit = 0; bit < 8; bit++)
+					crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+				table[i] = crc;
+			}
+			return table;
+		}();
+		return s_Table;
+	}
+
+	void AppendBigEndian(std::vector<unsigned char> &p_Data, unsigned int p_Value) {
+		p_Data.push_back(static_cast<unsigned char>(p_Value >> 24));
+		p_Data.push_back(static_cast<unsigned char>(p_Value >> 16));
+		p_Data.push_back(static_cast<unsigned char>(p_Value >> 8));
+		p_Data.push_back(static_cast<unsigned char>(p_Value));
+	}
+
+	void WritePNGChunk(std::ofstream &p_File, const char *p_Type, const std::vector<unsigned char> &p_Data) {
+		std::vector<unsigned char> header;
+		AppendBigEndian(header, static_cast<unsigned int>(p_Data.size()));
+		header.insert(header.end(), p_Type, p_Type + 4);
+
+		// The CRC covers the type and the data, not the length.
+		const std::array<unsigned int, 256> &crcTable = GetCRCTable();
+		unsigned int crc = 0xFFFFFFFFu;
+		for (size_t i = 4; i < header.size(); i++)
+			crc = crcTable[(crc ^ header[i]) & 0xFF] ^ (crc >> 8);
+		for (unsigned char byte : p_Data)
+			crc = crcTable[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+		std::vector<unsigned char> footer;
+		AppendBigEndian(footer, crc ^ 0xFFFFFFFFu);
+
+		p_File.write(reinterpret_cast<const char*>(header.data()), header.size());
+		p_File.write(reinterpret_cast<const char*>(p_Data.data()), p_Data.size());
+		p_File.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+	}
+
+	bool WritePNG(const std::string &p_FilePath, int p_Width, int p_Height, const std::vector<unsigned char> &p_RGBAPixels) {
+		std::ofstream file(p_FilePath, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+		std::vector<unsigned char> header;
+		AppendBigEndian(header, static_cast<unsigned int>(p_Width));
+		AppendBigEndian(header, static_cast<unsigned int>(p_Height));
+		// 8 bits per channel, RGB, default compression and filtering, not interlaced.
+		header.insert(header.end(), { 8, 2, 0, 0, 0 });
+		WritePNGChunk(file, "IHDR", header);
+
+		// Each row starts with its filter type, none, and OpenGL's rows are bottom first, so they're flipped.
+		size_t rowSize = static_cast<size_t>(p_Width) * 3 + 1;
+		std::vector<unsigned char> rows(rowSize * p_Height);
+		for (int y = 0; y < p_Height; y++) {
+			unsigned char *row = &rows[rowSize * y];
+			const unsigned char *source = &p_RGBAPixels[static_cast<size_t>(p_Height - 1 - y) * p_Width * 4];
+			row[0] = 0;
+			for (int x = 0; x < p_Width; x++) {
+				row[1 + x * 3] = source[x * 4];
+				row[2 + x * 3] = source[x * 4 + 1];
+				row[3 + x * 3] = source[x * 4 + 2];
+			}
+		}
+
+		// A zlib stream of stored blocks, each at most 65535 bytes, followed by the Adler-32 of the rows.
+		const size_t maxBlockSize = 65535;
+		std::vector<unsigned char> compressed;
+		compressed.reserve(rows.size() + rows.size() / maxBlockSize * 5 + 16);
+		compressed.push_back(0x78);
+		compressed.push_back(0x01);
+		for (size_t offset = 0; offset < rows.size() || offset == 0; offset += maxBlockSize) {
+			size_t blockSize = std::min(maxBlockSize, rows.size() - offset);
+			bool isFinalBlock = offset + blockSize >= rows.size();
+			compressed.push_back(isFinalBlock ? 1 : 0);
+			compressed.push_back(static_cast<unsigned char>(blockSize));
+			compressed.push_back(static_cast<unsigned char>(blockSize >> 8));
+			compressed.push_back(static_cast<unsigned char>(~blockSize));
+			compressed.push_back(static_cast<unsigned char>(~blockSize >> 8));
+			compressed.insert(compressed.end(), rows.begin() + offset, rows.begin() + offset + blockSize);
+			if (isFinalBlock)
+				break;
+		}
+		unsigned int adlerA = 1;
+		unsigned int adlerB = 0;
+		for (size_t offset = 0; offset < rows.size(); offset += 5552) {
+			// 5552 bytes is the most that can be summed before the sums have to be reduced, to stay inside 32 bits.
+			size_t end = std::min(rows.size(), offset + 5552);
+			for (size_t i = offset; i < end; i++) {
+				adlerA += rows[i];
+				adlerB += adlerA;
+			}
+			adlerA %= 65521;
+			adlerB %= 65521;
+		}
+		AppendBigEndian(compressed, (adlerB << 16) | adlerA);
+		WritePNGChunk(file, "IDAT", compressed);
+		WritePNGChunk(file, "IEND", std::vector<unsigned char>());
+
+		return file.good();
+	}
+}
+
+FrameCapture::FrameCapture(int p_Width, int p_Height, CaptureFormat p_Format, const std::string &p_OutputPath, unsigned int p_RingSize)
+	: m_Width(p_Width), m_Height(p_Height), m_Format(p_Format), m_OutputPath(p_OutputPath) {
+	GLsizeiptr frameSize = static_cast<GLsizeiptr>(m_Width) * m_Height * 4;
+	m_Slots.resize(std::max(1u, p_RingSize));
+	for (ReadbackSlot &slot : m_Slots) {
+		glGenBuffers(1, &slot.m_PixelBufferObject);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_PixelBufferObject);
+		// Written by the GPU and read by the CPU.
+		glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	if (m_Format == CaptureFormat::PNG_SEQUENCE) {
+		std::error_code error;
+		std::filesystem::create_directories(m_OutputPath, error);
+	}
+	else {
+		std::cout << "\nCapturing raw video, encode it with: ffmpeg -f rawvideo -pixel_format rgb24 -video_size " << m_Width << "x" << m_Height
+			<< " -framerate 60 -i " << m_OutputPath << " capture.mp4" << std::endl;
+	}
+
+	m_WriterThread = std::thread(&FrameCapture::WriterLoop, this);
+}
+
+FrameCapture::~FrameCapture() {
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		m_IsWriterRunning = false;
+	}
+	m_QueueCondition.notify_all();
+	m_WriterThread.join();
+
+	for (ReadbackSlot &slot : m_Slots)
+		glDeleteBuffers(1, &slot.m_PixelBufferObject);
+
+	std::cout << "\nFrame capture - Frames captured: " << m_CapturedFrameCount << "\tWritten: " << m_WrittenFrameCount
+		<< "\tSkipped: " << m_SkippedFrameCount << "\tReadback stalls: " << m_ReadbackStallCount
+		<< "\tWaiting on the writer: " << m_WriterWaitMilliseconds << " ms" << std::endl;
+	if (m_HasWriteFailed)
+		std::cout << "ERROR::FRAME_CAPTURE:: Some frames couldn't be written to: " << m_OutputPath << std::endl;
+}
+
+void FrameCapture::Capture(unsigned int p_FrameBufferObject, int p_Width, int p_Height, unsigned long long p_FrameIndex) {
+	CPU_PROFILE_FUNCTION();
+	if (p_Width != m_Width || p_Height != m_Height) {
+		// Every frame of a sequence has to be the same size.
+		m_SkippedFrameCount++;
+		return;
+	}
+
+	ReadbackSlot &slot = m_Slots[m_CurrentSlot];
+	if (slot.m_Fence != nullptr)
+		ResolveSlot(slot);
+
+	// Tightly packed RGBA rows are the format drivers copy fastest, and the read returns as soon as it's queued.
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, p_FrameBufferObject);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_PixelBufferObject);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.m_FrameIndex = p_FrameIndex;
+	m_CapturedFrameCount++;
+	m_CurrentSlot = (m_CurrentSlot + 1) % m_Slots.size();
+}
+
+void FrameCapture::ResolveSlot(ReadbackSlot &p_Slot) {
+	// Check without waiting first, so only real stalls are counted.
+	GLenum result = glClientWaitSync(p_Slot.m_Fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED) {
+		m_ReadbackStallCount++;
+		const GLuint64 oneMillisecond = 1000000;
+		do {
+			result = glClientWaitSync(p_Slot.m_Fence, GL_SYNC_FLUSH_COMMANDS_BIT, oneMillisecond);
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(p_Slot.m_Fence);
+	p_Slot.m_Fence = nullptr;
+	if (result == GL_WAIT_FAILED) {
+		std::cout << "ERROR::FRAME_CAPTURE:: Waiting for a readback's fence failed." << std::endl;
+		return;
+	}
+
+	CapturedFrame frame;
+	frame.m_FrameIndex = p_Slot.m_FrameIndex;
+	{
+		// Wait for the writer to catch up, rather than let the queue grow without limit.
+		std::unique_lock<std::mutex> lock(m_QueueMutex);
+		if (m_QueuedFrames.size() >= s_m_MaxQueuedFrames) {
+			auto waitStart = std::chrono::steady_clock::now();
+			m_QueueCondition.wait(lock, [this]() { return m_QueuedFrames.size() < s_m_MaxQueuedFrames; });
+			m_WriterWaitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+		}
+
+		if (!m_FreePixelBuffers.empty()) {
+			frame.m_Pixels = std::move(m_FreePixelBuffers.back());
+			m_FreePixelBuffers.pop_back();
+		}
+	}
+
+	size_t frameSize = static_cast<size_t>(m_Width) * m_Height * 4;
+	frame.m_Pixels.resize(frameSize);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, p_Slot.m_PixelBufferObject);
+	const void *mappedData = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(frameSize), GL_MAP_READ_BIT);
+	if (mappedData != nullptr) {
+		std::memcpy(frame.m_Pixels.data(), mappedData, frameSize);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	if (mappedData == nullptr) {
+		std::cout << "ERROR::FRAME_CAPTURE:: Failed to map a readback buffer." << std::endl;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		m_QueuedFrames.push_back(std::move(frame));
+	}
+	m_QueueCondition.notify_all();
+}
+
+void FrameCapture::Flush() {
+	// Oldest first, so the frames reach the writer in order.
+	for (size_t i = 0; i < m_Slots.size(); i++) {
+		ReadbackSlot &slot = m_Slots[(m_CurrentSlot + i) % m_Slots.size()];
+		if (slot.m_Fence != nullptr)
+			ResolveSlot(slot);
+	}
+}
+
+void FrameCapture::WriterLoop() {
+	CPU_PROFILE_THREAD_NAME("Frame capture writer");
+	std::ofstream rawVideoFile;
+	if (m_Format == CaptureFormat::RAW_VIDEO) {
+		rawVideoFile.open(m_OutputPath, std::ios::binary | std::ios::trunc);
+		if (!rawVideoFile.is_open())
+			std::cout << "ERROR::FRAME_CAPTURE:: Failed to open the raw video file: " << m_OutputPath << std::endl;
+	}
+
+	std::unique_lock<std::mutex> lock(m_QueueMutex);
+	while (true) {
+		m_QueueCondition.wait(lock, [this]() { return !m_IsWriterRunning || !m_QueuedFrames.empty(); });
+		if (m_QueuedFrames.empty())
+			break;
+
+		CapturedFrame frame = std::move(m_QueuedFrames.front());
+		m_QueuedFrames.pop_front();
+		lock.unlock();
+		m_QueueCondition.notify_all();
+
+		bool isWritten = WriteFrame(frame, rawVideoFile);
+
+		lock.lock();
+		m_HasWriteFailed = m_HasWriteFailed || !isWritten;
+		m_WrittenFrameCount += isWritten ? 1 : 0;
+		m_FreePixelBuffers.push_back(std::move(frame.m_Pixels));
+	}
+}
+
+bool FrameCapture::WriteFrame(const CapturedFrame &p_Frame, std::ofstream &p_RawVideoFile) const {
+	CPU_PROFILE_FUNCTION();
+	if (m_Format == CaptureFormat::PNG_SEQUENCE) {
+		std::ostringstream fileName;
+		fileName << "frame_" << std::setw(6) << std::setfill('0') << p_Frame.m_FrameIndex << ".png";
+		return WritePNG((std::filesystem::path(m_OutputPath) / fileName.str()).string(), m_Width, m_Height, p_Frame.m_Pixels);
+	}
+
+	if (!p_RawVideoFile.is_open())
+		return false;
+
+	// Top row first, and without the alpha channel, as video encoders expect.
+	std::vector<unsigned char> row(static_cast<size_t>(m_Width) * 3);
+	for (int y = m_Height - 1; y >= 0; y--) {
+		const unsigned char *source = &p_Frame.m_Pixels[static_cast<size_t>(y) * m_Width * 4];
+		for (int x = 0; x < m_Width; x++) {
+			row[x * 3] = source[x * 4];
+			row[x * 3 + 1] = source[x * 4 + 1];
+			row[x * 3 + 2] = source[x * 4 + 2];
+		}
+		p_RawVideoFile.write(reinterpret_cast<const char*>(row.data()), row.size());
+	}
+	return p_RawVideoFile.good();
+}
@@ -0,0 +1,76 @@
+#include "FramePacket.h"
+
+float FramePacketBuffer::MillisecondsSince(std::chrono::steady_clock::time_point p_Start) {
+	return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - p_Start).count();
+}
+
+FramePacket &FramePacketBuffer::BeginWrite() {
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	auto start = std::chrono::steady_clock::now();
+	m_Condition.wait(lock, [this]() { return m_ReadingIndex != m_WriteIndex; });
+	m_ProducerWaitMilliseconds += MillisecondsSince(start);
+
+	return m_Packets[m_WriteIndex];
+}
+
+void FramePacketBuffer::Publish() {
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		auto start = std::chrono::steady_clock::now();
+		m_Condition.wait(lock, [this]() { return m_ReadyIndex == s_m_NoPacket; });
+		m_ProducerWaitMilliseconds += MillisecondsSince(start);
+
+		m_ReadyIndex = m_WriteIndex;
+		m_WriteIndex = 1 - m_WriteIndex;
+	}
+	m_Condition.notify_all();
+}
+
+const FramePacket *FramePacketBuffer::Acquire() {
+	const FramePacket *packet = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		auto start = std::chrono::steady_clock::now();
+		m_Condition.wait(lock, [this]() { return m_ReadyIndex != s_m_NoPacket || m_IsClosed; });
+		m_ConsumerWaitMilliseconds += MillisecondsSince(start);
+
+		if (m_ReadyIndex == s_m_NoPacket)
+			return nullptr;
+
+		m_ReadingIndex = m_ReadyIndex;
+		m_ReadyIndex = s_m_NoPacket;
+		packet = &m_Packets[m_ReadingIndex];
+	}
+	m_Condition.notify_all();
+
+	return packet;
+}
+
+void FramePacketBuffer::Release() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_ReadingIndex = s_m_NoPacket;
+	}
+	m_Condition.notify_all();
+}
+
+void FramePacketBuffer::Close() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsClosed = true;
+		// Drop a packet that hasn't been taken, so the render thread can stop straight away.
+		m_ReadyIndex = s_m_NoPacket;
+	}
+	m_Condition.notify_all();
+}
+
+void FramePacketBuffer::TakeWaitTimes(float &p_ProducerWaitMilliseconds, float &p_ConsumerWaitMilliseconds) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	p_ProducerWaitMilliseconds = m_ProducerWaitMilliseconds;
+	p_ConsumerWaitMilliseconds = m_ConsumerWaitMilliseconds;
+	m_ProducerWaitMilliseconds = 0.0f;
+	m_ConsumerWaitMilliseconds = 0.0f;
+}
@@ -0,0 +1,202 @@
+#include "GPUProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <glad/glad.h>
+
+#include "TextRenderer.h"
+
+const float GPUProfiler::s_m_AverageWeight(0.05f);
+
+GPUProfiler::GPUProfiler() {
+	// KHR_debug is core in OpenGL 4.3, but the groups are only a hint for tools, so go without them if the driver's are missing.
+	m_HasDebugGroups = GLAD_GL_VERSION_4_3 && glPushDebugGroup != nullptr && glPopDebugGroup != nullptr;
+}
+
+GPUProfiler::~GPUProfiler() {
+	for (Frame &frame : m_Frames) {
+		if (!frame.m_Queries.empty())
+			glDeleteQueries(static_cast<GLsizei>(frame.m_Queries.size()), frame.m_Queries.data());
+	}
+}
+
+unsigned int GPUProfiler::IssueTimestamp() {
+	Frame &frame = m_Frames[m_CurrentFrame];
+	if (frame.m_UsedQueryCount == frame.m_Queries.size()) {
+		// Grow in blocks, a new pass shouldn't cost a query object each frame until the ring has caught up.
+		size_t previousSize = frame.m_Queries.size();
+		frame.m_Queries.resize(std::max<size_t>(16, previousSize * 2));
+		glGenQueries(static_cast<GLsizei>(frame.m_Queries.size() - previousSize), frame.m_Queries.data() + previousSize);
+	}
+
+	glQueryCounter(frame.m_Queries[frame.m_UsedQueryCount], GL_TIMESTAMP);
+	return frame.m_UsedQueryCount++;
+}
+
+void GPUProfiler::ReadResults() {
+	Frame &frame = m_Frames[m_CurrentFrame];
+	if (frame.m_Passes.empty())
+		return;
+
+	// The queries finish in the order they were issued, so if the last is ready they all are. If not, drop the frame rather than stall.
+	GLint resultAvailable = GL_FALSE;
+	glGetQueryObjectiv(frame.m_Queries[frame.m_UsedQueryCount - 1], GL_QUERY_RESULT_AVAILABLE, &resultAvailable);
+	if (resultAvailable == GL_FALSE) {
+		m_DroppedFrameCount++;
+		return;
+	}
+
+	std::vector<GLuint64> timestamps(frame.m_UsedQueryCount);
+	for (unsigned int i = 0; i < frame.m_UsedQueryCount; i++)
+		glGetQueryObjectui64v(frame.m_Queries[i], GL_QUERY_RESULT, &timestamps[i]);
+
+	// A pass can run more than once a frame, so sum its runs before updating the averages.
+	std::vector<float> frameMilliseconds(m_Timings.size(), 0.0f);
+	for (GPUPassTiming &timing : m_Timings)
+		timing.m_WasRecorded = false;
+	for (const PassRecord &record : frame.m_Passes) {
+		GLuint64 begin = timestamps[record.m_BeginQuery];
+		GLuint64 end = timestamps[record.m_EndQuery];
+		frameMilliseconds[record.m_Pass] += end > begin ? static_cast<float>(end - begin) / 1000000.0f : 0.0f;
+		m_Timings[record.m_Pass].m_WasRecorded = true;
+	}
+
+	for (size_t i = 0; i < m_Timings.size(); i++) {
+		GPUPassTiming &timing = m_Timings[i];
+		if (!timing.m_WasRecorded)
+			continue;
+
+		timing.m_ElapsedMilliseconds = frameMilliseconds[i];
+		if (timing.m_AverageMilliseconds == 0.0f)
+			timing.m_AverageMilliseconds = timing.m_ElapsedMilliseconds;
+		else
+			timing.m_AverageMilliseconds += (timing.m_ElapsedMilliseconds - timing.m_AverageMilliseconds) * s_m_AverageWeight;
+	}
+}
+
+void GPUProfiler::BeginFrame() {
+	if (m_IsRecording)
+		EndFrame();
+
+	m_CurrentFrame = (m_CurrentFrame + 1) % s_m_FrameRingSize;
+	ReadResults();
+
+	Frame &frame = m_Frames[m_CurrentFrame];
+	frame.m_UsedQueryCount = 0;
+	frame.m_Passes.clear();
+	m_IsRecording = true;
+}
+
+void GPUProfiler::EndFrame() {
+	if (!m_OpenPasses.empty())
+		std::cout << "ERROR::GPU_PROFILER:: " << m_OpenPasses.size() << " pass(es) weren't ended before the end of the frame." << std::endl;
+	while (!m_OpenPasses.empty())
+		EndPass();
+
+	m_IsRecording = false;
+}
+
+void GPUProfiler::BeginPass(const char *p_Name) {
+	if (m_HasDebugGroups)
+		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, p_Name);
+	if (!m_IsRecording)
+		return;
+
+	auto timingIndex = m_TimingIndices.find(p_Name);
+	if (timingIndex == m_TimingIndices.end()) {
+		GPUPassTiming timing;
+		timing.m_Name = p_Name;
+		timing.m_Depth = static_cast<unsigned int>(m_OpenPasses.size());
+		timingIndex = m_TimingIndices.emplace(timing.m_Name, m_Timings.size()).first;
+		m_Timings.push_back(timing);
+	}
+
+	PassRecord record;
+	record.m_Pass = timingIndex->second;
+	record.m_BeginQuery = IssueTimestamp();
+	record.m_EndQuery = record.m_BeginQuery;
+
+	Frame &frame = m_Frames[m_CurrentFrame];
+	m_OpenPasses.push_back(frame.m_Passes.size());
+	frame.m_Passes.push_back(record);
+}
+
+void GPUProfiler::EndPass() {
+	if (m_HasDebugGroups)
+		glPopDebugGroup();
+	if (!m_IsRecording || m_OpenPasses.empty())
+		return;
+
+	Frame &frame = m_Frames[m_CurrentFrame];
+	frame.m_Passes[m_OpenPasses.back()].m_EndQuery = IssueTimestamp();
+	m_OpenPasses.pop_back();
+}
+
+const GPUPassTiming *GPUProfiler::GetPassTiming(const std::string &p_Name) const {
+	auto timingIndex = m_TimingIndices.find(p_Name);
+	return timingIndex != m_TimingIndices.end() ? &m_Timings[timingIndex->second] : nullptr;
+}
+
+void GPUProfiler::RenderOverlay(int p_Width, int p_Height, float p_BudgetMilliseconds, TextRenderer *p_TextRenderer) const {
+	static const float s_Palette[][3] = {
+		{ 0.90f, 0.30f, 0.25f }, { 0.25f, 0.65f, 0.90f }, { 0.95f, 0.75f, 0.20f }, { 0.40f, 0.80f, 0.35f },
+		{ 0.70f, 0.40f, 0.85f }, { 0.95f, 0.50f, 0.70f }, { 0.30f, 0.85f, 0.80f }, { 0.85f, 0.55f, 0.25f }
+	};
+	const size_t paletteSize = sizeof(s_Palette) / sizeof(s_Palette[0]);
+
+	// Solid rectangles are cleared with the scissor test, so the overlay needs no shader or vertex data of its own.
+	const int margin = 8;
+	const int rowHeight = std::max(4, p_Height / 60);
+	const int barWidth = p_Width - margin * 2;
+	const float pixelsPerMillisecond = static_cast<float>(barWidth) / p_BudgetMilliseconds;
+	auto fillRectangle = [](int p_X, int p_Y, int p_RectangleWidth, int p_RectangleHeight, float p_Red, float p_Green, float p_Blue) {
+		if (p_RectangleWidth <= 0 || p_RectangleHeight <= 0)
+			return;
+		glScissor(p_X, p_Y, p_RectangleWidth, p_RectangleHeight);
+		glClearColor(p_Red, p_Green, p_Blue, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+	};
+
+	glEnable(GL_SCISSOR_TEST);
+	int top = p_Height - margin;
+	fillRectangle(margin - 2, top - rowHeight * 2 - 6, barWidth + 4, rowHeight * 2 + 6, 0.05f, 0.05f, 0.05f);
+	// One row for the outermost passes, one for the passes directly inside them, each laid end to end.
+	for (unsigned int depth = 0; depth < 2; depth++) {
+		int y = top - 2 - rowHeight * (depth + 1) - static_cast<int>(depth) * 2;
+		float x = static_cast<float>(margin);
+		for (size_t i = 0; i < m_Timings.size(); i++) {
+			const GPUPassTiming &timing = m_Timings[i];
+			if (timing.m_Depth != depth || !timing.m_WasRecorded)
+				continue;
+
+			float width = std::min(timing.m_AverageMilliseconds * pixelsPerMillisecond, static_cast<float>(margin + barWidth) - x);
+			const float *colour = s_Palette[i % paletteSize];
+			fillRectangle(static_cast<int>(x), y, static_cast<int>(width), rowHeight, colour[0], colour[1], colour[2]);
+			x += width;
+		}
+	}
+	// Tick every millisecond, so the bars can be read without any text.
+	for (float millisecond = 1.0f; millisecond < p_BudgetMilliseconds; millisecond += 1.0f)
+		fillRectangle(margin + static_cast<int>(millisecond * pixelsPerMillisecond), top - rowHeight * 2 - 4, 1, 3, 1.0f, 1.0f, 1.0f);
+	glDisable(GL_SCISSOR_TEST);
+	if (!p_TextRenderer)
+		return;
+
+	// A line under the bars for each pass in them, in its bar's colour, the inner passes indented.
+	const unsigned int labelPixelHeight = 14;
+	float labelY = static_cast<float>(margin + rowHeight * 2 + 10);
+	for (size_t i = 0; i < m_Timings.size(); i++) {
+		const GPUPassTiming &timing = m_Timings[i];
+		if (timing.m_Depth > 1 || !timing.m_WasRecorded)
+			continue;
+
+		std::ostringstream label;
+		label << std::fixed << std::setprecision(2) << timing.m_Name << ": " << timing.m_AverageMilliseconds << " ms";
+		const float *colour = s_Palette[i % paletteSize];
+		p_TextRenderer->AddText(label.str(), glm::vec2(static_cast<float>(margin + timing.m_Depth * 16), labelY), labelPixelHeight, glm::vec4(colour[0], colour[1], colour[2], 1.0f));
+		labelY += p_TextRenderer->GetLineHeight(labelPixelHeight);
+	}
+}
@@ -0,0 +1,46 @@
+#include "GPUTimer.h"
+
+#include <glad/glad.h>
+
+const float GPUTimer::s_m_AverageWeight(0.05f);
+
+GPUTimer::GPUTimer() {
+	glGenQueries(s_m_QueryRingSize, m_Queries.data());
+	m_QueryIssued.fill(false);
+}
+
+GPUTimer::~GPUTimer() {
+	glDeleteQueries(s_m_QueryRingSize, m_Queries.data());
+}
+
+void GPUTimer::ReadResult() {
+	if (!m_QueryIssued[m_CurrentQuery])
+		return;
+	m_QueryIssued[m_CurrentQuery] = false;
+
+	// The query was issued a few frames ago, so it's almost always ready. If it isn't, drop the sample rather than stall.
+	GLint resultAvailable = GL_FALSE;
+	glGetQueryObjectiv(m_Queries[m_CurrentQuery], GL_QUERY_RESULT_AVAILABLE, &resultAvailable);
+	if (resultAvailable == GL_FALSE)
+		return;
+
+	GLuint64 elapsedNanoseconds = 0;
+	glGetQueryObjectui64v(m_Queries[m_CurrentQuery], GL_QUERY_RESULT, &elapsedNanoseconds);
+	m_ElapsedMilliseconds = static_cast<float>(elapsedNanoseconds) / 1000000.0f;
+
+	if (m_AverageMilliseconds == 0.0f)
+		m_AverageMilliseconds = m_ElapsedMilliseconds;
+	else
+		m_AverageMilliseconds += (m_ElapsedMilliseconds - m_AverageMilliseconds) * s_m_AverageWeight;
+}
+
+void GPUTimer::Begin() {
+	ReadResult();
+	glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_CurrentQuery]);
+}
+
+void GPUTimer::End() {
+	glEndQuery(GL_TIME_ELAPSED);
+	m_QueryIssued[m_CurrentQuery] = true;
+	m_CurrentQuery = (m_CurrentQuery + 1) % s_m_QueryRingSize;
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "GLAD/glad.h"
+
+// Stands for no texel of the set being in reach, small enough that adding a squared distance to it stays finite.
+static const float s_FarDistance = 1e20f;
+
+GlyphAtlas::GlyphAtlas(FT_Face p_Face, bool p_IsDistanceField) : m_Face(p_Face), m_IsDistanceField(p_IsDistanceField) {
+	// Cleared, so the padding between glyphs is empty, or as far outside as a distance field goes.
+	std::vector<unsigned char> emptyTexels(static_cast<size_t>(s_m_Size) * s_m_Size, 0);
+	glGenTextures(1, &m_TextureID);
+	glBindTexture(GL_TEXTURE_2D, m_TextureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, s_m_Size, s_m_Size, 0, GL_RED, GL_UNSIGNED_BYTE, emptyTexels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+GlyphAtlas::~GlyphAtlas() {
+	glDeleteTextures(1, &m_TextureID);
+}
+
+const Glyph &GlyphAtlas::GetGlyph(unsigned int p_Character, unsigned int p_PixelHeight) {
+	// A distance field serves every size, so its glyphs are only keyed by the character.
+	unsigned long long key = m_IsDistanceField ? p_Character : (static_cast<unsigned long long>(p_PixelHeight) << 32) | p_Character;
+	auto glyph = m_Glyphs.find(key);
+	if (glyph != m_Glyphs.end())
+		return glyph->second;
+
+	return m_Glyphs.emplace(key, Rasterise(p_Character, p_PixelHeight)).first->second;
+}
+
+float GlyphAtlas::GetScale(unsigned int p_PixelHeight) const {
+	return m_IsDistanceField ? static_cast<float>(p_PixelHeight) / s_m_DistanceFieldPixelHeight : 1.0f;
+}
+
+bool GlyphAtlas::Pack(int p_Width, int p_Height, glm::ivec2 &p_Position) {
+	// The shelf that wastes the least height, out of those the glyph fits on.
+	Shelf *bestShelf = nullptr;
+	for (Shelf &shelf : m_Shelves) {
+		if (shelf.m_Height < p_Height || shelf.m_UsedWidth + p_Width > s_m_Size)
+			continue;
+		if (!bestShelf || shelf.m_Height < bestShelf->m_Height)
+			bestShelf = &shelf;
+	}
+
+	if (!bestShelf) {
+		int shelfHeight = ((p_Height + s_m_ShelfRounding - 1) / s_m_ShelfRounding) * s_m_ShelfRounding;
+		if (p_Width > s_m_Size || m_NextShelfY + shelfHeight > s_m_Size)
+			return false;
+
+		Shelf shelf;
+		shelf.m_Y = m_NextShelfY;
+		shelf.m_Height = shelfHeight;
+		m_Shelves.push_back(shelf);
+		m_NextShelfY += shelfHeight;
+		bestShelf = &m_Shelves.back();
+	}
+
+	p_Position = glm::ivec2(bestShelf->m_UsedWidth, bestShelf->m_Y);
+	bestShelf->m_UsedWidth += p_Width;
+	m_UsedArea += p_Width * p_Height;
+	return true;
+}
+
+Glyph GlyphAtlas::Rasterise(unsigned int p_Character, unsigned int p_PixelHeight) {
+	Glyph glyph;
+	FT_Set_Pixel_Sizes(m_Face, 0, m_IsDistanceField ? s_m_DistanceFieldPixelHeight * s_m_DistanceFieldOversampling : p_PixelHeight);
+	if (FT_Load_Char(m_Face, p_Character, FT_LOAD_RENDER)) {
+		std::cout << "ERROR::GLYPHATLAS:: Failed to load the glyph for character " << p_Character << std::endl;
+		return glyph;
+	}
+
+	const FT_GlyphSlot slot = m_Face->glyph;
+	const float scale = m_IsDistanceField ? 1.0f / s_m_DistanceFieldOversampling : 1.0f;
+	// The advance is in 64ths of a pixel.
+	glyph.m_Advance = static_cast<float>(slot->advance.x) / 64.0f * scale;
+	if (slot->bitmap.width == 0 || slot->bitmap.rows == 0)
+		return glyph;
+
+	const unsigned char *texels = slot->bitmap.buffer;
+	int width = static_cast<int>(slot->bitmap.width);
+	int height = static_cast<int>(slot->bitmap.rows);
+	int pitch = slot->bitmap.pitch;
+	glm::vec2 offset(static_cast<float>(slot->bitmap_left), -static_cast<float>(slot->bitmap_top));
+	std::vector<unsigned char> distanceField;
+	if (m_IsDistanceField) {
+		distanceField = CreateDistanceField(slot->bitmap.buffer, width, height, pitch, width, height);
+		texels = distanceField.data();
+		pitch = width;
+		// The field reaches the spread past the outline's bounds on every side.
+		offset = offset * scale - glm::vec2(static_cast<float>(s_m_DistanceFieldSpread));
+	}
+
+	glm::ivec2 position;
+	if (!Pack(width + s_m_Padding, height + s_m_Padding, position)) {
+		if (!m_IsFull) {
+			m_IsFull = true;
+			std::cout << "ERROR::GLYPHATLAS:: The atlas is full, the glyphs that don't fit won't be drawn." << std::endl;
+		}
+		return glyph;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, m_TextureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, width, height, GL_RED, GL_UNSIGNED_BYTE, texels);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glyph.m_Offset = offset;
+	glyph.m_Size = glm::vec2(static_cast<float>(width), static_cast<float>(height));
+	glyph.m_TextureMin = glm::vec2(position) / static_cast<float>(s_m_Size);
+	glyph.m_TextureMax = glm::vec2(position + glm::ivec2(width, height)) / static_cast<float>(s_m_Size);
+	return glyph;
+}
+
+std::vector<unsigned char> GlyphAtlas::CreateDistanceField(const unsigned char *p_Bitmap, int p_Width, int p_Height, int p_Pitch, int &p_FieldWidth, int &p_FieldHeight) {
+	const int oversampling = s_m_DistanceFieldOversampling;
+	const int border = s_m_DistanceFieldSpread * oversampling;
+	// The bitmap, with room for the spread around it, rounded up to whole texels of the field.
+	p_FieldWidth = (p_Width + border * 2 + oversampling - 1) / oversampling;
+	p_FieldHeight = (p_Height + border * 2 + oversampling - 1) / oversampling;
+	int width = p_FieldWidth * oversampling;
+	int height = p_FieldHeight * oversampling;
+
+	// Half coverage is the outline, which is sharp enough at this size.
+	std::vector<float> toInside(static_cast<size_t>(width) * height, s_FarDistance);
+	std::vector<float> toOutside(static_cast<size_t>(width) * height, 0.0f);
+	for (int y = 0; y < p_Height; y++) {
+		for (int x = 0; x < p_Width; x++) {
+			if (p_Bitmap[y * p_Pitch + x] < 128)
+				continue;
+			size_t index = static_cast<size_t>(y + border) * width + x + border;
+			toInside[index] = 0.0f;
+			toOutside[index] = s_FarDistance;
+		}
+	}
+	DistanceTransform(toInside, width, height);
+	DistanceTransform(toOutside, width, height);
+
+	// Each texel's distance is the average over the texels it covers, the outline lies half way between the centres
+	// of an inside and an outside texel.
+	std::vector<unsigned char> field(static_cast<size_t>(p_FieldWidth) * p_FieldHeight);
+	const float toFieldPixels = 1.0f / static_cast<float>(oversampling * oversampling * oversampling);
+	for (int fieldY = 0; fieldY < p_FieldHeight; fieldY++) {
+		for (int fieldX = 0; fieldX < p_FieldWidth; fieldX++) {
+			float distance = 0.0f;
+			for (int y = fieldY * oversampling; y < (fieldY + 1) * oversampling; y++) {
+				for (int x = fieldX * oversampling; x < (fieldX + 1) * oversampling; x++) {
+					size_t index = static_cast<size_t>(y) * width + x;
+					distance += toInside[index] == 0.0f ? std::sqrt(toOutside[index]) - 0.5f : 0.5f - std::sqrt(toInside[index]);
+				}
+			}
+			// Positive inside, and half way at the outline.
+			float value = 0.5f + distance * toFieldPixels / (2.0f * s_m_DistanceFieldSpread);
+			field[static_cast<size_t>(fieldY) * p_FieldWidth + fieldX] = static_cast<unsigned char>(std::lround(glm::clamp(value, 0.0f, 1.0f) * 255.0f));
+		}
+	}
+	return field;
+}
+
+void GlyphAtlas::DistanceTransform(std::vector<float> &p_Distances, int p_Width, int p_Height) {
+	// Separable, down each column and then along each row.
+	int count = std::max(p_Width, p_Height);
+	std::vector<float> input(count), output(count), boundaries(count + 1);
+	std::vector<int> vertices(count);
+	for (int x = 0; x < p_Width; x++) {
+		for (int y = 0; y < p_Height; y++)
+			input[y] = p_Distances[static_cast<size_t>(y) * p_Width + x];
+		DistanceTransform(input.data(), output.data(), p_Height, vertices.data(), boundaries.data());
+		for (int y = 0; y < p_Height; y++)
+			p_Distances[static_cast<size_t>(y) * p_Width + x] = output[y];
+	}
+	for (int y = 0; y < p_Height; y++) {
+		float *row = &p_Distances[static_cast<size_t>(y) * p_Width];
+		std::copy(row, row + p_Width, input.begin());
+		DistanceTransform(input.data(), row, p_Width, vertices.data(), boundaries.data());
+	}
+}
+
+void GlyphAtlas::DistanceTransform(const float *p_Input, float *p_Output, int p_Count, int *p_Vertices, float *p_Boundaries) {
+	// Each texel is a parabola rooted at its distance so far, the distance at each texel is the lowest parabola there.
+	int parabola = 0;
+	p_Vertices[0] = 0;
+	p_Boundaries[0] = -s_FarDistance;
+	p_Boundaries[1] = s_FarDistance;
+	for (int q = 1; q < p_Count; q++) {
+		float intersection;
+		while (true) {
+			int vertex = p_Vertices[parabola];
+			intersection = ((p_Input[q] + static_cast<float>(q * q)) - (p_Input[vertex] + static_cast<float>(vertex * vertex))) / static_cast<float>(2 * (q - vertex));
+			if (intersection > p_Boundaries[parabola])
+				break;
+			// The new parabola is lower than this one everywhere this one was lowest.
+			parabola--;
+		}
+		parabola++;
+		p_Vertices[parabola] = q;
+		p_Boundaries[parabola] = intersection;
+		p_Boundaries[parabola + 1] = s_FarDistance;
+	}
+
+	parabola = 0;
+	for (int q = 0; q < p_Count; q++) {
+		while (p_Boundaries[parabola + 1] < static_cast<float>(q))
+			parabola++;
+		float offset = static_cast<float>(q - p_Vertices[parabola]);
+		p_Output[q] = offset * offset + p_Input[p_Vertices[parabola]];
+	}
+}
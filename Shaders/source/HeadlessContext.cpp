@@ -0,0 +1,261 @@
+#include "HeadlessContext.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace {
+	// The values of the EGL enums used, from egl.h and eglext.h.
+	const int s_EGLNone = 0x3038;
+	const int s_EGLExtensions = 0x3055;
+	const int s_EGLSurfaceType = 0x3033;
+	const int s_EGLPbufferBit = 0x0001;
+	const int s_EGLRenderableType = 0x3040;
+	const int s_EGLOpenGLBit = 0x0008;
+	const int s_EGLRedSize = 0x3024;
+	const int s_EGLGreenSize = 0x3023;
+	const int s_EGLBlueSize = 0x3022;
+	const int s_EGLAlphaSize = 0x3021;
+	const int s_EGLDepthSize = 0x3025;
+	const int s_EGLStencilSize = 0x3026;
+	const int s_EGLWidth = 0x3057;
+	const int s_EGLHeight = 0x3056;
+	const unsigned int s_EGLOpenGLAPI = 0x30A2;
+	const int s_EGLContextMajorVersion = 0x3098;
+	const int s_EGLContextMinorVersion = 0x30FB;
+	const int s_EGLContextOpenGLProfileMask = 0x30FD;
+	const int s_EGLContextOpenGLCoreProfileBit = 0x0001;
+	const unsigned int s_EGLPlatformSurfacelessMesa = 0x31DD;
+
+	bool HasExtension(const char *p_Extensions, const char *p_Name) {
+		if (p_Extensions == nullptr)
+			return false;
+
+		size_t nameLength = std::strlen(p_Name);
+		for (const char *start = std::strstr(p_Extensions, p_Name); start != nullptr; start = std::strstr(start + nameLength, p_Name)) {
+			// Make sure it's the whole name, not the start of a longer one.
+			if ((start == p_Extensions || start[-1] == ' ') && (start[nameLength] == ' ' || start[nameLength] == '\0'))
+				return true;
+		}
+		return false;
+	}
+
+	void SetEnvironment(const char *p_Name, const char *p_Value) {
+#ifdef _WIN32
+		_putenv_s(p_Name, p_Value);
+#else
+		setenv(p_Name, p_Value, 1);
+#endif
+	}
+}
+
+HeadlessContext::GetProcAddressFunction HeadlessContext::s_m_GetProcAddress = nullptr;
+
+HeadlessContext::~HeadlessContext() {
+	DestroyContext();
+
+	if (m_Library != nullptr) {
+#ifdef _WIN32
+		FreeLibrary(static_cast<HMODULE>(m_Library));
+#else
+		dlclose(m_Library);
+#endif
+	}
+}
+
+void *HeadlessContext::LoadFunction(const char *p_Name) {
+	return s_m_GetProcAddress(p_Name);
+}
+
+bool HeadlessContext::LoadEGL() {
+#ifdef _WIN32
+	HMODULE library = LoadLibraryA("libEGL.dll");
+	m_Library = library;
+	auto load = [library](const char *p_Name) { return reinterpret_cast<void*>(::GetProcAddress(library, p_Name)); };
+#else
+	m_Library = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+	if (m_Library == nullptr)
+		m_Library = dlopen("libEGL.so", RTLD_NOW | RTLD_LOCAL);
+	void *library = m_Library;
+	auto load = [library](const char *p_Name) { return dlsym(library, p_Name); };
+#endif
+	if (m_Library == nullptr) {
+		std::cout << "ERROR::HEADLESS_CONTEXT:: Failed to load the EGL library." << std::endl;
+		return false;
+	}
+
+	m_GetDisplay = reinterpret_cast<GetDisplayFunction>(load("eglGetDisplay"));
+	m_Initialize = reinterpret_cast<InitializeFunction>(load("eglInitialize"));
+	m_Terminate = reinterpret_cast<TerminateFunction>(load("eglTerminate"));
+	m_QueryString = reinterpret_cast<QueryStringFunction>(load("eglQueryString"));
+	m_BindAPI = reinterpret_cast<BindAPIFunction>(load("eglBindAPI"));
+	m_ChooseConfig = reinterpret_cast<ChooseConfigFunction>(load("eglChooseConfig"));
+	m_CreatePbufferSurface = reinterpret_cast<CreatePbufferSurfaceFunction>(load("eglCreatePbufferSurface"));
+	m_DestroySurface = reinterpret_cast<DestroySurfaceFunction>(load("eglDestroySurface"));
+	m_CreateContext = reinterpret_cast<CreateContextFunction>(load("eglCreateContext"));
+	m_DestroyContext = reinterpret_cast<DestroyContextFunction>(load("eglDestroyContext"));
+	m_MakeCurrent = reinterpret_cast<MakeCurrentFunction>(load("eglMakeCurrent"));
+	m_GetError = reinterpret_cast<GetErrorFunction>(load("eglGetError"));
+	s_m_GetProcAddress = reinterpret_cast<GetProcAddressFunction>(load("eglGetProcAddress"));
+
+	if (!m_GetDisplay || !m_Initialize || !m_Terminate || !m_QueryString || !m_BindAPI || !m_ChooseConfig || !m_CreatePbufferSurface
+		|| !m_DestroySurface || !m_CreateContext || !m_DestroyContext || !m_MakeCurrent || !m_GetError || !s_m_GetProcAddress) {
+		std::cout << "ERROR::HEADLESS_CONTEXT:: The EGL library is missing core functions." << std::endl;
+		return false;
+	}
+
+	// Client extensions are queried without a display.
+	const char *clientExtensions = m_QueryString(nullptr, s_EGLExtensions);
+	if (HasExtension(clientExtensions, "EGL_EXT_platform_base"))
+		m_GetPlatformDisplay = reinterpret_cast<GetPlatformDisplayFunction>(s_m_GetProcAddress("eglGetPlatformDisplayEXT"));
+	if (!HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+		m_GetPlatformDisplay = nullptr;
+
+	return true;
+}
+
+bool HeadlessContext::CreateContext(bool p_UseSoftwareRenderer) {
+	if (p_UseSoftwareRenderer) {
+		// Mesa reads these when the display is initialised.
+		SetEnvironment("LIBGL_ALWAYS_SOFTWARE", "1");
+		SetEnvironment("GALLIUM_DRIVER", "llvmpipe");
+	}
+	m_IsSoftwareRenderer = p_UseSoftwareRenderer;
+
+	// Mesa's surfaceless platform doesn't need a display server, otherwise the default display has to do.
+	m_Display = m_GetPlatformDisplay ? m_GetPlatformDisplay(s_EGLPlatformSurfacelessMesa, nullptr, nullptr) : m_GetDisplay(nullptr);
+	EGLint major = 0;
+	EGLint minor = 0;
+	if (m_Display == nullptr || !m_Initialize(m_Display, &major, &minor)) {
+		std::cout << "ERROR::HEADLESS_CONTEXT:: Failed to initialise an EGL display, error: 0x" << std::hex << m_GetError() << std::dec << std::endl;
+		m_Display = nullptr;
+		return false;
+	}
+	if (!m_BindAPI(s_EGLOpenGLAPI)) {
+		std::cout << "ERROR::HEADLESS_CONTEXT:: The EGL display doesn't support desktop OpenGL." << std::endl;
+		DestroyContext();
+		return false;
+	}
+
+	EGLint pbufferConfigAttributes[] = {
+		s_EGLSurfaceType, s_EGLPbufferBit,
+		s_EGLRenderableType, s_EGLOpenGLBit,
+		s_EGLRedSize, 8, s_EGLGreenSize, 8, s_EGLBlueSize, 8, s_EGLAlphaSize, 8,
+		s_EGLDepthSize, 24, s_EGLStencilSize, 8,
+		s_EGLNone
+	};
+	EGLint anyConfigAttributes[] = {
+		s_EGLRenderableType, s_EGLOpenGLBit,
+		s_EGLNone
+	};
+	EGLConfig config = nullptr;
+	EGLint configCount = 0;
+	bool hasPbufferConfig = m_ChooseConfig(m_Display, pbufferConfigAttributes, &config, 1, &configCount) && configCount > 0;
+	if (!hasPbufferConfig) {
+		// Without a pbuffer the context is used without a surface, which needs EGL_KHR_surfaceless_context.
+		if (!HasExtension(m_QueryString(m_Display, s_EGLExtensions), "EGL_KHR_surfaceless_context")) {
+			std::cout << "ERROR::HEADLESS_CONTEXT:: The EGL display supports neither pbuffers nor surfaceless contexts." << std::endl;
+			DestroyContext();
+			return false;
+		}
+		if (!m_ChooseConfig(m_Display, anyConfigAttributes, &config, 1, &configCount) || configCount == 0)
+			config = nullptr;
+	}
+
+	EGLint contextAttributes[] = {
+		s_EGLContextMajorVersion, 4,
+		s_EGLContextMinorVersion, 3,
+		s_EGLContextOpenGLProfileMask, s_EGLContextOpenGLCoreProfileBit,
+		s_EGLNone
+	};
+	m_Context = m_CreateContext(m_Display, config, nullptr, contextAttributes);
+	if (m_Context == nullptr) {
+		std::cout << "ERROR::HEADLESS_CONTEXT:: Failed to create an OpenGL 4.3 core context, error: 0x" << std::hex << m_GetError() << std::dec << std::endl;
+		DestroyContext();
+		return false;
+	}
+
+	if (hasPbufferConfig) {
+		EGLint surfaceAttributes[] = {
+			s_EGLWidth, m_Width,
+			s_EGLHeight, m_Height,
+			s_EGLNone
+		};
+		// A failed pbuffer isn't fatal, the context can still render into a framebuffer object.
+		m_Surface = m_CreatePbufferSurface(m_Display, config, surfaceAttributes);
+	}
+
+	return MakeCurrent();
+}
+
+void HeadlessContext::DestroyContext() {
+	if (m_Display == nullptr)
+		return;
+
+	m_MakeCurrent(m_Display, nullptr, nullptr, nullptr);
+	if (m_Surface != nullptr)
+		m_DestroySurface(m_Display, m_Surface);
+	if (m_Context != nullptr)
+		m_DestroyContext(m_Display, m_Context);
+	m_Terminate(m_Display);
+
+	m_Surface = nullptr;
+	m_Context = nullptr;
+	m_Display = nullptr;
+}
+
+bool HeadlessContext::Initialize(int p_Width, int p_Height, bool p_UseSoftwareRenderer) {
+	m_Width = p_Width;
+	m_Height = p_Height;
+
+	if (!LoadEGL())
+		return false;
+
+	if (CreateContext(p_UseSoftwareRenderer))
+		return true;
+	if (p_UseSoftwareRenderer)
+		return false;
+
+	// No usable GPU, so fall back to llvmpipe.
+	std::cout << "Falling back to the software rasteriser." << std::endl;
+	DestroyContext();
+	return CreateContext(true);
+}
+
+void HeadlessContext::CreateFrameBuffer() {
+	if (HasSurface() || m_FrameBufferObject != 0)
+		return;
+
+	// Stands in for the window's framebuffer, so the final pass has somewhere to go.
+	glGenFramebuffers(1, &m_FrameBufferObject);
+	glGenRenderbuffers(1, &m_ColourRenderBufferObject);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_ColourRenderBufferObject);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColourRenderBufferObject);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::HEADLESS_CONTEXT:: The stand-in framebuffer is not complete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool HeadlessContext::MakeCurrent() {
+	if (!m_MakeCurrent(m_Display, m_Surface, m_Surface, m_Context)) {
+		std::cout << "ERROR::HEADLESS_CONTEXT:: Failed to make the context current, error: 0x" << std::hex << m_GetError() << std::dec << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void HeadlessContext::ReleaseCurrent() {
+	m_MakeCurrent(m_Display, nullptr, nullptr, nullptr);
+}
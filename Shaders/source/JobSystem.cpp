@@ -0,0 +1,157 @@
+#include "JobSystem.h"
+
+#include <cassert>
+#include <string>
+
+#include "CPUProfiler.h"
+
+thread_local JobSystem *JobSystem::t_m_JobSystem = nullptr;
+thread_local unsigned int JobSystem::t_m_WorkerIndex = 0;
+
+JobSystem::JobSystem(unsigned int p_ThreadCount) {
+	if (p_ThreadCount == 0)
+		p_ThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	const unsigned int maxJobsPerWorker = s_m_MaxJobsPerWorker;
+	m_Workers.resize(p_ThreadCount);
+	for (unsigned int i = 0; i < p_ThreadCount; i++) {
+		m_Workers[i].m_Queue = std::make_unique<WorkStealingQueue<Job>>(maxJobsPerWorker);
+		m_Workers[i].m_Jobs.reset(new Job[maxJobsPerWorker]);
+		m_Workers[i].m_RandomState = 2463534242u + i * 7919u;
+	}
+
+	m_PreviousJobSystem = t_m_JobSystem;
+	m_PreviousWorkerIndex = t_m_WorkerIndex;
+	t_m_JobSystem = this;
+	t_m_WorkerIndex = 0;
+
+	for (unsigned int i = 1; i < p_ThreadCount; i++)
+		m_Threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(m_WakeMutex);
+		m_IsRunning = false;
+	}
+	m_WakeCondition.notify_all();
+	for (auto &thread : m_Threads)
+		thread.join();
+
+	t_m_JobSystem = m_PreviousJobSystem;
+	t_m_WorkerIndex = m_PreviousWorkerIndex;
+}
+
+void JobSystem::WorkerLoop(unsigned int p_WorkerIndex) {
+	t_m_JobSystem = this;
+	t_m_WorkerIndex = p_WorkerIndex;
+	CPU_PROFILE_THREAD_NAME("Job worker " + std::to_string(p_WorkerIndex));
+
+	while (m_IsRunning) {
+		Job *job = nullptr;
+		for (unsigned int i = 0; i < s_m_IdleSpinCount && !job; i++) {
+			job = FindJob(p_WorkerIndex);
+			if (!job)
+				std::this_thread::yield();
+		}
+		if (job) {
+			Execute(job);
+			continue;
+		}
+
+		// Nothing to do, sleep until a job is pushed. Run checks the sleeper count after counting its job, so a wake can't be missed.
+		std::unique_lock<std::mutex> lock(m_WakeMutex);
+		m_SleepingWorkers++;
+		m_WakeCondition.wait(lock, [this]() { return !m_IsRunning || m_QueuedJobs.load() > 0; });
+		m_SleepingWorkers--;
+	}
+}
+
+JobSystem::Job *JobSystem::FindJob(unsigned int p_WorkerIndex) {
+	Worker &worker = m_Workers[p_WorkerIndex];
+	Job *job = worker.m_Queue->Pop();
+
+	if (!job && m_Workers.size() > 1) {
+		// Start from a random victim, so the thieves don't all fight over the same deque.
+		worker.m_RandomState ^= worker.m_RandomState << 13;
+		worker.m_RandomState ^= worker.m_RandomState >> 17;
+		worker.m_RandomState ^= worker.m_RandomState << 5;
+		size_t workerCount = m_Workers.size();
+		size_t firstVictim = worker.m_RandomState % workerCount;
+		for (size_t i = 0; i < workerCount && !job; i++) {
+			size_t victim = (firstVictim + i) % workerCount;
+			if (victim != p_WorkerIndex)
+				job = m_Workers[victim].m_Queue->Steal();
+		}
+	}
+
+	if (job)
+		m_QueuedJobs--;
+	return job;
+}
+
+JobSystem::Job *JobSystem::AllocateJob(Worker &p_Worker) {
+	// Jobs mostly finish in the order they're queued, so the next in the ring is nearly always free.
+	for (unsigned int i = 0; i < s_m_MaxJobsPerWorker; i++) {
+		Job *job = &p_Worker.m_Jobs[p_Worker.m_NextJob];
+		p_Worker.m_NextJob = (p_Worker.m_NextJob + 1) % s_m_MaxJobsPerWorker;
+		if (job->m_IsFree.load(std::memory_order_acquire)) {
+			job->m_IsFree.store(false, std::memory_order_relaxed);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::Execute(Job *p_Job) {
+	p_Job->m_Function();
+
+	// Cleared before the job is freed or counted, so whatever the function captured is released before a waiter carries on.
+	JobCounter *counter = p_Job->m_Counter;
+	p_Job->m_Function = nullptr;
+	p_Job->m_Counter = nullptr;
+	p_Job->m_IsFree.store(true, std::memory_order_release);
+	counter->fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Run(std::function<void()> p_Function, JobCounter &p_Counter) {
+	if (t_m_JobSystem != this) {
+		p_Function();
+		return;
+	}
+
+	// With every job in flight there's nowhere to put another, so it runs here, without touching the ring.
+	Worker &worker = m_Workers[t_m_WorkerIndex];
+	Job *job = AllocateJob(worker);
+	if (!job) {
+		p_Function();
+		return;
+	}
+	job->m_Function = std::move(p_Function);
+	job->m_Counter = &p_Counter;
+
+	p_Counter.fetch_add(1, std::memory_order_relaxed);
+	if (!worker.m_Queue->Push(job)) {
+		Execute(job);
+		return;
+	}
+
+	m_QueuedJobs++;
+	if (m_SleepingWorkers.load() > 0) {
+		std::lock_guard<std::mutex> lock(m_WakeMutex);
+		m_WakeCondition.notify_one();
+	}
+}
+
+void JobSystem::Wait(const JobCounter &p_Counter) {
+	assert(t_m_JobSystem == this || p_Counter.load() == 0);
+
+	// Help out rather than block, the jobs being waited on may be sitting in this thread's own deque.
+	while (p_Counter.load(std::memory_order_acquire) != 0) {
+		Job *job = FindJob(t_m_WorkerIndex);
+		if (job)
+			Execute(job);
+		else
+			std::this_thread::yield();
+	}
+}
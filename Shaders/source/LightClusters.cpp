@@ -0,0 +1,137 @@
+#include "LightClusters.h"
+
+#include <algorithm>
+
+#include "FramePacket.h"
+#include "JobSystem.h"
+
+void LightClusterBinner::Bin(JobSystem &p_JobSystem, const std::vector<FrameLight> &p_Lights, const glm::mat4 &p_View, const glm::mat4 &p_Projection, float p_NearPlane, float p_FarPlane,
+	size_t p_MaxIndexCount, std::vector<glm::uvec2> &p_ClusterLightRanges, std::vector<unsigned int> &p_ClusterLightIndices) {
+	for (unsigned int slice = 0; slice <= s_m_SliceCount; slice++)
+		m_SliceDepths[slice] = p_NearPlane * glm::pow(p_FarPlane / p_NearPlane, static_cast<float>(slice) / s_m_SliceCount);
+	glm::vec2 sliceScaleAndBias = GetSliceScaleAndBias(p_NearPlane, p_FarPlane);
+	auto getSlice = [&sliceScaleAndBias](float p_Depth) {
+		float slice = glm::log(p_Depth) * sliceScaleAndBias.x - sliceScaleAndBias.y;
+		return static_cast<unsigned int>(glm::clamp(slice, 0.0f, static_cast<float>(s_m_SliceCount - 1)));
+	};
+	auto getTile = [](float p_NDC, unsigned int p_TileCount) {
+		float tile = (p_NDC * 0.5f + 0.5f) * p_TileCount;
+		return static_cast<unsigned int>(glm::clamp(tile, 0.0f, static_cast<float>(p_TileCount - 1)));
+	};
+
+	// Find the range of clusters each light's bounds cover, so the slices only test the clusters a light could touch.
+	m_Lights.clear();
+	for (size_t i = 0; i < p_Lights.size(); i++) {
+		BinnedLight light;
+		light.m_ViewPosition = glm::vec3(p_View * glm::vec4(p_Lights[i].m_Position, 1.0f));
+		light.m_Radius = p_Lights[i].m_Radius;
+		light.m_Index = static_cast<unsigned int>(i);
+		float depth = -light.m_ViewPosition.z;
+		if (depth + light.m_Radius < p_NearPlane || depth - light.m_Radius > p_FarPlane)
+			continue;
+		light.m_FirstSlice = getSlice(std::max(depth - light.m_Radius, p_NearPlane));
+		light.m_LastSlice = getSlice(std::min(depth + light.m_Radius, p_FarPlane));
+
+		if (depth - light.m_Radius <= p_NearPlane) {
+			// Part of the light is behind the camera, where projecting its corners would flip them.
+			light.m_TileMinimum = glm::uvec2(0, 0);
+			light.m_TileMaximum = glm::uvec2(s_m_TileCountX - 1, s_m_TileCountY - 1);
+		}
+		else {
+			glm::vec2 minimum(1.0f);
+			glm::vec2 maximum(-1.0f);
+			for (unsigned int corner = 0; corner < 8; corner++) {
+				glm::vec3 offset((corner & 1) ? light.m_Radius : -light.m_Radius, (corner & 2) ? light.m_Radius : -light.m_Radius, (corner & 4) ? light.m_Radius : -light.m_Radius);
+				glm::vec4 clipPosition = p_Projection * glm::vec4(light.m_ViewPosition + offset, 1.0f);
+				glm::vec2 ndcPosition = glm::vec2(clipPosition) / clipPosition.w;
+				minimum = glm::min(minimum, ndcPosition);
+				maximum = glm::max(maximum, ndcPosition);
+			}
+			if (maximum.x < -1.0f || maximum.y < -1.0f || minimum.x > 1.0f || minimum.y > 1.0f)
+				continue;
+			light.m_TileMinimum = glm::uvec2(getTile(minimum.x, s_m_TileCountX), getTile(minimum.y, s_m_TileCountY));
+			light.m_TileMaximum = glm::uvec2(getTile(maximum.x, s_m_TileCountX), getTile(maximum.y, s_m_TileCountY));
+		}
+		m_Lights.push_back(light);
+	}
+
+	p_JobSystem.ParallelFor(s_m_SliceCount, 1, [this, &p_Projection](size_t p_FirstSlice, size_t p_LastSlice) {
+		for (size_t slice = p_FirstSlice; slice < p_LastSlice; slice++)
+			BinSlice(static_cast<unsigned int>(slice), p_Projection);
+	});
+
+	// Join the slices' lists, in cluster order.
+	p_ClusterLightRanges.assign(s_m_ClusterCount, glm::uvec2(0));
+	p_ClusterLightIndices.clear();
+	m_DroppedIndexCount = 0;
+	for (unsigned int slice = 0; slice < s_m_SliceCount; slice++) {
+		const SliceBin &bin = m_Slices[slice];
+		for (unsigned int tile = 0; tile < s_m_TileCount; tile++) {
+			unsigned int count = bin.m_TileOffsets[tile + 1] - bin.m_TileOffsets[tile];
+			unsigned int keptCount = static_cast<unsigned int>(std::min<size_t>(count, p_MaxIndexCount - p_ClusterLightIndices.size()));
+			m_DroppedIndexCount += count - keptCount;
+
+			p_ClusterLightRanges[tile + slice * s_m_TileCount] = glm::uvec2(static_cast<unsigned int>(p_ClusterLightIndices.size()), keptCount);
+			auto first = bin.m_Indices.begin() + bin.m_TileOffsets[tile];
+			p_ClusterLightIndices.insert(p_ClusterLightIndices.end(), first, first + keptCount);
+		}
+	}
+}
+
+void LightClusterBinner::BinSlice(unsigned int p_Slice, const glm::mat4 &p_Projection) {
+	SliceBin &bin = m_Slices[p_Slice];
+	bin.m_Hits.clear();
+
+	// A symmetric perspective projection, so a point at a given depth and NDC position is at NDC * depth / scale in view space.
+	float nearDepth = m_SliceDepths[p_Slice];
+	float farDepth = m_SliceDepths[p_Slice + 1];
+	float inverseXScale = 1.0f / p_Projection[0][0];
+	float inverseYScale = 1.0f / p_Projection[1][1];
+	auto getViewRange = [nearDepth, farDepth](unsigned int p_Tile, unsigned int p_TileCount, float p_InverseScale) {
+		float first = -1.0f + 2.0f * p_Tile / p_TileCount;
+		float last = -1.0f + 2.0f * (p_Tile + 1) / p_TileCount;
+		return glm::vec2(std::min(first * nearDepth, first * farDepth), std::max(last * nearDepth, last * farDepth)) * p_InverseScale;
+	};
+
+	for (const BinnedLight &light : m_Lights) {
+		if (p_Slice < light.m_FirstSlice || p_Slice > light.m_LastSlice)
+			continue;
+
+		// Test the light's sphere against each cluster's view space bounding box.
+		float closestZ = glm::clamp(light.m_ViewPosition.z, -farDepth, -nearDepth) - light.m_ViewPosition.z;
+		float radiusSquared = light.m_Radius * light.m_Radius - closestZ * closestZ;
+		for (unsigned int y = light.m_TileMinimum.y; y <= light.m_TileMaximum.y; y++) {
+			glm::vec2 yRange = getViewRange(y, s_m_TileCountY, inverseYScale);
+			float closestY = glm::clamp(light.m_ViewPosition.y, yRange.x, yRange.y) - light.m_ViewPosition.y;
+			float rowRadiusSquared = radiusSquared - closestY * closestY;
+			if (rowRadiusSquared < 0.0f)
+				continue;
+
+			for (unsigned int x = light.m_TileMinimum.x; x <= light.m_TileMaximum.x; x++) {
+				glm::vec2 xRange = getViewRange(x, s_m_TileCountX, inverseXScale);
+				float closestX = glm::clamp(light.m_ViewPosition.x, xRange.x, xRange.y) - light.m_ViewPosition.x;
+				if (closestX * closestX <= rowRadiusSquared)
+					bin.m_Hits.push_back(glm::uvec2(x + y * s_m_TileCountX, light.m_Index));
+			}
+		}
+	}
+
+	// A counting sort by tile, which keeps each tile's lights in order.
+	bin.m_TileOffsets.fill(0);
+	for (const glm::uvec2 &hit : bin.m_Hits)
+		bin.m_TileOffsets[hit.x + 1]++;
+	for (unsigned int tile = 0; tile < s_m_TileCount; tile++)
+		bin.m_TileOffsets[tile + 1] += bin.m_TileOffsets[tile];
+
+	std::array<unsigned int, s_m_TileCount> cursors;
+	std::copy(bin.m_TileOffsets.begin(), bin.m_TileOffsets.end() - 1, cursors.begin());
+	bin.m_Indices.resize(bin.m_Hits.size());
+	for (const glm::uvec2 &hit : bin.m_Hits)
+		bin.m_Indices[cursors[hit.x]++] = hit.y;
+}
+
+glm::vec2 LightClusterBinner::GetSliceScaleAndBias(float p_NearPlane, float p_FarPlane) {
+	// slice = log(depth / near) / log(far / near) * slices, split so the shaders only need one multiply and subtract.
+	float scale = s_m_SliceCount / glm::log(p_FarPlane / p_NearPlane);
+	return glm::vec2(scale, scale * glm::log(p_NearPlane));
+}
@@ -13,6 +13,18 @@ Mesh::Mesh(std::vector<Vertex> p_Vertices, std::vector<unsigned int> p_Indices,
 
 // Render the mesh with a given shader program.
 void Mesh::Render(const unsigned int p_ShaderProgram) {
+	BindTextures(p_ShaderProgram);
+
+	// Draw mesh.
+	glBindVertexArray(m_VertexArrayObject);
+	glDrawElements(GL_TRIANGLES, (GLsizei)m_Indices.size(), GL_UNSIGNED_INT, 0);
+	glBindVertexArray(0);
+
+	// Return to default texture.
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void Mesh::BindTextures(const unsigned int p_ShaderProgram) const {
 	// Bind the appropriate textures.
 	unsigned int diffuseNr = 1;
 	unsigned int specularNr = 1;
@@ -37,50 +49,74 @@ void Mesh::Render(const unsigned int p_ShaderProgram) {
 		// and finally bind the texture.
 		glBindTexture(GL_TEXTURE_2D, m_Textures[i].m_ID);
 	}
+}
 
-	// Draw mesh.
-	glBindVertexArray(m_VertexArrayObject);
+// Render the mesh's positions only, the depth pass doesn't need any other attributes or textures.
+void Mesh::RenderDepthOnly() {
+	glBindVertexArray(m_PositionOnlyVertexArrayObject);
 	glDrawElements(GL_TRIANGLES, (GLsizei)m_Indices.size(), GL_UNSIGNED_INT, 0);
 	glBindVertexArray(0);
-
-	// Return to default texture.
-	glActiveTexture(GL_TEXTURE0);
 }
 
 // Initialises all the buffer arrays.
 void Mesh::SetupMesh() {
+	// Split the vertices into two streams, so passes that only need positions don't fetch the other attributes.
+	std::vector<glm::vec3> positions(m_Vertices.size());
+	std::vector<VertexSurface> surfaces(m_Vertices.size());
+	for (size_t i = 0; i < m_Vertices.size(); i++) {
+		positions[i] = m_Vertices[i].m_Position;
+		surfaces[i].m_Normal = m_Vertices[i].m_Normal;
+		surfaces[i].m_TextureCoordinates = m_Vertices[i].m_TextureCoordinates;
+		surfaces[i].m_Tangent = m_Vertices[i].m_Tangent;
+	}
+
 	// Create buffers/arrays.
 	glGenVertexArrays(1, &m_VertexArrayObject);
-	glGenBuffers(1, &m_VertexBufferObject);
+	glGenVertexArrays(1, &m_PositionOnlyVertexArrayObject);
+	glGenBuffers(1, &m_PositionBufferObject);
+	glGenBuffers(1, &m_SurfaceBufferObject);
 	glGenBuffers(1, &m_ElementBufferObject);
 
-	glBindVertexArray(m_VertexArrayObject);
 	// Load data into vertex buffers.
-	glBindBuffer(GL_ARRAY_BUFFER, m_VertexBufferObject);
-
-	// Set the memory address as the first vertex struct.
-	glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex), &m_Vertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, m_PositionBufferObject);
+	glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), &positions[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, m_SurfaceBufferObject);
+	glBufferData(GL_ARRAY_BUFFER, surfaces.size() * sizeof(VertexSurface), &surfaces[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+	// The vertex array object, with every attribute.
+	glBindVertexArray(m_VertexArrayObject);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ElementBufferObject);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(unsigned int), &m_Indices[0], GL_STATIC_DRAW);
 
-	// Set the vertex attribute pointers.
+	glBindVertexBuffer(s_m_PositionStreamBinding, m_PositionBufferObject, 0, sizeof(glm::vec3));
+	glBindVertexBuffer(s_m_SurfaceStreamBinding, m_SurfaceBufferObject, 0, sizeof(VertexSurface));
+
+	// Set the vertex attribute formats, and the stream they're read from.
 	// Positions.
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+	glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, 0);
+	glVertexAttribBinding(0, s_m_PositionStreamBinding);
 	// Normals.
 	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Normal));
+	glVertexAttribFormat(1, 3, GL_FLOAT, GL_FALSE, offsetof(VertexSurface, m_Normal));
+	glVertexAttribBinding(1, s_m_SurfaceStreamBinding);
 	// Texture coordinates.
 	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_TextureCoordinates));
-	// Tangets.
+	glVertexAttribFormat(2, 2, GL_FLOAT, GL_FALSE, offsetof(VertexSurface, m_TextureCoordinates));
+	glVertexAttribBinding(2, s_m_SurfaceStreamBinding);
+	// Tangents.
 	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Tangent));
-	// Bitangents.
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Bitangent));
+	glVertexAttribFormat(3, 3, GL_FLOAT, GL_FALSE, offsetof(VertexSurface, m_Tangent));
+	glVertexAttribBinding(3, s_m_SurfaceStreamBinding);
+
+	// The vertex array object, with only the positions, sharing the same index buffer.
+	glBindVertexArray(m_PositionOnlyVertexArrayObject);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ElementBufferObject);
+	glBindVertexBuffer(s_m_PositionStreamBinding, m_PositionBufferObject, 0, sizeof(glm::vec3));
+	glEnableVertexAttribArray(0);
+	glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, 0);
+	glVertexAttribBinding(0, s_m_PositionStreamBinding);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 }
\ No newline at end of file
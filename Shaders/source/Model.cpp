@@ -4,6 +4,9 @@
 #include <stb_image/stb_image.h>
 
 #include <iostream>
+#include <limits>
+
+#include "CPUProfiler.h"
 
 Model::Model(std::string p_FilePath) {
 	LoadModel(p_FilePath);
@@ -13,13 +16,36 @@ Model::Model(const std::string &p_FilePath, bool &p_ModelLoaded) {
 	p_ModelLoaded = LoadModel(p_FilePath);
 }
 
+Model::Model(std::vector<Mesh> p_Meshes) : m_Meshes(p_Meshes) {
+	// Every mesh belongs to a single, untransformed, node.
+	TransformHandle rootNode = m_NodeHierarchy.AddNode();
+	m_MeshNodes.assign(m_Meshes.size(), rootNode);
+	m_NodeHierarchy.Update();
+	CalculateBoundingSphere();
+}
+
 void Model::Render(const unsigned int p_ShaderProgram) {
-	for (auto mesh : m_Meshes) {
+	for (auto &mesh : m_Meshes) {
 		mesh.Render(p_ShaderProgram);
 	}
 }
 
+void Model::RenderDepthOnly() {
+	for (auto &mesh : m_Meshes) {
+		mesh.RenderDepthOnly();
+	}
+}
+
+void Model::RenderMesh(size_t p_MeshIndex, const unsigned int p_ShaderProgram) {
+	m_Meshes[p_MeshIndex].Render(p_ShaderProgram);
+}
+
+void Model::RenderMeshDepthOnly(size_t p_MeshIndex) {
+	m_Meshes[p_MeshIndex].RenderDepthOnly();
+}
+
 bool Model::LoadModel(std::string p_FilePath) {
+	CPU_PROFILE_FUNCTION();
 	Assimp::Importer import;
 	const aiScene *scene = import.ReadFile(p_FilePath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
 
@@ -29,21 +55,65 @@ bool Model::LoadModel(std::string p_FilePath) {
 	}
 	m_Directory = p_FilePath.substr(0, p_FilePath.find_last_of('/'));
 
-	ProcessNode(scene->mRootNode, scene);
+	ProcessNode(scene->mRootNode, scene, s_InvalidTransform);
+
+	// The nodes don't move once loaded, so their transforms only need calculating once.
+	m_NodeHierarchy.Update();
+	for (auto node : m_MeshNodes) {
+		if (m_NodeHierarchy.GetWorldMatrix(node) != glm::mat4(1.0f)) {
+			m_HasNodeTransforms = true;
+			break;
+		}
+	}
+	CalculateBoundingSphere();
 
 	return true;
 }
 
-void Model::ProcessNode(aiNode *p_Node, const aiScene *p_Scene) {
+void Model::ProcessNode(aiNode *p_Node, const aiScene *p_Scene, TransformHandle p_ParentNode) {
+	// Keep the node's transform, relative to its parent.
+	aiVector3D scaling;
+	aiQuaternion rotation;
+	aiVector3D position;
+	p_Node->mTransformation.Decompose(scaling, rotation, position);
+	TransformHandle node = m_NodeHierarchy.AddNode(p_ParentNode, glm::vec3(position.x, position.y, position.z),
+		glm::quat(rotation.w, rotation.x, rotation.y, rotation.z), glm::vec3(scaling.x, scaling.y, scaling.z));
+
 	// Get the meshes of the node and add them to our vector.
 	for (unsigned int i = 0; i < p_Node->mNumMeshes; i++) {
 		int sceneMeshIndex = p_Node->mMeshes[i];
 		aiMesh* mesh = p_Scene->mMeshes[sceneMeshIndex];
 		m_Meshes.push_back(ProcessMesh(mesh, p_Scene));
+		m_MeshNodes.push_back(node);
 	}
 	// Recursively process the nodes of any children.
 	for (unsigned int i = 0; i < p_Node->mNumChildren; i++) {
-		ProcessNode(p_Node->mChildren[i], p_Scene);
+		ProcessNode(p_Node->mChildren[i], p_Scene, node);
+	}
+}
+
+void Model::CalculateBoundingSphere() {
+	glm::vec3 minimum(std::numeric_limits<float>::max());
+	glm::vec3 maximum(std::numeric_limits<float>::lowest());
+	for (size_t i = 0; i < m_Meshes.size(); i++) {
+		const glm::mat4 &meshTransform = GetMeshTransform(i);
+		for (const auto &vertex : m_Meshes[i].m_Vertices) {
+			glm::vec3 position = glm::vec3(meshTransform * glm::vec4(vertex.m_Position, 1.0f));
+			minimum = glm::min(minimum, position);
+			maximum = glm::max(maximum, position);
+		}
+	}
+	if (minimum.x > maximum.x)
+		return;
+
+	m_BoundingSphereCentre = (minimum + maximum) * 0.5f;
+	m_BoundingSphereRadius = 0.0f;
+	for (size_t i = 0; i < m_Meshes.size(); i++) {
+		const glm::mat4 &meshTransform = GetMeshTransform(i);
+		for (const auto &vertex : m_Meshes[i].m_Vertices) {
+			glm::vec3 position = glm::vec3(meshTransform * glm::vec4(vertex.m_Position, 1.0f));
+			m_BoundingSphereRadius = glm::max(m_BoundingSphereRadius, glm::distance(position, m_BoundingSphereCentre));
+		}
 	}
 }
 
@@ -0,0 +1,28 @@
+#include "OpenGLExtensions.h"
+
+#include <cstring>
+#include <iostream>
+
+PFNGLBUFFERSTORAGEPROC OpenGLExtensions::s_m_BufferStorage = nullptr;
+
+bool OpenGLExtensions::IsExtensionSupported(const char *p_Name) {
+	GLint numberOfExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numberOfExtensions);
+	for (GLint i = 0; i < numberOfExtensions; i++) {
+		const char *extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		if (extension != nullptr && std::strcmp(extension, p_Name) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+void OpenGLExtensions::Load(GLADloadproc p_Loader) {
+	bool isVersion44 = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 4);
+
+	if (isVersion44 || IsExtensionSupported("GL_ARB_buffer_storage"))
+		s_m_BufferStorage = reinterpret_cast<PFNGLBUFFERSTORAGEPROC>(p_Loader("glBufferStorage"));
+
+	if (!HasBufferStorage())
+		std::cout << "\nglBufferStorage isn't supported, streaming buffers will fall back to glBufferSubData." << std::endl;
+}
\ No newline at end of file
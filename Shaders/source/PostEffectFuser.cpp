@@ -0,0 +1,63 @@
+#include "PostEffectFuser.h"
+
+#include <iostream>
+#include <sstream>
+
+#include "PostEffects.h"
+#include "ResourceManager.h"
+#include "Shader.h"
+
+static const char *s_FusedVertexShader =
+	"#version 430 core\n"
+	"\n"
+	"#include \"include/fullScreenTriangle.glsl\"\n"
+	"\n"
+	"out vec2 TexCoords;\n"
+	"\n"
+	"void main() {\n"
+	"	TexCoords = FullScreenTexCoords();\n"
+	"	gl_Position = vec4(TexCoords * 2.0f - 1.0f, 0.0f, 1.0f);\n"
+	"}\n";
+
+std::string PostEffectFuser::GenerateFragmentShader(const std::vector<const PixelEffect*> &p_Effects) {
+	std::ostringstream source;
+	source << "#version 430 core\n\n";
+	source << "in vec2 TexCoords;\n\n";
+	source << "out vec4 FragColour;\n\n";
+	source << "uniform sampler2D scene;\n\n";
+	for (const PixelEffect *effect : p_Effects)
+		source << "#include \"" << effect->GetSnippetPath() << "\"\n";
+
+	source << "\nvoid main() {\n";
+	source << "\tvec3 colour = texture(scene, TexCoords).rgb;\n";
+	for (const PixelEffect *effect : p_Effects)
+		source << "\tcolour = " << effect->GetFunctionName() << "(colour, TexCoords);\n";
+	source << "\tFragColour = vec4(colour, 1.0f);\n";
+	source << "}\n";
+
+	return source.str();
+}
+
+std::shared_ptr<Shader> PostEffectFuser::GetProgram(const std::vector<const PixelEffect*> &p_Effects) {
+	std::string key = "fused";
+	for (const PixelEffect *effect : p_Effects)
+		key += "_" + effect->GetFunctionName();
+
+	auto iter = m_Programs.find(key);
+	if (iter != m_Programs.end())
+		return iter->second;
+
+	// A chain that doesn't compile is remembered too, so it isn't retried every frame.
+	std::shared_ptr<Shader> program = ResourceManagerInstance.CompileShader(key, s_FusedVertexShader, GenerateFragmentShader(p_Effects));
+	if (program) {
+		program->Use();
+		program->SetInt("scene", 0);
+	}
+	else {
+		std::cout << "ERROR::POST_EFFECT_FUSER:: The fused shader " << key << " failed to compile." << std::endl;
+		m_FailedCompileCount++;
+	}
+	m_Programs.emplace(key, program);
+
+	return program;
+}
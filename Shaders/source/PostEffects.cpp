@@ -0,0 +1,641 @@
+#include "PostEffects.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <glad/glad.h>
+
+#include "PostProcessGraph.h"
+#include "ResourceManager.h"
+#include "Shader.h"
+#include "UniformBlocks.h"
+
+// The texture coordinate offsets of a 3x3 kernel's taps.
+static void SetKernelOffsets(const Shader &p_Shader) {
+	float offset = 1.0f / 300.0f;
+	float offsets[9][2] = {
+		{ -offset,  offset  },  // Top-left.
+		{  0.0f,    offset  },  // Top-center.
+		{  offset,  offset  },  // Top-right.
+		{ -offset,  0.0f    },  // Center-left.
+		{  0.0f,    0.0f    },  // Center-center.
+		{  offset,  0.0f    },  // Center-right.
+		{ -offset, -offset  },  // Bottom-left.
+		{  0.0f,   -offset  },  // Bottom-center.
+		{  offset, -offset  }   // Bottom-right.
+	};
+	glUniform2fv(glGetUniformLocation(p_Shader.GetID(), "offsets"), 9, (GLfloat*)offsets);
+}
+
+ShakeEffect::ShakeEffect() : PostEffect("Shake") {
+	m_Shader = ResourceManagerInstance.GetShader("postShake");
+	m_Shader->Use();
+	m_Shader->SetInt("scene", 0);
+	SetKernelOffsets(*m_Shader);
+
+	float blurKernel[9] = {
+		1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
+		2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
+		1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
+	};
+	glUniform1fv(glGetUniformLocation(m_Shader->GetID(), "blurKernel"), 9, &blurKernel[0]);
+}
+
+void ShakeEffect::Update(float p_DeltaTime) {
+	m_AccumulatedTime += p_DeltaTime;
+}
+
+void ShakeEffect::Setup(PostProcessGraph &p_Graph) {
+	PostResource input = p_Graph.GetColour();
+	PostTargetDescription description;
+	description.m_Format = p_Graph.GetFormat(input);
+	PostResource output = p_Graph.CreateTarget("Shake", description);
+	p_Graph.AddPass(GetName(), { input }, { output }, [this, input, output](PostProcessGraph &p_Graph) {
+		p_Graph.BindTarget(output);
+		// The image is moved off the edge of the screen, uncovering the background.
+		glClearColor(0.25f, 0.25f, 0.25f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		m_Shader->Use();
+		m_Shader->SetFloat("time", m_AccumulatedTime);
+		p_Graph.BindTexture(0, input);
+		p_Graph.DrawFullScreenTriangle();
+	});
+	p_Graph.SetColour(output);
+}
+
+BlurEffect::BlurEffect() : PostEffect("Blur") {
+	m_Shader = ResourceManagerInstance.GetShader("postBlur");
+	m_Shader->Use();
+	m_Shader->SetInt("source", 0);
+}
+
+void BlurEffect::Setup(PostProcessGraph &p_Graph) {
+	// The radius in reduced pixels, with the kernel covering three standard deviations either side.
+	int radius = std::min(s_m_MaxRadius, std::max(1, static_cast<int>(std::ceil(m_Radius / m_Downsample))));
+	float sigma = radius / 3.0f;
+	m_Weights.resize(radius + 1);
+	float total = 0.0f;
+	for (int i = 0; i <= radius; i++) {
+		m_Weights[i] = std::exp(-0.5f * i * i / (sigma * sigma));
+		total += i == 0 ? m_Weights[i] : 2.0f * m_Weights[i];
+	}
+	for (float &weight : m_Weights)
+		weight /= total;
+
+	PostTargetDescription description;
+	description.m_Scale = 1.0f / m_Downsample;
+	// The shader's image format, so the blur keeps the colour's range whether it's run before or after the tonemap.
+	description.m_Format = GL_R11F_G11F_B10F;
+	description.m_IsImage = true;
+	PostResource input = p_Graph.GetColour();
+	PostResource horizontal = p_Graph.CreateTarget("Blurred rows", description);
+	PostResource output = p_Graph.CreateTarget("Blurred", description);
+	p_Graph.AddPass("Blur rows", { input }, { horizontal }, [this, input, horizontal](PostProcessGraph &p_Graph) {
+		Dispatch(p_Graph, input, horizontal, glm::ivec2(1, 0));
+	});
+	p_Graph.AddPass("Blur columns", { horizontal }, { output }, [this, horizontal, output](PostProcessGraph &p_Graph) {
+		Dispatch(p_Graph, horizontal, output, glm::ivec2(0, 1));
+	});
+	p_Graph.SetColour(output);
+}
+
+void BlurEffect::Dispatch(PostProcessGraph &p_Graph, unsigned int p_Input, unsigned int p_Output, const glm::ivec2 &p_Direction) const {
+	glm::ivec2 inputSize = p_Graph.GetSize(p_Input);
+	glm::ivec2 size = p_Graph.GetSize(p_Output);
+
+	m_Shader->Use();
+	glUniform2i(glGetUniformLocation(m_Shader->GetID(), "direction"), p_Direction.x, p_Direction.y);
+	m_Shader->SetInt("radius", static_cast<int>(m_Weights.size()) - 1);
+	glUniform1fv(glGetUniformLocation(m_Shader->GetID(), "weights"), static_cast<GLsizei>(m_Weights.size()), m_Weights.data());
+	// A quarter of an output pixel either side of its centre lands the bilinear taps between the input's pixels, for a 2x2 or 4x4 box.
+	if (inputSize != size)
+		m_Shader->SetVec2("downsampleOffset", glm::vec2(0.25f) / glm::vec2(size));
+	else
+		m_Shader->SetVec2("downsampleOffset", glm::vec2(0.0f));
+	p_Graph.BindTexture(0, p_Input);
+	p_Graph.BindImage(0, p_Output);
+
+	// One work group per run of pixels along each row, or column.
+	int lineLength = p_Direction.x == 1 ? size.x : size.y;
+	int lineCount = p_Direction.x == 1 ? size.y : size.x;
+	glDispatchCompute((lineLength + s_m_TileSize - 1) / s_m_TileSize, lineCount, 1);
+	// The next pass samples what was written, or the graph blits it into the output.
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
+void PixelEffect::Setup(PostProcessGraph &p_Graph) {
+	p_Graph.AddPixelEffect(*this);
+}
+
+void PixelEffect::SetTexture(const std::string &p_Uniform, PostResource p_Resource) {
+	for (PixelEffectTexture &texture : m_Textures) {
+		if (texture.m_Uniform == p_Uniform) {
+			texture.m_Resource = p_Resource;
+			return;
+		}
+	}
+	m_Textures.push_back({ p_Uniform, p_Resource });
+}
+
+InvertColoursEffect::InvertColoursEffect() : PixelEffect("Invert colours", "include/pixelEffects/invertColours.glsl", "InvertColours") {
+}
+
+TonemapEffect::TonemapEffect() : PixelEffect("Tonemap", "include/pixelEffects/tonemap.glsl", "Tonemap") {
+}
+
+void TonemapEffect::SetUniforms(const Shader &p_Shader) const {
+	p_Shader.SetFloat("tonemapExposure", m_Exposure);
+}
+
+BloomEffect::BloomEffect() : PixelEffect("Bloom", "include/pixelEffects/bloom.glsl", "Bloom") {
+	m_DownsampleShader = ResourceManagerInstance.GetShader("postBloomDownsample");
+	m_DownsampleShader->Use();
+	m_DownsampleShader->SetInt("source", 0);
+	m_UpsampleShader = ResourceManagerInstance.GetShader("postBloomUpsample");
+	m_UpsampleShader->Use();
+	m_UpsampleShader->SetInt("source", 0);
+	m_UpsampleShader->SetInt("current", 1);
+}
+
+void BloomEffect::Setup(PostProcessGraph &p_Graph) {
+	PostResource input = p_Graph.GetColour();
+	glm::ivec2 size = p_Graph.GetSize(input);
+	PostTargetDescription description;
+	description.m_Scale = p_Graph.GetScale(input);
+	description.m_Format = GL_R11F_G11F_B10F;
+
+	// Halved until the next level would be too small to blur, so small targets get a shorter chain.
+	std::vector<PostResource> levels;
+	while (static_cast<int>(levels.size()) < s_m_MaxLevelCount && std::min(size.x, size.y) / 2 >= s_m_MinLevelSize) {
+		size /= 2;
+		description.m_Scale *= 0.5f;
+		std::string name = "Bloom down " + std::to_string(levels.size());
+		PostResource source = levels.empty() ? input : levels.back();
+		PostResource level = p_Graph.CreateTarget(name, description);
+		bool isFirstLevel = levels.empty();
+		p_Graph.AddPass(name, { source }, { level }, [this, source, level, isFirstLevel](PostProcessGraph &p_Graph) {
+			p_Graph.BindTarget(level);
+			m_DownsampleShader->Use();
+			m_DownsampleShader->SetVec2("sourceTexelSize", glm::vec2(1.0f) / glm::vec2(p_Graph.GetSize(source)));
+			m_DownsampleShader->SetBool("isFirstLevel", isFirstLevel);
+			float knee = std::max(m_Knee, 1e-5f);
+			m_DownsampleShader->SetVec4("bloomFilter", m_Threshold, m_Threshold - knee, 2.0f * knee, 0.25f / knee);
+			p_Graph.BindTexture(0, source);
+			p_Graph.DrawFullScreenTriangle();
+		});
+		levels.push_back(level);
+	}
+	if (levels.empty())
+		return;
+
+	PostResource upsampled = levels.back();
+	for (size_t i = levels.size() - 1; i-- > 0;) {
+		std::string name = "Bloom up " + std::to_string(i);
+		PostResource current = levels[i];
+		description.m_Scale = p_Graph.GetScale(current);
+		PostResource level = p_Graph.CreateTarget(name, description);
+		p_Graph.AddPass(name, { upsampled, current }, { level }, [this, upsampled, current, level](PostProcessGraph &p_Graph) {
+			p_Graph.BindTarget(level);
+			m_UpsampleShader->Use();
+			m_UpsampleShader->SetVec2("sourceTexelSize", glm::vec2(1.0f) / glm::vec2(p_Graph.GetSize(upsampled)));
+			m_UpsampleShader->SetFloat("radius", m_Radius);
+			p_Graph.BindTexture(0, upsampled);
+			p_Graph.BindTexture(1, current);
+			p_Graph.DrawFullScreenTriangle();
+		});
+		upsampled = level;
+	}
+	m_LevelCount = static_cast<int>(levels.size());
+
+	// Added to the colour in the fused pass, with whatever pixel effects come after it.
+	SetTexture("bloomTexture", upsampled);
+	PixelEffect::Setup(p_Graph);
+}
+
+void BloomEffect::SetUniforms(const Shader &p_Shader) const {
+	// Every level adds its glow on the way up, so the sum is averaged over them.
+	p_Shader.SetFloat("bloomIntensity", m_Intensity / m_LevelCount);
+}
+
+const float AutoExposureEffect::s_m_MinLogLuminance = -10.0f;
+const float AutoExposureEffect::s_m_LogLuminanceRange = 16.0f;
+const float AutoExposureEffect::s_m_LowPercentile = 0.1f;
+const float AutoExposureEffect::s_m_HighPercentile = 0.9f;
+const float AutoExposureEffect::s_m_KeyValue = 0.18f;
+
+AutoExposureEffect::AutoExposureEffect() : PostEffect("Auto exposure") {
+	m_Shader = ResourceManagerInstance.GetShader("postHistogram");
+	m_Shader->Use();
+	m_Shader->SetInt("source", 0);
+	m_Shader->SetFloat("minLogLuminance", s_m_MinLogLuminance);
+	m_Shader->SetFloat("inverseLogLuminanceRange", 1.0f / s_m_LogLuminanceRange);
+
+	for (Histogram &histogram : m_Histograms) {
+		glGenBuffers(1, &histogram.m_Buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, histogram.m_Buffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, s_m_BinCount * sizeof(unsigned int), nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+AutoExposureEffect::~AutoExposureEffect() {
+	for (Histogram &histogram : m_Histograms) {
+		if (histogram.m_Fence != nullptr)
+			glDeleteSync(histogram.m_Fence);
+		glDeleteBuffers(1, &histogram.m_Buffer);
+	}
+}
+
+void AutoExposureEffect::Update(float p_DeltaTime) {
+	ReadBackHistograms();
+
+	// Adapted in log space, so brightening and darkening by the same factor take the same time.
+	float adaptation = 1.0f - std::exp(-p_DeltaTime * m_AdaptationSpeed);
+	float logExposure = std::log2(m_Exposure);
+	logExposure += (std::log2(m_TargetExposure) - logExposure) * adaptation;
+	m_Exposure = std::exp2(logExposure);
+}
+
+void AutoExposureEffect::ReadBackHistograms() {
+	// The fences are signalled in the order the histograms were filled, the oldest being the one filled next.
+	for (int i = 0; i < s_m_RingSize; i++) {
+		Histogram &histogram = m_Histograms[(m_NextHistogram + i) % s_m_RingSize];
+		if (histogram.m_Fence == nullptr)
+			continue;
+
+		GLenum result = glClientWaitSync(histogram.m_Fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+			break;
+		glDeleteSync(histogram.m_Fence);
+		histogram.m_Fence = nullptr;
+		if (result == GL_WAIT_FAILED) {
+			std::cout << "ERROR::AUTO_EXPOSURE:: Waiting for a histogram's fence failed." << std::endl;
+			continue;
+		}
+
+		unsigned int bins[s_m_BinCount];
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, histogram.m_Buffer);
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(bins), bins);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		float total = 0.0f;
+		for (unsigned int count : bins)
+			total += count;
+		if (total == 0.0f)
+			continue;
+
+		// The mean log luminance of the pixels between the percentiles, counting only the part of each bin inside them.
+		float low = total * s_m_LowPercentile;
+		float high = total * s_m_HighPercentile;
+		float accumulated = 0.0f;
+		float logLuminanceSum = 0.0f;
+		float weightSum = 0.0f;
+		for (int bin = 0; bin < s_m_BinCount; bin++) {
+			float start = accumulated;
+			accumulated += bins[bin];
+			float weight = std::min(accumulated, high) - std::max(start, low);
+			if (weight <= 0.0f)
+				continue;
+
+			// The black bin counts as the darkest the range covers.
+			float position = bin == 0 ? 0.0f : (bin - 0.5f) / (s_m_BinCount - 2);
+			logLuminanceSum += (s_m_MinLogLuminance + position * s_m_LogLuminanceRange) * weight;
+			weightSum += weight;
+		}
+		if (weightSum > 0.0f) {
+			float averageLuminance = std::exp2(logLuminanceSum / weightSum);
+			m_TargetExposure = std::min(m_MaxExposure, std::max(m_MinExposure, s_m_KeyValue / averageLuminance));
+		}
+	}
+}
+
+void AutoExposureEffect::Setup(PostProcessGraph &p_Graph) {
+	// Only reads the colour, and is never culled, as what it writes is read back rather than sampled.
+	PostResource input = p_Graph.GetColour();
+	p_Graph.AddPass("Luminance histogram", { input }, { }, [this, input](PostProcessGraph &p_Graph) {
+		Histogram &histogram = m_Histograms[m_NextHistogram];
+		if (histogram.m_Fence != nullptr) {
+			// The GPU is a whole ring behind, so this frame isn't measured rather than waiting.
+			m_SkippedFrameCount++;
+			return;
+		}
+
+		// Sampled at half size, each sample the bilinear average of four pixels, as the average luminance hardly changes.
+		glm::ivec2 size = glm::max(p_Graph.GetSize(input) / 2, glm::ivec2(1));
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, histogram.m_Buffer);
+		glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(ShaderStorageBinding::LUMINANCE_HISTOGRAM), histogram.m_Buffer);
+		m_Shader->Use();
+		glUniform2i(glGetUniformLocation(m_Shader->GetID(), "size"), size.x, size.y);
+		p_Graph.BindTexture(0, input);
+		glDispatchCompute((size.x + s_m_GroupSize - 1) / s_m_GroupSize, (size.y + s_m_GroupSize - 1) / s_m_GroupSize, 1);
+		// The counts are read back through the buffer, once the fence says they're written.
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		histogram.m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_NextHistogram = (m_NextHistogram + 1) % s_m_RingSize;
+	}, true);
+}
+
+ColourGradingEffect::ColourGradingEffect() : PixelEffect("Colour grading", "include/pixelEffects/colourGrading.glsl", "ColourGrading") {
+}
+
+void ColourGradingEffect::SetUniforms(const Shader &p_Shader) const {
+	p_Shader.SetFloat("gradingContrast", m_Contrast);
+	p_Shader.SetFloat("gradingSaturation", m_Saturation);
+	p_Shader.SetVec3("gradingColourFilter", m_ColourFilter);
+}
+
+VignetteEffect::VignetteEffect() : PixelEffect("Vignette", "include/pixelEffects/vignette.glsl", "Vignette") {
+}
+
+void VignetteEffect::SetUniforms(const Shader &p_Shader) const {
+	p_Shader.SetFloat("vignetteStrength", m_Strength);
+	p_Shader.SetFloat("vignetteRadius", m_Radius);
+}
+
+EdgeKernelEffect::EdgeKernelEffect() : PostEffect("Edge kernel") {
+	m_Shader = ResourceManagerInstance.GetShader("postEdgeKernel");
+	m_Shader->Use();
+	m_Shader->SetInt("scene", 0);
+	SetKernelOffsets(*m_Shader);
+
+	int edgeKernel[9] = {
+		-1, -1, -1,
+		-1,  8, -1,
+		-1, -1, -1
+	};
+	glUniform1iv(glGetUniformLocation(m_Shader->GetID(), "edgeKernel"), 9, edgeKernel);
+}
+
+void EdgeKernelEffect::Setup(PostProcessGraph &p_Graph) {
+	PostResource input = p_Graph.GetColour();
+	PostTargetDescription description;
+	description.m_Format = p_Graph.GetFormat(input);
+	PostResource output = p_Graph.CreateTarget("Edges", description);
+	p_Graph.AddPass(GetName(), { input }, { output }, [this, input, output](PostProcessGraph &p_Graph) {
+		p_Graph.BindTarget(output);
+		m_Shader->Use();
+		p_Graph.BindTexture(0, input);
+		p_Graph.DrawFullScreenTriangle();
+	});
+	p_Graph.SetColour(output);
+}
+
+FXAAEffect::FXAAEffect() : PostEffect("FXAA") {
+	m_Shader = ResourceManagerInstance.GetShader("postFXAA");
+	m_Shader->Use();
+	m_Shader->SetInt("scene", 0);
+}
+
+void FXAAEffect::Setup(PostProcessGraph &p_Graph) {
+	PostResource input = p_Graph.GetColour();
+	PostTargetDescription description;
+	description.m_Format = p_Graph.GetFormat(input);
+	PostResource output = p_Graph.CreateTarget("FXAA", description);
+	p_Graph.AddPass(GetName(), { input }, { output }, [this, input, output](PostProcessGraph &p_Graph) {
+		p_Graph.BindTarget(output);
+		m_Shader->Use();
+		p_Graph.BindTexture(0, input);
+		p_Graph.DrawFullScreenTriangle();
+	});
+	p_Graph.SetColour(output);
+}
+
+const float SMAAEffect::s_m_SmoothMaxDistance = 32.0f;
+
+// The area under the line from start to end, over the pixel from x to x + 1, split into the part below the edge and the part above.
+static glm::vec2 AreaUnderLine(const glm::vec2 &p_Start, const glm::vec2 &p_End, float p_X) {
+	float x1 = p_X;
+	float x2 = p_X + 1.0f;
+	bool isInside = (x1 >= p_Start.x && x1 < p_End.x) || (x2 > p_Start.x && x2 <= p_End.x);
+	if (!isInside)
+		return glm::vec2(0.0f);
+
+	glm::vec2 delta = p_End - p_Start;
+	float y1 = p_Start.y + delta.y * (x1 - p_Start.x) / delta.x;
+	float y2 = p_Start.y + delta.y * (x2 - p_Start.x) / delta.x;
+
+	// A trapezoid, when the line stays on one side of the edge across the pixel.
+	if (std::signbit(y1) == std::signbit(y2) || std::abs(y1) < 1e-4f || std::abs(y2) < 1e-4f) {
+		float area = (y1 + y2) / 2.0f;
+		return area < 0.0f ? glm::vec2(-area, 0.0f) : glm::vec2(0.0f, area);
+	}
+
+	// Otherwise two triangles, either side of where the line crosses the edge.
+	float crossing = -p_Start.y * delta.x / delta.y + p_Start.x;
+	float areas[2] = { y1 * (crossing - x1) / 2.0f, y2 * (x2 - crossing) / 2.0f };
+	glm::vec2 result(0.0f);
+	for (float area : areas)
+		result[area < 0.0f ? 0 : 1] += std::abs(area);
+	return result;
+}
+
+// Rounds the corners of short U shapes, which would otherwise be cut into a triangle.
+static glm::vec2 SmoothArea(float p_Distance, const glm::vec2 &p_Area1, const glm::vec2 &p_Area2, float p_SmoothMaxDistance) {
+	glm::vec2 smoothed1 = glm::sqrt(p_Area1 * 2.0f) * 0.5f;
+	glm::vec2 smoothed2 = glm::sqrt(p_Area2 * 2.0f) * 0.5f;
+	float blend = std::min(1.0f, p_Distance / p_SmoothMaxDistance);
+	return glm::mix(smoothed1, p_Area1, blend) + glm::mix(smoothed2, p_Area2, blend);
+}
+
+std::vector<unsigned char> SMAAEffect::GenerateAreaTexture() {
+	// The tile each of the 16 patterns of crossing edges goes in. A crossing edge is 1 above the line, 3 below it, and 4 through it.
+	static const int s_PatternTiles[16][2] = {
+		{ 0, 0 }, { 3, 0 }, { 0, 3 }, { 3, 3 }, { 1, 0 }, { 4, 0 }, { 1, 3 }, { 4, 3 },
+		{ 0, 1 }, { 3, 1 }, { 0, 4 }, { 3, 4 }, { 1, 1 }, { 4, 1 }, { 1, 4 }, { 4, 4 }
+	};
+	// The line's ends are half a pixel either side of the edge, where it meets a crossing edge.
+	const float above = 0.5f;
+	const float below = -0.5f;
+
+	int size = s_m_AreaTileSize * s_m_AreaTileCount;
+	std::vector<unsigned char> texels(size * size * 2, 0);
+	for (int pattern = 0; pattern < 16; pattern++) {
+		for (int y = 0; y < s_m_AreaTileSize; y++) {
+			for (int x = 0; x < s_m_AreaTileSize; x++) {
+				// Indexed by the square roots of the distances, for more detail on short lines.
+				float left = static_cast<float>(x * x);
+				float right = static_cast<float>(y * y);
+				float length = left + right + 1.0f;
+				glm::vec2 middle(length / 2.0f, 0.0f);
+
+				glm::vec2 area(0.0f);
+				switch (pattern) {
+				case 1:	// Crossed below on the left.
+					if (left <= right)
+						area = AreaUnderLine(glm::vec2(0.0f, below), middle, left);
+					break;
+				case 2:	// Crossed below on the right.
+					if (left >= right)
+						area = AreaUnderLine(middle, glm::vec2(length, below), left);
+					break;
+				case 3:	// Crossed below at both ends, a U.
+					area = SmoothArea(length, AreaUnderLine(glm::vec2(0.0f, below), middle, left), AreaUnderLine(middle, glm::vec2(length, below), left), s_m_SmoothMaxDistance);
+					break;
+				case 4:	// Crossed above on the left.
+					if (left <= right)
+						area = AreaUnderLine(glm::vec2(0.0f, above), middle, left);
+					break;
+				case 6:	// Above on the left, below on the right, a step, whether or not either end is also crossed through.
+				case 7:
+				case 14:
+					area = AreaUnderLine(glm::vec2(0.0f, above), glm::vec2(length, below), left);
+					break;
+				case 8:	// Crossed above on the right.
+					if (left >= right)
+						area = AreaUnderLine(middle, glm::vec2(length, above), left);
+					break;
+				case 9:	// Below on the left, above on the right, the other step.
+				case 11:
+				case 13:
+					area = AreaUnderLine(glm::vec2(0.0f, below), glm::vec2(length, above), left);
+					break;
+				case 12:	// Crossed above at both ends, an upside down U.
+					area = SmoothArea(length, AreaUnderLine(glm::vec2(0.0f, above), middle, left), AreaUnderLine(middle, glm::vec2(length, above), left), s_m_SmoothMaxDistance);
+					break;
+				default:	// No crossing edges, or crossed through, which could be either way.
+					break;
+				}
+
+				int texelX = s_PatternTiles[pattern][0] * s_m_AreaTileSize + x;
+				int texelY = s_PatternTiles[pattern][1] * s_m_AreaTileSize + y;
+				unsigned char *texel = &texels[(texelY * size + texelX) * 2];
+				texel[0] = static_cast<unsigned char>(std::min(1.0f, area.x) * 255.0f + 0.5f);
+				texel[1] = static_cast<unsigned char>(std::min(1.0f, area.y) * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	return texels;
+}
+
+// The value a bilinear fetch gives for four binary edges, a quarter of the way from the second pixel to the first, and an eighth of the way to the row before.
+static float BilinearEdges(int p_Edges) {
+	auto edge = [p_Edges](int p_Index) {
+		return static_cast<float>((p_Edges >> p_Index) & 1);
+	};
+	float before = edge(0) * 0.25f + edge(1) * 0.75f;
+	float current = edge(2) * 0.25f + edge(3) * 0.75f;
+	return before * 0.125f + current * 0.875f;
+}
+
+std::vector<unsigned char> SMAAEffect::GenerateSearchTexture() {
+	// Bit 3 is the nearer pixel on the line's row, bit 2 the further one, bits 1 and 0 the same pixels on the row before.
+	auto isSet = [](int p_Edges, int p_Index) {
+		return ((p_Edges >> p_Index) & 1) != 0;
+	};
+
+	int width = s_m_SearchHalfWidth * 2;
+	std::vector<unsigned char> texels(width * s_m_SearchHeight, 0);
+	for (int crossing = 0; crossing < 16; crossing++) {
+		for (int line = 0; line < 16; line++) {
+			// Searching left, the nearer pixel is still on the line even with a crossing edge, which ends the line there.
+			int left = 0;
+			if (isSet(line, 3))
+				left++;
+			if (left == 1 && isSet(line, 2) && !isSet(crossing, 1) && !isSet(crossing, 3))
+				left++;
+
+			// Searching right, a crossing edge ends the line before the pixel it's on.
+			int right = 0;
+			if (isSet(line, 3) && !isSet(crossing, 1) && !isSet(crossing, 3))
+				right++;
+			if (right == 1 && isSet(line, 2) && !isSet(crossing, 0) && !isSet(crossing, 2))
+				right++;
+
+			int x = static_cast<int>(std::round(BilinearEdges(crossing) * 32.0f));
+			int y = static_cast<int>(std::round(BilinearEdges(line) * 32.0f));
+			texels[y * width + x] = static_cast<unsigned char>(left * 127);
+			texels[y * width + x + s_m_SearchHalfWidth] = static_cast<unsigned char>(right * 127);
+		}
+	}
+
+	return texels;
+}
+
+SMAAEffect::SMAAEffect() : PostEffect("SMAA") {
+	m_EdgesShader = ResourceManagerInstance.GetShader("postSMAAEdges");
+	m_EdgesShader->Use();
+	m_EdgesShader->SetInt("scene", 0);
+	m_WeightsShader = ResourceManagerInstance.GetShader("postSMAAWeights");
+	m_WeightsShader->Use();
+	m_WeightsShader->SetInt("edgesTexture", 0);
+	m_WeightsShader->SetInt("areaTexture", 1);
+	m_WeightsShader->SetInt("searchTexture", 2);
+	m_BlendingShader = ResourceManagerInstance.GetShader("postSMAABlending");
+	m_BlendingShader->Use();
+	m_BlendingShader->SetInt("scene", 0);
+	m_BlendingShader->SetInt("weightsTexture", 1);
+
+	// Filtered, as the lookups interpolate between the distances.
+	int areaSize = s_m_AreaTileSize * s_m_AreaTileCount;
+	std::vector<unsigned char> areaTexels = GenerateAreaTexture();
+	glGenTextures(1, &m_AreaTexture);
+	glBindTexture(GL_TEXTURE_2D, m_AreaTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, areaSize, areaSize, 0, GL_RG, GL_UNSIGNED_BYTE, areaTexels.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	std::vector<unsigned char> searchTexels = GenerateSearchTexture();
+	glGenTextures(1, &m_SearchTexture);
+	glBindTexture(GL_TEXTURE_2D, m_SearchTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, s_m_SearchHalfWidth * 2, s_m_SearchHeight, 0, GL_RED, GL_UNSIGNED_BYTE, searchTexels.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+SMAAEffect::~SMAAEffect() {
+	glDeleteTextures(1, &m_AreaTexture);
+	glDeleteTextures(1, &m_SearchTexture);
+}
+
+void SMAAEffect::Setup(PostProcessGraph &p_Graph) {
+	PostResource input = p_Graph.GetColour();
+	PostTargetDescription edgesDescription;
+	edgesDescription.m_Format = GL_RG8;
+	PostResource edges = p_Graph.CreateTarget("SMAA edges", edgesDescription);
+	PostResource weights = p_Graph.CreateTarget("SMAA weights", PostTargetDescription());
+	PostTargetDescription outputDescription;
+	outputDescription.m_Format = p_Graph.GetFormat(input);
+	PostResource output = p_Graph.CreateTarget("SMAA", outputDescription);
+
+	// Every pass works on the pixels of the targets it draws into, whatever size the colour coming in is.
+	auto setMetrics = [](const Shader &p_Shader, const glm::ivec2 &p_Size) {
+		glUniform4f(glGetUniformLocation(p_Shader.GetID(), "smaaMetrics"), 1.0f / p_Size.x, 1.0f / p_Size.y, static_cast<float>(p_Size.x), static_cast<float>(p_Size.y));
+	};
+	p_Graph.AddPass("SMAA edges", { input }, { edges }, [this, input, edges, setMetrics](PostProcessGraph &p_Graph) {
+		p_Graph.BindTarget(edges);
+		m_EdgesShader->Use();
+		setMetrics(*m_EdgesShader, p_Graph.GetSize(edges));
+		p_Graph.BindTexture(0, input);
+		p_Graph.DrawFullScreenTriangle();
+	});
+	p_Graph.AddPass("SMAA weights", { edges }, { weights }, [this, edges, weights, setMetrics](PostProcessGraph &p_Graph) {
+		p_Graph.BindTarget(weights);
+		m_WeightsShader->Use();
+		setMetrics(*m_WeightsShader, p_Graph.GetSize(weights));
+		p_Graph.BindTexture(0, edges);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, m_AreaTexture);
+		glActiveTexture(GL_TEXTURE2);
+		glBindTexture(GL_TEXTURE_2D, m_SearchTexture);
+		p_Graph.DrawFullScreenTriangle();
+	});
+	p_Graph.AddPass("SMAA blending", { input, weights }, { output }, [this, input, weights, output, setMetrics](PostProcessGraph &p_Graph) {
+		p_Graph.BindTarget(output);
+		m_BlendingShader->Use();
+		setMetrics(*m_BlendingShader, p_Graph.GetSize(output));
+		p_Graph.BindTexture(0, input);
+		p_Graph.BindTexture(1, weights);
+		p_Graph.DrawFullScreenTriangle();
+	});
+	p_Graph.SetColour(output);
+}
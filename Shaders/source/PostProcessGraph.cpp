@@ -0,0 +1,270 @@
+#include "PostProcessGraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "GPUProfiler.h"
+#include "PostEffectFuser.h"
+#include "PostEffects.h"
+#include "ResourceManager.h"
+#include "Shader.h"
+
+PostProcessGraph::PostProcessGraph(RenderTargetPool &p_Pool, PostEffectFuser &p_Fuser) : m_Pool(p_Pool), m_Fuser(p_Fuser) {
+	glGenVertexArrays(1, &m_EmptyVertexArrayObject);
+
+	m_UpscaleShader = ResourceManagerInstance.GetShader("postUpscale");
+	m_UpscaleShader->Use();
+	m_UpscaleShader->SetInt("scene", 0);
+}
+
+PostProcessGraph::~PostProcessGraph() {
+	glDeleteVertexArrays(1, &m_EmptyVertexArrayObject);
+}
+
+void PostProcessGraph::Reset(int p_Width, int p_Height, const RenderTarget &p_SceneColour, unsigned int p_OutputFrameBufferObject, int p_OutputWidth, int p_OutputHeight) {
+	m_Width = p_Width;
+	m_Height = p_Height;
+	m_Resources.clear();
+	m_Passes.clear();
+
+	m_OutputTarget.m_FrameBufferObject = p_OutputFrameBufferObject;
+	m_OutputTarget.m_Width = p_OutputWidth;
+	m_OutputTarget.m_Height = p_OutputHeight;
+
+	Resource sceneColour;
+	sceneColour.m_Name = "Scene colour";
+	sceneColour.m_Description.m_Format = p_SceneColour.m_Format;
+	sceneColour.m_Width = p_SceneColour.m_Width;
+	sceneColour.m_Height = p_SceneColour.m_Height;
+	sceneColour.m_Target = &p_SceneColour;
+	sceneColour.m_IsImported = true;
+	m_Resources.push_back(sceneColour);
+	m_Colour = 0;
+}
+
+PostResource PostProcessGraph::CreateTarget(const std::string &p_Name, const PostTargetDescription &p_Description) {
+	Resource resource;
+	resource.m_Name = p_Name;
+	resource.m_Description = p_Description;
+	resource.m_Width = std::max(1, static_cast<int>(m_Width * p_Description.m_Scale + 0.5f));
+	resource.m_Height = std::max(1, static_cast<int>(m_Height * p_Description.m_Scale + 0.5f));
+	m_Resources.push_back(resource);
+
+	return static_cast<PostResource>(m_Resources.size() - 1);
+}
+
+void PostProcessGraph::AddPass(const std::string &p_Name, const std::vector<PostResource> &p_Reads, const std::vector<PostResource> &p_Writes, PassFunction p_Function, bool p_HasSideEffects) {
+	Pass pass;
+	pass.m_Name = p_Name;
+	pass.m_Reads = p_Reads;
+	pass.m_Writes = p_Writes;
+	pass.m_Function = p_Function;
+	pass.m_HasSideEffects = p_HasSideEffects;
+	m_Passes.push_back(pass);
+}
+
+void PostProcessGraph::AddPixelEffect(const PixelEffect &p_Effect) {
+	// Nothing can sample the colour between two pixel effects, so the second can run in the first's pass.
+	if (!m_Passes.empty()) {
+		Pass &lastPass = m_Passes.back();
+		if (!lastPass.m_PixelEffects.empty() && lastPass.m_Writes.size() == 1 && lastPass.m_Writes[0] == m_Colour) {
+			lastPass.m_PixelEffects.push_back(&p_Effect);
+			lastPass.m_Name += " + " + p_Effect.GetName();
+			for (const PixelEffectTexture &texture : p_Effect.GetTextures())
+				lastPass.m_Reads.push_back(texture.m_Resource);
+			if (p_Effect.MapsToDisplay())
+				m_Resources[m_Colour].m_Description.m_Format = GL_RGBA8;
+			return;
+		}
+	}
+
+	PostResource input = m_Colour;
+	PostTargetDescription description;
+	description.m_Format = p_Effect.MapsToDisplay() ? GL_RGBA8 : GetFormat(input);
+	PostResource output = CreateTarget(p_Effect.GetName(), description);
+	std::vector<PostResource> reads = { input };
+	for (const PixelEffectTexture &texture : p_Effect.GetTextures())
+		reads.push_back(texture.m_Resource);
+	unsigned int passIndex = static_cast<unsigned int>(m_Passes.size());
+	AddPass(p_Effect.GetName(), reads, { output }, [passIndex, input, output](PostProcessGraph &p_Graph) {
+		p_Graph.DrawPixelEffects(passIndex, input, output);
+	});
+	m_Passes.back().m_PixelEffects.push_back(&p_Effect);
+	SetColour(output);
+}
+
+void PostProcessGraph::DrawPixelEffects(unsigned int p_PassIndex, PostResource p_Input, PostResource p_Output) const {
+	const std::vector<const PixelEffect*> &effects = m_Passes[p_PassIndex].m_PixelEffects;
+	std::shared_ptr<Shader> program = m_Fuser.GetProgram(effects);
+	if (!program) {
+		// The fuser has already reported it, so the chain is skipped rather than leaving the target undrawn.
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Resources[p_Input].m_Target->m_FrameBufferObject);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_Resources[p_Output].m_Target->m_FrameBufferObject);
+		glBlitFramebuffer(0, 0, m_Resources[p_Input].m_Width, m_Resources[p_Input].m_Height, 0, 0, m_Resources[p_Output].m_Width, m_Resources[p_Output].m_Height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		return;
+	}
+
+	BindTarget(p_Output);
+	program->Use();
+	BindTexture(0, p_Input);
+	// The effects' own textures take the units after the colour, in the chain's order.
+	unsigned int unit = 1;
+	for (const PixelEffect *effect : effects) {
+		effect->SetUniforms(*program);
+		for (const PixelEffectTexture &texture : effect->GetTextures()) {
+			program->SetInt(texture.m_Uniform, unit);
+			BindTexture(unit++, texture.m_Resource);
+		}
+	}
+	DrawFullScreenTriangle();
+}
+
+void PostProcessGraph::Cull() {
+	// The passes were added in the order they run, so walking back from the final colour finds every pass it depends on.
+	for (Resource &resource : m_Resources) {
+		resource.m_IsNeeded = false;
+		resource.m_IsOutput = false;
+		resource.m_LastUse = s_m_NoPass;
+	}
+	m_Resources[m_Colour].m_IsNeeded = true;
+
+	m_CulledPassCount = 0;
+	for (size_t i = m_Passes.size(); i-- > 0;) {
+		Pass &pass = m_Passes[i];
+		pass.m_IsCulled = !pass.m_HasSideEffects && std::none_of(pass.m_Writes.begin(), pass.m_Writes.end(), [this](PostResource p_Resource) {
+			return m_Resources[p_Resource].m_IsNeeded;
+		});
+		if (pass.m_IsCulled) {
+			m_CulledPassCount++;
+			continue;
+		}
+
+		for (PostResource resource : pass.m_Reads)
+			m_Resources[resource].m_IsNeeded = true;
+		for (PostResource resource : pass.m_Writes) {
+			if (m_Resources[resource].m_IsImported)
+				std::cout << "ERROR::POST_PROCESS_GRAPH:: Pass " << pass.m_Name << " writes the imported texture " << m_Resources[resource].m_Name << std::endl;
+		}
+	}
+
+	// Released after the last pass that touches them, so the pool can hand them to the passes after.
+	for (unsigned int i = 0; i < m_Passes.size(); i++) {
+		if (m_Passes[i].m_IsCulled)
+			continue;
+		for (PostResource resource : m_Passes[i].m_Reads)
+			m_Resources[resource].m_LastUse = i;
+		for (PostResource resource : m_Passes[i].m_Writes)
+			m_Resources[resource].m_LastUse = i;
+	}
+
+	// When nothing samples the final colour, and it's the output's size, the pass writing it can draw straight into the output.
+	// An image can't be, as the output has no texture to bind.
+	Resource &finalColour = m_Resources[m_Colour];
+	bool isRead = std::any_of(m_Passes.begin(), m_Passes.end(), [this](const Pass &p_Pass) {
+		return !p_Pass.m_IsCulled && std::find(p_Pass.m_Reads.begin(), p_Pass.m_Reads.end(), m_Colour) != p_Pass.m_Reads.end();
+	});
+	finalColour.m_IsOutput = !finalColour.m_IsImported && !finalColour.m_Description.m_IsImage && !isRead && finalColour.m_Width == m_OutputTarget.m_Width && finalColour.m_Height == m_OutputTarget.m_Height;
+}
+
+void PostProcessGraph::Execute(GPUProfiler *p_Profiler) {
+	Cull();
+
+	// Every pass overwrites its whole target.
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+	for (unsigned int i = 0; i < m_Passes.size(); i++) {
+		Pass &pass = m_Passes[i];
+		if (pass.m_IsCulled)
+			continue;
+
+		for (PostResource resource : pass.m_Writes) {
+			Resource &written = m_Resources[resource];
+			if (written.m_IsOutput)
+				written.m_Target = &m_OutputTarget;
+			else if (!written.m_IsImported && !written.m_Target)
+				written.m_Target = m_Pool.Acquire(written.m_Width, written.m_Height, written.m_Description.m_Format);
+		}
+
+		if (p_Profiler)
+			p_Profiler->BeginPass(pass.m_Name.c_str());
+		pass.m_Function(*this);
+		if (p_Profiler)
+			p_Profiler->EndPass();
+
+		for (PostResource resource : pass.m_Reads) {
+			Resource &read = m_Resources[resource];
+			if (read.m_LastUse == i && !read.m_IsImported && !read.m_IsOutput && resource != m_Colour) {
+				m_Pool.Release(read.m_Target);
+				read.m_Target = nullptr;
+			}
+		}
+		for (PostResource resource : pass.m_Writes) {
+			Resource &written = m_Resources[resource];
+			if (written.m_LastUse == i && !written.m_IsImported && !written.m_IsOutput && resource != m_Colour) {
+				m_Pool.Release(written.m_Target);
+				written.m_Target = nullptr;
+			}
+		}
+	}
+
+	Present(p_Profiler);
+
+	glBindVertexArray(0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_OutputTarget.m_FrameBufferObject);
+	glViewport(0, 0, m_OutputTarget.m_Width, m_OutputTarget.m_Height);
+	glEnable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+}
+
+void PostProcessGraph::Present(GPUProfiler *p_Profiler) {
+	// Already drawn into the output by the last pass.
+	Resource &finalColour = m_Resources[m_Colour];
+	if (finalColour.m_IsOutput)
+		return;
+
+	if (finalColour.m_Width == m_OutputTarget.m_Width && finalColour.m_Height == m_OutputTarget.m_Height) {
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, finalColour.m_Target->m_FrameBufferObject);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_OutputTarget.m_FrameBufferObject);
+		glBlitFramebuffer(0, 0, finalColour.m_Width, finalColour.m_Height, 0, 0, m_OutputTarget.m_Width, m_OutputTarget.m_Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+	else {
+		// Drawn rather than blitted, so the detail the smaller image lost can be sharpened back.
+		if (p_Profiler)
+			p_Profiler->BeginPass("Upscale");
+		glBindFramebuffer(GL_FRAMEBUFFER, m_OutputTarget.m_FrameBufferObject);
+		glViewport(0, 0, m_OutputTarget.m_Width, m_OutputTarget.m_Height);
+		m_UpscaleShader->Use();
+		m_UpscaleShader->SetFloat("sharpness", m_UpscaleSharpness);
+		BindTexture(0, m_Colour);
+		DrawFullScreenTriangle();
+		if (p_Profiler)
+			p_Profiler->EndPass();
+	}
+	if (!finalColour.m_IsImported) {
+		m_Pool.Release(finalColour.m_Target);
+		finalColour.m_Target = nullptr;
+	}
+}
+
+void PostProcessGraph::BindTarget(PostResource p_Resource) const {
+	const Resource &resource = m_Resources[p_Resource];
+	glBindFramebuffer(GL_FRAMEBUFFER, resource.m_Target->m_FrameBufferObject);
+	glViewport(0, 0, resource.m_Width, resource.m_Height);
+}
+
+void PostProcessGraph::BindTexture(unsigned int p_Unit, PostResource p_Resource) const {
+	glActiveTexture(GL_TEXTURE0 + p_Unit);
+	glBindTexture(GL_TEXTURE_2D, m_Resources[p_Resource].m_Target->m_TextureID);
+}
+
+void PostProcessGraph::BindImage(unsigned int p_Unit, PostResource p_Resource) const {
+	const Resource &resource = m_Resources[p_Resource];
+	glBindImageTexture(p_Unit, resource.m_Target->m_TextureID, 0, GL_FALSE, 0, GL_WRITE_ONLY, resource.m_Description.m_Format);
+}
+
+void PostProcessGraph::DrawFullScreenTriangle() const {
+	glBindVertexArray(m_EmptyVertexArrayObject);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+}
@@ -1,147 +1,112 @@
 #include "PostProcessor.h"
 
-#define _USE_MATH_DEFINES
-#include <math.h>
+#include <algorithm>
 #include <iostream>
 
 #include <glad/glad.h>
 
-#include "ResourceManager.h"
-#include "shader.h"
-
-PostProcessor::PostProcessor(float p_QuadWidth, float p_QuadHeight) 
-	: m_QuadWidth(p_QuadWidth), m_QuadHeight(p_QuadHeight) {
-	m_Shader = ResourceManagerInstance.GetShader("postProcessingEffects");
-
-	std::cout << "Texture width: " << p_QuadWidth << "\t" << "Texture height: " << p_QuadHeight;
-
-	glGenFramebuffers(1, &m_FrameBufferObject);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
-
-	// Create a colour attachment texture.
-	glGenTextures(1, &m_TextureID);
-	glBindTexture(GL_TEXTURE_2D, m_TextureID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, (GLsizei)p_QuadWidth, (GLsizei)p_QuadHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_TextureID, 0);
-
-	// Create a renderbuffer object for the depth and stencil attachment, as we won't be sampling these.
-	glGenRenderbuffers(1, &m_RenderBufferObject);
-	glBindRenderbuffer(GL_RENDERBUFFER, m_RenderBufferObject);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, (GLsizei)p_QuadWidth, (GLsizei)p_QuadHeight);
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_RenderBufferObject);
-	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-		std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+#include "PostEffectFuser.h"
+#include "GPUProfiler.h"
+#include "PostEffects.h"
+#include "PostProcessGraph.h"
+
+const float PostProcessor::s_m_MinRenderScale = 0.5f;
+const float PostProcessor::s_m_DefaultSharpness = 0.5f;
+
+PostProcessor::PostProcessor(int p_OutputWidth, int p_OutputHeight)
+	: m_OutputWidth(p_OutputWidth), m_OutputHeight(p_OutputHeight) {
+	std::cout << "Texture width: " << p_OutputWidth << "\t" << "Texture height: " << p_OutputHeight;
+	UpdateRenderSize();
+	glGetIntegerv(GL_MAX_SAMPLES, &m_MaxSampleCount);
 
-	InitializeRenderData();
-
-	// Set uniforms.
-	m_Shader->Use();
-	m_Shader->SetInt("scene", 0);
-	float offset = 1.0f / 300.0f;
-	float offsets[9][2] = {
-		{ -offset,  offset  },  // Top-left.
-		{  0.0f,    offset  },  // Top-center.
-		{  offset,  offset  },  // Top-right.
-		{ -offset,  0.0f    },  // Center-left.
-		{  0.0f,    0.0f    },  // Center-center.
-		{  offset,  0.0f    },  // Center-right.
-		{ -offset, -offset  },  // Bottom-left.
-		{  0.0f,   -offset  },  // Bottom-center.
-		{  offset, -offset  }   // Bottom-right.
-	};
-	glUniform2fv(glGetUniformLocation(m_Shader->GetID(), "offsets"), 9, (GLfloat*)offsets);
-
-	int edgeKernel[9] = {
-		-1, -1, -1,
-		-1,  8, -1,
-		-1, -1, -1
-	};
-	glUniform1iv(glGetUniformLocation(m_Shader->GetID(), "edgeKernel"), 9, edgeKernel);
-
-	float blurKernel[9] = {
-		1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
-		2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
-		1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
-	};
-	glUniform1fv(glGetUniformLocation(m_Shader->GetID(), "blurKernel"), 9, &blurKernel[0]);
+	m_TargetPool = std::make_shared<RenderTargetPool>();
+	m_Fuser = std::make_shared<PostEffectFuser>();
+	m_Graph = std::make_shared<PostProcessGraph>(*m_TargetPool, *m_Fuser);
 }
 
 PostProcessor::~PostProcessor() {
 	// Set the Frame Buffer Object back to the default one.
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-	// Clean up the memory.
-	glDeleteBuffers(1, &m_VBO);
-	glDeleteVertexArrays(1, &m_VAO);
-	glDeleteRenderbuffers(1, &m_RenderBufferObject);
-	glDeleteFramebuffers(1, &m_FrameBufferObject);
+	// Clean up the memory, the graph goes before the pool and fuser it borrows from.
+	m_Graph.reset();
+	m_Fuser.reset();
+	m_TargetPool.reset();
 }
 
-void PostProcessor::InitializeRenderData() {
-	float vertices[] = {
-		// Positions  // Texture Coordinates.
-		-1.0f, -1.0f, 0.0f, 0.0f,
-		 1.0f,  1.0f, 1.0f, 1.0f,
-		-1.0f,  1.0f, 0.0f, 1.0f,
-
-		-1.0f, -1.0f, 0.0f, 0.0f,
-		 1.0f, -1.0f, 1.0f, 0.0f,
-		 1.0f,  1.0f, 1.0f, 1.0f
-	};
+void PostProcessor::UpdateRenderSize() {
+	m_RenderWidth = std::max(1, static_cast<int>(m_OutputWidth * m_RenderScale + 0.5f));
+	m_RenderHeight = std::max(1, static_cast<int>(m_OutputHeight * m_RenderScale + 0.5f));
+}
 
-	glGenBuffers(1, &m_VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices[0], GL_STATIC_DRAW);
+void PostProcessor::SetOutputSize(int p_OutputWidth, int p_OutputHeight) {
+	m_OutputWidth = p_OutputWidth;
+	m_OutputHeight = p_OutputHeight;
+	UpdateRenderSize();
+}
 
-	glGenVertexArrays(1, &m_VAO);
-	glBindVertexArray(m_VAO);
+void PostProcessor::SetRenderScale(float p_RenderScale) {
+	m_RenderScale = std::min(1.0f, std::max(s_m_MinRenderScale, p_RenderScale));
+	UpdateRenderSize();
+}
 
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GL_FLOAT), NULL);
+void PostProcessor::SetSampleCount(int p_SampleCount) {
+	m_SampleCount = p_SampleCount > 1 ? std::min(p_SampleCount, m_MaxSampleCount) : 0;
+}
 
-	// Unbind.
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+void PostProcessor::AddEffect(std::shared_ptr<PostEffect> p_Effect) {
+	m_Effects.push_back(p_Effect);
 }
 
 void PostProcessor::Update(float p_DeltaTime) {
-	m_AccumulatedTime += p_DeltaTime;
-
-	m_Shader->Use();
-	m_Shader->SetFloat("time", m_AccumulatedTime);
+	for (auto &effect : m_Effects) {
+		if (effect->IsEnabled())
+			effect->Update(p_DeltaTime);
+	}
 }
 
 void PostProcessor::BeginRender() {
-	//glBindFramebuffer(GL_FRAMEBUFFER, m_MultisampledFrameBufferObject);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	// Pooled like the effects' targets, so going back to a recent size reuses the target, and sizes that stop being used are freed.
+	// Floating point, so lighting brighter than white survives until the tonemap, at the same four bytes a pixel as RGBA8.
+	m_SceneTarget = m_TargetPool->Acquire(m_RenderWidth, m_RenderHeight, GL_R11F_G11F_B10F, true, m_SampleCount);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_SceneTarget->m_FrameBufferObject);
+	glViewport(0, 0, m_RenderWidth, m_RenderHeight);
 	glEnable(GL_DEPTH_TEST);
 	glClearColor(0.25f, 0.25f, 0.25f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void PostProcessor::Render() {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glDisable(GL_DEPTH_TEST);
-	glClearColor(0.25f, 0.25f, 0.25f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT);
-
-	m_Shader->Use();
-	// Set uniforms.
-	m_Shader->SetBool("shake", m_Shake);
-	m_Shader->SetBool("invertColours", m_InvertColours);
-	m_Shader->SetBool("chaos", m_Chaos);
-	
-	// Render the textured quad.
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_TextureID);
-
-	glBindVertexArray(m_VAO);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-
-	// Unbind the VAO.
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+void PostProcessor::Render(GPUProfiler *p_Profiler) {
+	const RenderTarget *sceneTarget = m_SceneTarget;
+	if (m_SceneTarget->m_SampleCount > 0) {
+		// The effects can only sample a single sampled texture, the depth isn't needed after the scene.
+		if (p_Profiler)
+			p_Profiler->BeginPass("MSAA resolve");
+		m_ResolveTarget = m_TargetPool->Acquire(m_RenderWidth, m_RenderHeight, GL_R11F_G11F_B10F);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_SceneTarget->m_FrameBufferObject);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ResolveTarget->m_FrameBufferObject);
+		glBlitFramebuffer(0, 0, m_RenderWidth, m_RenderHeight, 0, 0, m_RenderWidth, m_RenderHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		if (p_Profiler)
+			p_Profiler->EndPass();
+		sceneTarget = m_ResolveTarget;
+	}
+
+	// Rebuilt every frame, so toggling an effect only changes which passes are added.
+	m_Graph->Reset(m_RenderWidth, m_RenderHeight, *sceneTarget, m_OutputFrameBufferObject, m_OutputWidth, m_OutputHeight);
+	// Only sharpened when the scene was rendered smaller, an effect leaving a smaller image is upscaled as it is.
+	m_Graph->SetUpscaleSharpness(m_RenderScale < 1.0f ? m_Sharpness : 0.0f);
+	for (auto &effect : m_Effects) {
+		if (effect->IsEnabled())
+			effect->Setup(*m_Graph);
+	}
+	m_Graph->Execute(p_Profiler);
+
+	m_TargetPool->Release(m_SceneTarget);
+	m_SceneTarget = nullptr;
+	if (m_ResolveTarget) {
+		m_TargetPool->Release(m_ResolveTarget);
+		m_ResolveTarget = nullptr;
+	}
+	m_TargetPool->EndFrame();
+}
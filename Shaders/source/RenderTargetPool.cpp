@@ -0,0 +1,126 @@
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <iostream>
+
+RenderTargetPool::~RenderTargetPool() {
+	for (auto &pooledTarget : m_Targets)
+		DeleteTarget(pooledTarget->m_Target);
+}
+
+void RenderTargetPool::CreateTarget(RenderTarget &p_Target, bool p_HasDepth) {
+	glGenTextures(1, &p_Target.m_TextureID);
+	GLenum textureTarget = p_Target.m_SampleCount > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+	glBindTexture(textureTarget, p_Target.m_TextureID);
+	if (p_Target.m_SampleCount > 0) {
+		glTexStorage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, p_Target.m_SampleCount, p_Target.m_Format, p_Target.m_Width, p_Target.m_Height, GL_TRUE);
+	}
+	else {
+		glTexStorage2D(GL_TEXTURE_2D, 1, p_Target.m_Format, p_Target.m_Width, p_Target.m_Height);
+		// Filtered, so passes at a different resolution can sample it directly.
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+	glBindTexture(textureTarget, 0);
+
+	glGenFramebuffers(1, &p_Target.m_FrameBufferObject);
+	glBindFramebuffer(GL_FRAMEBUFFER, p_Target.m_FrameBufferObject);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureTarget, p_Target.m_TextureID, 0);
+	if (p_HasDepth) {
+		// A renderbuffer, as the depth and stencil are never sampled.
+		glGenRenderbuffers(1, &p_Target.m_DepthRenderBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, p_Target.m_DepthRenderBuffer);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, p_Target.m_SampleCount, GL_DEPTH24_STENCIL8, p_Target.m_Width, p_Target.m_Height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, p_Target.m_DepthRenderBuffer);
+	}
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::RENDER_TARGET_POOL:: A render target is not complete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTargetPool::DeleteTarget(RenderTarget &p_Target) {
+	glDeleteFramebuffers(1, &p_Target.m_FrameBufferObject);
+	glDeleteTextures(1, &p_Target.m_TextureID);
+	glDeleteRenderbuffers(1, &p_Target.m_DepthRenderBuffer);
+	p_Target.m_FrameBufferObject = 0;
+	p_Target.m_TextureID = 0;
+	p_Target.m_DepthRenderBuffer = 0;
+}
+
+const RenderTarget *RenderTargetPool::Acquire(int p_Width, int p_Height, GLenum p_Format, bool p_HasDepth, int p_SampleCount) {
+	for (auto &pooledTarget : m_Targets) {
+		const RenderTarget &target = pooledTarget->m_Target;
+		if (!pooledTarget->m_IsAcquired && target.m_Width == p_Width && target.m_Height == p_Height && target.m_Format == p_Format && (target.m_DepthRenderBuffer != 0) == p_HasDepth
+			&& target.m_SampleCount == p_SampleCount) {
+			pooledTarget->m_IsAcquired = true;
+			pooledTarget->m_LastUsedFrame = m_FrameIndex;
+			return &target;
+		}
+	}
+
+	std::unique_ptr<PooledTarget> pooledTarget = std::make_unique<PooledTarget>();
+	pooledTarget->m_Target.m_Width = p_Width;
+	pooledTarget->m_Target.m_Height = p_Height;
+	pooledTarget->m_Target.m_Format = p_Format;
+	pooledTarget->m_Target.m_SampleCount = p_SampleCount;
+	pooledTarget->m_IsAcquired = true;
+	pooledTarget->m_LastUsedFrame = m_FrameIndex;
+	CreateTarget(pooledTarget->m_Target, p_HasDepth);
+	m_CreatedTargetCount++;
+
+	m_Targets.push_back(std::move(pooledTarget));
+	return &m_Targets.back()->m_Target;
+}
+
+void RenderTargetPool::Release(const RenderTarget *p_Target) {
+	for (auto &pooledTarget : m_Targets) {
+		if (&pooledTarget->m_Target == p_Target) {
+			pooledTarget->m_IsAcquired = false;
+			return;
+		}
+	}
+}
+
+void RenderTargetPool::EndFrame() {
+	// The GL keeps a deleted texture alive until the frames still in flight are done with it.
+	auto isIdle = [this](const std::unique_ptr<PooledTarget> &p_PooledTarget) {
+		return !p_PooledTarget->m_IsAcquired && m_FrameIndex - p_PooledTarget->m_LastUsedFrame >= s_m_MaxIdleFrames;
+	};
+	for (auto &pooledTarget : m_Targets) {
+		if (isIdle(pooledTarget))
+			DeleteTarget(pooledTarget->m_Target);
+	}
+	m_Targets.erase(std::remove_if(m_Targets.begin(), m_Targets.end(), isIdle), m_Targets.end());
+	m_FrameIndex++;
+}
+
+unsigned int RenderTargetPool::GetBytesPerTexel(GLenum p_Format) {
+	switch (p_Format) {
+	case GL_R8:
+		return 1;
+	case GL_RG8:
+	case GL_R16F:
+		return 2;
+	case GL_RGBA16F:
+		return 8;
+	case GL_RGBA32F:
+		return 16;
+	default:
+		// GL_RGBA8, GL_R11F_G11F_B10F, GL_R32F and the like, and what drivers pad three channel formats out to.
+		return 4;
+	}
+}
+
+size_t RenderTargetPool::GetAllocatedBytes() const {
+	size_t bytes = 0;
+	for (const auto &pooledTarget : m_Targets) {
+		const RenderTarget &target = pooledTarget->m_Target;
+		// GL_DEPTH24_STENCIL8 packs into four bytes.
+		unsigned int bytesPerTexel = GetBytesPerTexel(target.m_Format) + (target.m_DepthRenderBuffer != 0 ? 4 : 0);
+		bytes += static_cast<size_t>(target.m_Width) * target.m_Height * bytesPerTexel * std::max(1, target.m_SampleCount);
+	}
+
+	return bytes;
+}
@@ -0,0 +1,128 @@
+#include "RenderThread.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+#include <glad/glad.h>
+
+#include "Window.h"
+#include "Scene.h"
+#include "JobSystem.h"
+#include "CPUProfiler.h"
+
+const float RenderThread::s_m_ReportInterval = 2.0f;
+
+RenderThread::RenderThread(std::shared_ptr<Window> p_Window, std::shared_ptr<Scene> p_Scene, bool p_IsThreaded)
+	: m_Window(p_Window), m_Scene(p_Scene), m_IsThreaded(p_IsThreaded) {
+	m_ReportStart = std::chrono::steady_clock::now();
+
+	if (m_IsThreaded) {
+		// A context can only be current on one thread at a time.
+		m_Window->ReleaseContext();
+		m_Thread = std::thread(&RenderThread::ThreadLoop, this);
+	}
+}
+
+RenderThread::~RenderThread() {
+	Stop();
+}
+
+void RenderThread::ThreadLoop() {
+	CPU_PROFILE_THREAD_NAME("Render thread");
+	m_Window->MakeContextCurrent();
+	// The render thread records its command buffers on its own workers, the simulation's are busy with the next frame.
+	JobSystem jobSystem(std::max(1u, std::thread::hardware_concurrency() / 2));
+
+	while (const FramePacket *packet = m_Packets.Acquire()) {
+		RenderPacket(*packet, jobSystem);
+		m_Packets.Release();
+	}
+
+	// Make sure the GPU is done with everything, before the context moves back to the main thread.
+	glFinish();
+	m_Window->ReleaseContext();
+}
+
+FramePacket &RenderThread::BeginFrame() {
+	// Includes any wait for the render thread to free a packet.
+	CPU_PROFILE_FUNCTION();
+	m_CurrentPacket = m_IsThreaded ? &m_Packets.BeginWrite() : &m_UnthreadedPacket;
+	m_CurrentPacket->m_FrameIndex = m_FrameIndex++;
+	m_CurrentPacket->m_InputTime = std::chrono::steady_clock::now();
+
+	return *m_CurrentPacket;
+}
+
+void RenderThread::EndFrame() {
+	CPU_PROFILE_FUNCTION();
+	m_CurrentPacket->m_SimulationMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_CurrentPacket->m_InputTime).count();
+
+	if (m_IsThreaded)
+		m_Packets.Publish();
+	else
+		RenderPacket(*m_CurrentPacket, m_Scene->GetJobSystem());
+	m_CurrentPacket = nullptr;
+}
+
+void RenderThread::Stop() {
+	if (m_IsStopped)
+		return;
+	m_IsStopped = true;
+
+	if (m_IsThreaded) {
+		m_Packets.Close();
+		m_Thread.join();
+		m_Window->MakeContextCurrent();
+	}
+}
+
+void RenderThread::RenderPacket(const FramePacket &p_Packet, JobSystem &p_JobSystem) {
+	auto start = std::chrono::steady_clock::now();
+	{
+		CPU_PROFILE_SCOPE("Render");
+		m_Scene->Render(p_Packet, p_JobSystem);
+	}
+	{
+		CPU_PROFILE_SCOPE("Swap buffers");
+		m_Window->SwapBuffers();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	// Latency runs from the input being read, through the simulation and any waiting, to the frame being presented.
+	float latencyMilliseconds = std::chrono::duration<float, std::milli>(end - p_Packet.m_InputTime).count();
+	m_FramesRendered++;
+	m_SimulationMilliseconds += p_Packet.m_SimulationMilliseconds;
+	m_RenderMilliseconds += std::chrono::duration<float, std::milli>(end - start).count();
+	m_LatencyMilliseconds += latencyMilliseconds;
+	m_WorstLatencyMilliseconds = std::max(m_WorstLatencyMilliseconds, latencyMilliseconds);
+
+	if (std::chrono::duration<float>(end - m_ReportStart).count() >= s_m_ReportInterval)
+		ReportTimings();
+}
+
+void RenderThread::ReportTimings() {
+	auto now = std::chrono::steady_clock::now();
+	float seconds = std::chrono::duration<float>(now - m_ReportStart).count();
+	float frames = static_cast<float>(std::max(1u, m_FramesRendered));
+
+	float simulationWaitMilliseconds = 0.0f;
+	float renderWaitMilliseconds = 0.0f;
+	m_Packets.TakeWaitTimes(simulationWaitMilliseconds, renderWaitMilliseconds);
+
+	// Built up front, so it isn't interleaved with the simulation thread's output.
+	std::ostringstream report;
+	report << "Frame pipeline (" << (m_IsThreaded ? "render thread" : "single thread") << ") - " << m_FramesRendered / seconds << " FPS"
+		<< "\tSimulation: " << m_SimulationMilliseconds / frames << " ms"
+		<< "\tRender: " << m_RenderMilliseconds / frames << " ms"
+		<< "\tWaiting, simulation: " << simulationWaitMilliseconds / frames << " ms, render: " << renderWaitMilliseconds / frames << " ms"
+		<< "\tInput latency: " << m_LatencyMilliseconds / frames << " ms (worst " << m_WorstLatencyMilliseconds << " ms)\n";
+	std::cout << report.str() << std::flush;
+
+	m_ReportStart = now;
+	m_FramesRendered = 0;
+	m_SimulationMilliseconds = 0.0f;
+	m_RenderMilliseconds = 0.0f;
+	m_LatencyMilliseconds = 0.0f;
+	m_WorstLatencyMilliseconds = 0.0f;
+}
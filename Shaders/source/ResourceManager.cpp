@@ -3,6 +3,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <filesystem>
 
 #include "GLAD/glad.h"
 #include "STB_IMAGE/stb_image.h"
@@ -10,8 +11,10 @@
 #include "FileSystemHelper.h"
 #include "Model.h"
 #include "Shader.h"
+#include "CPUProfiler.h"
 
 ResourceManager::ResourceManager() {
+	CPU_PROFILE_FUNCTION();
 	LoadShadersFromFolder("resources/shaders/");
 	LoadModelsFromFolder("resources/models/");
 }
@@ -51,9 +54,10 @@ bool ResourceManager::LoadShaderFromFile(const std::string &p_VertexShaderFile,
 		vertexShaderFile.close();
 		fragmentShaderFile.close();
 
-		// Convert the stream into a string.
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+		// Convert the stream into a string, pasting in any included files.
+		std::string shaderDirectory = std::filesystem::path(p_VertexShaderFile).parent_path().string();
+		vertexCode = ResolveShaderIncludes(vShaderStream.str(), shaderDirectory);
+		fragmentCode = ResolveShaderIncludes(fShaderStream.str(), shaderDirectory);
 
 		// If the geometry shader path is present, also load a geometry shader.
 		if (p_GeometryShaderFile != " ") {
@@ -62,7 +66,7 @@ bool ResourceManager::LoadShaderFromFile(const std::string &p_VertexShaderFile,
 				std::stringstream gShaderStream;
 				gShaderStream << geometryShaderFile.rdbuf();
 				geometryShaderFile.close();
-				geometryCode = gShaderStream.str();
+				geometryCode = ResolveShaderIncludes(gShaderStream.str(), shaderDirectory);
 			}
 		}
 	}
@@ -100,14 +104,73 @@ bool ResourceManager::LoadShaderFromFile(const std::string &p_VertexShaderFile,
 	return success;
 }
 
+bool ResourceManager::LoadComputeShaderFromFile(const std::string &p_ComputeShaderFile) {
+	std::ifstream computeShaderFile(p_ComputeShaderFile);
+	if (!computeShaderFile.is_open()) {
+		std::cerr << "ERROR::SHADER: Failed to read shader file: " << p_ComputeShaderFile;
+		return false;
+	}
+
+	std::stringstream cShaderStream;
+	cShaderStream << computeShaderFile.rdbuf();
+	computeShaderFile.close();
+	std::string shaderDirectory = std::filesystem::path(p_ComputeShaderFile).parent_path().string();
+	std::string computeCode = ResolveShaderIncludes(cShaderStream.str(), shaderDirectory);
+
+	std::shared_ptr<Shader> shader = std::make_shared<Shader>();
+	bool success = shader->CompileCompute(computeCode.c_str());
+	if (success)
+		m_Shaders.emplace(FileSystemHelper::GetNameFromFile(p_ComputeShaderFile), shader);
+	else
+		glDeleteProgram(shader->GetID());
+
+	return success;
+}
+
+std::string ResourceManager::ResolveShaderIncludes(const std::string &p_ShaderCode, const std::string &p_Directory, unsigned int p_Depth) {
+	if (p_Depth > s_m_MaxShaderIncludeDepth) {
+		std::cerr << "ERROR::SHADER: Shader includes are nested too deeply, is a file including itself?";
+		return p_ShaderCode;
+	}
+
+	std::stringstream shaderCode(p_ShaderCode);
+	std::stringstream resolvedCode;
+	std::string line;
+	while (std::getline(shaderCode, line)) {
+		// Replace lines of the form: #include "relative/path.glsl" with the file's contents.
+		size_t directivePosition = line.find("#include");
+		if (directivePosition != std::string::npos && directivePosition == line.find_first_not_of(" \t")) {
+			size_t pathStart = line.find('"', directivePosition);
+			size_t pathEnd = pathStart != std::string::npos ? line.find('"', pathStart + 1) : std::string::npos;
+			if (pathEnd != std::string::npos) {
+				std::filesystem::path includePath = std::filesystem::path(p_Directory) / line.substr(pathStart + 1, pathEnd - pathStart - 1);
+				std::ifstream includeFile(includePath);
+				if (includeFile.is_open()) {
+					std::stringstream includeStream;
+					includeStream << includeFile.rdbuf();
+					resolvedCode << ResolveShaderIncludes(includeStream.str(), includePath.parent_path().string(), p_Depth + 1) << "\n";
+					continue;
+				}
+				std::cerr << "ERROR::SHADER: Failed to open included shader file: " << includePath.string();
+			}
+		}
+		resolvedCode << line << "\n";
+	}
+
+	return resolvedCode.str();
+}
+
 bool ResourceManager::LoadShadersFromFolder(const std::string &p_FolderPath) {
+	CPU_PROFILE_FUNCTION();
+	m_ShaderFolder = p_FolderPath;
 	std::vector<FileInformation> shaderFiles = FileSystemHelper::GetFilesInFolder(p_FolderPath);
-	FileSystemHelper::RetainRemoveFilesWithExtensions(shaderFiles, { ".vert", ".VERT", ".frag", ".FRAG", ".geom", ".GEOM" });
+	FileSystemHelper::RetainRemoveFilesWithExtensions(shaderFiles, { ".vert", ".VERT", ".frag", ".FRAG", ".geom", ".GEOM", ".comp", ".COMP" });
 
 	struct ShaderGroup {
 		std::string m_VertexShaderLocation;
 		std::string m_FragmentShaderLocation;
 		std::string m_GeometryShaderLocation;
+		std::string m_ComputeShaderLocation = " ";
 
 		ShaderGroup() : m_VertexShaderLocation(" "), m_FragmentShaderLocation(" "), m_GeometryShaderLocation(" ") { }
 		ShaderGroup(const std::string &p_VertexShaderLocation, const std::string &p_FragmentShaderLocation, const std::string &p_GeometryShaderLocation = " ")
@@ -127,11 +190,20 @@ bool ResourceManager::LoadShadersFromFolder(const std::string &p_FolderPath) {
 			shaders[shaderFile.m_Name].m_FragmentShaderLocation = shaderFile.m_Location;
 		else if (shaderFile.m_Extension == ".geom" || shaderFile.m_Extension == ".GEOM")
 			shaders[shaderFile.m_Name].m_GeometryShaderLocation = shaderFile.m_Location;
+		else if (shaderFile.m_Extension == ".comp" || shaderFile.m_Extension == ".COMP")
+			shaders[shaderFile.m_Name].m_ComputeShaderLocation = shaderFile.m_Location;
 		else
 			allSuccessful = false;
 	}
 
 	for (const auto &shader : shaders) {
+		// A compute shader stands alone, it's never part of a program with the other stages.
+		if (shader.second.m_ComputeShaderLocation != " ") {
+			if (!LoadComputeShaderFromFile(shader.second.m_ComputeShaderLocation))
+				allSuccessful = false;
+			continue;
+		}
+
 		bool successful = LoadShaderFromFile(shader.second.m_VertexShaderLocation, shader.second.m_FragmentShaderLocation, shader.second.m_GeometryShaderLocation);
 
 		if (!successful)
@@ -156,6 +228,20 @@ std::shared_ptr<Shader> ResourceManager::LoadShader(const std::string &p_VertexS
 	return std::shared_ptr<Shader>(nullptr);
 }
 
+std::shared_ptr<Shader> ResourceManager::CompileShader(const std::string &p_Name, const std::string &p_VertexCode, const std::string &p_FragmentCode) {
+	std::string vertexCode = ResolveShaderIncludes(p_VertexCode, m_ShaderFolder);
+	std::string fragmentCode = ResolveShaderIncludes(p_FragmentCode, m_ShaderFolder);
+
+	std::shared_ptr<Shader> shader = std::make_shared<Shader>();
+	if (!shader->Compile(vertexCode.c_str(), fragmentCode.c_str())) {
+		glDeleteProgram(shader->GetID());
+		return std::shared_ptr<Shader>(nullptr);
+	}
+
+	m_Shaders[p_Name] = shader;
+	return shader;
+}
+
 std::shared_ptr<Shader> ResourceManager::GetShader(const std::string &p_Name) {
 	auto iter = m_Shaders.find(p_Name);
 	if (iter != m_Shaders.end()) {
@@ -232,6 +318,7 @@ unsigned int ResourceManager::LoadOpenGLCubemapTexture(const std::vector<std::st
 }
 
 bool ResourceManager::LoadModelsFromFolder(const std::string &p_FolderName) {
+	CPU_PROFILE_FUNCTION();
 	// Load any models, inside of a certain folder.
 	std::vector<FileInformation> modelFiles = FileSystemHelper::GetFilesInFolder(p_FolderName);
 
@@ -303,4 +390,9 @@ std::shared_ptr<Model> ResourceManager::GetModel(const std::string &p_ModelName)
 	}
 
 	return std::shared_ptr<Model>(nullptr);
-}
\ No newline at end of file
+}
+
+bool ResourceManager::AddModel(const std::string &p_ModelName, std::shared_ptr<Model> p_Model) {
+	// Returns false, without replacing it, if a model already has the name.
+	return m_Models.insert(std::pair<std::string, std::shared_ptr<Model>>(p_ModelName, p_Model)).second;
+}
@@ -1,6 +1,10 @@
 #include "Scene.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -12,19 +16,173 @@
 #include "Window.h"
 #include "Camera.h"
 #include "PostProcessor.h"
+#include "PostEffectFuser.h"
+#include "PostEffects.h"
+#include "PostProcessGraph.h"
 #include "Skybox.h"
+#include "TextRenderer.h"
 #include "ResourceManager.h"
 #include "Shader.h"
-#include "GameObject.h"
+#include "Model.h"
+#include "GPUProfiler.h"
+#include "DeferredRenderer.h"
+#include "DynamicResolutionController.h"
+#include "ShadowRenderer.h"
+#include "UniformBlocks.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "TransformHierarchy.h"
+#include "TaskGraph.h"
+#include "CommandReplayer.h"
+#include "CPUProfiler.h"
 
-Scene::Scene(std::shared_ptr<Window> p_Window) : m_Window(p_Window) {
+Scene::Scene(std::shared_ptr<Window> p_Window, bool p_CreateDefaultEntities, unsigned int p_StreamingBufferRegionSize) : m_Window(p_Window) {
 	m_Camera = std::make_shared<Camera>(glm::vec3(0.0f, 0.0f, 0.0f));
-	m_PostProcessor = std::make_shared<PostProcessor>((float)p_Window->Width(), (float)p_Window->Height());
-	m_Skybox = std::make_shared<Skybox>();
+	m_PostProcessor = std::make_shared<PostProcessor>(p_Window->Width(), p_Window->Height());
+	m_PostProcessor->SetOutputFrameBuffer(p_Window->GetFrameBufferObject());
+	// The colour effects first, so the shake moves the finished image. The pixel effects are kept together, so they fuse into one pass.
+	// The luminance is measured before anything changes the scene's colour, and the bloom is added before the tonemap.
+	m_AutoExposureEffect = std::make_shared<AutoExposureEffect>();
+	m_EdgeKernelEffect = std::make_shared<EdgeKernelEffect>();
+	m_BlurEffect = std::make_shared<BlurEffect>();
+	m_BloomEffect = std::make_shared<BloomEffect>();
+	m_TonemapEffect = std::make_shared<TonemapEffect>();
+	// The scene is lit in HDR, so the chain always ends by mapping it into the displayable range.
+	m_TonemapEffect->SetEnabled(true);
+	m_ColourGradingEffect = std::make_shared<ColourGradingEffect>();
+	m_VignetteEffect = std::make_shared<VignetteEffect>();
+	m_InvertColoursEffect = std::make_shared<InvertColoursEffect>();
+	m_FXAAEffect = std::make_shared<FXAAEffect>();
+	m_SMAAEffect = std::make_shared<SMAAEffect>();
+	m_ShakeEffect = std::make_shared<ShakeEffect>();
+	m_PostProcessor->AddEffect(m_AutoExposureEffect);
+	m_PostProcessor->AddEffect(m_EdgeKernelEffect);
+	m_PostProcessor->AddEffect(m_BlurEffect);
+	m_PostProcessor->AddEffect(m_BloomEffect);
+	m_PostProcessor->AddEffect(m_TonemapEffect);
+	m_PostProcessor->AddEffect(m_ColourGradingEffect);
+	m_PostProcessor->AddEffect(m_VignetteEffect);
+	m_PostProcessor->AddEffect(m_InvertColoursEffect);
+	// After the colour effects, so the edges are smoothed in the colours they're shown in.
+	m_PostProcessor->AddEffect(m_FXAAEffect);
+	m_PostProcessor->AddEffect(m_SMAAEffect);
+	m_PostProcessor->AddEffect(m_ShakeEffect);
 
-	m_SceneObject = std::make_shared<GameObject>(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), "nanosuit", "blinnPhong");
-	m_LightObject = std::make_shared<GameObject>(glm::vec3(10.5f, 15.5f, 15.5f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.25f, 0.25f, 0.25f), "sphere", "flat");
-	m_LightObject->SetColour(glm::vec3(1.0f, 1.0f, 1.0f));
+	m_JobSystem = std::make_shared<JobSystem>();
+	// After the job system, which bakes the sky's lighting if it isn't cached.
+	m_Skybox = std::make_shared<Skybox>(*m_JobSystem);
+	m_TextRenderer = std::make_shared<TextRenderer>("resources/fonts/arial.ttf");
+	m_Entities = std::make_shared<EntityManager>();
+	m_TransformSystem = std::make_shared<TransformSystem>();
+	m_CullingSystem = std::make_shared<CullingSystem>();
+	m_DrawPacketSystem = std::make_shared<DrawPacketSystem>();
+	m_LightSystem = std::make_shared<LightSystem>();
+	m_LightClusterBinner = std::make_shared<LightClusterBinner>();
+	m_ShadowCasterSystem = std::make_shared<ShadowCasterSystem>();
+	m_Sun.m_Direction = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.45f));
+	m_Sun.m_Colour = glm::vec3(0.45f, 0.43f, 0.4f);
+	BuildFrameGraph();
+	if (p_CreateDefaultEntities) {
+		m_SceneEntity = CreateRenderableEntity(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), "nanosuit", "blinnPhong", glm::vec3(1.0f, 1.0f, 1.0f));
+		m_LightEntity = CreateRenderableEntity(glm::vec3(10.5f, 15.5f, 15.5f), glm::vec3(0.25f, 0.25f, 0.25f), "sphere", "flat", glm::vec3(1.0f, 1.0f, 1.0f), true);
+	}
+
+	m_DepthShader = ResourceManagerInstance.GetShader("depthOnly");
+	m_LitShader = ResourceManagerInstance.GetShader("blinnPhong");
+	m_GeometryShader = ResourceManagerInstance.GetShader("gBuffer");
+	m_DeferredRenderer = std::make_shared<DeferredRenderer>(p_Window->Width(), p_Window->Height());
+	m_ShadowRenderer = std::make_shared<ShadowRenderer>();
+	m_GPUProfiler = std::make_shared<GPUProfiler>();
+	m_ResolutionController = std::make_shared<DynamicResolutionController>();
+	m_StreamingBuffer = std::make_shared<StreamingBuffer>(GL_UNIFORM_BUFFER, p_StreamingBufferRegionSize);
+	// Each region starts wherever the last ended, so it has room to align the lights' offset for binding.
+	const GLint storageAlignment = StreamingBuffer::QueryBindingAlignment(GL_SHADER_STORAGE_BUFFER);
+	m_LightBuffer = std::make_shared<StreamingBuffer>(GL_SHADER_STORAGE_BUFFER, s_m_MaxLights * sizeof(PointLightData) + storageAlignment);
+	// The offsets and counts, then the indices, each with room to be aligned.
+	m_ClusterBuffer = std::make_shared<StreamingBuffer>(GL_SHADER_STORAGE_BUFFER, LightClusterBinner::s_m_ClusterCount * sizeof(glm::uvec2) + s_m_MaxClusterLightIndices * sizeof(unsigned int) + 2 * storageAlignment);
+}
+
+void Scene::BuildFrameGraph() {
+	// Each system goes wide across the job system by itself, the graph only orders them. The simulation thread helps while it waits.
+	m_FrameGraph = std::make_shared<TaskGraph>();
+	TaskHandle transformTask = m_FrameGraph->AddTask("Transforms", [this]() {
+		m_TransformSystem->Update(*m_JobSystem, *m_Entities);
+	});
+	// Animation would run here, before the transforms, once the engine has any.
+	TaskHandle cullingTask = m_FrameGraph->AddTask("Culling", [this]() {
+		m_CullingSystem->Update(*m_JobSystem, *m_Entities, Frustum(m_SimulationPacket->m_ProjectionMatrix * m_SimulationPacket->m_ViewMatrix));
+	});
+	TaskHandle drawPacketTask = m_FrameGraph->AddTask("Draw packets", [this]() {
+		m_DrawPacketSystem->Update(*m_JobSystem, *m_Entities, m_SimulationPacket->m_ViewPosition, m_SimulationPacket->m_DrawPackets);
+	});
+	TaskHandle sortTask = m_FrameGraph->AddTask("Draw key sort", [this]() {
+		m_DrawPacketSystem->Sort(m_SimulationPacket->m_DrawPackets, m_SimulationPacket->m_DrawOrder);
+	});
+	TaskHandle lightTask = m_FrameGraph->AddTask("Lights", [this]() {
+		m_LightSystem->Update(*m_Entities, Frustum(m_SimulationPacket->m_ProjectionMatrix * m_SimulationPacket->m_ViewMatrix), m_SimulationPacket->m_Lights);
+		if (m_SimulationPacket->m_Lights.size() > s_m_MaxLights)
+			m_SimulationPacket->m_Lights.resize(s_m_MaxLights);
+	});
+	TaskHandle lightClusterTask = m_FrameGraph->AddTask("Light clusters", [this]() {
+		FramePacket &packet = *m_SimulationPacket;
+		if (!packet.m_Settings.m_UseClusteredShading) {
+			packet.m_ClusterLightRanges.clear();
+			packet.m_ClusterLightIndices.clear();
+			return;
+		}
+		m_LightClusterBinner->Bin(*m_JobSystem, packet.m_Lights, packet.m_ViewMatrix, packet.m_ProjectionMatrix, m_NearClippingPlane, m_FarClippingPlane,
+			s_m_MaxClusterLightIndices, packet.m_ClusterLightRanges, packet.m_ClusterLightIndices);
+	});
+	// Every caster, not just the visible ones, as objects out of view can still cast into it.
+	TaskHandle shadowCasterTask = m_FrameGraph->AddTask("Shadow casters", [this]() {
+		FramePacket &packet = *m_SimulationPacket;
+		if (!packet.m_Settings.m_UseShadows) {
+			packet.m_ShadowCasters.clear();
+			packet.m_MovedStaticCasterBounds.clear();
+			packet.m_ShadowReceiverDepth = 0.0f;
+			return;
+		}
+		m_ShadowCasterSystem->Update(*m_Entities, packet.m_ShadowCasters, packet.m_MovedStaticCasterBounds);
+		packet.m_ShadowReceiverDepth = m_ShadowCasterSystem->CalculateReceiverDepth(*m_Entities, packet.m_ViewMatrix);
+	});
+
+	m_FrameGraph->AddDependency(transformTask, cullingTask);
+	m_FrameGraph->AddDependency(cullingTask, drawPacketTask);
+	m_FrameGraph->AddDependency(drawPacketTask, sortTask);
+	m_FrameGraph->AddDependency(transformTask, lightTask);
+	m_FrameGraph->AddDependency(lightTask, lightClusterTask);
+	m_FrameGraph->AddDependency(cullingTask, shadowCasterTask);
+}
+
+Entity Scene::CreateRenderableEntity(const glm::vec3 &p_Position, const glm::vec3 &p_Scale, const std::string &p_ModelName, const std::string &p_ShaderName, const glm::vec3 &p_Colour, bool p_IsLight, Entity p_Parent) {
+	TransformComponent transform;
+	transform.m_Position = p_Position;
+	transform.m_Scale = p_Scale;
+	transform.m_Parent = p_Parent;
+
+	RenderableComponent renderable;
+	renderable.m_Model = ResourceManagerInstance.GetModel(p_ModelName).get();
+	renderable.m_Shader = ResourceManagerInstance.GetShader(p_ShaderName).get();
+
+	ColourComponent colour;
+	colour.m_Colour = p_Colour;
+
+	BoundsComponent bounds;
+	bounds.m_LocalCentre = renderable.m_Model->GetBoundingSphereCentre();
+	bounds.m_LocalRadius = renderable.m_Model->GetBoundingSphereRadius();
+
+	if (p_IsLight) {
+		// The light is drawn as a sphere, in the light's colour.
+		LightComponent light;
+		light.m_Colour = p_Colour;
+		Entity lightEntity = m_Entities->CreateEntity(transform, renderable, colour, bounds, light);
+		if (!m_Entities->IsAlive(m_LightEntity))
+			m_LightEntity = lightEntity;
+		return lightEntity;
+	}
+	// Everything but the lights casts shadows, the light's own sphere would only shadow the scene from itself.
+	ShadowCasterComponent shadowCaster;
+	return m_Entities->CreateEntity(transform, renderable, colour, bounds, shadowCaster);
 }
 
 void Scene::HandleMouseInput(float p_XPosition, float p_YPosition) {
@@ -37,6 +195,12 @@ void Scene::HandleMouseInput(float p_XPosition, float p_YPosition) {
 	s_PreviousYPosition = p_YPosition;
 }
 
+void Scene::ShowStatus(const std::string &p_Message) {
+	std::cout << "\n" << p_Message << std::endl;
+	m_StatusMessage = p_Message;
+	m_StatusMessageTime = m_StatusMessageDuration;
+}
+
 void Scene::HandleKeyboardInput(std::vector<bool> &p_KeyPressBuffer, std::vector<bool> &p_KeyReleaseBuffer) {
 	// Camera movement:
 	if (p_KeyPressBuffer['W'])
@@ -53,102 +217,709 @@ void Scene::HandleKeyboardInput(std::vector<bool> &p_KeyPressBuffer, std::vector
 		m_Camera->ProcessKeyboard(CameraMovement::DOWN, m_DeltaTime);
 	if (p_KeyReleaseBuffer['B'])
 		m_Camera->m_EnableSpeedBoost = !m_Camera->m_EnableSpeedBoost;
+	// The post-processor belongs to the render thread, so the effects are toggled here and handed over in the frame packet.
 	if (p_KeyReleaseBuffer['1']) {
-		if (m_PostProcessor->GetShakeState()) {
-			m_PostProcessor->SetShakeState(false);
-			std::cout << "\nShake effect: Off" << std::endl;
+		if (m_Settings.m_Shake) {
+			m_Settings.m_Shake = false;
+			ShowStatus("Shake effect: Off");
 		}
 		else {
-			m_PostProcessor->SetShakeState(true);
-			std::cout << "\nShake effect: On" << std::endl;
+			m_Settings.m_Shake = true;
+			ShowStatus("Shake effect: On");
 		}
 	}
 	if (p_KeyReleaseBuffer['2']) {
-		if (m_PostProcessor->GetInvertColoursState()) {
-			m_PostProcessor->SetInvertColoursState(false);
-			std::cout << "\nInverted colour effect: Off" << std::endl;
+		if (m_Settings.m_InvertColours) {
+			m_Settings.m_InvertColours = false;
+			ShowStatus("Inverted colour effect: Off");
 		}
 		else {
-			m_PostProcessor->SetInvertColoursState(true);
-			std::cout << "\nInverted colour effect: On" << std::endl;
+			m_Settings.m_InvertColours = true;
+			m_Settings.m_Chaos = false;
+			ShowStatus("Inverted colour effect: On");
 		}
 	}
 	if (p_KeyReleaseBuffer['3']) {
-		if (m_PostProcessor->GetChaosState()) {
-			m_PostProcessor->SetChaosState(false);
-			std::cout << "\nEdge kernel effect: Off" << std::endl;
+		if (m_Settings.m_Chaos) {
+			m_Settings.m_Chaos = false;
+			ShowStatus("Edge kernel effect: Off");
 		}
 		else {
-			m_PostProcessor->SetChaosState(true);
-			std::cout << "\nEdge kernel effect: On" << std::endl;
+			m_Settings.m_Chaos = true;
+			m_Settings.m_InvertColours = false;
+			ShowStatus("Edge kernel effect: On");
 		}
 	}
+	if (p_KeyReleaseBuffer['U']) {
+		m_Settings.m_UseBlur = !m_Settings.m_UseBlur;
+		if (m_Settings.m_UseBlur)
+			ShowStatus("Blur: On");
+		else
+			ShowStatus("Blur: Off");
+	}
+	if (p_KeyReleaseBuffer['L']) {
+		m_Settings.m_UseBloom = !m_Settings.m_UseBloom;
+		if (m_Settings.m_UseBloom)
+			ShowStatus("Bloom: On");
+		else
+			ShowStatus("Bloom: Off");
+	}
+	if (p_KeyReleaseBuffer['X']) {
+		m_Settings.m_UseAutoExposure = !m_Settings.m_UseAutoExposure;
+		if (m_Settings.m_UseAutoExposure)
+			ShowStatus("Auto exposure: On");
+		else
+			ShowStatus("Auto exposure: Off");
+	}
+	if (p_KeyReleaseBuffer['G']) {
+		m_Settings.m_UseColourGrading = !m_Settings.m_UseColourGrading;
+		if (m_Settings.m_UseColourGrading)
+			ShowStatus("Colour grading: On");
+		else
+			ShowStatus("Colour grading: Off");
+	}
+	if (p_KeyReleaseBuffer['V']) {
+		m_Settings.m_UseVignette = !m_Settings.m_UseVignette;
+		if (m_Settings.m_UseVignette)
+			ShowStatus("Vignette: On");
+		else
+			ShowStatus("Vignette: Off");
+	}
 	if (p_KeyReleaseBuffer['4']) {
-		m_UseBlinnPhong = !m_UseBlinnPhong;
-		if (m_UseBlinnPhong)
-			std::cout << "\nBlinn phong: On" << std::endl;
+		m_Settings.m_UseBlinnPhong = !m_Settings.m_UseBlinnPhong;
+		if (m_Settings.m_UseBlinnPhong)
+			ShowStatus("Blinn phong: On");
 		else 
-			std::cout << "\nBlinn phong: Off" << std::endl;
+			ShowStatus("Blinn phong: Off");
 	}
 	if (p_KeyReleaseBuffer['5']) {
-		m_UseNormalMap = !m_UseNormalMap;
-		if (m_UseNormalMap)
-			std::cout << "\nUsing normal maps: On" << std::endl;
+		m_Settings.m_UseNormalMap = !m_Settings.m_UseNormalMap;
+		if (m_Settings.m_UseNormalMap)
+			ShowStatus("Using normal maps: On");
 		else
-			std::cout << "\nUsing normal maps: Off" << std::endl;
+			ShowStatus("Using normal maps: Off");
 	}
 	if (p_KeyReleaseBuffer['6']) {
-		m_UseToonShading = !m_UseToonShading;
-		if (m_UseToonShading)
-			std::cout << "\nToon shading: On" << std::endl;
+		m_Settings.m_UseToonShading = !m_Settings.m_UseToonShading;
+		if (m_Settings.m_UseToonShading)
+			ShowStatus("Toon shading: On");
 		else
-			std::cout << "\nToon shading: Off" << std::endl;
+			ShowStatus("Toon shading: Off");
 	}
 	if (p_KeyReleaseBuffer['7']) {
-		m_ShowNormalMap = !m_ShowNormalMap;
-		if (m_ShowNormalMap)
-			std::cout << "\nShow Normal Map: On" << std::endl;
+		m_Settings.m_ShowNormalMap = !m_Settings.m_ShowNormalMap;
+		if (m_Settings.m_ShowNormalMap)
+			ShowStatus("Show Normal Map: On");
+		else
+			ShowStatus("Show Normal Map: Off");
+	}
+	if (p_KeyReleaseBuffer['8']) {
+		m_Settings.m_UseDepthPrePass = !m_Settings.m_UseDepthPrePass;
+		if (m_Settings.m_UseDepthPrePass)
+			ShowStatus("Depth pre-pass: On");
+		else
+			ShowStatus("Depth pre-pass: Off");
+	}
+	if (p_KeyReleaseBuffer['9']) {
+		m_Settings.m_UseDeferredShading = !m_Settings.m_UseDeferredShading;
+		if (m_Settings.m_UseDeferredShading)
+			ShowStatus("Deferred shading: On");
+		else
+			ShowStatus("Deferred shading: Off");
+	}
+	if (p_KeyReleaseBuffer['0']) {
+		m_Settings.m_UseClusteredShading = !m_Settings.m_UseClusteredShading;
+		if (m_Settings.m_UseClusteredShading)
+			ShowStatus("Clustered shading: On");
+		else
+			ShowStatus("Clustered shading: Off");
+	}
+	if (p_KeyReleaseBuffer['O']) {
+		m_Settings.m_UseShadows = !m_Settings.m_UseShadows;
+		if (m_Settings.m_UseShadows)
+			ShowStatus("Shadows: On");
+		else
+			ShowStatus("Shadows: Off");
+	}
+	if (p_KeyReleaseBuffer['R']) {
+		m_Settings.m_UseDynamicResolution = !m_Settings.m_UseDynamicResolution;
+		if (m_Settings.m_UseDynamicResolution)
+			ShowStatus("Dynamic resolution: On");
+		else
+			ShowStatus("Dynamic resolution: Off");
+	}
+	if (p_KeyReleaseBuffer['M']) {
+		m_Settings.m_AntiAliasing = static_cast<AntiAliasingMode>((static_cast<int>(m_Settings.m_AntiAliasing) + 1) % static_cast<int>(AntiAliasingMode::COUNT));
+		ShowStatus(std::string("Anti-aliasing: ") + GetAntiAliasingModeName(m_Settings.m_AntiAliasing));
+	}
+	if (p_KeyReleaseBuffer['P']) {
+		m_Settings.m_ShowGPUProfiler = !m_Settings.m_ShowGPUProfiler;
+		if (m_Settings.m_ShowGPUProfiler)
+			ShowStatus("GPU profiler overlay: On");
+		else
+			ShowStatus("GPU profiler overlay: Off");
+	}
+	if (p_KeyReleaseBuffer['F']) {
+		m_Settings.m_UseDistanceFieldText = !m_Settings.m_UseDistanceFieldText;
+		if (m_Settings.m_UseDistanceFieldText)
+			ShowStatus("Distance field text: On");
 		else
-			std::cout << "\nShow Normal Map: Off" << std::endl;
+			ShowStatus("Distance field text: Off");
 	}
 
 	for (auto releasedKey : p_KeyReleaseBuffer)
 		releasedKey = false;
 }
 
-void Scene::Update(float p_DeltaTime) {
+void Scene::Update(float p_DeltaTime, FramePacket &p_Packet) {
 	m_DeltaTime = p_DeltaTime;
 
-	m_PostProcessor->Update(p_DeltaTime);
+	// Everything the render thread needs is copied into the packet, it never reads the simulation's state directly.
+	p_Packet.m_DeltaTime = p_DeltaTime;
+	p_Packet.m_Width = m_Window->Width();
+	p_Packet.m_Height = m_Window->Height();
+	p_Packet.m_ProjectionMatrix = GetProjectionMatrix();
+	p_Packet.m_ViewMatrix = m_Camera->GetViewMatrix();
+	p_Packet.m_ViewPosition = m_Camera->m_Position;
+	p_Packet.m_Settings = m_Settings;
+	p_Packet.m_Sun = m_Sun;
+	// Shown for a while after a toggle, fading out over the last part.
+	m_StatusMessageTime = std::max(m_StatusMessageTime - p_DeltaTime, 0.0f);
+	p_Packet.m_StatusMessage = m_StatusMessageTime > 0.0f ? m_StatusMessage : std::string();
+	p_Packet.m_StatusMessageOpacity = std::min(m_StatusMessageTime / m_StatusMessageFadeTime, 1.0f);
+
+	m_SimulationPacket = &p_Packet;
+	m_FrameGraph->Execute(*m_JobSystem);
+	m_SimulationPacket = nullptr;
+
+	if (m_Entities->IsAlive(m_LightEntity)) {
+		p_Packet.m_Light.m_Position = glm::vec3(m_Entities->GetComponent<TransformComponent>(m_LightEntity)->m_WorldMatrix[3]);
+		p_Packet.m_Light.m_Colour = m_Entities->GetComponent<LightComponent>(m_LightEntity)->m_Colour;
+		p_Packet.m_Light.m_Attenuation = m_Entities->GetComponent<LightComponent>(m_LightEntity)->m_Attenuation;
+		p_Packet.m_Light.m_Radius = LightSystem::CalculateRadius(p_Packet.m_Light.m_Colour, p_Packet.m_Light.m_Attenuation);
+	}
+
+	m_TimeSinceSimulationReport += p_DeltaTime;
+	if (m_TimeSinceSimulationReport >= m_TimingReportInterval) {
+		m_TimeSinceSimulationReport = 0.0f;
+		ReportSimulationTimings();
+	}
 }
 
-void Scene::Render() {
-	m_PostProcessor->BeginRender();
-	glm::mat4 projectionMatrix = glm::perspective(glm::radians(m_Camera->m_Zoom), static_cast<float>(m_Window->Width()) / static_cast<float>(m_Window->Height()), m_NearClippingPlane, m_FarClippingPlane);
-	glm::mat4 viewMatrix = m_Camera->GetViewMatrix();
+glm::mat4 Scene::GetProjectionMatrix() const {
+	return glm::perspective(glm::radians(m_Camera->m_Zoom), static_cast<float>(m_Window->Width()) / static_cast<float>(m_Window->Height()), m_NearClippingPlane, m_FarClippingPlane);
+}
+
+void Scene::UploadFrameData(const FramePacket &p_Packet) {
+	StreamingBuffer::Allocation frameAllocation = m_StreamingBuffer->AllocateForBinding(sizeof(FrameUniformData));
+	if (frameAllocation.IsValid()) {
+		FrameUniformData *frameData = static_cast<FrameUniformData*>(frameAllocation.m_Data);
+		frameData->m_Projection = p_Packet.m_ProjectionMatrix;
+		frameData->m_View = p_Packet.m_ViewMatrix;
+		frameData->m_ViewPosition = glm::vec4(p_Packet.m_ViewPosition, 1.0f);
+		frameData->m_InverseViewProjection = glm::inverse(p_Packet.m_ProjectionMatrix * p_Packet.m_ViewMatrix);
+		frameData->m_ClusterGridSize = glm::uvec4(LightClusterBinner::s_m_TileCountX, LightClusterBinner::s_m_TileCountY, LightClusterBinner::s_m_SliceCount, 0);
+		glm::vec2 sliceScaleAndBias = LightClusterBinner::GetSliceScaleAndBias(m_NearClippingPlane, m_FarClippingPlane);
+		// The tiles divide up the scene's target, which is smaller than the window when the render scale is.
+		frameData->m_ClusterParameters = glm::vec4(sliceScaleAndBias, static_cast<float>(LightClusterBinner::s_m_TileCountX) / m_PostProcessor->GetRenderWidth(),
+			static_cast<float>(LightClusterBinner::s_m_TileCountY) / m_PostProcessor->GetRenderHeight());
+		// The shaders want the direction towards the sun.
+		frameData->m_SunDirection = glm::vec4(-glm::normalize(p_Packet.m_Sun.m_Direction), 0.0f);
+		frameData->m_SunColour = glm::vec4(p_Packet.m_Sun.m_Colour, 1.0f);
+
+		glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBlockBinding::FRAME_DATA), frameAllocation.m_Buffer, frameAllocation.m_Offset, frameAllocation.m_Size);
+	}
+}
+
+unsigned int Scene::UploadLights(const FramePacket &p_Packet) {
+	size_t lightCount = std::min(p_Packet.m_Lights.size(), s_m_MaxLights);
+	if (lightCount == 0)
+		return 0;
+
+	StreamingBuffer::Allocation lightAllocation = m_LightBuffer->AllocateForBinding(lightCount * sizeof(PointLightData));
+	if (!lightAllocation.IsValid())
+		return 0;
+
+	PointLightData *lightData = static_cast<PointLightData*>(lightAllocation.m_Data);
+	for (size_t i = 0; i < lightCount; i++) {
+		const FrameLight &light = p_Packet.m_Lights[i];
+		lightData[i].m_PositionRadius = glm::vec4(light.m_Position, light.m_Radius);
+		lightData[i].m_Colour = glm::vec4(light.m_Colour, 1.0f);
+		lightData[i].m_Attenuation = glm::vec4(light.m_Attenuation, 0.0f);
+	}
+	m_LightBuffer->Flush();
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(ShaderStorageBinding::LIGHTS), lightAllocation.m_Buffer, lightAllocation.m_Offset, lightAllocation.m_Size);
+
+	return static_cast<unsigned int>(lightCount);
+}
+
+void Scene::UploadLightClusters(const FramePacket &p_Packet) {
+	// Bound even when there are no lights, as every pixel still reads its cluster's count.
+	const std::vector<glm::uvec2> &ranges = p_Packet.m_ClusterLightRanges;
+	const std::vector<unsigned int> &indices = p_Packet.m_ClusterLightIndices;
+	StreamingBuffer::Allocation rangeAllocation = m_ClusterBuffer->AllocateForBinding(LightClusterBinner::s_m_ClusterCount * sizeof(glm::uvec2));
+	StreamingBuffer::Allocation indexAllocation = m_ClusterBuffer->AllocateForBinding(std::max<size_t>(1, indices.size()) * sizeof(unsigned int));
+	if (!rangeAllocation.IsValid() || !indexAllocation.IsValid())
+		return;
+
+	if (ranges.size() == LightClusterBinner::s_m_ClusterCount)
+		std::memcpy(rangeAllocation.m_Data, ranges.data(), ranges.size() * sizeof(glm::uvec2));
+	else
+		std::memset(rangeAllocation.m_Data, 0, rangeAllocation.m_Size);
+	if (!indices.empty())
+		std::memcpy(indexAllocation.m_Data, indices.data(), indices.size() * sizeof(unsigned int));
+	m_ClusterBuffer->Flush();
+
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(ShaderStorageBinding::CLUSTER_LIGHT_RANGES), rangeAllocation.m_Buffer, rangeAllocation.m_Offset, rangeAllocation.m_Size);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(ShaderStorageBinding::CLUSTER_LIGHT_INDICES), indexAllocation.m_Buffer, indexAllocation.m_Offset, indexAllocation.m_Size);
+}
+
+StreamingBuffer::Allocation Scene::UploadObjectData(const FramePacket &p_Packet, const DrawPacket &p_DrawPacket, size_t p_MeshIndex) {
+	StreamingBuffer::Allocation allocation = m_StreamingBuffer->AllocateForBinding(sizeof(ObjectUniformData));
+	if (!allocation.IsValid())
+		return allocation;
+
+	const Model &model = *p_DrawPacket.m_Model;
+	ObjectUniformData *objectData = static_cast<ObjectUniformData*>(allocation.m_Data);
+	if (model.HasNodeTransforms()) {
+		objectData->m_Model = p_DrawPacket.m_WorldMatrix * model.GetMeshTransform(p_MeshIndex);
+		objectData->m_NormalMatrix = glm::mat3x4(glm::transpose(glm::inverse(glm::mat3(objectData->m_Model))));
+	}
+	else {
+		objectData->m_Model = p_DrawPacket.m_WorldMatrix;
+		objectData->m_NormalMatrix = glm::mat3x4(p_DrawPacket.m_NormalMatrix);
+	}
+	objectData->m_SurfaceColour = glm::vec4(p_DrawPacket.m_Colour, 1.0f);
+
+	// Move the light and camera into object space once here, rather than moving every vertex's tangent frame into world space.
+	glm::mat4 inverseModelMatrix = glm::inverse(objectData->m_Model);
+	float useObjectSpace = TransformHierarchy::HasUniformScale(objectData->m_Model) ? 1.0f : 0.0f;
+	objectData->m_ObjectLightPosition = glm::vec4(glm::vec3(inverseModelMatrix * glm::vec4(p_Packet.m_Light.m_Position, 1.0f)), useObjectSpace);
+	objectData->m_ObjectViewPosition = inverseModelMatrix * glm::vec4(p_Packet.m_ViewPosition, 1.0f);
+
+	return allocation;
+}
+
+void Scene::RecordCommandBuffers(const FramePacket &p_Packet, JobSystem &p_JobSystem) {
+	CPU_PROFILE_FUNCTION();
+	// Split the draw order into a few slices per thread, each recorded into its own buffers and replayed in the same order.
+	size_t drawCount = p_Packet.m_DrawOrder.size();
+	size_t sliceCount = std::min<size_t>(p_JobSystem.GetThreadCount() * 2, (drawCount + s_m_MinimumDrawsPerSlice - 1) / s_m_MinimumDrawsPerSlice);
+	sliceCount = std::max<size_t>(1, sliceCount);
+	size_t sliceSize = (drawCount + sliceCount - 1) / sliceCount;
+
+	m_DepthCommandBuffers.resize(sliceCount);
+	m_ColourCommandBuffers.resize(sliceCount);
+	m_GeometryCommandBuffers.resize(sliceCount);
+	// The G-buffer already lays down the lit objects' depth, so a depth pre-pass would only repeat it.
+	bool recordGeometryPass = p_Packet.m_Settings.m_UseDeferredShading;
+	bool recordDepthPrePass = p_Packet.m_Settings.m_UseDepthPrePass && !recordGeometryPass;
+
+	p_JobSystem.ParallelFor(sliceCount, 1, [this, &p_Packet, drawCount, sliceSize, recordDepthPrePass, recordGeometryPass](size_t p_FirstSlice, size_t p_LastSlice) {
+		CPU_PROFILE_SCOPE("Record command buffer slices");
+		for (size_t slice = p_FirstSlice; slice < p_LastSlice; slice++) {
+			CommandBuffer &depthCommands = m_DepthCommandBuffers[slice];
+			CommandBuffer &colourCommands = m_ColourCommandBuffers[slice];
+			CommandBuffer &geometryCommands = m_GeometryCommandBuffers[slice];
+			depthCommands.Reset();
+			colourCommands.Reset();
+			geometryCommands.Reset();
+
+			size_t begin = std::min(slice * sliceSize, drawCount);
+			size_t end = std::min(begin + sliceSize, drawCount);
+			for (size_t i = begin; i < end; i++) {
+				RecordDrawPacket(p_Packet, p_Packet.m_DrawPackets[p_Packet.m_DrawOrder[i]], recordDepthPrePass ? &depthCommands : nullptr, colourCommands,
+					recordGeometryPass ? &geometryCommands : nullptr);
+			}
+		}
+	});
+
+	if (m_ValidateCommandBuffers)
+		ValidateCommandBuffers();
+}
+
+void Scene::RecordDrawPacket(const FramePacket &p_Packet, const DrawPacket &p_DrawPacket, CommandBuffer *p_DepthCommands, CommandBuffer &p_ColourCommands, CommandBuffer *p_GeometryCommands) {
+	// Meshes share the object's data, unless the model's nodes move them relative to each other.
+	const Model &model = *p_DrawPacket.m_Model;
+	StreamingBuffer::Allocation objectData;
+	for (size_t i = 0; i < model.GetMeshCount(); i++) {
+		if (i == 0 || model.HasNodeTransforms())
+			objectData = UploadObjectData(p_Packet, p_DrawPacket, i);
+		if (!objectData.IsValid())
+			continue;
+
+		const Mesh &mesh = model.GetMesh(i);
+		if (p_GeometryCommands && p_DrawPacket.m_Shader == m_LitShader.get()) {
+			p_GeometryCommands->BindProgram(m_GeometryShader->GetID());
+			p_GeometryCommands->BindObjectData(objectData.m_Buffer, objectData.m_Offset, objectData.m_Size);
+			p_GeometryCommands->BindMaterial(&mesh);
+			p_GeometryCommands->DrawIndexed(mesh.GetVertexArray(), mesh.GetIndexCount());
+			continue;
+		}
+
+		if (p_DepthCommands) {
+			p_DepthCommands->BindProgram(m_DepthShader->GetID());
+			p_DepthCommands->BindObjectData(objectData.m_Buffer, objectData.m_Offset, objectData.m_Size);
+			p_DepthCommands->DrawIndexed(mesh.GetPositionOnlyVertexArray(), mesh.GetIndexCount());
+		}
+
+		p_ColourCommands.BindProgram(p_DrawPacket.m_Shader->GetID());
+		p_ColourCommands.BindObjectData(objectData.m_Buffer, objectData.m_Offset, objectData.m_Size);
+		p_ColourCommands.BindMaterial(&mesh);
+		p_ColourCommands.DrawIndexed(mesh.GetVertexArray(), mesh.GetIndexCount());
+	}
+}
+
+void Scene::ValidateCommandBuffers() const {
+	std::string error;
+	for (size_t i = 0; i < m_ColourCommandBuffers.size(); i++) {
+		if (!m_DepthCommandBuffers[i].Validate(m_StreamingBuffer->GetBindingAlignment(), error))
+			std::cout << "ERROR::COMMAND_BUFFER:: Depth pre-pass slice " << i << ": " << error << std::endl;
+		if (!m_ColourCommandBuffers[i].Validate(m_StreamingBuffer->GetBindingAlignment(), error))
+			std::cout << "ERROR::COMMAND_BUFFER:: Colour pass slice " << i << ": " << error << std::endl;
+		if (!m_GeometryCommandBuffers[i].Validate(m_StreamingBuffer->GetBindingAlignment(), error))
+			std::cout << "ERROR::COMMAND_BUFFER:: G-buffer pass slice " << i << ": " << error << std::endl;
+	}
+}
+
+void Scene::Render(const FramePacket &p_Packet, JobSystem &p_JobSystem) {
+	auto renderStart = std::chrono::steady_clock::now();
+	const RenderSettings &settings = p_Packet.m_Settings;
+	if (p_Packet.m_Width != m_ViewportWidth || p_Packet.m_Height != m_ViewportHeight) {
+		m_ViewportWidth = p_Packet.m_Width;
+		m_ViewportHeight = p_Packet.m_Height;
+		glViewport(0, 0, m_ViewportWidth, m_ViewportHeight);
+		m_PostProcessor->SetOutputSize(m_ViewportWidth, m_ViewportHeight);
+	}
+	// Last frame's time is a few frames old, but it's the newest the GPU profiler has.
+	if (settings.m_UseDynamicResolution) {
+		const GPUPassTiming *frameTiming = m_GPUProfiler->GetPassTiming("Frame");
+		m_ResolutionController->SetBudget(settings.m_FrameBudgetMilliseconds);
+		m_PostProcessor->SetRenderScale(m_ResolutionController->Update(frameTiming && frameTiming->m_WasRecorded ? frameTiming->m_ElapsedMilliseconds : 0.0f));
+	}
+	else {
+		m_ResolutionController->Reset();
+		m_PostProcessor->SetRenderScale(1.0f);
+	}
+	// Only reallocates the G-buffer when the size has changed.
+	m_DeferredRenderer->Resize(m_PostProcessor->GetRenderWidth(), m_PostProcessor->GetRenderHeight());
+	m_ShakeEffect->SetEnabled(settings.m_Shake);
+	m_InvertColoursEffect->SetEnabled(settings.m_InvertColours);
+	m_EdgeKernelEffect->SetEnabled(settings.m_Chaos);
+	m_BlurEffect->SetEnabled(settings.m_UseBlur);
+	m_BloomEffect->SetEnabled(settings.m_UseBloom);
+	m_AutoExposureEffect->SetEnabled(settings.m_UseAutoExposure);
+	m_ColourGradingEffect->SetEnabled(settings.m_UseColourGrading);
+	m_VignetteEffect->SetEnabled(settings.m_UseVignette);
+	UpdateAntiAliasing(settings);
+	// Reads back whichever luminance histograms the GPU has finished, before this frame's exposure is used.
+	m_PostProcessor->Update(p_Packet.m_DeltaTime);
+	m_TonemapEffect->SetExposure(m_AutoExposureEffect->IsEnabled() ? m_AutoExposureEffect->GetExposure() : 1.0f);
+
+	m_GPUProfiler->BeginFrame();
+	m_GPUProfiler->BeginPass("Frame");
+	m_StreamingBuffer->BeginFrame();
+	m_LightBuffer->BeginFrame();
+	m_ClusterBuffer->BeginFrame();
+	m_ShadowRenderer->BeginFrame();
+	UploadFrameData(p_Packet);
+	unsigned int lightCount = settings.m_UseDeferredShading || settings.m_UseClusteredShading ? UploadLights(p_Packet) : 0;
+	if (settings.m_UseClusteredShading)
+		UploadLightClusters(p_Packet);
+	RecordCommandBuffers(p_Packet, p_JobSystem);
+	m_ShadowRenderer->Prepare(p_Packet, m_NearClippingPlane, p_JobSystem);
+	// Everything this frame reads has been written, so make it visible to the GPU.
+	m_StreamingBuffer->Flush();
+
+	CPU_PROFILE_SCOPE("Submit");
 	for (auto &shader : ResourceManagerInstance.m_Shaders) {
 		shader.second->Use();
-		shader.second->SetMat4("projection", projectionMatrix);
-		shader.second->SetMat4("view", viewMatrix);
-		shader.second->SetMat4("viewWithoutTransform", glm::mat4(glm::mat3(viewMatrix)));
-
-		shader.second->SetVec3("lightPosition", m_LightObject->GetPosition());
-		shader.second->SetVec3("lightColour", m_LightObject->GetColour());
-		shader.second->SetVec3("lightAttenuation", glm::vec3(1.0f, 0.022f, 0.0019f));
-		shader.second->SetFloat("specularExponent", m_UseBlinnPhong ? 16.0f : 8.0f);
+		shader.second->SetVec3("lightPosition", p_Packet.m_Light.m_Position);
+		shader.second->SetVec3("lightColour", p_Packet.m_Light.m_Colour);
+		shader.second->SetVec3("lightAttenuation", p_Packet.m_Light.m_Attenuation);
+		shader.second->SetFloat("specularExponent", settings.m_UseBlinnPhong ? 16.0f : 8.0f);
 		shader.second->SetFloat("surfaceSpecularBrightness", 0.4f);
-		shader.second->SetFloat("ambientStrength", 0.1f);
+		shader.second->SetFloat("environmentIntensity", 0.3f);
+
+		shader.second->SetBool("blinn", settings.m_UseBlinnPhong);
+		shader.second->SetBool("useNormalMap", settings.m_UseNormalMap);
+		shader.second->SetBool("toonShading", settings.m_UseToonShading);
+		shader.second->SetBool("showNormalMap", settings.m_ShowNormalMap);
+		shader.second->SetBool("clusteredLighting", settings.m_UseClusteredShading);
+		shader.second->SetInt("cascadeShadowMap", ShadowRenderer::s_m_CascadeTextureUnit);
+		shader.second->SetInt("pointShadowMap", ShadowRenderer::s_m_PointTextureUnit);
+		shader.second->SetInt("irradianceMap", Skybox::s_m_IrradianceTextureUnit);
+		shader.second->SetInt("prefilteredMap", Skybox::s_m_PrefilteredTextureUnit);
+	}
+
+	{
+		// Drawn into their own framebuffer, before the scene's is bound.
+		GPUProfileScope shadowScope(*m_GPUProfiler, "Shadows");
+		m_GPUProfiler->BeginPass("Cascades");
+		m_ShadowRenderer->RenderCascades();
+		m_GPUProfiler->EndPass();
+		m_GPUProfiler->BeginPass("Point light");
+		m_ShadowRenderer->RenderPointLight();
+		m_GPUProfiler->EndPass();
+	}
+	m_PostProcessor->BeginRender();
+	m_ShadowRenderer->BindTextures();
+	m_Skybox->BindTextures();
+
+	if (settings.m_UseDeferredShading) {
+		// Lay down the lit objects' surfaces, then add up the lights over them. The forward pass still draws everything else.
+		GPUProfileScope deferredScope(*m_GPUProfiler, "Deferred shading");
+		m_GPUProfiler->BeginPass("G-buffer");
+		m_DeferredRenderer->BeginGeometryPass();
+		CommandReplayer::Replay(m_GeometryCommandBuffers);
+		m_DeferredRenderer->EndGeometryPass(m_PostProcessor->GetSceneFrameBuffer());
+		m_GPUProfiler->EndPass();
+
+		m_GPUProfiler->BeginPass("Light volumes");
+		m_DeferredRenderer->RenderLights(lightCount);
+		m_GPUProfiler->EndPass();
 
-		shader.second->SetVec3("viewPosition", m_Camera->m_Position);
-		shader.second->SetBool("blinn", m_UseBlinnPhong);
-		shader.second->SetBool("useNormalMap", m_UseNormalMap);
-		shader.second->SetBool("toonShading", m_UseToonShading);
-		shader.second->SetBool("showNormalMap", m_ShowNormalMap);
+		m_GPUProfiler->BeginPass("Sun");
+		m_DeferredRenderer->RenderSun();
+		m_GPUProfiler->EndPass();
 	}
-	m_LightObject->Render();
-	m_SceneObject->Render();
+	else if (settings.m_UseDepthPrePass) {
+		// Lay down the depth of the opaque geometry first, without any colour writes.
+		GPUProfileScope depthPrePassScope(*m_GPUProfiler, "Depth pre-pass");
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		CommandReplayer::Replay(m_DepthCommandBuffers);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+		// Only the front-most fragment passes, so the lighting is calculated once per pixel.
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+	}
+
+	m_GPUProfiler->BeginPass("Colour pass");
+	CommandReplayer::Replay(m_ColourCommandBuffers);
+	m_GPUProfiler->EndPass();
+
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+
+	m_GPUProfiler->BeginPass("Skybox");
 	m_Skybox->Render();
-	m_PostProcessor->Render();
+	m_GPUProfiler->EndPass();
+	m_GPUProfiler->BeginPass("Post-processing");
+	m_PostProcessor->Render(m_GPUProfiler.get());
+	m_GPUProfiler->EndPass();
+	if (m_FrameCapture) {
+		// Before the overlay, so only the frame itself is captured.
+		GPUProfileScope captureScope(*m_GPUProfiler, "Frame capture");
+		m_FrameCapture->Capture(m_PostProcessor->GetOutputFrameBuffer(), p_Packet.m_Width, p_Packet.m_Height, p_Packet.m_FrameIndex);
+	}
+	m_StreamingBuffer->EndFrame();
+	m_LightBuffer->EndFrame();
+	m_ClusterBuffer->EndFrame();
+	m_ShadowRenderer->EndFrame();
+	m_GPUProfiler->EndPass();
+
+	// Drawn after the frame's own passes, so the overlay doesn't time itself. The text is added first and drawn last, in one draw.
+	m_TextRenderer->SetUseDistanceField(settings.m_UseDistanceFieldText);
+	if (settings.m_ShowGPUProfiler)
+		m_GPUProfiler->RenderOverlay(p_Packet.m_Width, p_Packet.m_Height, settings.m_FrameBudgetMilliseconds, m_TextRenderer.get());
+	if (!p_Packet.m_StatusMessage.empty()) {
+		const unsigned int statusPixelHeight = 24;
+		m_TextRenderer->AddText(p_Packet.m_StatusMessage, glm::vec2(12.0f, p_Packet.m_Height - 12.0f - m_TextRenderer->GetLineHeight(statusPixelHeight)), statusPixelHeight,
+			glm::vec4(1.0f, 1.0f, 1.0f, p_Packet.m_StatusMessageOpacity));
+	}
+	m_TextRenderer->Render(p_Packet.m_Width, p_Packet.m_Height);
+	m_GPUProfiler->EndFrame();
+
+	if (m_RecordFrameStatistics)
+		RecordFrameStatistics(p_Packet, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - renderStart).count());
+
+	m_TimeSinceRenderReport += p_Packet.m_DeltaTime;
+	if (m_TimeSinceRenderReport >= m_TimingReportInterval) {
+		m_TimeSinceRenderReport = 0.0f;
+		ReportRenderTimings(p_Packet);
+	}
+}
+
+void Scene::ReportSimulationTimings() {
+	std::ostringstream report;
+	report << "CPU time (ms), " << m_JobSystem->GetThreadCount() << " threads -";
+	for (TaskHandle i = 0; i < m_FrameGraph->GetTaskCount(); i++)
+		report << " " << m_FrameGraph->GetTaskName(i) << ": " << m_FrameGraph->GetTaskMilliseconds(i) << "\t";
+	if (m_Settings.m_UseClusteredShading)
+		report << "Light cluster indices dropped: " << m_LightClusterBinner->GetDroppedIndexCount();
+	report << "\n";
+	std::cout << report.str() << std::flush;
+}
+
+void Scene::UpdateAntiAliasing(const RenderSettings &p_Settings) {
+	// The G-buffer's depth can't be blitted into a multisampled target, so MSAA only applies to forward shading.
+	bool useMSAA = p_Settings.m_AntiAliasing == AntiAliasingMode::MSAA && !p_Settings.m_UseDeferredShading;
+	m_PostProcessor->SetSampleCount(useMSAA ? s_m_MSAASampleCount : 0);
+	m_FXAAEffect->SetEnabled(p_Settings.m_AntiAliasing == AntiAliasingMode::FXAA);
+	m_SMAAEffect->SetEnabled(p_Settings.m_AntiAliasing == AntiAliasingMode::SMAA);
+
+	// Compared by the whole frame, as MSAA's cost is spread over every pass that draws into the scene.
+	if (p_Settings.m_AntiAliasing != m_MeasuredAntiAliasing) {
+		m_MeasuredAntiAliasing = p_Settings.m_AntiAliasing;
+		m_FramesInAntiAliasingMode = 0;
+		return;
+	}
+	m_FramesInAntiAliasingMode++;
+	const GPUPassTiming *frameTiming = m_GPUProfiler->GetPassTiming("Frame");
+	if (m_FramesInAntiAliasingMode > s_m_AntiAliasingSettleFrames && frameTiming && frameTiming->m_WasRecorded) {
+		float &milliseconds = m_AntiAliasingMilliseconds[static_cast<size_t>(m_MeasuredAntiAliasing)];
+		milliseconds = milliseconds == 0.0f ? frameTiming->m_ElapsedMilliseconds : milliseconds + (frameTiming->m_ElapsedMilliseconds - milliseconds) * 0.1f;
+	}
+}
+
+void Scene::ReportRenderTimings(const FramePacket &p_Packet) {
+	// Built up front, so it isn't interleaved with the simulation thread's output.
+	std::ostringstream report;
+	report << "\nGPU time (ms) -";
+	for (const GPUPassTiming &timing : m_GPUProfiler->GetPassTimings()) {
+		if (timing.m_WasRecorded)
+			report << " " << std::string(timing.m_Depth, '>') << (timing.m_Depth > 0 ? " " : "") << timing.m_Name << ": " << timing.m_AverageMilliseconds << "\t";
+	}
+	report << "Late results dropped: " << m_GPUProfiler->GetDroppedFrameCount() << "\n";
+	report << "Streaming buffer - CPU stalls: " << m_StreamingBuffer->GetStallCount() << " (" << m_StreamingBuffer->GetStallMilliseconds() << " ms)"
+		<< "\tFailed allocations: " << m_StreamingBuffer->GetFailedAllocationCount() << "\n";
+
+	unsigned int commandCount = 0;
+	unsigned int drawCount = 0;
+	unsigned int droppedCommandCount = 0;
+	for (size_t i = 0; i < m_ColourCommandBuffers.size(); i++) {
+		for (const CommandBuffer *commandBuffer : { &m_DepthCommandBuffers[i], &m_ColourCommandBuffers[i], &m_GeometryCommandBuffers[i] }) {
+			commandCount += static_cast<unsigned int>(commandBuffer->GetCommands().size());
+			drawCount += commandBuffer->GetDrawCount();
+			droppedCommandCount += commandBuffer->GetDroppedCommandCount();
+		}
+	}
+	report << "Command buffers - Slices: " << m_ColourCommandBuffers.size() << "\tCommands: " << commandCount
+		<< "\tDraws: " << drawCount << "\tRedundant state changes dropped: " << droppedCommandCount << "\n";
+	const RenderTargetPool &targetPool = m_PostProcessor->GetTargetPool();
+	report << "Post-processing - Passes: " << m_PostProcessor->GetGraph().GetPassCount() << "\tCulled: " << m_PostProcessor->GetGraph().GetCulledPassCount()
+		<< "\tTargets: " << targetPool.GetTargetCount() << " (" << targetPool.GetAllocatedBytes() / (1024.0f * 1024.0f) << " MB)\tCreated: " << targetPool.GetCreatedTargetCount()
+		<< "\tFused programs: " << m_PostProcessor->GetFuser().GetProgramCount() << "\n";
+	// The passes each mode adds, and the frame time measured in every mode used so far.
+	static const std::array<std::vector<const char*>, static_cast<size_t>(AntiAliasingMode::COUNT)> s_AntiAliasingPasses = { {
+		{}, { "MSAA resolve" }, { "FXAA" }, { "SMAA edges", "SMAA weights", "SMAA blending" }
+	} };
+	float passMilliseconds = 0.0f;
+	for (const char *passName : s_AntiAliasingPasses[static_cast<size_t>(p_Packet.m_Settings.m_AntiAliasing)]) {
+		const GPUPassTiming *timing = m_GPUProfiler->GetPassTiming(passName);
+		if (timing && timing->m_WasRecorded)
+			passMilliseconds += timing->m_AverageMilliseconds;
+	}
+	report << "Anti-aliasing - Mode: " << GetAntiAliasingModeName(p_Packet.m_Settings.m_AntiAliasing);
+	if (p_Packet.m_Settings.m_AntiAliasing == AntiAliasingMode::MSAA && m_PostProcessor->GetSampleCount() == 0)
+		report << " (off with deferred shading)";
+	report << "\tPasses: " << passMilliseconds << " ms\tFrame by mode (ms) -";
+	for (size_t i = 0; i < m_AntiAliasingMilliseconds.size(); i++) {
+		if (m_AntiAliasingMilliseconds[i] > 0.0f)
+			report << " " << GetAntiAliasingModeName(static_cast<AntiAliasingMode>(i)) << ": " << m_AntiAliasingMilliseconds[i];
+	}
+	report << "\n";
+	if (p_Packet.m_Settings.m_UseBloom || m_AutoExposureEffect->IsEnabled()) {
+		// The bloom's chain is as long as the render size allows, so its passes are summed by name.
+		float bloomMilliseconds = 0.0f;
+		for (const GPUPassTiming &timing : m_GPUProfiler->GetPassTimings()) {
+			if (timing.m_WasRecorded && timing.m_Name.compare(0, 6, "Bloom ") == 0)
+				bloomMilliseconds += timing.m_AverageMilliseconds;
+		}
+		const GPUPassTiming *histogramTiming = m_GPUProfiler->GetPassTiming("Luminance histogram");
+		report << "HDR - Bloom chain: " << bloomMilliseconds << " ms\tHistogram: " << (histogramTiming && histogramTiming->m_WasRecorded ? histogramTiming->m_AverageMilliseconds : 0.0f)
+			<< " ms\tExposure: " << m_AutoExposureEffect->GetExposure() << " (target " << m_AutoExposureEffect->GetTargetExposure()
+			<< ")\tHistograms skipped: " << m_AutoExposureEffect->GetSkippedFrameCount() << "\n";
+	}
+	if (p_Packet.m_Settings.m_UseDynamicResolution) {
+		report << "Dynamic resolution - Scale: " << m_PostProcessor->GetRenderScale() << " (" << m_PostProcessor->GetRenderWidth() << "x" << m_PostProcessor->GetRenderHeight()
+			<< ")\tBudget: " << m_ResolutionController->GetBudget() << " ms\tChanges: " << m_ResolutionController->GetChangeCount() << "\n";
+	}
+	if (p_Packet.m_Settings.m_UseShadows) {
+		report << "Shadows - Cache redraws: " << m_ShadowRenderer->GetCacheRedrawCount() << "\tStatic draws: " << m_ShadowRenderer->GetStaticDrawCount()
+			<< "\tMoving draws: " << m_ShadowRenderer->GetMovingDrawCount() << "\tFailed allocations: " << m_ShadowRenderer->GetFailedAllocationCount() << "\n";
+	}
+	if (m_TextRenderer->GetLastDrawCharacterCount() > 0) {
+		const GlyphAtlas &atlas = m_TextRenderer->IsUsingDistanceField() ? m_TextRenderer->GetDistanceFieldAtlas() : m_TextRenderer->GetBitmapAtlas();
+		report << "Text - Characters: " << m_TextRenderer->GetLastDrawCharacterCount() << "\tGlyphs: " << atlas.GetGlyphCount() << "\tAtlas: " << atlas.GetOccupancy() * 100.0f
+			<< "% full, " << atlas.GetShelfCount() << " shelves\tDropped characters: " << m_TextRenderer->GetDroppedCharacterCount() << "\n";
+	}
+	std::cout << report.str() << std::flush;
+}
+
+void Scene::RecordFrameStatistics(const FramePacket &p_Packet, float p_RenderMilliseconds) {
+	FrameStatistics statistics;
+	statistics.m_FrameIndex = p_Packet.m_FrameIndex;
+	statistics.m_RenderMilliseconds = p_RenderMilliseconds;
+	const GPUPassTiming *frameTiming = m_GPUProfiler->GetPassTiming("Frame");
+	statistics.m_GPUMilliseconds = frameTiming ? frameTiming->m_ElapsedMilliseconds : 0.0f;
+	statistics.m_RenderScale = m_PostProcessor->GetRenderScale();
+	statistics.m_VisibleObjectCount = static_cast<unsigned int>(p_Packet.m_DrawPackets.size());
+
+	for (size_t i = 0; i < m_ColourCommandBuffers.size(); i++) {
+		for (const CommandBuffer *commandBuffer : { &m_DepthCommandBuffers[i], &m_ColourCommandBuffers[i], &m_GeometryCommandBuffers[i] }) {
+			statistics.m_DrawCount += commandBuffer->GetDrawCount();
+			statistics.m_TriangleCount += commandBuffer->GetIndexCount() / 3;
+			statistics.m_ProgramChangeCount += commandBuffer->GetCommandCount(CommandType::BIND_PROGRAM);
+			statistics.m_MaterialChangeCount += commandBuffer->GetCommandCount(CommandType::BIND_MATERIAL);
+			statistics.m_ObjectDataChangeCount += commandBuffer->GetCommandCount(CommandType::BIND_OBJECT_DATA);
+		}
+	}
+
+	m_FrameStatistics.push_back(statistics);
+}
+
+JobSystem &Scene::GetJobSystem() {
+	return *m_JobSystem;
+}
+
+void Scene::SetCommandBufferValidation(bool p_IsEnabled) {
+	m_ValidateCommandBuffers = p_IsEnabled;
+}
+
+std::shared_ptr<Camera> Scene::GetCamera() {
+	return m_Camera;
+}
+
+RenderSettings &Scene::GetRenderSettings() {
+	return m_Settings;
+}
+
+void Scene::SetLightAttenuation(Entity p_LightEntity, const glm::vec3 &p_Attenuation) {
+	LightComponent *light = m_Entities->GetComponent<LightComponent>(p_LightEntity);
+	if (light)
+		light->m_Attenuation = p_Attenuation;
+}
+
+void Scene::SetSun(const glm::vec3 &p_Direction, const glm::vec3 &p_Colour) {
+	m_Sun.m_Direction = glm::normalize(p_Direction);
+	m_Sun.m_Colour = p_Colour;
+}
+
+void Scene::SetShadowCasterStatic(Entity p_Entity, bool p_IsStatic) {
+	ShadowCasterComponent *shadowCaster = m_Entities->GetComponent<ShadowCasterComponent>(p_Entity);
+	if (shadowCaster && shadowCaster->m_IsStatic != p_IsStatic) {
+		// Moving between the caches and the moving casters redraws the caches it was, or will be, in.
+		shadowCaster->m_IsStatic = p_IsStatic;
+		shadowCaster->m_HasMoved = true;
+	}
+}
+
+void Scene::SetFrameStatisticsRecording(bool p_IsEnabled) {
+	m_RecordFrameStatistics = p_IsEnabled;
+}
+
+const std::vector<FrameStatistics> &Scene::GetFrameStatistics() const {
+	return m_FrameStatistics;
+}
+
+const GPUProfiler &Scene::GetGPUProfiler() const {
+	return *m_GPUProfiler;
+}
+
+void Scene::StartFrameCapture(CaptureFormat p_Format, const std::string &p_OutputPath) {
+	m_FrameCapture = std::make_shared<FrameCapture>(m_Window->Width(), m_Window->Height(), p_Format, p_OutputPath);
 }
 
 bool Scene::IsRunning() const {
@@ -7,11 +7,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "CPUProfiler.h"
+
 Shader::Shader() : m_ID(999999) {
 
 }
 
 bool Shader::Compile(const GLchar *p_VertexPath, const GLchar *p_FragmentPath, const GLchar *p_GeometryPath) {
+	CPU_PROFILE_FUNCTION();
 	GLuint sVertex;
 	GLuint sFragment;
 	GLuint gShader;
@@ -44,6 +47,27 @@ bool Shader::Compile(const GLchar *p_VertexPath, const GLchar *p_FragmentPath, c
 	return successful;
 }
 
+bool Shader::CompileCompute(const GLchar *p_ComputePath) {
+	CPU_PROFILE_FUNCTION();
+	GLuint sCompute;
+
+	// Compute Shader:
+	CreateShader(sCompute, GL_COMPUTE_SHADER, p_ComputePath, "COMPUTE");
+
+	// Shader Program:
+	m_ID = glCreateProgram();
+	glAttachShader(m_ID, sCompute);
+
+	glLinkProgram(m_ID);
+	bool successful = CheckErrors(m_ID, "PROGRAM");
+
+	// Clean up:
+	glDeleteShader(sCompute);
+
+	std::cout << "\n\n";
+	return successful;
+}
+
 bool Shader::CreateShader(GLuint &p_ShaderID, const GLenum &p_ShaderType, const GLchar *p_ShaderSource, const std::string &p_TypeInformation) {
 	std::cout << "\nSHADER SOURCE CODE:" << p_ShaderType << "	" << "SHADER TYPE: " << p_TypeInformation << "\n" << p_ShaderSource << "\n";
 
@@ -0,0 +1,385 @@
+#include "ShadowRenderer.h"
+
+#include <iostream>
+#include <string>
+
+#include <glad/glad.h>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "CommandReplayer.h"
+#include "CPUProfiler.h"
+#include "FramePacket.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "Model.h"
+#include "ResourceManager.h"
+#include "Shader.h"
+#include "UniformBlocks.h"
+
+const float ShadowRenderer::s_m_MinShadowDistance = 10.0f;
+const float ShadowRenderer::s_m_MaxShadowDistance = 100.0f;
+const float ShadowRenderer::s_m_SplitBlend = 0.75f;
+const float ShadowRenderer::s_m_CacheMargin = 0.25f;
+const float ShadowRenderer::s_m_SlopeBias = 2.0f;
+const float ShadowRenderer::s_m_ConstantBias = 4.0f;
+const float ShadowRenderer::s_m_PointNearPlane = 0.1f;
+const float ShadowRenderer::s_m_MaxPointShadowDistance = 60.0f;
+
+static_assert(ShadowRenderer::s_m_CascadeCount == 4, "The shadow data holds four cascades.");
+
+ShadowRenderer::ShadowRenderer() {
+	m_CascadeShader = ResourceManagerInstance.GetShader("shadowDepth");
+	m_PointShader = ResourceManagerInstance.GetShader("pointShadow");
+	m_ObjectBuffer = std::make_shared<StreamingBuffer>(GL_UNIFORM_BUFFER, s_m_MaxDrawsPerFrame * 256);
+	m_CascadeSplits.fill(0.0f);
+	m_FaceViewProjections.fill(glm::mat4(1.0f));
+
+	CreateTextures();
+}
+
+ShadowRenderer::~ShadowRenderer() {
+	glDeleteFramebuffers(1, &m_FrameBufferObject);
+	const unsigned int textures[] = { m_CascadeTexture, m_CascadeCacheTexture, m_PointTexture, m_PointCacheTexture };
+	glDeleteTextures(4, textures);
+}
+
+void ShadowRenderer::CreateTextures() {
+	auto createTexture = [](GLenum p_Target, int p_Resolution, int p_LayerCount, bool p_IsRead) {
+		unsigned int textureID;
+		glGenTextures(1, &textureID);
+		glBindTexture(p_Target, textureID);
+		if (p_Target == GL_TEXTURE_CUBE_MAP)
+			glTexStorage2D(p_Target, 1, GL_DEPTH_COMPONENT24, p_Resolution, p_Resolution);
+		else
+			glTexStorage3D(p_Target, 1, GL_DEPTH_COMPONENT24, p_Resolution, p_Resolution, p_LayerCount);
+
+		if (p_IsRead) {
+			// Compared in the sampler, and filtered between the four nearest results.
+			glTexParameteri(p_Target, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+			glTexParameteri(p_Target, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+			glTexParameteri(p_Target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(p_Target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+		else {
+			glTexParameteri(p_Target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(p_Target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		}
+		if (p_Target == GL_TEXTURE_CUBE_MAP) {
+			glTexParameteri(p_Target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(p_Target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(p_Target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		}
+		else {
+			// Anything outside a cascade is lit.
+			const float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			glTexParameteri(p_Target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+			glTexParameteri(p_Target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+			glTexParameterfv(p_Target, GL_TEXTURE_BORDER_COLOR, border);
+		}
+		glBindTexture(p_Target, 0);
+		return textureID;
+	};
+	m_CascadeTexture = createTexture(GL_TEXTURE_2D_ARRAY, s_m_CascadeResolution, s_m_CascadeCount, true);
+	m_CascadeCacheTexture = createTexture(GL_TEXTURE_2D_ARRAY, s_m_CascadeResolution, s_m_CascadeCount, false);
+	m_PointTexture = createTexture(GL_TEXTURE_CUBE_MAP, s_m_PointResolution, 6, true);
+	m_PointCacheTexture = createTexture(GL_TEXTURE_CUBE_MAP, s_m_PointResolution, 6, false);
+
+	glGenFramebuffers(1, &m_FrameBufferObject);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_CascadeTexture, 0, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::SHADOW_RENDERER:: The shadow framebuffer is not complete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowRenderer::BeginFrame() {
+	m_ObjectBuffer->BeginFrame();
+}
+
+void ShadowRenderer::EndFrame() {
+	m_ObjectBuffer->EndFrame();
+}
+
+void ShadowRenderer::FitCascades(const FramePacket &p_Packet, float p_NearPlane) {
+	// The sun's space only depends on the sun, so the caches survive the camera turning.
+	glm::vec3 sunDirection = glm::normalize(p_Packet.m_Sun.m_Direction);
+	if (sunDirection != m_SunDirection) {
+		m_SunDirection = sunDirection;
+		glm::vec3 up = glm::abs(sunDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		m_LightRotation = glm::lookAt(glm::vec3(0.0f), sunDirection, up);
+		for (unsigned int cascade = 0; cascade < s_m_CascadeCount; cascade++)
+			m_Views[cascade].m_IsCacheValid = false;
+	}
+
+	// Only as far as the furthest visible receiver, rounded up to a quarter of an octave, so the cascades keep their size while it wobbles.
+	float shadowDistance = glm::clamp(p_Packet.m_ShadowReceiverDepth, s_m_MinShadowDistance, s_m_MaxShadowDistance);
+	shadowDistance = glm::min(glm::exp2(glm::ceil(glm::log2(shadowDistance) * 4.0f) / 4.0f), s_m_MaxShadowDistance);
+
+	glm::mat4 inverseView = glm::inverse(p_Packet.m_ViewMatrix);
+	glm::vec3 cameraPosition = glm::vec3(inverseView[3]);
+	glm::vec3 cameraForward = -glm::normalize(glm::vec3(inverseView[2]));
+	// How far the frustum's corners are from its axis, squared, per unit of depth.
+	float cornerSlopeSquared = 1.0f / (p_Packet.m_ProjectionMatrix[0][0] * p_Packet.m_ProjectionMatrix[0][0]) + 1.0f / (p_Packet.m_ProjectionMatrix[1][1] * p_Packet.m_ProjectionMatrix[1][1]);
+
+	float sliceNear = p_NearPlane;
+	for (unsigned int cascade = 0; cascade < s_m_CascadeCount; cascade++) {
+		float fraction = static_cast<float>(cascade + 1) / s_m_CascadeCount;
+		float uniformSplit = p_NearPlane + (shadowDistance - p_NearPlane) * fraction;
+		float logarithmicSplit = p_NearPlane * glm::pow(shadowDistance / p_NearPlane, fraction);
+		float sliceFar = glm::mix(uniformSplit, logarithmicSplit, s_m_SplitBlend);
+		m_CascadeSplits[cascade] = sliceFar;
+
+		// The smallest sphere around the slice, which only depends on its depths. Rounded up, so it keeps its size as they wobble.
+		float centreDepth = glm::min((sliceFar + sliceNear) * (1.0f + cornerSlopeSquared) * 0.5f, sliceFar);
+		float radius = glm::sqrt((sliceFar - centreDepth) * (sliceFar - centreDepth) + sliceFar * sliceFar * cornerSlopeSquared);
+		radius = glm::ceil(radius * 16.0f) / 16.0f;
+		sliceNear = sliceFar;
+
+		// Keep the window while the sphere is still inside it. Otherwise centre it on the sphere, snapped to whole texels,
+		// so the casters land on the same texels wherever it goes and the shadows' edges don't crawl.
+		glm::vec3 centre = glm::vec3(m_LightRotation * glm::vec4(cameraPosition + cameraForward * centreDepth, 1.0f));
+		CascadeWindow &window = m_CascadeWindows[cascade];
+		float halfSize = radius * (1.0f + s_m_CacheMargin);
+		bool isInside = window.m_HalfSize == halfSize && glm::all(glm::lessThanEqual(glm::abs(glm::vec2(centre) - window.m_Centre) + radius, glm::vec2(halfSize)))
+			&& centre.z - radius >= window.m_Bottom && centre.z + radius <= window.m_Top;
+		if (!isInside) {
+			float texelSize = 2.0f * halfSize / s_m_CascadeResolution;
+			window.m_HalfSize = halfSize;
+			window.m_Centre = glm::floor(glm::vec2(centre) / texelSize + 0.5f) * texelSize;
+			window.m_Bottom = centre.z - halfSize;
+			window.m_Top = centre.z + halfSize;
+			m_Views[cascade].m_IsCacheValid = false;
+		}
+
+		// The view looks down negative z, so the depth nearest the sun is the near plane.
+		glm::mat4 projection = glm::ortho(window.m_Centre.x - window.m_HalfSize, window.m_Centre.x + window.m_HalfSize,
+			window.m_Centre.y - window.m_HalfSize, window.m_Centre.y + window.m_HalfSize, -window.m_Top, -window.m_Bottom);
+		m_Views[cascade].m_ViewProjection = projection * m_LightRotation;
+		m_Views[cascade].m_IsActive = true;
+	}
+}
+
+void ShadowRenderer::FitPointLight(const FramePacket &p_Packet) {
+	// Only the forward path lights with the scene's light, clustered and deferred shading light with the light list instead.
+	const FrameLight &light = p_Packet.m_Light;
+	ShadowView &view = m_Views[s_m_PointView];
+	float farPlane = glm::min(light.m_Radius, s_m_MaxPointShadowDistance);
+	view.m_IsActive = !p_Packet.m_Settings.m_UseDeferredShading && !p_Packet.m_Settings.m_UseClusteredShading && farPlane > s_m_PointNearPlane;
+	if (!view.m_IsActive) {
+		view.m_IsCacheValid = false;
+		return;
+	}
+
+	glm::vec4 positionFar(light.m_Position, farPlane);
+	if (positionFar == m_PointPositionFar && view.m_IsCacheValid)
+		return;
+
+	m_PointPositionFar = positionFar;
+	view.m_IsCacheValid = false;
+	// The faces in the order, and orientation, cube maps are laid out in.
+	static const glm::vec3 s_Directions[6] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f) };
+	static const glm::vec3 s_Ups[6] = { glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f) };
+	glm::mat4 projection = glm::perspective(glm::half_pi<float>(), 1.0f, s_m_PointNearPlane, farPlane);
+	for (int face = 0; face < 6; face++)
+		m_FaceViewProjections[face] = projection * glm::lookAt(light.m_Position, light.m_Position + s_Directions[face], s_Ups[face]);
+}
+
+bool ShadowRenderer::Overlaps(unsigned int p_View, const glm::vec4 &p_Bounds) const {
+	float radius = p_Bounds.w;
+	if (p_View == s_m_PointView)
+		return glm::distance(glm::vec3(p_Bounds), glm::vec3(m_PointPositionFar)) < m_PointPositionFar.w + radius;
+
+	// Anything across the window, from the sun down to the far side of the receivers, can cast into it.
+	const CascadeWindow &window = m_CascadeWindows[p_View];
+	glm::vec3 position = glm::vec3(m_LightRotation * glm::vec4(glm::vec3(p_Bounds), 1.0f));
+	return glm::abs(position.x - window.m_Centre.x) <= window.m_HalfSize + radius && glm::abs(position.y - window.m_Centre.y) <= window.m_HalfSize + radius
+		&& position.z + radius >= window.m_Bottom;
+}
+
+bool ShadowRenderer::RecordCaster(CommandBuffer &p_Commands, const ShadowCaster &p_Caster, unsigned int p_Program) {
+	// Meshes share the caster's data, unless the model's nodes move them relative to each other.
+	const Model &model = *p_Caster.m_Model;
+	StreamingBuffer::Allocation objectData;
+	bool isComplete = true;
+	p_Commands.BindProgram(p_Program);
+	for (size_t i = 0; i < model.GetMeshCount(); i++) {
+		if (i == 0 || model.HasNodeTransforms()) {
+			objectData = m_ObjectBuffer->AllocateForBinding(sizeof(ObjectUniformData));
+			if (objectData.IsValid())
+				static_cast<ObjectUniformData*>(objectData.m_Data)->m_Model = model.HasNodeTransforms() ? p_Caster.m_WorldMatrix * model.GetMeshTransform(i) : p_Caster.m_WorldMatrix;
+		}
+		if (!objectData.IsValid()) {
+			isComplete = false;
+			continue;
+		}
+
+		const Mesh &mesh = model.GetMesh(i);
+		p_Commands.BindObjectData(objectData.m_Buffer, objectData.m_Offset, objectData.m_Size);
+		p_Commands.DrawIndexed(mesh.GetPositionOnlyVertexArray(), mesh.GetIndexCount());
+	}
+
+	return isComplete;
+}
+
+void ShadowRenderer::RecordView(unsigned int p_View, const FramePacket &p_Packet) {
+	ShadowView &view = m_Views[p_View];
+	view.m_StaticCommands.Reset();
+	view.m_MovingCommands.Reset();
+	view.m_IsCacheComplete = true;
+	if (!view.m_IsActive)
+		return;
+
+	// A static caster moving into, or out of, the map means its cache has to be redrawn.
+	for (const glm::vec4 &bounds : p_Packet.m_MovedStaticCasterBounds) {
+		if (!view.m_IsCacheValid)
+			break;
+		if (Overlaps(p_View, bounds))
+			view.m_IsCacheValid = false;
+	}
+
+	unsigned int program = p_View == s_m_PointView ? m_PointShader->GetID() : m_CascadeShader->GetID();
+	for (const ShadowCaster &caster : p_Packet.m_ShadowCasters) {
+		if (caster.m_IsStatic && view.m_IsCacheValid)
+			continue;
+		if (!Overlaps(p_View, caster.m_Bounds))
+			continue;
+
+		if (caster.m_IsStatic)
+			view.m_IsCacheComplete &= RecordCaster(view.m_StaticCommands, caster, program);
+		else
+			RecordCaster(view.m_MovingCommands, caster, program);
+	}
+}
+
+void ShadowRenderer::Prepare(const FramePacket &p_Packet, float p_NearPlane, JobSystem &p_JobSystem) {
+	CPU_PROFILE_FUNCTION();
+	if (p_Packet.m_Settings.m_UseShadows) {
+		FitCascades(p_Packet, p_NearPlane);
+		FitPointLight(p_Packet);
+		p_JobSystem.ParallelFor(s_m_ViewCount, 1, [this, &p_Packet](size_t p_FirstView, size_t p_LastView) {
+			for (size_t view = p_FirstView; view < p_LastView; view++)
+				RecordView(static_cast<unsigned int>(view), p_Packet);
+		});
+	}
+	else {
+		// Casters can move while the shadows are off without the caches hearing of it, so they start again once they're back on.
+		for (ShadowView &view : m_Views) {
+			view.m_IsActive = false;
+			view.m_IsCacheValid = false;
+			view.m_StaticCommands.Reset();
+			view.m_MovingCommands.Reset();
+		}
+	}
+
+	m_StaticDrawCount = 0;
+	m_MovingDrawCount = 0;
+	for (const ShadowView &view : m_Views) {
+		m_StaticDrawCount += view.m_StaticCommands.GetDrawCount();
+		m_MovingDrawCount += view.m_MovingCommands.GetDrawCount();
+	}
+
+	// Bound whether or not there are shadows, as the shaders still read the flags.
+	StreamingBuffer::Allocation shadowAllocation = m_ObjectBuffer->AllocateForBinding(sizeof(ShadowUniformData));
+	if (shadowAllocation.IsValid()) {
+		ShadowUniformData *shadowData = static_cast<ShadowUniformData*>(shadowAllocation.m_Data);
+		for (unsigned int cascade = 0; cascade < s_m_CascadeCount; cascade++) {
+			shadowData->m_CascadeViewProjections[cascade] = m_Views[cascade].m_ViewProjection;
+			shadowData->m_CascadeSplits[cascade] = m_CascadeSplits[cascade];
+			shadowData->m_CascadeTexelSizes[cascade] = 2.0f * m_CascadeWindows[cascade].m_HalfSize / s_m_CascadeResolution;
+		}
+		shadowData->m_PointShadowPositionFar = m_PointPositionFar;
+		shadowData->m_ShadowFlags = glm::uvec4(m_Views[0].m_IsActive ? 1 : 0, m_Views[s_m_PointView].m_IsActive ? 1 : 0, 0, 0);
+	}
+	m_ObjectBuffer->Flush();
+	if (shadowAllocation.IsValid())
+		glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBlockBinding::SHADOW_DATA), shadowAllocation.m_Buffer, shadowAllocation.m_Offset, shadowAllocation.m_Size);
+}
+
+void ShadowRenderer::RenderView(ShadowView &p_View, unsigned int p_Target, unsigned int p_CacheTexture, unsigned int p_Texture, int p_Layer, int p_LayerCount, int p_Resolution) {
+	auto attach = [p_Target, p_Layer](unsigned int p_AttachedTexture) {
+		if (p_Target == GL_TEXTURE_CUBE_MAP)
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, p_AttachedTexture, 0);
+		else
+			glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, p_AttachedTexture, 0, p_Layer);
+	};
+
+	// The map only differs from the cache when moving casters were drawn over it, or the cache has changed.
+	bool needsCopy = p_View.m_HasMovingCasters;
+	if (!p_View.m_IsCacheValid) {
+		attach(p_CacheTexture);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		CommandReplayer::Replay(p_View.m_StaticCommands);
+		// If some casters didn't fit this frame, try again next frame.
+		p_View.m_IsCacheValid = p_View.m_IsCacheComplete;
+		m_CacheRedrawCount++;
+		needsCopy = true;
+	}
+	if (needsCopy)
+		glCopyImageSubData(p_CacheTexture, p_Target, 0, 0, 0, p_Layer, p_Texture, p_Target, 0, 0, 0, p_Layer, p_Resolution, p_Resolution, p_LayerCount);
+
+	p_View.m_HasMovingCasters = p_View.m_MovingCommands.GetDrawCount() > 0;
+	if (p_View.m_HasMovingCasters) {
+		attach(p_Texture);
+		CommandReplayer::Replay(p_View.m_MovingCommands);
+	}
+}
+
+void ShadowRenderer::RenderCascades() {
+	if (!m_Views[0].m_IsActive)
+		return;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	glViewport(0, 0, s_m_CascadeResolution, s_m_CascadeResolution);
+	// Casters nearer the sun than the window are flattened onto its near plane, rather than clipped away.
+	glEnable(GL_DEPTH_CLAMP);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(s_m_SlopeBias, s_m_ConstantBias);
+	// Both sides are drawn, as not every model is closed.
+	glDisable(GL_CULL_FACE);
+
+	m_CascadeShader->Use();
+	for (unsigned int cascade = 0; cascade < s_m_CascadeCount; cascade++) {
+		m_CascadeShader->SetMat4("lightViewProjection", m_Views[cascade].m_ViewProjection);
+		RenderView(m_Views[cascade], GL_TEXTURE_2D_ARRAY, m_CascadeCacheTexture, m_CascadeTexture, cascade, 1, s_m_CascadeResolution);
+	}
+	glBindVertexArray(0);
+
+	glEnable(GL_CULL_FACE);
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glDisable(GL_DEPTH_CLAMP);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowRenderer::RenderPointLight() {
+	ShadowView &view = m_Views[s_m_PointView];
+	if (!view.m_IsActive)
+		return;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FrameBufferObject);
+	glViewport(0, 0, s_m_PointResolution, s_m_PointResolution);
+	glDisable(GL_CULL_FACE);
+
+	m_PointShader->Use();
+	for (int face = 0; face < 6; face++)
+		m_PointShader->SetMat4("faceViewProjections[" + std::to_string(face) + "]", m_FaceViewProjections[face]);
+	m_PointShader->SetVec3("shadowLightPosition", glm::vec3(m_PointPositionFar));
+	m_PointShader->SetFloat("shadowFarPlane", m_PointPositionFar.w);
+	RenderView(view, GL_TEXTURE_CUBE_MAP, m_PointCacheTexture, m_PointTexture, 0, 6, s_m_PointResolution);
+	glBindVertexArray(0);
+
+	glEnable(GL_CULL_FACE);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowRenderer::BindTextures() const {
+	glActiveTexture(GL_TEXTURE0 + s_m_CascadeTextureUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_CascadeTexture);
+	glActiveTexture(GL_TEXTURE0 + s_m_PointTextureUnit);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, m_PointTexture);
+	glActiveTexture(GL_TEXTURE0);
+}
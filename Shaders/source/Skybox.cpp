@@ -1,5 +1,6 @@
 #include "Skybox.h"
 
+#include <iostream>
 #include <vector>
 
 #include "GLAD/glad.h"
@@ -7,63 +8,17 @@
 #include "ResourceManager.h"
 #include "Shader.h"
 
-const float Skybox::m_SkyboxSize(55.0f);
-
-Skybox::Skybox() : m_SkyboxVertices{
-	// Vertices' positions.
-	-m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-
-	-m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-	-m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	-m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-
-	m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-
-	-m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-	-m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-
-	-m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize,  m_SkyboxSize,
-	-m_SkyboxSize,  m_SkyboxSize, -m_SkyboxSize,
-
-	-m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize, -m_SkyboxSize,
-	-m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize,
-	m_SkyboxSize, -m_SkyboxSize,  m_SkyboxSize } {
-	m_Shader = ResourceManagerInstance.GetShader("skybox");
-	Prepare();
+const std::string Skybox::s_m_CachePath("cache/environment.ibl");
+
+// Uploads one level of a cube map, whose storage has already been allocated.
+static void UploadCubeMapLevel(const CubeMapImage &p_Image, int p_Level) {
+	for (int face = 0; face < 6; face++)
+		glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, p_Level, 0, 0, p_Image.m_Size, p_Image.m_Size, GL_RGB, GL_FLOAT, &p_Image.At(face, 0, 0));
 }
 
-void Skybox::Prepare() {
-	glGenVertexArrays(1, &m_SkyBoxVAO);
-	glGenBuffers(1, &m_SkyBoxVBO);
-	glBindVertexArray(m_SkyBoxVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_SkyBoxVBO);
-	glBufferData(GL_ARRAY_BUFFER, Skybox::m_SkyboxNumberOfVertices * sizeof(GLfloat), &m_SkyboxVertices, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GL_FLOAT), (GLvoid*)0);
+Skybox::Skybox(JobSystem &p_JobSystem) {
+	m_Shader = ResourceManagerInstance.GetShader("skybox");
+	glGenVertexArrays(1, &m_EmptyVertexArrayObject);
 
 	// Add the faces to a vector, so they can be passed and processed.
 	std::vector<std::string> skyboxFaces;
@@ -76,16 +31,89 @@ void Skybox::Prepare() {
 
 	// Process the faces - creating the cubemap.
 	m_CubeMapTextureID = ResourceManager::LoadOpenGLCubemapTexture(skyboxFaces);
+	// The prefiltered map's small levels would show their faces' edges, without filtering across them.
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	unsigned long long cacheKey = EnvironmentBaker::GetCacheKey(skyboxFaces);
+	if (!m_Baker.Load(s_m_CachePath, cacheKey)) {
+		CubeMapImage sky = ReadBackSky();
+		// A sky that didn't load isn't cached, so the bake is redone once it's there.
+		m_Baker.Bake(p_JobSystem, sky, sky.m_Size > 1 ? s_m_CachePath : std::string(), cacheKey);
+	}
+	std::cout << "\nEnvironment lighting - " << (m_Baker.WasCached() ? "Read from the cache" : "Baked") << " in " << m_Baker.GetBakeMilliseconds() << " ms" << std::endl;
+	CreateEnvironmentTextures();
+}
+
+Skybox::~Skybox() {
+	glDeleteTextures(1, &m_CubeMapTextureID);
+	glDeleteTextures(1, &m_IrradianceTextureID);
+	glDeleteTextures(1, &m_PrefilteredTextureID);
+	glDeleteVertexArrays(1, &m_EmptyVertexArrayObject);
+}
+
+CubeMapImage Skybox::ReadBackSky() const {
+	CubeMapImage sky;
+	glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubeMapTextureID);
+	glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, GL_TEXTURE_WIDTH, &sky.m_Size);
+	if (sky.m_Size == 0) {
+		// The colour the scene is cleared to, so the ambient light matches what's shown.
+		sky.m_Size = 1;
+		sky.m_Texels.assign(6, glm::vec3(0.25f));
+		return sky;
+	}
+
+	sky.m_Texels.resize(static_cast<size_t>(6) * sky.m_Size * sky.m_Size);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	for (int face = 0; face < 6; face++)
+		glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB, GL_FLOAT, &sky.At(face, 0, 0));
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	return sky;
+}
+
+void Skybox::CreateEnvironmentTextures() {
+	// Floating point, like the scene's target, so a sky brighter than white stays brighter.
+	CubeMapImage irradiance = m_Baker.EvaluateIrradiance(EnvironmentBaker::s_m_IrradianceSize);
+	glGenTextures(1, &m_IrradianceTextureID);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceTextureID);
+	glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_R11F_G11F_B10F, irradiance.m_Size, irradiance.m_Size);
+	UploadCubeMapLevel(irradiance, 0);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+	// Each level is a blurrier lobe, not just a smaller copy, so the shaders pick the level from the shininess.
+	const std::vector<CubeMapImage> &levels = m_Baker.GetPrefilteredLevels();
+	glGenTextures(1, &m_PrefilteredTextureID);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilteredTextureID);
+	glTexStorage2D(GL_TEXTURE_CUBE_MAP, static_cast<GLsizei>(levels.size()), GL_R11F_G11F_B10F, levels[0].m_Size, levels[0].m_Size);
+	for (size_t level = 0; level < levels.size(); level++)
+		UploadCubeMapLevel(levels[level], static_cast<int>(level));
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 }
 
 void Skybox::Render() {
-	glDepthFunc(GL_LEQUAL);		// The incoming depth value is less than or equal to the stored depth value.
+	glDepthFunc(GL_LEQUAL);		// The sky is at the far plane, where the depth buffer was cleared to.
 	m_Shader->Use();
 
-	glBindVertexArray(m_SkyBoxVAO);
+	glBindVertexArray(m_EmptyVertexArrayObject);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubeMapTextureID);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
 	glBindVertexArray(0);
 	glDepthFunc(GL_LESS);
-}
\ No newline at end of file
+}
+
+void Skybox::BindTextures() const {
+	glActiveTexture(GL_TEXTURE0 + s_m_IrradianceTextureUnit);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceTextureID);
+	glActiveTexture(GL_TEXTURE0 + s_m_PrefilteredTextureUnit);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilteredTextureID);
+	glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,147 @@
+#include "StreamingBuffer.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "OpenGLExtensions.h"
+
+GLint StreamingBuffer::QueryBindingAlignment(GLenum p_Target) {
+	GLint alignment = 1;
+	if (p_Target == GL_UNIFORM_BUFFER)
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	else if (p_Target == GL_SHADER_STORAGE_BUFFER)
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return alignment;
+}
+
+StreamingBuffer::StreamingBuffer(GLenum p_Target, GLsizeiptr p_RegionSize, unsigned int p_RegionCount)
+	: m_Target(p_Target), m_RegionSize(p_RegionSize), m_RegionCount(p_RegionCount), m_RegionFences(p_RegionCount, nullptr) {
+	GLsizeiptr bufferSize = m_RegionSize * m_RegionCount;
+	m_IsPersistentlyMapped = OpenGLExtensions::HasBufferStorage();
+	m_BindingAlignment = QueryBindingAlignment(m_Target);
+
+	glGenBuffers(1, &m_BufferObject);
+	glBindBuffer(m_Target, m_BufferObject);
+	if (m_IsPersistentlyMapped) {
+		// Map the whole buffer once, it stays mapped while the GPU reads from it.
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		OpenGLExtensions::s_m_BufferStorage(m_Target, bufferSize, nullptr, flags);
+		m_MappedData = static_cast<unsigned char*>(glMapBufferRange(m_Target, 0, bufferSize, flags));
+
+		if (m_MappedData == nullptr) {
+			std::cout << "ERROR::STREAMING_BUFFER:: Failed to persistently map the buffer." << std::endl;
+			m_IsPersistentlyMapped = false;
+
+			// Buffer storage is immutable, so a new buffer object is needed for the fallback.
+			glBindBuffer(m_Target, 0);
+			glDeleteBuffers(1, &m_BufferObject);
+			glGenBuffers(1, &m_BufferObject);
+			glBindBuffer(m_Target, m_BufferObject);
+		}
+	}
+
+	if (!m_IsPersistentlyMapped) {
+		glBufferData(m_Target, bufferSize, nullptr, GL_STREAM_DRAW);
+		m_StagingData.resize(static_cast<size_t>(bufferSize));
+		m_MappedData = m_StagingData.data();
+	}
+	glBindBuffer(m_Target, 0);
+}
+
+StreamingBuffer::~StreamingBuffer() {
+	for (auto &fence : m_RegionFences) {
+		if (fence != nullptr)
+			glDeleteSync(fence);
+	}
+
+	if (m_IsPersistentlyMapped) {
+		glBindBuffer(m_Target, m_BufferObject);
+		glUnmapBuffer(m_Target);
+		glBindBuffer(m_Target, 0);
+	}
+	glDeleteBuffers(1, &m_BufferObject);
+}
+
+void StreamingBuffer::WaitForRegion(unsigned int p_Region) {
+	GLsync &fence = m_RegionFences[p_Region];
+	if (fence == nullptr)
+		return;
+
+	// Check without waiting first, so only real stalls are counted.
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED) {
+		m_StallCount++;
+
+		auto waitStart = std::chrono::high_resolution_clock::now();
+		const GLuint64 oneMillisecond = 1000000;
+		do {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, oneMillisecond);
+		} while (result == GL_TIMEOUT_EXPIRED);
+		auto waitEnd = std::chrono::high_resolution_clock::now();
+
+		m_StallMilliseconds += std::chrono::duration<double, std::milli>(waitEnd - waitStart).count();
+	}
+	if (result == GL_WAIT_FAILED)
+		std::cout << "ERROR::STREAMING_BUFFER:: Waiting for a region's fence failed." << std::endl;
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+void StreamingBuffer::BeginFrame() {
+	m_CurrentRegion = (m_CurrentRegion + 1) % m_RegionCount;
+	WaitForRegion(m_CurrentRegion);
+
+	m_RegionOffset = 0;
+	m_FlushedOffset = 0;
+}
+
+void StreamingBuffer::EndFrame() {
+	Flush();
+	m_RegionFences[m_CurrentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamingBuffer::Allocation StreamingBuffer::Allocate(GLsizeiptr p_Size, GLsizeiptr p_Alignment) {
+	Allocation allocation;
+
+	GLsizeiptr regionStart = m_RegionSize * m_CurrentRegion;
+	GLsizeiptr regionOffset = m_RegionOffset.load(std::memory_order_relaxed);
+	GLsizeiptr alignedOffset;
+	// Several workers can allocate at once, so claim the space by moving the offset on, retrying if another got there first.
+	do {
+		// The region start is a multiple of the region size, so aligning the absolute offset is enough.
+		alignedOffset = regionStart + regionOffset;
+		if (p_Alignment > 1)
+			alignedOffset = ((alignedOffset + p_Alignment - 1) / p_Alignment) * p_Alignment;
+
+		if (alignedOffset + p_Size > regionStart + m_RegionSize) {
+			m_FailedAllocationCount++;
+			return allocation;
+		}
+	} while (!m_RegionOffset.compare_exchange_weak(regionOffset, alignedOffset + p_Size - regionStart, std::memory_order_relaxed));
+
+	allocation.m_Data = m_MappedData + alignedOffset;
+	allocation.m_Buffer = m_BufferObject;
+	allocation.m_Offset = alignedOffset;
+	allocation.m_Size = p_Size;
+
+	return allocation;
+}
+
+StreamingBuffer::Allocation StreamingBuffer::AllocateForBinding(GLsizeiptr p_Size) {
+	return Allocate(p_Size, m_BindingAlignment);
+}
+
+void StreamingBuffer::Flush() {
+	GLsizeiptr regionOffset = m_RegionOffset.load();
+	if (m_IsPersistentlyMapped || m_FlushedOffset == regionOffset)
+		return;
+
+	// Upload everything written since the last flush.
+	GLsizeiptr regionStart = m_RegionSize * m_CurrentRegion;
+	glBindBuffer(m_Target, m_BufferObject);
+	glBufferSubData(m_Target, regionStart + m_FlushedOffset, regionOffset - m_FlushedOffset, m_MappedData + regionStart + m_FlushedOffset);
+	glBindBuffer(m_Target, 0);
+
+	m_FlushedOffset = regionOffset;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "TaskGraph.h"
+
+#include <cassert>
+#include <chrono>
+
+#include "CPUProfiler.h"
+
+TaskHandle TaskGraph::AddTask(const std::string &p_Name, std::function<void()> p_Function) {
+	auto task = std::make_unique<Task>();
+	task->m_Name = p_Name;
+	task->m_ProfileName = CPUProfiler::InternName(p_Name);
+	task->m_Function = std::move(p_Function);
+	m_Tasks.push_back(std::move(task));
+
+	return static_cast<TaskHandle>(m_Tasks.size() - 1);
+}
+
+void TaskGraph::AddDependency(TaskHandle p_Before, TaskHandle p_After) {
+	assert(p_Before < m_Tasks.size() && p_After < m_Tasks.size() && p_Before != p_After);
+
+	m_Tasks[p_Before]->m_Successors.push_back(p_After);
+	m_Tasks[p_After]->m_DependencyCount++;
+}
+
+void TaskGraph::RunTask(JobSystem &p_JobSystem, TaskHandle p_Task, JobCounter &p_Counter) {
+	p_JobSystem.Run([this, &p_JobSystem, p_Task, &p_Counter]() {
+		Task &task = *m_Tasks[p_Task];
+
+		auto start = std::chrono::high_resolution_clock::now();
+		{
+			CPU_PROFILE_SCOPE(task.m_ProfileName);
+			task.m_Function();
+		}
+		task.m_Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		// Queue the successors before this job finishes, so the counter can't reach zero while they're still to come.
+		for (auto successor : task.m_Successors) {
+			if (m_Tasks[successor]->m_RemainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				RunTask(p_JobSystem, successor, p_Counter);
+		}
+	}, p_Counter);
+}
+
+void TaskGraph::Execute(JobSystem &p_JobSystem) {
+	for (auto &task : m_Tasks)
+		task->m_RemainingDependencies.store(task->m_DependencyCount, std::memory_order_relaxed);
+
+	JobCounter counter{ 0 };
+	for (TaskHandle i = 0; i < m_Tasks.size(); i++) {
+		if (m_Tasks[i]->m_DependencyCount == 0)
+			RunTask(p_JobSystem, i, counter);
+	}
+	p_JobSystem.Wait(counter);
+}
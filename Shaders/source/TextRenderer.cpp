@@ -0,0 +1,128 @@
+#include "TextRenderer.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include "GLAD/glad.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include "ResourceManager.h"
+#include "Shader.h"
+
+TextRenderer::TextRenderer(const std::string &p_FontPath) {
+	if (FT_Init_FreeType(&m_Library))
+		std::cout << "ERROR::TEXTRENDERER:: Failed to initialise FreeType." << std::endl;
+	else if (FT_New_Face(m_Library, p_FontPath.c_str(), 0, &m_Face)) {
+		std::cout << "ERROR::TEXTRENDERER:: Failed to load the font at the path " << p_FontPath << std::endl;
+		m_Face = nullptr;
+	}
+	m_BitmapAtlas = std::make_unique<GlyphAtlas>(m_Face, false);
+	m_DistanceFieldAtlas = std::make_unique<GlyphAtlas>(m_Face, true);
+
+	m_Shader = ResourceManagerInstance.GetShader("font");
+	m_VertexBuffer = std::make_unique<StreamingBuffer>(GL_ARRAY_BUFFER, s_m_MaxCharactersPerFrame * 6 * sizeof(TextVertex));
+	glGenVertexArrays(1, &m_VertexArrayObject);
+	glBindVertexArray(m_VertexArrayObject);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glBindVertexArray(0);
+}
+
+TextRenderer::~TextRenderer() {
+	// The atlases hold the face, so they go first.
+	m_BitmapAtlas.reset();
+	m_DistanceFieldAtlas.reset();
+	glDeleteVertexArrays(1, &m_VertexArrayObject);
+	if (m_Face)
+		FT_Done_Face(m_Face);
+	if (m_Library)
+		FT_Done_FreeType(m_Library);
+}
+
+void TextRenderer::AddText(const std::string &p_Text, const glm::vec2 &p_Position, unsigned int p_PixelHeight, const glm::vec4 &p_Colour) {
+	if (!m_Face || p_PixelHeight == 0)
+		return;
+
+	GlyphAtlas &atlas = GetAtlas();
+	float scale = atlas.GetScale(p_PixelHeight);
+	float lineHeight = GetLineHeight(p_PixelHeight);
+	float ascender = static_cast<float>(m_Face->ascender) * p_PixelHeight / m_Face->units_per_EM;
+	unsigned int colour = glm::packUnorm4x8(p_Colour);
+
+	glm::vec2 pen(p_Position.x, p_Position.y + ascender);
+	for (char character : p_Text) {
+		if (character == '\n') {
+			pen = glm::vec2(p_Position.x, pen.y + lineHeight);
+			continue;
+		}
+
+		const Glyph &glyph = atlas.GetGlyph(static_cast<unsigned char>(character), p_PixelHeight);
+		if (glyph.m_Size.x > 0.0f) {
+			if (m_Vertices.size() + 6 > s_m_MaxCharactersPerFrame * 6) {
+				m_DroppedCharacterCount++;
+				continue;
+			}
+
+			// Bitmap glyphs are drawn a texel to a pixel, so they're only sharp on whole pixels.
+			glm::vec2 topLeft = pen + glyph.m_Offset * scale;
+			if (!atlas.IsDistanceField())
+				topLeft = glm::floor(topLeft + 0.5f);
+			glm::vec2 bottomRight = topLeft + glyph.m_Size * scale;
+
+			TextVertex topLeftVertex = { topLeft, glyph.m_TextureMin, colour };
+			TextVertex topRightVertex = { glm::vec2(bottomRight.x, topLeft.y), glm::vec2(glyph.m_TextureMax.x, glyph.m_TextureMin.y), colour };
+			TextVertex bottomLeftVertex = { glm::vec2(topLeft.x, bottomRight.y), glm::vec2(glyph.m_TextureMin.x, glyph.m_TextureMax.y), colour };
+			TextVertex bottomRightVertex = { bottomRight, glyph.m_TextureMax, colour };
+			m_Vertices.push_back(topLeftVertex);
+			m_Vertices.push_back(bottomLeftVertex);
+			m_Vertices.push_back(bottomRightVertex);
+			m_Vertices.push_back(topLeftVertex);
+			m_Vertices.push_back(bottomRightVertex);
+			m_Vertices.push_back(topRightVertex);
+		}
+		pen.x += glyph.m_Advance * scale;
+	}
+}
+
+float TextRenderer::GetLineHeight(unsigned int p_PixelHeight) const {
+	// In the font's units, so it doesn't depend on the size last rasterised.
+	return m_Face ? static_cast<float>(m_Face->height) * p_PixelHeight / m_Face->units_per_EM : static_cast<float>(p_PixelHeight);
+}
+
+void TextRenderer::Render(int p_Width, int p_Height) {
+	m_LastDrawCharacterCount = static_cast<unsigned int>(m_Vertices.size() / 6);
+	if (m_Vertices.empty())
+		return;
+
+	m_VertexBuffer->BeginFrame();
+	// AddText keeps to what a region holds, so this always fits.
+	GLsizeiptr size = static_cast<GLsizeiptr>(m_Vertices.size() * sizeof(TextVertex));
+	StreamingBuffer::Allocation allocation = m_VertexBuffer->Allocate(size, sizeof(TextVertex));
+	std::memcpy(allocation.m_Data, m_Vertices.data(), size);
+	m_VertexBuffer->Flush();
+
+	m_Shader->Use();
+	m_Shader->SetMat4("projection", glm::ortho(0.0f, static_cast<float>(p_Width), static_cast<float>(p_Height), 0.0f));
+	m_Shader->SetBool("distanceField", GetAtlas().IsDistanceField());
+	m_Shader->SetInt("text", 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, GetAtlas().GetTextureID());
+
+	glBindVertexArray(m_VertexArrayObject);
+	glBindBuffer(GL_ARRAY_BUFFER, allocation.m_Buffer);
+	// The position and texture coordinates are read as one vec4.
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), reinterpret_cast<void*>(offsetof(TextVertex, m_Position)));
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), reinterpret_cast<void*>(offsetof(TextVertex, m_Colour)));
+
+	// Over everything, blended with the global alpha blending.
+	glDisable(GL_DEPTH_TEST);
+	glDrawArrays(GL_TRIANGLES, static_cast<GLint>(allocation.m_Offset / static_cast<GLintptr>(sizeof(TextVertex))), static_cast<GLsizei>(m_Vertices.size()));
+	glEnable(GL_DEPTH_TEST);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_VertexBuffer->EndFrame();
+	m_Vertices.clear();
+}
@@ -0,0 +1,81 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cassert>
+
+void TransformHierarchy::Reserve(size_t p_NodeCount) {
+	m_LocalPositions.reserve(p_NodeCount);
+	m_LocalRotations.reserve(p_NodeCount);
+	m_LocalScales.reserve(p_NodeCount);
+	m_Parents.reserve(p_NodeCount);
+	m_WorldMatrices.reserve(p_NodeCount);
+	m_NormalMatrices.reserve(p_NodeCount);
+	m_Dirty.reserve(p_NodeCount);
+	m_WorldChanged.reserve(p_NodeCount);
+}
+
+TransformHandle TransformHierarchy::AddNode(TransformHandle p_Parent, const glm::vec3 &p_Position, const glm::quat &p_Rotation, const glm::vec3 &p_Scale) {
+	// Parents must already exist, which keeps the nodes in topological order.
+	assert(p_Parent == s_InvalidTransform || p_Parent < m_Parents.size());
+
+	TransformHandle node = static_cast<TransformHandle>(m_Parents.size());
+	m_LocalPositions.push_back(p_Position);
+	m_LocalRotations.push_back(p_Rotation);
+	m_LocalScales.push_back(p_Scale);
+	m_Parents.push_back(p_Parent);
+
+	m_WorldMatrices.push_back(glm::mat4(1.0f));
+	m_NormalMatrices.push_back(glm::mat3(1.0f));
+	m_Dirty.push_back(true);
+	m_WorldChanged.push_back(false);
+
+	return node;
+}
+
+unsigned int TransformHierarchy::Update() {
+	unsigned int updatedNodes = 0;
+
+	const size_t nodeCount = m_Parents.size();
+	for (size_t i = 0; i < nodeCount; i++) {
+		const TransformHandle parent = m_Parents[i];
+		const bool parentChanged = parent != s_InvalidTransform && m_WorldChanged[parent];
+
+		if (!m_Dirty[i] && !parentChanged) {
+			m_WorldChanged[i] = false;
+			continue;
+		}
+
+		// Local matrix = translate * rotate * scale, built directly rather than by multiplying three matrices.
+		glm::mat4 localMatrix = glm::mat4_cast(m_LocalRotations[i]);
+		localMatrix[0] *= m_LocalScales[i].x;
+		localMatrix[1] *= m_LocalScales[i].y;
+		localMatrix[2] *= m_LocalScales[i].z;
+		localMatrix[3] = glm::vec4(m_LocalPositions[i], 1.0f);
+
+		// The parent has a lower index, so its world matrix is already up to date.
+		if (parent != s_InvalidTransform)
+			m_WorldMatrices[i] = m_WorldMatrices[parent] * localMatrix;
+		else
+			m_WorldMatrices[i] = localMatrix;
+		m_NormalMatrices[i] = glm::transpose(glm::inverse(glm::mat3(m_WorldMatrices[i])));
+
+		m_Dirty[i] = false;
+		m_WorldChanged[i] = true;
+		updatedNodes++;
+	}
+
+	return updatedNodes;
+}
+
+void TransformHierarchy::MarkAllDirty() {
+	std::fill(m_Dirty.begin(), m_Dirty.end(), static_cast<unsigned char>(true));
+}
+
+bool TransformHierarchy::HasUniformScale(const glm::mat4 &p_Matrix) {
+	const float tolerance = 0.0001f;
+	float xScale = glm::length(glm::vec3(p_Matrix[0]));
+	float yScale = glm::length(glm::vec3(p_Matrix[1]));
+	float zScale = glm::length(glm::vec3(p_Matrix[2]));
+
+	return glm::abs(xScale - yScale) <= tolerance * xScale && glm::abs(xScale - zScale) <= tolerance * xScale;
+}
\ No newline at end of file
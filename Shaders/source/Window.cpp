@@ -6,6 +6,8 @@
 #include <glfw/glfw3.h>
 
 #include "ResourceManager.h"
+#include "OpenGLExtensions.h"
+#include "HeadlessContext.h"
 
 std::vector<bool> Window::s_m_KeyPressBuffer;
 std::vector<bool> Window::s_m_KeyReleaseBuffer;
@@ -44,10 +46,9 @@ void Window::KeyCallbackEvent(GLFWwindow *p_Window, int p_Key, int p_ScanCode, i
 }
 
 void Window::WindowResizeCallbackEvent(GLFWwindow *p_Window, int p_Width, int p_Height) {
-	// Change the OpenGL viewport to match the new window size.
+	// Events are handled on the main thread, which doesn't own the GL context, so the render thread changes the viewport when it sees the new size.
 	s_m_ScreenWidth = p_Width;
 	s_m_ScreenHeight = p_Height;
-	glViewport(0, 0, p_Width, p_Height);
 }
 
 bool Window::InitializeWindow(int p_Width, int p_Height, const std::string &p_WindowName) {
@@ -67,11 +68,8 @@ bool Window::InitializeWindow(int p_Width, int p_Height, const std::string &p_Wi
 
 	glfwMakeContextCurrent(m_Window);
 
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-		std::cout << "Failed to initialise GLAD" << std::endl;
+	if (!InitializeOpenGL((GLADloadproc)glfwGetProcAddress))
 		return false;
-	}
-	std::cout << "Renderer: " << glGetString(GL_RENDERER) << "\n" << "Version: " << glGetString(GL_VERSION);
 	
 	// Callback functions.
 	glfwSetFramebufferSizeCallback(m_Window, WindowResizeCallbackEvent);
@@ -81,6 +79,35 @@ bool Window::InitializeWindow(int p_Width, int p_Height, const std::string &p_Wi
 	glfwSetCursorPosCallback(m_Window, MouseMoveCallbackEvent);
 	CaptureMouse(m_Window);
 
+	return true;
+}
+
+bool Window::InitializeHeadless(int p_Width, int p_Height, bool p_UseSoftwareRenderer) {
+	s_m_ScreenWidth = p_Width;
+	s_m_ScreenHeight = p_Height;
+
+	m_HeadlessContext = std::make_unique<HeadlessContext>();
+	if (!m_HeadlessContext->Initialize(p_Width, p_Height, p_UseSoftwareRenderer)) {
+		std::cout << "Failed to create a headless OpenGL context" << std::endl;
+		m_HeadlessContext.reset();
+		return false;
+	}
+
+	if (!InitializeOpenGL(HeadlessContext::GetLoader()))
+		return false;
+	m_HeadlessContext->CreateFrameBuffer();
+
+	return true;
+}
+
+bool Window::InitializeOpenGL(void *(*p_Loader)(const char *p_Name)) {
+	if (!gladLoadGLLoader(p_Loader)) {
+		std::cout << "Failed to initialise GLAD" << std::endl;
+		return false;
+	}
+	OpenGLExtensions::Load(p_Loader);
+	std::cout << "Renderer: " << glGetString(GL_RENDERER) << "\n" << "Version: " << glGetString(GL_VERSION);
+
 	// Make space for the keybuffer.
 	s_m_KeyPressBuffer.resize(s_m_KeyBufferSize);
 	std::fill(s_m_KeyPressBuffer.begin(), s_m_KeyPressBuffer.end(), false);
@@ -104,9 +131,44 @@ bool Window::InitializeWindow(int p_Width, int p_Height, const std::string &p_Wi
 	return true;
 }
 
+Window::Window() = default;
+
 Window::~Window() {
 	// Clean up.
-	glfwTerminate();
+	m_HeadlessContext.reset();
+	if (m_Window != nullptr)
+		glfwTerminate();
+}
+
+bool Window::MakeContextCurrent() {
+	if (m_HeadlessContext)
+		return m_HeadlessContext->MakeCurrent();
+
+	glfwMakeContextCurrent(m_Window);
+	return true;
+}
+
+void Window::ReleaseContext() {
+	if (m_HeadlessContext)
+		m_HeadlessContext->ReleaseCurrent();
+	else
+		glfwMakeContextCurrent(nullptr);
+}
+
+void Window::SwapBuffers() {
+	// There's nothing to present headless, but the frame's commands are still submitted, as a swap would.
+	if (m_HeadlessContext)
+		glFlush();
+	else
+		glfwSwapBuffers(m_Window);
+}
+
+bool Window::IsHeadless() const {
+	return m_HeadlessContext != nullptr;
+}
+
+unsigned int Window::GetFrameBufferObject() const {
+	return m_HeadlessContext ? m_HeadlessContext->GetFrameBufferObject() : 0;
 }
 
 GLFWwindow *Window::GetWindow() const {
@@ -1,31 +1,164 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
 #include <glfw/glfw3.h>
 
 #include "Scene.h"
 #include "Window.h"
+#include "Benchmark.h"
+#include "RenderThread.h"
+#include "CPUProfiler.h"
+
+int main(int argc, char *argv[]) {
+	// Run one of the CPU benchmarks instead of the scene, e.g: Shaders.exe --benchmark transforms
+	if (argc > 2 && std::string(argv[1]) == "--benchmark")
+		return Benchmark::Run(argv[2], std::vector<std::string>(argv + 3, argv + argc)) ? 0 : -1;
+	bool isRenderThreaded = true;
+	bool validateCommandBuffers = false;
+	bool useDeferredShading = false;
+	bool useClusteredShading = false;
+	bool useShadows = true;
+	bool isHeadless = false;
+	bool useSoftwareRenderer = false;
+	int headlessFrameCount = 300;
+	int width = 800;
+	int height = 600;
+	std::string cpuTracePath;
+	std::string capturePath;
+	CaptureFormat captureFormat = CaptureFormat::PNG_SEQUENCE;
+	for (int i = 1; i < argc; i++) {
+		// Draw on the main thread, after the simulation, to compare against the render thread.
+		if (std::string(argv[i]) == "--single-threaded")
+			isRenderThreaded = false;
+		// Check every recorded command buffer before it's replayed.
+		else if (std::string(argv[i]) == "--validate-commands")
+			validateCommandBuffers = true;
+		// Start with deferred shading on, it can still be toggled with 9.
+		else if (std::string(argv[i]) == "--deferred")
+			useDeferredShading = true;
+		// Start with clustered forward shading on, it can still be toggled with 0.
+		else if (std::string(argv[i]) == "--clustered")
+			useClusteredShading = true;
+		// Start with shadows off, they can still be toggled with O.
+		else if (std::string(argv[i]) == "--no-shadows")
+			useShadows = false;
+		// Render a fixed number of frames without a window, e.g: Shaders.exe --headless --frames 600 --resolution 1920x1080
+		else if (std::string(argv[i]) == "--headless")
+			isHeadless = true;
+		else if (std::string(argv[i]) == "--software")
+			useSoftwareRenderer = true;
+		else if (std::string(argv[i]) == "--frames" && i + 1 < argc) {
+			char *end;
+			long frameCount = std::strtol(argv[++i], &end, 10);
+			if (end == argv[i] || *end != '\0' || frameCount < 0 || frameCount > INT_MAX) {
+				std::cout << "The frame count should be a whole number, not: " << argv[i] << std::endl;
+				return -1;
+			}
+			headlessFrameCount = static_cast<int>(frameCount);
+		}
+		else if (std::string(argv[i]) == "--resolution" && i + 1 < argc) {
+			// Read into locals, so a value that only partly matches changes nothing. Anything after the height is rejected.
+			int resolutionWidth, resolutionHeight;
+			char trailing;
+			if (std::sscanf(argv[++i], "%dx%d%c", &resolutionWidth, &resolutionHeight, &trailing) != 2 || resolutionWidth <= 0 || resolutionHeight <= 0) {
+				std::cout << "The resolution should look like 1920x1080, not: " << argv[i] << std::endl;
+				return -1;
+			}
+			width = resolutionWidth;
+			height = resolutionHeight;
+		}
+		// Write the CPU profiler's events to a Chrome trace on exit, e.g: Shaders.exe --cpu-trace trace.json
+		else if (std::string(argv[i]) == "--cpu-trace" && i + 1 < argc)
+			cpuTracePath = argv[++i];
+		// Write every frame to disk, as a folder of PNGs or one raw video file, e.g: Shaders.exe --headless --capture frames
+		else if (std::string(argv[i]) == "--capture" && i + 1 < argc)
+			capturePath = argv[++i];
+		else if (std::string(argv[i]) == "--capture-raw-video")
+			captureFormat = CaptureFormat::RAW_VIDEO;
+	}
+	if (!cpuTracePath.empty() && !CPUProfiler::IsEnabled())
+		std::cout << "The CPU profiler isn't compiled in, define ENABLE_CPU_PROFILER to record a trace." << std::endl;
+	CPU_PROFILE_THREAD_NAME("Main thread");
+	auto writeCPUTrace = [&cpuTracePath]() {
+		if (!cpuTracePath.empty() && CPUProfiler::IsEnabled() && CPUProfiler::WriteChromeTrace(cpuTracePath))
+			std::cout << "\nCPU trace written to " << cpuTracePath << std::endl;
+	};
 
-int main() {
 	std::shared_ptr<Window> window = std::make_shared<Window>();
-	if (!window->InitializeWindow(800, 600, "Advanced Shaders"))
+	if (isHeadless) {
+		if (!window->InitializeHeadless(width, height, useSoftwareRenderer))
+			return -1;
+	}
+	else if (!window->InitializeWindow(width, height, "Advanced Shaders")) {
 		return -1;
+	}
 
 	std::shared_ptr<Scene> scene = std::make_shared<Scene>(window);
+	scene->SetCommandBufferValidation(validateCommandBuffers);
+	scene->GetRenderSettings().m_UseDeferredShading = useDeferredShading;
+	scene->GetRenderSettings().m_UseClusteredShading = useClusteredShading;
+	scene->GetRenderSettings().m_UseShadows = useShadows;
+	if (!capturePath.empty())
+		scene->StartFrameCapture(captureFormat, capturePath);
+	// Takes the GL context from the main thread, which carries on with the input and simulation.
+	std::shared_ptr<RenderThread> renderThread = std::make_shared<RenderThread>(window, scene, isRenderThreaded);
+
+	if (isHeadless) {
+		// There's no input, and every run steps the simulation by the same amount, so runs can be compared.
+		const float fixedDeltaTime = 1.0f / 60.0f;
+		auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < headlessFrameCount && scene->IsRunning(); frame++) {
+			CPU_PROFILE_SCOPE("Frame");
+			FramePacket &packet = renderThread->BeginFrame();
+			{
+				CPU_PROFILE_SCOPE("Simulation");
+				scene->Update(fixedDeltaTime, packet);
+			}
+			renderThread->EndFrame();
+		}
+		renderThread->Stop();
+		auto end = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>(end - start).count();
+		std::cout << "\nHeadless: " << headlessFrameCount << " frames at " << width << "x" << height << " in " << seconds << " s ("
+			<< seconds * 1000.0 / std::max(1, headlessFrameCount) << " ms per frame)" << std::endl;
+		writeCPUTrace();
+		return 0;
+	}
 
 	auto previousTime = glfwGetTime();
 	while (!glfwWindowShouldClose(window->GetWindow()) && scene->IsRunning()) {
+		CPU_PROFILE_SCOPE("Frame");
 		auto currentTime = glfwGetTime();
 		auto deltaTime = currentTime - previousTime;
 		previousTime = currentTime;
 
-		scene->HandleMouseInput(static_cast<float>(window->MouseXPosition()), static_cast<float>(window->MouseYPosition()));
-		scene->HandleKeyboardInput(window->KeyPressBuffer(), window->KeyReleaseBuffer());
+		FramePacket &packet = renderThread->BeginFrame();
+		{
+			CPU_PROFILE_SCOPE("Input");
+			scene->HandleMouseInput(static_cast<float>(window->MouseXPosition()), static_cast<float>(window->MouseYPosition()));
+			scene->HandleKeyboardInput(window->KeyPressBuffer(), window->KeyReleaseBuffer());
+		}
+		{
+			CPU_PROFILE_SCOPE("Simulation");
+			scene->Update(static_cast<float>(deltaTime), packet);
+		}
+		renderThread->EndFrame();
 
-		scene->Update(static_cast<float>(deltaTime));
-		scene->Render();
-
-		// Swap the buffers.
-		glfwSwapBuffers(window->GetWindow());
+		CPU_PROFILE_SCOPE("Poll events");
 		glfwPollEvents();
 	}
 
+	// The scene's GL objects are deleted on this thread, so it needs the context back first.
+	renderThread->Stop();
+	writeCPUTrace();
+
 	return 0;
 }
\ No newline at end of file